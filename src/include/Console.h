@@ -35,7 +35,10 @@
    ParseTree *_prelations;
    std::vector<ParseTree*> *_pvariables;
    std::vector<std::string> _array_names;
+   unsigned int _nthread;
+   bool _plates;
    static unsigned int &rngSeed();
+   void printSchedule();
    void handle(bool clear=true);  
  public:
    /**
@@ -109,6 +112,35 @@
     * @see Model#samplerFactories, Model#rngFactories
     */
    bool initialize();
+   /**
+    * @short Sets the number of threads used by each chain.
+    *
+    * Samplers that do not share any nodes in their Markov blankets
+    * are updated concurrently within each chain using the given
+    * number of threads. The setting is applied to the current model,
+    * if there is one, and to all models subsequently initialized. A
+    * summary of the sampler colouring is printed if the model is
+    * initialized.
+    *
+    * @param nthread Number of threads per chain. Setting nthread to
+    * 1 restores sequential updating of samplers.
+    *
+    * @returns true on success, false on failure.
+    *
+    * @see Model#setSamplerThreads
+    */
+   bool setSamplerThreads(unsigned int nthread);
+   /**
+    * @short Turns compilation of plates on or off.
+    *
+    * When plates are on, relations in the body of a for loop that
+    * have the same distribution or function for every value of the
+    * counter are compiled into a single vectorized node. The setting
+    * takes effect the next time a model is compiled.
+    *
+    * @see Compiler#setPlates
+    */
+   void setPlates(bool plates);
    /**
     * @short Updates the Markov chain generated by the model.
     *
@@ -130,9 +162,13 @@
     *
     * @param type Name of the monitor type.
     *
+    * @param stem Stem of the names of files written by monitors
+    * that save their values while the model is updated, such as
+    * stream monitors.
     */
    bool setMonitor(std::string const &name, Range const &range,
-		   unsigned int thin, std::string const &type); 
+		   unsigned int thin, std::string const &type,
+		   std::string const &stem = "CODA"); 
    /**
     * @short Clears a monitor. 
     * 
@@ -191,10 +227,15 @@
     * @param prefix Prefix to be prepended to the output file names
     * 
     * @param type Name of the monitor type or "*" for all types
+    *
+    * @param binary If true, write a binary trace file instead of
+    * CODA text files.
     */
    bool coda(std::vector<std::pair<std::string, Range> > const &nodes,
-	     std::string const &prefix, std::string const &type);
-   bool coda(std::string const &prefix, std::string const &type);
+	     std::string const &prefix, std::string const &type,
+	     bool binary = false);
+   bool coda(std::string const &prefix, std::string const &type,
+	     bool binary = false);
    BUGSModel const *model();
    unsigned int nchain() const;
    bool dumpMonitors(std::map<std::string,SArray> &data_table,
@@ -231,6 +272,16 @@
     */
    static bool setFactoryActive(std::string const &name, FactoryType type, 
 				bool active);
+   /**
+    * Sets an option of a factory.
+    *
+    * @return true if a factory with the given name and type accepted
+    * the option, false otherwise.
+    *
+    * @see Factory#setOption
+    */
+   static bool setFactoryOption(std::string const &name, FactoryType type,
+				std::string const &option, double value);
    /**
     * Sets the seed for all RNG factories.
     *
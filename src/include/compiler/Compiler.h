@@ -52,6 +52,8 @@ class Compiler {
   std::set<std::string> _lhs_vars;
   std::map<std::pair<std::vector<unsigned long>, std::vector<double> >,
       ConstantNode *> _cnode_map;
+  bool _plates;
+  std::set<std::pair<ParseTree const *, std::vector<unsigned long> > > _plate_relations;
   
   Node *getArraySubset(ParseTree const *t);
   SimpleRange VariableSubsetRange(ParseTree const *var);
@@ -61,6 +63,14 @@ class Compiler {
     void traverseForwards(ParseTree const *relations, CompilerMemFn fun);
     void traverseBackwards(ParseTree const *relations, CompilerMemFn fun);
   void allocate(ParseTree const *rel);
+  void allocatePlates(ParseTree const *loop,
+		      std::vector<unsigned long> const &counter_range);
+  Node * allocatePlate(ParseTree const *rel, std::string const &counter,
+		       std::vector<unsigned long> const &counter_range);
+  Node * getPlateParameter(ParseTree const *t, std::string const &counter,
+			   std::vector<unsigned long> const &counter_range);
+  Range getPlateRange(ParseTree const *var, std::string const &counter,
+		      std::vector<unsigned long> const &counter_range);
   Node * allocateStochastic(ParseTree const *stoch_rel);
   Node * allocateLogical(ParseTree const *dtrm_rel);
   void setConstantMask(ParseTree const *rel);
@@ -104,6 +114,28 @@ public:
    * @param prelations ParseTree corresponding to a parsed model block
    */
   void undeclaredVariables(ParseTree const *prelations);
+  /**
+   * Enables or disables plate compilation, which is disabled by
+   * default.
+   *
+   * When plates are enabled, a relation in the body of a for loop is
+   * compiled into a single node for all values of the counter,
+   * instead of one node per value, if it has the form
+   *
+   * y[i] ~ dfoo(a[i], b)  or  mu[i] <- f(x[i], c)
+   *
+   * where i is the counter of the innermost loop, the relation does
+   * not use i in any other way, and the counter takes consecutive
+   * values. A stochastic relation must be fully observed, with a
+   * scalar distribution and no truncation, and is compiled into a
+   * PlateStochasticNode. A logical relation must be a scalar
+   * function and is compiled into a vectorized logical node.  A
+   * variable indexed by the counter, such as a[i], must be fixed,
+   * or must be a subset of a single node, so that no sampler
+   * depends on the whole plate through a single element.  Relations
+   * that do not meet these conditions are compiled as usual.
+   */
+  void setPlates(bool plates);
   /**
    * Traverses the ParseTree creating nodes.
    *
@@ -73,6 +73,23 @@ public:
 		       std::vector<double const *> const &parameters,
 		       std::vector<std::vector<unsigned long>> const &dims,
 		       unsigned long i) const;
+    /**
+     * Calculates the gradient of the log density with respect to the
+     * value x. This function should only be called if
+     * Distribution#hasValueScore returns true.
+     *
+     * @param s Array to hold the results (assumed to be of correct
+     * length). The gradient is added to this array.
+     *
+     * @param x Value at which to evaluate the gradient.
+     *
+     * @param parameters Vector of parameter values.
+     *
+     * @param dims Vector of parameter dimensions.
+     */
+    virtual void valueScore(double *s, double const *x,
+			    std::vector<double const *> const &parameters,
+			    std::vector<std::vector<unsigned long>> const &dims) const;
     /**
      * Draws a random sample from the distribution. 
      *
@@ -171,6 +171,14 @@ public:
      * (starting from zero).
      */
     virtual bool hasScore(unsigned long i) const;
+    /**
+     * Returns true if the (log) density of the distribution is
+     * differentiable with respect to its value, and the functions
+     * ScalarDist#valueScore, VectorDist#valueScore, and
+     * ArrayDist#valueScore are implemented. The default
+     * implementation returns false.
+     */
+    virtual bool hasValueScore() const;
 };
 
 /**
@@ -73,11 +73,91 @@ class ScalarDist : public Distribution
 			    std::vector<double const *> const &parameters,
 			    double const *lbound, double const *ubound)
       const = 0;
+  /**
+   * Calculates the log densities of a batch of n unbounded
+   * observations that share the same distribution.
+   *
+   * Parameters are supplied in structure-of-arrays form: the value
+   * of parameter j for observation i is parameters[j][i]. The log
+   * density of any observation with invalid parameter values is
+   * JAGS_NEGINF, so the result for each observation is the same as
+   * calling checkParameterValue followed by logDensity.
+   *
+   * The default implementation evaluates each observation in turn
+   * with the scalar logDensity function. Distributions that provide
+   * a faster implementation should also overload hasBatchLogDensity.
+   *
+   * @param density Array of length n to which the log densities are
+   * written
+   * @param x Array of n values
+   * @param n Number of observations
+   * @param type Type of density calculation required
+   * @param parameters Vector of npar arrays of length n
+   */
+  virtual void batchLogDensity(double *density, double const *x,
+			       unsigned long n, PDFType type,
+			       std::vector<double const *> const &parameters)
+      const;
+  /**
+   * Indicates whether the distribution has its own implementation of
+   * batchLogDensity. Samplers only group observations into batches
+   * for distributions that return true. The default implementation
+   * returns false.
+   */
+  virtual bool hasBatchLogDensity() const;
+  /**
+   * Tests whether the normalizing constant of the likelihood is
+   * fixed, given which parameters are fixed.
+   *
+   * For some discrete distributions, the log density contains terms,
+   * such as a binomial coefficient, that depend only on the sampled
+   * value and on parameters that are usually data. When the sampled
+   * value is observed and these parameters are fixed, such terms are
+   * constant and logKernel may be used in place of logDensity with
+   * type PDF_LIKELIHOOD.
+   *
+   * The default implementation returns false.
+   *
+   * @param fixmask Boolean vector indicating which parameters have
+   * fixed values.
+   */
+  virtual bool isNormalizationFixed(std::vector<bool> const &fixmask)
+      const;
+  /**
+   * Calculates the log likelihood of an unbounded observation,
+   * omitting terms that are constant when isNormalizationFixed
+   * returns true. The parameter values are assumed to be valid.
+   *
+   * The default implementation calls logDensity with type
+   * PDF_LIKELIHOOD.
+   */
+  virtual double logKernel(double x,
+			   std::vector<double const *> const &parameters)
+      const;
+  /**
+   * Calculates logKernel for a batch of n observations, with the
+   * arguments of batchLogDensity.  The result for any observation
+   * with invalid parameter values is JAGS_NEGINF.
+   *
+   * The default implementation calls batchLogDensity with type
+   * PDF_LIKELIHOOD.
+   */
+  virtual void batchLogKernel(double *density, double const *x,
+			      unsigned long n,
+			      std::vector<double const *> const &parameters)
+      const;
   /**
    * Calculates the score function
    */
   virtual double score(double x, std::vector<double const *> const &pars,
 		       unsigned long i) const;
+  /**
+   * Calculates the derivative of the log density with respect to
+   * the value x. This function should only be called if
+   * Distribution#hasValueScore returns true.
+   */
+  virtual double valueScore(double x,
+			    std::vector<double const *> const &pars) const;
   /**
    * Draws a random sample 
    */
@@ -13,10 +13,19 @@ namespace jags {
  * be used to aggregate several small nodes into a larger one, or to take
  * a subset of a larger node, or some combination of the two.
  *
+ * When an AggNode takes equally spaced elements of a single parent,
+ * it is a view of that parent: it keeps only the parent, the offset
+ * of the first element and the stride, and has the parent as its
+ * only parent, instead of storing a parent and an offset for each
+ * element. If the subset is contiguous, the AggNode shares the values
+ * of its parent and never needs to copy them.
  */
 class AggNode : public DeterministicNode {
     std::vector<unsigned long> _offsets;
     std::vector<double const *>  _parent_values;
+    Node const *_source;
+    unsigned long _start;
+    unsigned long _step;
     bool _discrete;
     /* Forbid copying */
     AggNode(AggNode const &orig);
@@ -54,7 +63,8 @@ public:
 	    std::vector<unsigned long> const &offsets);
     ~AggNode() override;
     /**
-     * Copies values from parents.
+     * Copies values from parents. This does nothing if the AggNode
+     * shares the values of its parent.
      */
     void deterministicSample(unsigned int chain) override;
     /**
@@ -76,13 +86,35 @@ public:
      */
     std::string deparse(std::vector<std::string> const &parents) const override;
     /**
-     * Returns the vector of offsets
+     * Returns the node from which element i of the value is copied.
+     * This is not the same as parents()[i] when the AggNode is a
+     * view of a single parent.
      */
-    std::vector<unsigned long> const &offsets() const;
+    Node const *parent(unsigned long i) const;
+    /**
+     * Returns the offset, within parent(i), of the element from which
+     * element i of the value is copied.
+     */
+    unsigned long offset(unsigned long i) const;
+    /**
+     * Indicates whether the AggNode is a contiguous subset of a
+     * single parent, sharing its values instead of copying them.
+     */
+    bool isView() const;
     //DeterministicNode *clone(std::vector<Node const *> const &parents) const;
     bool hasGradient(Node const *arg) const override;
     void gradient(double *grad, Node const *arg, unsigned int chain)
 	const override;
+    /**
+     * Each element of an aggregate node is copied from a single
+     * element of a parent, so the adjoints are added to the elements
+     * of the parent they were copied from, without forming the
+     * Jacobian.
+     */
+    void gradientProduct(double *padj, double const *adj,
+			 Node const *parent, unsigned int chain,
+			 double *work) const override;
+    unsigned long gradientWorkLength(Node const *parent) const override;
 };
 
 } /* namespace jags */
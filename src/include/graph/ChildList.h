@@ -0,0 +1,93 @@
+#ifndef CHILD_LIST_H_
+#define CHILD_LIST_H_
+
+#include <graph/NodeArena.h>
+
+#include <algorithm>
+
+namespace jags {
+
+/**
+ * @short List of the children of a Node
+ *
+ * The children of a node are stored in a contiguous array. While the
+ * graph is being built, the array is allocated on the heap and grows
+ * as children are added. Once the graph is complete, the array may
+ * be frozen into a NodeArena so that the children of successive
+ * nodes are stored together, which speeds up traversal of the
+ * graph. A frozen list is copied back to the heap if a child is
+ * later added to it.
+ */
+template<class T>
+class ChildList {
+    T **_data;
+    unsigned long _size;
+    unsigned long _capacity; // Zero if _data is not owned
+    /* Forbid copying */
+    ChildList(ChildList const &);
+    ChildList &operator=(ChildList const &);
+public:
+    typedef T * const *const_iterator;
+
+    ChildList() : _data(nullptr), _size(0), _capacity(0) {}
+    ~ChildList()
+    {
+	if (_capacity) delete [] _data;
+    }
+    const_iterator begin() const { return _data; }
+    const_iterator end() const { return _data + _size; }
+    unsigned long size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    T *operator[](unsigned long i) const { return _data[i]; }
+    /**
+     * Adds a child to the end of the list
+     */
+    void push_back(T *node)
+    {
+	if (_size >= _capacity) {
+	    unsigned long capacity = _size < 2 ? 2 : 2 * _size;
+	    T **data = new T*[capacity];
+	    std::copy(_data, _data + _size, data);
+	    if (_capacity) delete [] _data;
+	    _data = data;
+	    _capacity = capacity;
+	}
+	_data[_size++] = node;
+    }
+    /**
+     * Removes a child from the list, if it is present.
+     *
+     * When a model is deleted, nodes are deleted in reverse order of
+     * construction, so the child to remove is usually the last
+     * one. For efficiency, we therefore search from the end.
+     */
+    void remove(T *node)
+    {
+	for (unsigned long i = _size; i > 0; --i) {
+	    if (_data[i - 1] == node) {
+		std::copy(_data + i, _data + _size, _data + i - 1);
+		--_size;
+		return;
+	    }
+	}
+    }
+    /**
+     * Moves the list into storage allocated from the given arena
+     */
+    void freeze(NodeArena &arena)
+    {
+	if (_capacity == 0) return;
+	T **data = nullptr;
+	if (_size) {
+	    data = static_cast<T**>(arena.allocate(_size * sizeof(T*)));
+	    std::copy(_data, _data + _size, data);
+	}
+	delete [] _data;
+	_data = data;
+	_capacity = 0;
+    }
+};
+
+} /* namespace jags */
+
+#endif /* CHILD_LIST_H_ */
@@ -147,13 +147,54 @@ public:
      * Calculates the gradient function.
      *
      * @param grad Array to hold the result (assumed to be of correct
-     * length). The gradient is added to this array.
+     * length). The gradient is added to this array. The result is the
+     * Jacobian matrix with length() rows and parent->length()
+     * columns, stored in column-major order, so that the derivative
+     * of element p with respect to element q of the parent is found
+     * at grad[p + length() * q].
      * 
      * @param parent Parent node with respect to which the gradient is
      * calculated.
+     *
+     * @param chain Index number of the chain to evaluate.
      */
     virtual void gradient(double *grad, Node const *parent, unsigned int chain)
 	const = 0;
+    /**
+     * Adds the product of the transposed Jacobian matrix with respect
+     * to a parent and a vector of adjoints. This is the step used to
+     * propagate derivatives back from a node to its parents in
+     * reverse-mode differentiation.
+     *
+     * The default implementation forms the Jacobian with the
+     * gradient member function. Nodes with a sparse Jacobian, such
+     * as aggregate nodes and vectorized scalar functions, override
+     * this so that the cost is proportional to length() instead of
+     * length() * parent->length().
+     *
+     * @param padj Array of length parent->length() to which the
+     * product is added.
+     *
+     * @param adj Array of length length() holding the adjoints of
+     * this node.
+     *
+     * @param parent Parent node with respect to which the gradient is
+     * calculated.
+     *
+     * @param chain Index number of the chain to evaluate.
+     *
+     * @param work Work space of length gradientWorkLength(parent).
+     */
+    virtual void gradientProduct(double *padj, double const *adj,
+				 Node const *parent, unsigned int chain,
+				 double *work) const;
+    /**
+     * Returns the length of the work space required by
+     * gradientProduct. The default is length() * parent->length(),
+     * the size of the dense Jacobian. Nodes that override
+     * gradientProduct with a sparse calculation return zero.
+     */
+    virtual unsigned long gradientWorkLength(Node const *parent) const;
 };
 
 } /* namespace jags */
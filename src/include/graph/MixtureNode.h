@@ -105,6 +105,15 @@ public:
     bool hasGradient(Node const *arg) const override;
     void gradient(double *grad, Node const *arg, unsigned int chain)
 	const override;    
+    /**
+     * The Jacobian is the identity matrix for the active parent and
+     * zero for the others, so the adjoints are copied to the active
+     * parent without forming the Jacobian.
+     */
+    void gradientProduct(double *padj, double const *adj,
+			 Node const *parent, unsigned int chain,
+			 double *work) const override;
+    unsigned long gradientWorkLength(Node const *parent) const override;
 };
 
 bool isMixture(Node const *);
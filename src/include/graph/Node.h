@@ -8,6 +8,7 @@
 
 #include <distribution/Distribution.h>
 // Required for PDFtype enum
+#include <graph/ChildList.h>
 
 namespace jags {
 
@@ -21,8 +22,8 @@ class Graph;
  */
 class Node {
     std::vector<Node const *> _parents;
-    std::list<StochasticNode*> *_stoch_children;
-    std::list<DeterministicNode *> *_dtrm_children;
+    mutable ChildList<StochasticNode> _stoch_children;
+    mutable ChildList<DeterministicNode> _dtrm_children;
 
     /* Forbid copying of Node objects */
     Node(Node const &orig);
@@ -32,7 +33,46 @@ protected:
     std::vector<unsigned long> const &_dim;
     const unsigned long _length;
     const unsigned int _nchain;
+    /**
+     * Values of the node. The values for chain n start at
+     * _data + n * _stride. Each chain has its own cache-aligned
+     * storage so that parallel chains do not share cache lines.
+     */
     double *_data;
+    unsigned long _stride;
+    /**
+     * Records that the value of the node has changed in the given
+     * chain. Subclasses that write directly to _data must call this
+     * function after doing so.
+     */
+    inline void incrementVersion(unsigned int chain)
+    {
+	++*versionPtr(chain);
+    }
+    /**
+     * Releases the storage of the node and makes it share the values
+     * of another node instead. The values of this node are then
+     * values of the other node starting at the given offset, and the
+     * two nodes share the same version counter.
+     *
+     * This allows a node that is a contiguous subset of another node
+     * to be represented without copying.
+     */
+    void shareValues(Node const *node, unsigned long offset);
+    /**
+     * Indicates whether the node shares the values of another node
+     */
+    bool sharesValues() const;
+private:
+    /* Offset of _data from the values of the node owning the storage */
+    unsigned long _offset;
+    bool _shared;
+    /* The version counter of each chain is stored before its values */
+    inline unsigned long *versionPtr(unsigned int chain) const
+    {
+	return reinterpret_cast<unsigned long*>(_data - _offset +
+						chain * _stride - 1);
+    }
 
 public:
     /**
@@ -57,6 +97,16 @@ public:
      * Destructor. 
      */
     virtual ~Node();
+    /**
+     * Allocates memory for a Node from the active NodeArena, or from
+     * the heap if there is no active arena.
+     */
+    static void *operator new(std::size_t size);
+    /**
+     * Releases memory for a Node. Memory allocated from an arena is
+     * not released until the arena is destroyed.
+     */
+    static void operator delete(void *ptr);
     /**
      * Number of chains.
      */ 
@@ -84,11 +134,16 @@ public:
     /**
      * Returns the stochastic children of the node
      */
-    std::list<StochasticNode*> const *stochasticChildren();
+    ChildList<StochasticNode> const *stochasticChildren();
     /**
      * Returns the deterministic children of the node
      */
-    std::list<DeterministicNode*> const *deterministicChildren();
+    ChildList<DeterministicNode> const *deterministicChildren();
+    /**
+     * Moves the lists of children into storage allocated from the
+     * given arena. This is done once the graph is complete.
+     */
+    void freezeChildren(NodeArena &arena);
     /**
      * Initializes the node for the given chain. The value array of a
      * newly constructed Node consists of missing values (denoted by
@@ -153,6 +208,17 @@ public:
      * the given chain.
      */
     double const *value(unsigned int chain) const;
+    /**
+     * Returns a counter that is incremented every time the value of
+     * the node changes in the given chain. Two calls that return the
+     * same version are guaranteed to see the same value, so the
+     * version may be used to validate quantities calculated from the
+     * value of the node.
+     */
+    inline unsigned long version(unsigned int chain) const
+    {
+	return *versionPtr(chain);
+    }
     /**
      * Returns the length of the value array
      */
@@ -162,7 +228,9 @@ public:
      */
     std::vector<unsigned long> const &dim() const;
     /**
-     * Swaps the values in the given chains
+     * Swaps the values in the given chains. This does nothing if the
+     * node shares the values of another node, as they are swapped
+     * along with the values of that node.
      */
     void swapValue(unsigned int chain1, unsigned int chain2);
 
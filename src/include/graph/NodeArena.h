@@ -0,0 +1,63 @@
+#ifndef NODE_ARENA_H_
+#define NODE_ARENA_H_
+
+#include <vector>
+#include <cstddef>
+
+namespace jags {
+
+/**
+ * @short Memory arena for the nodes of a model
+ *
+ * A NodeArena provides storage for Node objects, their values, and
+ * their lists of children. Memory is taken from large chunks by
+ * incrementing a pointer, and is only released, all at once, when
+ * the arena is destroyed. This avoids fragmenting the heap when a
+ * model contains millions of nodes, and places nodes that are
+ * created together close together in memory.
+ *
+ * Nodes are allocated in an arena while it is active (see
+ * NodeArena::Scope). An arena is only active in the thread that
+ * created the Scope.  Nodes allocated in an arena must be destroyed
+ * before the arena itself.  Destroying such a node runs its
+ * destructor but does not release its memory.
+ */
+class NodeArena {
+    std::vector<char*> _chunks;
+    char *_next;
+    std::size_t _left;
+    /* Forbid copying */
+    NodeArena(NodeArena const &);
+    NodeArena &operator=(NodeArena const &);
+public:
+    NodeArena();
+    ~NodeArena();
+    /**
+     * Returns a pointer to size bytes of storage, aligned so that
+     * it can hold any type.
+     */
+    void *allocate(std::size_t size);
+    /**
+     * Returns the active arena, or a null pointer if there is none.
+     */
+    static NodeArena *active();
+    /**
+     * @short Activates an arena
+     *
+     * A NodeArena::Scope object makes the given arena active for
+     * its lifetime. The previously active arena, if any, is
+     * restored on destruction.
+     */
+    class Scope {
+	NodeArena *_previous;
+	Scope(Scope const &);
+	Scope &operator=(Scope const &);
+    public:
+	Scope(NodeArena *arena);
+	~Scope();
+    };
+};
+
+} /* namespace jags */
+
+#endif /* NODE_ARENA_H_ */
@@ -0,0 +1,88 @@
+#ifndef PLATE_STOCHASTIC_NODE_H_
+#define PLATE_STOCHASTIC_NODE_H_
+
+#include <graph/StochasticNode.h>
+
+#include <memory>
+
+namespace jags {
+
+class ScalarDist;
+class PlateDist;
+
+/**
+ * @short Vectorized stochastic node using a scalar distribution
+ *
+ * A PlateStochasticNode represents a set of independent scalar
+ * stochastic nodes with the same distribution, such as the
+ * relations in the body of a for loop.  Each parameter is either a
+ * vector, with one value for each element of the plate, or a scalar
+ * that is shared by all elements.  The log density of the node is
+ * the sum of the log densities of its elements, calculated with
+ * ScalarDist#batchLogDensity.
+ *
+ * The distribution of a plate, as returned by
+ * StochasticNode#distribution, is not the scalar distribution of its
+ * elements.  Samplers that can handle plates must test for them
+ * explicitly and use elementDistribution.
+ */
+class PlateStochasticNode : public StochasticNode {
+    std::unique_ptr<PlateDist const> const _platedist;
+    ScalarDist const * const _dist;
+    std::vector<bool> const _isvector;
+    bool const _fixnorm;
+    PlateStochasticNode(std::unique_ptr<PlateDist> platedist,
+			ScalarDist const *dist, unsigned long length,
+			unsigned int nchain,
+			std::vector<Node const *> const &parameters);
+    void sp(double *lower, double *upper, unsigned int chain) const override;
+    double calLogDensity(unsigned int chain, PDFType type) const override;
+    double plateLogDensity(unsigned int chain, PDFType type,
+			   double *elements) const;
+public:
+    /**
+     * Constructor.
+     *
+     * @param dist Distribution of each element
+     * @param length Number of elements
+     * @param nchain Number of chains
+     * @param parameters Parameters of the distribution. Each
+     * parameter must have length 1 or the same length as the node.
+     */
+    PlateStochasticNode(ScalarDist const *dist, unsigned long length,
+			unsigned int nchain,
+			std::vector<Node const *> const &parameters);
+    ~PlateStochasticNode() override;
+    /**
+     * Returns the distribution of each element of the plate
+     */
+    ScalarDist const *elementDistribution() const;
+    /**
+     * Tests whether parameter i has a separate value for each
+     * element. If not, its single value is shared by all elements.
+     */
+    bool isVectorParameter(unsigned long i) const;
+    /**
+     * Calculates the log density of each element of the plate. The
+     * log density of the node is the sum of these values. Unlike
+     * logDensity, the values are not cached.
+     *
+     * @param ld Array of length equal to the length of the node, to
+     * which the log densities are written.
+     */
+    void elementLogDensity(double *ld, unsigned int chain, PDFType type)
+	const;
+    void randomSample(RNG *rng, unsigned int chain) override;
+    void score(double *s, Node const *parent, unsigned int chain)
+	const override;
+    void valueScore(double *s, unsigned int chain) const override;
+    bool checkParentValues(unsigned int chain) const override;
+    std::string deparse(std::vector<std::string> const &parameters)
+	const override;
+    double KL(unsigned int ch1, unsigned int ch2, RNG *rng,
+	      unsigned int nrep) const override;
+};
+
+} /* namespace jags */
+
+#endif /* PLATE_STOCHASTIC_NODE_H_ */
@@ -12,7 +12,9 @@ class ScalarDist;
  */
 class ScalarStochasticNode : public StochasticNode {
     ScalarDist const * const _dist;
+    bool const _fixnorm;
     void sp(double *lower, double *upper, unsigned int chain) const override;
+    double calLogDensity(unsigned int chain, PDFType type) const override;
 public:
     /**
      * Constructs a new ScalarStochasticNode 
@@ -20,11 +22,21 @@ public:
     ScalarStochasticNode(ScalarDist const *dist, unsigned int nchain,
 			 std::vector<Node const *> const &parameters,
 			 Node const *lower, Node const *upper);
-    double logDensity(unsigned int chain, PDFType type) const override;
     void randomSample(RNG *rng, unsigned int chain) override;
     void truncatedSample(RNG *rng, unsigned int chain,
 			 double const *lower, double const *upper);
+    void score(double *s, Node const *parent, unsigned int chain)
+	const override;
+    void valueScore(double *s, unsigned int chain) const override;
     bool checkParentValues(unsigned int chain) const override;
+    /**
+     * Indicates whether the normalizing constant of the likelihood
+     * is fixed, in which case it is omitted when the log density is
+     * calculated with type PDF_LIKELIHOOD.
+     *
+     * @see ScalarDist#isNormalizationFixed
+     */
+    bool isNormalizationFixed() const;
     //StochasticNode *clone(std::vector<Node const *> const &parents,
     //Node const *lower, Node const *upper) const;
     double KL(unsigned int ch1, unsigned int ch2, RNG *rng,
@@ -49,7 +49,23 @@ class StochasticNode : public Node {
     std::vector<bool> const * _observed;
     const bool _discrete;
     const std::array<int, 2> _depth;
+    /* 
+       Cached log densities for a single chain. Versions never
+       decrease, so the sum of the versions of the node and its
+       parents changes whenever any one of them changes. A new
+       cache is current for a new node but contains no valid values.
+    */
+    struct DensityCache {
+	unsigned long version = 0;
+	double value[3];
+	bool valid[3] = {false, false, false};
+    };
+    mutable std::vector<DensityCache> _cache;
     virtual void sp(double *lower, double *upper, unsigned int chain) const = 0;
+    /**
+     * Calculates the log density without reference to the cache.
+     */
+    virtual double calLogDensity(unsigned int chain, PDFType type) const = 0;
 protected:
     std::vector<std::vector<double const*> > _parameters;
 public:
@@ -123,6 +139,31 @@ public:
      * has been called.
      */
     bool isFixed() const override;
+    /**
+     * Returns the log density of the node.
+     *
+     * For multivariate nodes, the value is cached separately for
+     * each chain and each PDFType. A cached value is reused as long
+     * as the versions of the node and all of its parents are
+     * unchanged, so repeated evaluation at the same point, for
+     * example by a sampler that evaluates the current value at the
+     * start of each update, does not call the distribution again.
+     * Scalar densities are cheaper to evaluate than to validate, so
+     * they are only cached after a call to cacheLogDensity.
+     *
+     * @see Node#version
+     */
+    double logDensity(unsigned int chain, PDFType type) const override;
+    /**
+     * Turns on caching of the log density for a scalar node. This is
+     * worthwhile when several clients, such as monitors, request
+     * the same log density at each iteration. It has no effect on
+     * multivariate nodes, which are always cached.
+     *
+     * This function must not be called while the model is being
+     * updated.
+     */
+    void cacheLogDensity() const;
     /**
      * Sets the value of the node to be the same in all chains.
      * After setData is called, the stochastic node is considered
@@ -168,6 +209,53 @@ public:
      * @see Distribution#fullRank
      */
     bool fullRank() const;
+    /**
+     * Indicates whether the log density of the node can be
+     * differentiated with respect to the value of the given parent,
+     * i.e. whether the distribution supplies a score function for
+     * every parameter that coincides with the parent.
+     *
+     * Bounded nodes always return false, since the normalizing
+     * constant of a truncated distribution also depends on the
+     * parameters. A parent that is used as a bound also returns
+     * false.
+     *
+     * @see Distribution#hasScore
+     */
+    bool hasScore(Node const *parent) const;
+    /**
+     * Calculates the gradient of the log density of the node with
+     * respect to the value of a parent.  This function should only
+     * be called if hasScore returns true for the same parent.
+     *
+     * @param s Array of length parent->length() to which the
+     * gradient is added.
+     *
+     * @param parent Parent node with respect to which the derivative
+     * is taken.
+     *
+     * @param chain Index number of the chain to evaluate.
+     */
+    virtual void score(double *s, Node const *parent, unsigned int chain)
+	const = 0;
+    /**
+     * Indicates whether the log density of the node can be
+     * differentiated with respect to its own value.
+     *
+     * @see Distribution#hasValueScore
+     */
+    bool hasValueScore() const;
+    /**
+     * Calculates the gradient of the log density of the node with
+     * respect to its own value. This function should only be called
+     * if hasValueScore returns true.
+     *
+     * @param s Array of length length() to which the gradient is
+     * added.
+     *
+     * @param chain Index number of the chain to evaluate.
+     */
+    virtual void valueScore(double *s, unsigned int chain) const = 0;
 };
 
 /**
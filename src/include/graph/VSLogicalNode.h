@@ -36,6 +36,15 @@ public:
     //DeterministicNode *clone(std::vector<Node const *> const &parents) const;
     void gradient(double *grad, Node const *arg, unsigned int chain)
 	const override;
+    /**
+     * The Jacobian is diagonal with respect to a vector argument and
+     * a single column with respect to a scalar argument, so the
+     * product is calculated directly, one element at a time.
+     */
+    void gradientProduct(double *padj, double const *adj,
+			 Node const *parent, unsigned int chain,
+			 double *work) const override;
+    unsigned long gradientWorkLength(Node const *parent) const override;
 };
 
 } /* namespace jags */
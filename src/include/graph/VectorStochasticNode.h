@@ -14,6 +14,7 @@ class VectorStochasticNode : public StochasticNode {
     VectorDist const * const _dist;
     std::vector<unsigned long> _lengths;
     void sp(double *lower, double *upper, unsigned int chain) const override;
+    double calLogDensity(unsigned int chain, PDFType type) const override;
 public:
     /**
      * Constructs a new StochasticNode given a vector distribution and
@@ -22,8 +23,10 @@ public:
      */
     VectorStochasticNode(VectorDist const *dist, unsigned int nchain,
 			 std::vector<Node const *> const &parameters);
-    double logDensity(unsigned int chain, PDFType type) const override;
     void randomSample(RNG *rng, unsigned int chain) override;
+    void score(double *s, Node const *parent, unsigned int chain)
+	const override;
+    void valueScore(double *s, unsigned int chain) const override;
     bool checkParentValues(unsigned int chain) const override;
     //StochasticNode *clone(std::vector<Node const *> const &parents,
     //Node const *lower, Node const *upper) const;
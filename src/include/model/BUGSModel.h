@@ -50,14 +50,22 @@ public:
      * 
      * @param type Name of the monitor type or "*" for all types
      *
+     * @param binary If true, then the monitors are written to a
+     * single binary trace file instead of CODA text files.
+     *
      * @exception logic_error
+     *
+     * @see TraceFile
      */
     void coda(std::vector<std::pair<std::string,Range> > const &nodes, 
-	      std::string const &prefix, std::string &warn, std::string const &type);
+	      std::string const &prefix, std::string &warn, std::string const &type,
+	      bool binary = false);
     /**
-     * Write out all monitors in CODA format
+     * Write out all monitors in CODA format, or in binary format if
+     * the binary argument is true.
      */
-    void coda(std::string const &prefix, std::string &warn, std::string const &type);
+    void coda(std::string const &prefix, std::string &warn, std::string const &type,
+	      bool binary = false);
     /**
      * Sets the state of the RNG, and the values of the unobserved
      * stochastic nodes in the model, for a given chain.
@@ -98,11 +106,14 @@ public:
      * @param msg User-friendly error message that may be given if no
      * monitor can be created.
      *
+     * @param stem Stem of the names of any files written by the
+     * monitor
+     *
      * @return True if the monitor was created.  
      */
     bool setMonitor(std::string const &name, Range const &range,
 		    unsigned int thin, std::string const &type,
-		    std::string &msg);
+		    std::string &msg, std::string const &stem = "CODA");
     /**
      * Deletes a Monitor that has been previously created with a call
      * to setMonitor.
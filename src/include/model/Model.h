@@ -2,6 +2,7 @@
 #define MODEL_H_
 
 #include <model/MonitorControl.h>
+#include <graph/NodeArena.h>
 
 #include <vector>
 #include <list>
@@ -40,10 +41,21 @@ private:
   bool _is_initialized;
   bool _adapt;
   bool _data_gen;
+  unsigned int _nthread;
+  std::vector<std::vector<Sampler*> > _schedule;
+  std::vector<std::vector<RNG*> > _thread_rng;
+  std::vector<std::vector<int> > _thread_rng_state;
+  NodeArena _arena;
   void initializeNodes();
   void chooseRNGs();
   void chooseSamplers();
+  void chooseSchedule();
+  void restoreThreadRNGs(unsigned int chain);
   void setSampledExtra();
+  void updateChain(unsigned int chain);
+  void updateColour(std::vector<Sampler*> const &samplers,
+		    unsigned int chain);
+  bool monitorsDue(unsigned int iteration) const;
 public:
   /**
    * @param nchain Number of parallel chains in the model.
@@ -77,6 +89,11 @@ public:
    * Updates the model by the given number of iterations. A
    * logic_error is thrown if the model is uninitialized.
    *
+   * Each chain runs the whole block of iterations on a single
+   * worker thread. The threads meet at a barrier after each
+   * iteration, so that if one chain fails, all chains stop after
+   * the same iteration.
+   *
    * @param niter Number of iterations to run
    */
   void update(unsigned int niter);
@@ -157,6 +174,26 @@ public:
    * @return success indicator
    */
   bool setRNG(RNG *rng, unsigned int chain);
+  /**
+   * Gets the state of the RNGs of the given chain: the state of the
+   * chain RNG, followed by the states of the RNGs of any additional
+   * sampler threads. If no RNG has been assigned to the chain, the
+   * state is empty.
+   *
+   * @see Model#setSamplerThreads
+   */
+  void getRNGState(std::vector<int> &state, unsigned int chain) const;
+  /**
+   * Sets the state of the RNGs of the given chain from a vector
+   * returned by getRNGState. The states of the thread RNGs are kept
+   * until the threads RNGs are created when the model is
+   * initialized. They are ignored if the number of sampler threads
+   * has changed, in which case the thread RNGs are seeded from the
+   * chain RNG.
+   *
+   * @return success indicator
+   */
+  bool setRNGState(std::vector<int> const &state, unsigned int chain);
   /**
    * Tests whether all samplers in adaptive mode have passed the
    * efficiency test that allows adaptive mode to be switched off
@@ -175,6 +212,42 @@ public:
    * adaptOff function has been called).
    */
   bool isAdapting() const;
+  /**
+   * Sets the number of threads used to update the samplers within
+   * each chain. By default there is one thread per chain and the
+   * samplers are updated sequentially.
+   *
+   * When nthread > 1 the samplers are coloured so that samplers
+   * with the same colour do not modify any node in the Markov
+   * blanket of another sampler with that colour. Samplers of the
+   * same colour are then updated concurrently. Each thread has its
+   * own RNG, seeded from the state of the chain RNG, so that results
+   * are reproducible for a fixed number of threads.
+   *
+   * The threads of a chain form a nested parallel region inside the
+   * region that runs the chains. The model does not change the
+   * OpenMP settings of the process, so with more than one chain the
+   * samplers of a chain are only updated concurrently if nested
+   * parallelism is enabled, e.g. with OMP_MAX_ACTIVE_LEVELS=2.
+   * Otherwise they are updated sequentially with the same RNGs and
+   * give the same results.
+   *
+   * This may be called before or after the model is initialized.
+   */
+  void setSamplerThreads(unsigned int nthread);
+  /**
+   * Returns the number of threads used to update samplers within
+   * each chain.
+   */
+  unsigned int samplerThreads() const;
+  /**
+   * Returns the samplers grouped by colour, in the order in which
+   * the colours are updated. The schedule is empty if samplers are
+   * updated sequentially.
+   *
+   * @see Model#setSamplerThreads
+   */
+  std::vector<std::vector<Sampler*> > const &samplerSchedule() const;
   /**
    * Returns a vector of all stochastic nodes in the model
    */
@@ -183,6 +256,12 @@ public:
    * Returns a vector of all nodes in the model
    */ 
   std::vector<Node*> const &nodes() const;
+  /**
+   * Returns the arena that holds the nodes of the model. The arena
+   * should be made active (see NodeArena::Scope) while the graph is
+   * being built. It is destroyed after all nodes in the model.
+   */
+  NodeArena &arena();
 };
 
 } /* namespace jags */
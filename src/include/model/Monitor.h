@@ -32,8 +32,63 @@ public:
      * Failure to guarantee this may cause long MCMC runs to slow down
      * dramatically.  This is particularly important if the monitor
      * needs to allocate new memory for stored samples.
+     *
+     * The default implementation calls update(chain) for each chain,
+     * and must be overridden by monitors that do not update by chain.
+     */
+    virtual void update();
+    /**
+     * Updates the monitor for a single chain.
+     *
+     * This is called instead of update for monitors that update by
+     * chain. Calls for different chains may run concurrently in
+     * different threads, after all chains have completed the
+     * iteration, so the monitor must only modify the state belonging
+     * to the given chain. It may read the values of other chains,
+     * but it must not calculate their log densities, which are
+     * cached separately for each chain.
+     * Statistics that are pooled over chains should be reduced when
+     * they are requested by the value member function.
+     *
+     * The default implementation throws a logic_error.
+     *
+     * @see updatesByChain
      */
-    virtual void update() = 0;
+    virtual void update(unsigned int chain);
+    /**
+     * Discards the values recorded by the last call to update.  This
+     * is used when the model fails part way through monitoring an
+     * iteration, so that no monitor records it. It is called before
+     * the values of any nodes change, so a monitor may recalculate
+     * the values it recorded in order to remove them.
+     *
+     * The default implementation calls rollback(chain) for each
+     * chain, and must be overridden by monitors that do not update by
+     * chain.
+     */
+    virtual void rollback();
+    /**
+     * Discards the values recorded by the last call to update(chain)
+     * for the given chain. As for update(chain), calls for different
+     * chains may run concurrently.
+     *
+     * The default implementation throws a logic_error.
+     *
+     * @see rollback()
+     */
+    virtual void rollback(unsigned int chain);
+    /**
+     * Indicates whether the monitor can be updated separately for
+     * each chain with update(chain).  The default implementation
+     * returns false.
+     */
+    virtual bool updatesByChain() const;
+    /**
+     * Called when the monitor is placed under the control of a
+     * MonitorControl, with the first iteration to be monitored and
+     * the thinning interval. The default implementation does nothing.
+     */
+    virtual void setIterations(unsigned int start, unsigned int thin);
     /**
      * Returns the vector of nodes from which the monitor's value is
      * derived.
@@ -62,6 +117,23 @@ public:
      * The vector of monitored values for the given chain
      */
     virtual std::vector<double> const &value(unsigned int chain) const = 0;
+    /**
+     * Copies the monitored values of a contiguous block of elements
+     * for the given chain, for all iterations.
+     *
+     * @param chain Index number of the chain
+     * @param begin Index of the first element of the block
+     * @param end One past the index of the last element of the block
+     * @param x Vector that will contain the values on exit. The value
+     * of element v at iteration k is x[k * (end - begin) + v - begin].
+     *
+     * The default implementation copies the values from the vector
+     * returned by the value member function.  Monitors that do not
+     * hold their values in memory should override it so that output
+     * can be written in blocks of bounded size.
+     */
+    virtual void values(unsigned int chain, unsigned long begin,
+			unsigned long end, std::vector<double> &x) const;
      /**
       * Dumps the monitored values to an SArray. 
       *
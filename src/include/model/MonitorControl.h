@@ -28,9 +28,47 @@ public:
      * the thinning interval, then the update function of the Monitor
      * is called function is called.
      *
+     * Monitors that update by chain are not updated here, but the
+     * iteration is still counted. They must be updated for each chain
+     * by calling update(iteration, chain).
+     *
      * @param iteration The current iteration number.
      */
     void update(unsigned int iteration);
+    /**
+     * Updates a single chain of a monitor that updates by chain, if
+     * it is due at the given iteration. This may be called
+     * concurrently for different chains.
+     *
+     * @param iteration The current iteration number.
+     * @param chain Index number of the chain
+     *
+     * @see Monitor#updatesByChain
+     */
+    void update(unsigned int iteration, unsigned int chain);
+    /**
+     * Discards the values recorded by update(iteration), if the
+     * monitor was due at the given iteration, so that the iteration
+     * is no longer counted.
+     *
+     * Monitors that update by chain are not rolled back here. They
+     * must be rolled back for each chain that was updated by calling
+     * rollback(iteration, chain).
+     *
+     * @see Monitor#rollback
+     */
+    void rollback(unsigned int iteration);
+    /**
+     * Discards the values recorded by update(iteration, chain) for a
+     * single chain of a monitor that updates by chain.
+     */
+    void rollback(unsigned int iteration, unsigned int chain);
+    /**
+     * Indicates whether the monitor is due to be updated at the
+     * given iteration, taking account of the start and thinning
+     * interval.
+     */
+    bool isDue(unsigned int iteration) const;
     /**
      * Reserves enough memory for a further niter iterations, taking
      * account of the thinning interval of the monitor.
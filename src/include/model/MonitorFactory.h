@@ -46,6 +46,19 @@ public:
     virtual Monitor *getMonitor(std::string const &name, Range const &range,
 				BUGSModel *model, std::string const &type,
 				std::string &msg) = 0;
+    /**
+     * Creates a monitor that may write its values to files while the
+     * model is updated.
+     *
+     * @param stem Stem of the names of any files written by the
+     * monitor, as in the CODA command.
+     *
+     * The other arguments are the same as above. The default
+     * implementation ignores the stem.
+     */
+    virtual Monitor *getMonitor(std::string const &name, Range const &range,
+				BUGSModel *model, std::string const &type,
+				std::string const &stem, std::string &msg);
 };
 
 } /* namespace jags */
@@ -109,6 +109,14 @@ public:
    * If the node name is not found, an empty string is returned
    */
   std::string getName(Node const *node) const;
+  /**
+   * Gets the BUGS language names of the elements of a node that
+   * belongs to one of the NodeArrays in the symbol table. For
+   * example, the elements of a node "y[1:3]" are "y[1]", "y[2]" and
+   * "y[3]". If the node does not belong to a NodeArray, a vector
+   * containing the name returned by getName is returned.
+   */
+  std::vector<std::string> getElementNames(Node const *node) const;
   /**
    * Locks all the NodeArrays contained in the SymTab
    */
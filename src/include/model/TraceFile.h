@@ -0,0 +1,163 @@
+#ifndef TRACE_FILE_H_
+#define TRACE_FILE_H_
+
+#include <util/binaryio.h>
+
+#include <string>
+#include <vector>
+
+namespace jags {
+
+/**
+ * @short Reader for binary trace files
+ *
+ * A binary trace file contains the values of a set of monitors,
+ * written by the CODA command with the binary format option. Unlike
+ * CODA output, values are stored with full precision, missing values
+ * are retained, and no parsing is required to read them.
+ *
+ * The file starts with a header, in which all integers are unsigned
+ * 64-bit values and each string is stored as its length followed by
+ * its characters (without a terminating null):
+ * <ul>
+ * <li>The 8 characters "JAGSBIN" followed by a null</li>
+ * <li>The value 0x0102030405060708, which identifies the byte order</li>
+ * <li>The file format version</li>
+ * <li>The number of monitors</li>
+ * </ul>
+ * This is followed by a record for each monitor containing its name,
+ * type, number of dimensions, dimensions, number of chains, number of
+ * iterations, first iteration, thinning interval, a flags field (bit
+ * 0 is set if the monitor pools over chains and bit 1 if it pools
+ * over iterations), the byte offset of its data from the start of the
+ * file, and the names of its elements.
+ *
+ * The values of a monitor may be divided between consecutive records
+ * with the same name, each holding a block of iterations, as in the
+ * files written by stream monitors. Bit 2 of the flags field is set
+ * in every record after the first, and these records do not store
+ * the element names, which are those of the first record.
+ *
+ * The data for each monitor are 64-bit floating point values stored
+ * in columns. There is one column for each element and chain, in
+ * that order, and each column contains the values of all iterations.
+ * Data offsets are multiples of 8 so that the columns are aligned
+ * when the file is mapped into memory.
+ *
+ * On systems that support it, the file is mapped into memory and
+ * columns are returned as pointers into the mapping, so that only
+ * the parts of the file that are accessed are read from disk.
+ */
+class TraceFile {
+public:
+    /**
+     * Header record for a monitor
+     */
+    struct Record {
+	std::string name;
+	std::string type;
+	std::vector<unsigned long> dim;
+	unsigned long nchain;
+	unsigned long niter;
+	unsigned long start;
+	unsigned long thin;
+	unsigned long flags;
+	unsigned long offset;
+	std::vector<std::string> elt_names;
+    };
+    /**
+     * Flag for a record that continues the previous record with the
+     * same name. The element names are not written to the file.
+     */
+    static const unsigned long CONTINUED = 4;
+private:
+    MappedFile _file;
+    std::vector<Record> _records;
+    Record const &record(unsigned int i) const;
+public:
+    /**
+     * Opens a binary trace file and reads the header.
+     *
+     * @exception runtime_error if the file cannot be opened or is not
+     * a valid binary trace file written on a platform with the same
+     * byte order.
+     */
+    TraceFile(std::string const &file);
+    TraceFile(TraceFile const &) = delete;
+    TraceFile &operator=(TraceFile const &) = delete;
+    /**
+     * Returns the number of monitors in the file
+     */
+    unsigned int size() const;
+    /**
+     * Returns the index of the first monitor with the given name, or
+     * the number of monitors if there is no such monitor.
+     */
+    unsigned int find(std::string const &name) const;
+    /**
+     * Returns the name of monitor i
+     */
+    std::string const &name(unsigned int i) const;
+    /**
+     * Returns the type of monitor i
+     */
+    std::string const &type(unsigned int i) const;
+    /**
+     * Returns the dimension of a single value of monitor i
+     */
+    std::vector<unsigned long> const &dim(unsigned int i) const;
+    /**
+     * Returns the names of the elements of monitor i
+     */
+    std::vector<std::string> const &elementNames(unsigned int i) const;
+    /**
+     * Returns the number of chains for monitor i. This is 1 if the
+     * monitor pools over chains.
+     */
+    unsigned int nchain(unsigned int i) const;
+    /**
+     * Returns the number of iterations for monitor i. This is 1 if
+     * the monitor pools over iterations.
+     */
+    unsigned long niter(unsigned int i) const;
+    /**
+     * Returns the first iteration monitored by monitor i
+     */
+    unsigned long start(unsigned int i) const;
+    /**
+     * Returns the thinning interval of monitor i
+     */
+    unsigned long thin(unsigned int i) const;
+    /**
+     * Returns true if monitor i pools over chains
+     */
+    bool poolChains(unsigned int i) const;
+    /**
+     * Returns true if monitor i pools over iterations
+     */
+    bool poolIterations(unsigned int i) const;
+    /**
+     * Returns a pointer to the values of element v of monitor i for
+     * the given chain. The values of all niter(i) iterations are
+     * contiguous, so a slice of iterations can be read without
+     * copying. The pointer is valid for the lifetime of the TraceFile.
+     */
+    double const *column(unsigned int i, unsigned long v,
+			 unsigned int chain) const;
+    /**
+     * Returns the start of the header of a file containing n
+     * monitors. The records for the monitors follow it.
+     */
+    static std::string fileHeader(unsigned long n);
+    /**
+     * Returns the header record for a monitor. The size of the record
+     * does not depend on the number of iterations, first iteration,
+     * thinning interval or offset. It depends on the flags only
+     * through the CONTINUED flag.
+     */
+    static std::string recordHeader(Record const &r);
+};
+
+} /* namespace jags */
+
+#endif /* TRACE_FILE_H_ */
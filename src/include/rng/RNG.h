@@ -54,6 +54,25 @@ struct RNG
      * Generates are andom value with an exponential distribution
      */
     virtual double exponential() = 0;
+    /**
+     * Fills an array with uniform random values on (0,1). The
+     * default implementation calls uniform() n times. An RNG that
+     * can generate values in bulk more cheaply should override it.
+     *
+     * @param x Pointer to the start of an array of length n
+     * @param n Number of values to generate
+     */
+    virtual void uniform(double *x, unsigned long n);
+    /**
+     * Fills an array with standard normal random values. The default
+     * implementation calls normal() n times.
+     */
+    virtual void normal(double *x, unsigned long n);
+    /**
+     * Fills an array with exponential random values. The default
+     * implementation calls exponential() n times.
+     */
+    virtual void exponential(double *x, unsigned long n);
     /**
      * This static utility function may be used by an RNG object to coerce
      * values in the range [0,1] to the open range (0,1)
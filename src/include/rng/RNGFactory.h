@@ -39,8 +39,22 @@ class RNGFactory : public Factory
      * This function can be repeatedly called with the same name
      * argument. There is no guarantee that RNG objects created in this
      * way will generate independent streams.
+     *
+     * @param name Name of the RNG
      */
     virtual RNG * makeRNG(std::string const &name) = 0;
+    /**
+     * Returns a newly allocated RNG object for the given chain.
+     *
+     * @param chain Index of the chain (starting from zero) that will
+     * use the RNG. A factory for an RNG with several streams may use
+     * it to choose the stream, so that the RNG does not depend on
+     * how many RNGs the factory has made before.
+     *
+     * The default implementation ignores the chain and calls
+     * makeRNG(name).
+     */
+    virtual RNG * makeRNG(std::string const &name, unsigned int chain);
 };
 
 } /* namespace jags */
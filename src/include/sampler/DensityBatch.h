@@ -0,0 +1,77 @@
+#ifndef DENSITY_BATCH_H_
+#define DENSITY_BATCH_H_
+
+#include <distribution/Distribution.h>
+
+#include <vector>
+
+namespace jags {
+
+class StochasticNode;
+class ScalarDist;
+
+/**
+ * @short Batch of scalar stochastic nodes with a common distribution
+ *
+ * A DensityBatch calculates the sum of the log densities of a group
+ * of unbounded scalar stochastic nodes that share the same
+ * distribution with a single call to ScalarDist#batchLogDensity,
+ * instead of one virtual call per node.
+ *
+ * The values of the nodes and their parameters are gathered into
+ * contiguous arrays before each evaluation. The addresses from which
+ * they are gathered are calculated once, when the batch is
+ * constructed, since the values of a node are stored at a fixed
+ * address for its lifetime.
+ *
+ * If the normalizing constants of all the nodes in the batch are
+ * fixed, the likelihood is calculated with ScalarDist#batchLogKernel.
+ */
+class DensityBatch {
+    ScalarDist const *_dist;
+    std::vector<StochasticNode const *> _nodes;
+    bool _fixnorm;
+    std::vector<std::vector<double const *> > _address;
+    mutable std::vector<std::vector<double> > _work;
+    mutable std::vector<std::vector<double const *> > _par;
+public:
+    /**
+     * Constructor.
+     *
+     * @param dist Distribution shared by all nodes
+     * @param nodes Vector of nodes for which canBatch returns true
+     */
+    DensityBatch(ScalarDist const *dist,
+		 std::vector<StochasticNode const *> const &nodes);
+    /**
+     * Returns the nodes in the batch
+     */
+    std::vector<StochasticNode const *> const &nodes() const;
+    /**
+     * Returns the sum of the log densities of the nodes in the batch.
+     * The result is the same, up to rounding error, as the sum of
+     * the values returned by StochasticNode#logDensity.
+     */
+    double logDensity(unsigned int chain, PDFType type) const;
+    /**
+     * Tests whether a node can be evaluated in a DensityBatch. The
+     * node must be scalar, without bounds, and have a distribution
+     * with its own implementation of ScalarDist#batchLogDensity.
+     */
+    static bool canBatch(StochasticNode const *node);
+    /**
+     * Divides a vector of stochastic nodes into batches.
+     *
+     * Nodes that can be batched are grouped by distribution, in
+     * order of first appearance. Remaining nodes, including those
+     * in groups too small to be worth batching, are written to other
+     * in their original order.
+     */
+    static void makeBatches(std::vector<StochasticNode *> const &nodes,
+			    std::vector<DensityBatch> &batches,
+			    std::vector<StochasticNode *> &other);
+};
+
+} /* namespace jags */
+
+#endif /* DENSITY_BATCH_H_ */
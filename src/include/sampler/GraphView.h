@@ -1,9 +1,12 @@
 #ifndef GRAPH_VIEW_H_ 
 #define GRAPH_VIEW_H_
 
+#include <sampler/DensityBatch.h>
+
 #include <vector>
 #include <string>
 #include <set>
+#include <utility>
 
 namespace jags {
 
@@ -44,6 +47,19 @@ class GraphView {
   std::vector<StochasticNode *> _stoch_children;
   std::vector<DeterministicNode*> _determ_children;
   bool _multilevel;
+  std::vector<DensityBatch> _batches;
+  std::vector<StochasticNode *> _unbatched;
+  std::vector<unsigned long> _determ_offset;
+  std::vector<std::vector<std::pair<unsigned int, unsigned long> > >
+      _score_links;
+  std::vector<std::vector<std::pair<unsigned int, unsigned long> > >
+      _gradient_links;
+  unsigned long _adjoint_length;
+  unsigned long _jacobian_length;
+  mutable std::vector<std::vector<double> > _adjoint;
+  mutable std::vector<std::vector<double> > _jacobian;
+  void setAdjointLinks();
+  double logChildDensity(unsigned int chain) const;
   void classifyChildren(std::vector<StochasticNode *> const &nodes,
 			Graph const &graph,
 			std::vector<StochasticNode *> &stoch_nodes,
@@ -134,6 +150,45 @@ public:
    * to give the log full conditional density
    */
   double logLikelihood(unsigned int chain) const;
+  /**
+   * Indicates whether the log full conditional density can be
+   * differentiated with respect to the values of the sampled nodes.
+   * This requires that every deterministic child has a gradient, and
+   * every stochastic child has a score function, with respect to each
+   * of its parents that depends on the sampled nodes. The density of
+   * each sampled node must also be differentiable with respect to its
+   * own value.
+   *
+   * @see DeterministicNode#hasGradient, StochasticNode#hasScore,
+   * StochasticNode#hasValueScore
+   */
+  bool hasGradient() const;
+  /**
+   * Calculates the gradient of the log full conditional density with
+   * respect to the values of the sampled nodes.
+   *
+   * The calculation uses reverse-mode accumulation: the score
+   * functions of the stochastic children give the derivatives with
+   * respect to their parents, and these are propagated back to the
+   * sampled nodes through the deterministic children in reverse
+   * topological order, using DeterministicNode#gradientProduct.
+   * Aggregate nodes, mixture nodes and vectorized scalar functions
+   * have sparse Jacobians and never form them as dense matrices.
+   * The cost is proportional to the size of the Markov blanket,
+   * not to the number of sampled values. The
+   * layout of the adjoints is calculated once, when the GraphView is
+   * constructed, and the work space is allocated per chain, so that
+   * different chains may be evaluated in parallel.
+   *
+   * This function should only be called if hasGradient returns true.
+   *
+   * @param chain Number of the chain (starting from zero) to query.
+   *
+   * @param grad Array of length length() to which the gradient is
+   * written, in the same order as the values used by getValue and
+   * setValue.
+   */
+  void logFullConditionalGradient(unsigned int chain, double *grad) const;
   /**
    * Checks that the log density is finite for all sampled nodes and
    * all stochastic children. If any log density value is negative
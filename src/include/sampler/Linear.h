@@ -9,6 +9,7 @@ class GraphView;
 class SingletonGraphView;
 class Graph;
 class StochasticNode;
+class Node;
 
 /**
  * Helper function to check additivity. The function returns true if
@@ -60,6 +61,49 @@ bool checkAdditive(std::vector<StochasticNode*> const &snodes,
  */
 bool checkLinear(GraphView const *gv, bool fixed, bool link=false);
 
+/**
+ * Helper function to check whether the coefficients of the linear
+ * deterministic descendants within the given GraphView can be
+ * calculated analytically by linearCoef. This requires checkLinear
+ * to return true, and every deterministic child (other than a link
+ * function, if link is true) to have a gradient with respect to each
+ * of its parents that depends on the sampled nodes.
+ *
+ * @param gv GraphView to be tested.
+ *
+ * @param link Boolean flag with the same meaning as for checkLinear.
+ *
+ * @see DeterministicNode#hasGradient
+ */
+bool checkLinearCoef(GraphView const *gv, bool link=false);
+
+/**
+ * Calculates the coefficients of linear functions of the sampled
+ * nodes in a GraphView, i.e. the Jacobian of their values with
+ * respect to the values of the sampled nodes. The Jacobian is
+ * accumulated in a single forward pass over the deterministic
+ * children using their local gradients, so the values of the graph
+ * are not modified.
+ *
+ * This function should only be called if checkLinearCoef returns
+ * true. Link functions in the GraphView are ignored.
+ *
+ * @param gv GraphView containing the sampled nodes.
+ *
+ * @param nodes Vector of nodes for which the coefficients are
+ * required. Each node must be a sampled node or a deterministic
+ * child of gv that is not a link function. Nodes that do not
+ * depend on the sampled nodes have zero coefficients.
+ *
+ * @param chain Number of the chain (starting from zero) to evaluate.
+ *
+ * @param coef Vector to hold the result. On exit, it holds a matrix
+ * in column-major order with one row for each element of the
+ * concatenated values of nodes, and gv->length() columns.
+ */
+void linearCoef(GraphView const *gv, std::vector<Node const *> const &nodes,
+		unsigned int chain, std::vector<double> &coef);
+
 /**
  * Helper function to check for scale transformations. The function
  * returns true if all deterministic children within the given
@@ -42,6 +42,12 @@ public:
      * Returns the vector of stochastic nodes sampled by the Sampler
      */
     std::vector<StochasticNode*> const &nodes() const;
+    /**
+     * Returns the GraphView of the Sampler, which describes the
+     * sampled nodes together with their stochastic and deterministic
+     * children.
+     */
+    GraphView const *graphView() const;
     /**
      * Updates the sampled nodes and their immediate deterministic
      * descendants for the given chain.
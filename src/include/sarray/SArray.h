@@ -40,6 +40,12 @@ public:
      * an SArray cannot change its length or dimension.
      */
     SArray(SArray const &orig);
+    /**
+     * Move constructor, which takes the storage of the values of the
+     * original SArray instead of copying it. The original SArray
+     * has no values afterwards, and may only be destroyed.
+     */
+    SArray(SArray &&orig);
     /**
      * Sets the value of an SArray.
      *
@@ -50,6 +56,18 @@ public:
      * @exception length_error
      */
     void setValue(std::vector<double> const &value);
+    /**
+     * Sets the value of an SArray, taking ownership of the storage
+     * of the given vector instead of copying it. This avoids a copy
+     * when reading large data sets.
+     *
+     * @param value vector of values to be assigned. The size of this
+     * vector must match the length of the SArray or a length_error
+     * exception will be thrown.
+     *
+     * @exception length_error
+     */
+    void setValue(std::vector<double> &&value);
     /**
      * Sets the value of a single element of SArray
      *
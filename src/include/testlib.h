@@ -3,6 +3,10 @@
 
 #include <vector>
 
+namespace jags {
+    class GraphView;
+}
+
 //A mix-in class for test fixtures that provides some useful constants
 class JAGSFixture
 {
@@ -34,4 +38,16 @@ class JAGSFixture
     std::vector<bool> TTT; 
 };
 
+/*
+  Numerical gradient of the log full conditional density of a
+  GraphView with respect to the values of the sampled nodes,
+  calculated by central differences with step size delta. This
+  requires one pair of evaluations of the log full conditional per
+  sampled value and is used as a reference when testing
+  GraphView::logFullConditionalGradient.
+*/
+std::vector<double> 
+numLogFullConditionalGradient(jags::GraphView const *gv, unsigned int chain,
+			      double delta);
+
 #endif /* TEST_LIB_H */
@@ -28,6 +28,19 @@ namespace jags {
 	 * Indicates whether the factory is in an active state.
 	 */
 	bool isActive() const;
+	/**
+	 * Sets a named option of the factory. Options are read when
+	 * the factory creates new objects, so they do not affect
+	 * objects that already exist. The default implementation
+	 * has no options and returns false.
+	 *
+	 * @param name Name of the option
+	 * @param value New value of the option
+	 *
+	 * @return true if the option was set, false if the factory
+	 * has no option with the given name or the value is invalid.
+	 */
+	virtual bool setOption(std::string const &name, double value);
 	/**
 	 * Returns the name of the factory.
 	 */
@@ -0,0 +1,79 @@
+#ifndef UTIL_BINARYIO_H_
+#define UTIL_BINARYIO_H_
+
+#include <string>
+#include <cstdint>
+
+namespace jags {
+
+    /*
+     * Headers of binary files, such as binary trace files and binary
+     * data files, store integers as unsigned 64-bit values and
+     * strings as their length followed by their characters, without
+     * a terminating null.
+     */
+
+    /**
+     * Appends an integer to a header
+     */
+    void putInt(std::uint64_t x, std::string &out);
+    /**
+     * Appends a string to a header
+     */
+    void putString(std::string const &s, std::string &out);
+    /**
+     * Reads an integer from a header of the given size, starting at
+     * position pos, which is advanced past the integer.
+     *
+     * @exception runtime_error if the header is truncated
+     */
+    std::uint64_t getInt(char const *data, unsigned long size,
+			 unsigned long &pos);
+    /**
+     * Reads a string from a header of the given size, starting at
+     * position pos, which is advanced past the string.
+     *
+     * @exception runtime_error if the header is truncated
+     */
+    std::string getString(char const *data, unsigned long size,
+			  unsigned long &pos);
+    /**
+     * Rounds a byte offset up to a multiple of the size of a double,
+     * so that values stored at the offset are aligned.
+     */
+    unsigned long alignOffset(unsigned long offset);
+
+    /**
+     * @short Read-only contents of a binary file
+     *
+     * On systems that support it, the file is mapped into memory, so
+     * that only the parts of the file that are accessed are read
+     * from disk. Otherwise the whole file is read into a buffer. In
+     * both cases the data are aligned so that doubles stored at
+     * aligned offsets can be accessed directly.
+     */
+    class MappedFile {
+	char const *_data;
+	unsigned long _size;
+	bool _mapped;
+      public:
+	/**
+	 * @exception runtime_error if the file cannot be read
+	 */
+	MappedFile(std::string const &file);
+	~MappedFile();
+	MappedFile(MappedFile const &) = delete;
+	MappedFile &operator=(MappedFile const &) = delete;
+	/**
+	 * Returns a pointer to the contents of the file
+	 */
+	char const *data() const;
+	/**
+	 * Returns the size of the file in bytes
+	 */
+	unsigned long size() const;
+    };
+
+} /* namespace jags */
+
+#endif /* UTIL_BINARYIO_H_ */
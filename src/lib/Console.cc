@@ -42,7 +42,8 @@ namespace jags {
 
 Console::Console(ostream &out, ostream &err)
   : _out(out), _err(err), _model(nullptr),
-    _pdata(nullptr), _prelations(nullptr),  _pvariables(nullptr)
+    _pdata(nullptr), _prelations(nullptr),  _pvariables(nullptr),
+    _nthread(1), _plates(false)
 {
 }
 
@@ -191,111 +192,134 @@ bool Console::compile(map<string, SArray> &data_table, unsigned int nchain,
     if (_pdata && gendata) {
 	_model = new BUGSModel(1);
 
-	Compiler compiler(*_model, data_table);
-	_out << "Compiling data graph" << endl;
-	try {
-	    if (_pvariables) {
-		_out << "   Declaring variables" << endl;
-		compiler.declareVariables(*_pvariables);
-	    }
-	    _out << "   Resolving undeclared variables" << endl;
-	    compiler.undeclaredVariables(_pdata);
-	    _out << "   Allocating nodes" << endl;
-	    compiler.writeRelations(_pdata);
+	/*
+	   The arena of the data model must not be active when the
+	   model is deleted, so the scope is closed first.
+	*/
+	bool ok = true;
+	{
+	    NodeArena::Scope scope(&_model->arena());
+	    Compiler compiler(*_model, data_table);
+	    _out << "Compiling data graph" << endl;
+	    try {
+		if (_pvariables) {
+		    _out << "   Declaring variables" << endl;
+		    compiler.declareVariables(*_pvariables);
+		}
+		_out << "   Resolving undeclared variables" << endl;
+		compiler.undeclaredVariables(_pdata);
+		_out << "   Allocating nodes" << endl;
+		compiler.writeRelations(_pdata);
       
-	    /* Check validity of data generating model */
-	    for (vector<StochasticNode*>::const_iterator r = _model->stochasticNodes().begin();
-		 r != _model->stochasticNodes().end(); ++r)
-	    {
-		if (isObserved(*r)) {
-		    vector<Node const*> const &parents = (*r)->parents();
-		    for (vector<Node const*>::const_iterator p = parents.begin();
-			 p != parents.end(); ++p)
-		    {
-			if (!((*p)->isFixed())) {
-			    _err << "Invalid data graph: observed stochastic node " 
-				 << _model->symtab().getName(*r) 
-				 << " has non-fixed parent " 
-				 << _model->symtab().getName(*p)
-				 << "\n";
-			    clearModel();
-			    return false;
+		/* Check validity of data generating model */
+		for (vector<StochasticNode*>::const_iterator r = _model->stochasticNodes().begin();
+		     ok && r != _model->stochasticNodes().end(); ++r)
+		{
+		    if (isObserved(*r)) {
+			vector<Node const*> const &parents = (*r)->parents();
+			for (vector<Node const*>::const_iterator p = parents.begin();
+			     ok && p != parents.end(); ++p)
+			{
+			    if (!((*p)->isFixed())) {
+				_err << "Invalid data graph: observed stochastic node " 
+				     << _model->symtab().getName(*r) 
+				     << " has non-fixed parent " 
+				     << _model->symtab().getName(*p)
+				     << "\n";
+				ok = false;
+			    }
 			}
 		    }
 		}
+		if (ok) {
+		    _out << "   Initializing" << endl;
+		    _model->initialize(true);
+		    // Do a single update (by forward sampling)
+		    _model->update(1);
+		    //Save data generating RNG for later use. It is owned by the
+		    //RNGFactory, not the model.
+		    datagen_rng = _model->rng(0);
+		    _out << "   Reading data back into data table" << endl;
+		    _model->symtab().readValues(data_table, 0, ALL_VALUES);
+		}
+	    }
+	    catch(...) {
+		handle(false);
+		ok = false;
 	    }
-	    _out << "   Initializing" << endl;
-	    _model->initialize(true);
-	    // Do a single update (by forward sampling)
-	    _model->update(1);
-	    //Save data generating RNG for later use. It is owned by the
-	    //RNGFactory, not the model.
-	    datagen_rng = _model->rng(0);
-	    _out << "   Reading data back into data table" << endl;
-	    _model->symtab().readValues(data_table, 0, ALL_VALUES);
-	    delete _model;
-	    _model = nullptr;
 	}
-	catch(...) {
-	    handle();
+	if (!ok) {
+	    clearModel();
 	    return false;
 	}
+	delete _model;
+	_model = nullptr;
     }
 
     _model = new BUGSModel(nchain);
-    Compiler compiler(*_model, data_table);
 
-    _out << "Compiling model graph" << endl;
-    try {
-	if (_pvariables) {
-	    _out << "   Declaring variables" << endl;
-	    compiler.declareVariables(*_pvariables);
-	}
-	if (_prelations) {
-	    _out << "   Resolving undeclared variables" << endl;
-	    compiler.undeclaredVariables(_prelations);
-	    _out << "   Allocating nodes" << endl;
-	    compiler.writeRelations(_prelations);
-	}
-	else {
-	    _err << "Nothing to compile" << endl;
-	    return false;
-	}
-	if (_model) {
-	    unsigned int nobs = 0, npart = 0, nparam = 0;
-	    vector<StochasticNode*> const &snodes =  _model->stochasticNodes();
-	    for (unsigned int i = 0; i < snodes.size(); ++i) {
-		if (isObserved(snodes[i])) {
-		    if (isParameter(snodes[i])) {
-			++npart;
+    /*
+       As for the data model, the scope of the arena is closed before
+       the model is cleared after an error.
+    */
+    bool ok = true;
+    {
+	NodeArena::Scope scope(&_model->arena());
+	Compiler compiler(*_model, data_table);
+	compiler.setPlates(_plates);
+
+	_out << "Compiling model graph" << endl;
+	try {
+	    if (_pvariables) {
+		_out << "   Declaring variables" << endl;
+		compiler.declareVariables(*_pvariables);
+	    }
+	    if (_prelations) {
+		_out << "   Resolving undeclared variables" << endl;
+		compiler.undeclaredVariables(_prelations);
+		_out << "   Allocating nodes" << endl;
+		compiler.writeRelations(_prelations);
+	    }
+	    else {
+		_err << "Nothing to compile" << endl;
+		ok = false;
+	    }
+	    if (ok) {
+		unsigned int nobs = 0, npart = 0, nparam = 0;
+		vector<StochasticNode*> const &snodes =  _model->stochasticNodes();
+		for (unsigned int i = 0; i < snodes.size(); ++i) {
+		    if (isObserved(snodes[i])) {
+			if (isParameter(snodes[i])) {
+			    ++npart;
+			}
+			else {
+			    ++nobs;
+			}
 		    }
 		    else {
-			++nobs;
+			++nparam;
 		    }
 		}
-		else {
-		    ++nparam;
+		_out << "Graph information:\n";
+		_out << "   Fully observed stochastic nodes: " << nobs << "\n";
+		if (npart > 0) {
+		    _out << "   Partly observed stochastic nodes: " << npart << "\n";
+		}
+		_out << "   Unobserved stochastic nodes: " << nparam << "\n";
+		_out << "   Total graph size: " << _model->nodes().size() << endl;
+		if (datagen_rng) {
+		    // Reuse the data-generation RNG, if there is one, for chain 0 
+		    _model->setRNG(datagen_rng, 0);
 		}
-	    }
-            _out << "Graph information:\n";
-	    _out << "   Fully observed stochastic nodes: " << nobs << "\n";
-	    if (npart > 0) {
-		_out << "   Partly observed stochastic nodes: " << npart << "\n";
-	    }
-	    _out << "   Unobserved stochastic nodes: " << nparam << "\n";
-	    _out << "   Total graph size: " << _model->nodes().size() << endl;
-	    if (datagen_rng) {
-		// Reuse the data-generation RNG, if there is one, for chain 0 
-		_model->setRNG(datagen_rng, 0);
 	    }
 	}
-	else {
-	    _err << "No model" << endl;
-	    return false;
+	catch(...) {
+	    handle(false);
+	    ok = false;
 	}
     }
-    catch(...) {
-	handle();
+    if (!ok) {
+	clearModel();
 	return false;
     }
     
@@ -320,7 +344,9 @@ bool Console::initialize()
     
     try {
 	_out << "Initializing model" << endl;
+	_model->setSamplerThreads(_nthread);
 	_model->initialize(false);
+	printSchedule();
     }
     catch(...) {
 	handle();
@@ -330,6 +356,52 @@ bool Console::initialize()
     return true;
 }
 
+void Console::printSchedule()
+{
+    vector<vector<Sampler*> > const &schedule = _model->samplerSchedule();
+    if (schedule.empty()) return;
+
+    unsigned long nsampler = 0;
+    for (unsigned int i = 0; i < schedule.size(); ++i) {
+	nsampler += schedule[i].size();
+    }
+    _out << "   Sampler schedule: " << nsampler << " samplers in "
+	 << schedule.size() << " colours using "
+	 << _model->samplerThreads() << " threads per chain\n"
+	 << "   Colour sizes:";
+    for (unsigned int i = 0; i < schedule.size(); ++i) {
+	_out << " " << schedule[i].size();
+    }
+    _out << endl;
+}
+
+void Console::setPlates(bool plates)
+{
+    _plates = plates;
+}
+
+bool Console::setSamplerThreads(unsigned int nthread)
+{
+    if (nthread == 0) {
+	_err << "Number of threads must be > 0" << endl;
+	return false;
+    }
+    _nthread = nthread;
+
+    if (_model && _model->isInitialized()) {
+	try {
+	    _model->setSamplerThreads(_nthread);
+	    printSchedule();
+	}
+	catch(...) {
+	    handle();
+	    return false;
+	}
+    }
+
+    return true;
+}
+
 bool Console::setParameters(map<string, SArray> const &init_table,
 			    unsigned int chain)
 {
@@ -406,7 +478,8 @@ unsigned int Console::iter() const
 }
 
 bool Console::setMonitor(string const &name, Range const &range,
-			 unsigned int thin, string const &type)
+			 unsigned int thin, string const &type,
+			 string const &stem)
 {
     if (!_model) {
 	_err << "Can't set monitor. No model!" << endl;    
@@ -426,7 +499,7 @@ bool Console::setMonitor(string const &name, Range const &range,
 	    _model->adaptOff();
 	}
 	string msg;
-	bool ok = _model->setMonitor(name, range, thin, type, msg);
+	bool ok = _model->setMonitor(name, range, thin, type, msg, stem);
 	if (!ok) {
 	    _err << "Failed to set " << type << " monitor for " << 
 		name << printRange(range) << endl;
@@ -498,7 +571,7 @@ bool Console::dumpState(map<string,SArray> &data_table,
       
       vector<int> rngstate;
       if (_model->rng(chain - 1)) {
-	_model->rng(chain - 1)->getState(rngstate);
+	_model->getRNGState(rngstate, chain - 1);
 	
 	vector<unsigned long> dimrng(1,rngstate.size());
 	SArray rngsarray(dimrng);
@@ -564,7 +637,7 @@ void Console::dumpNodeNames(vector<string> &node_names,
 	
 }
 		 
-bool Console::coda(string const &prefix, string const &type)
+bool Console::coda(string const &prefix, string const &type, bool binary)
 {
     if (!_model) {
 	_err << "Can't dump CODA output. No model!" << endl;
@@ -573,7 +646,7 @@ bool Console::coda(string const &prefix, string const &type)
 
     try {
         string warn;
-	_model->coda(prefix, warn, type);
+	_model->coda(prefix, warn, type, binary);
         if (!warn.empty()) {
             _err << "WARNING:\n" << warn;
         }
@@ -587,7 +660,7 @@ bool Console::coda(string const &prefix, string const &type)
 }
 
 bool Console::coda(vector<pair<string, Range> > const &nodes,
-		   string const &prefix, string const &type)
+		   string const &prefix, string const &type, bool binary)
 {
     if (!_model) {
 	_err << "Can't dump CODA output. No model!" << endl;
@@ -596,7 +669,7 @@ bool Console::coda(vector<pair<string, Range> > const &nodes,
 
     try {
         string warn;
-	_model->coda(nodes, prefix, warn, type);
+	_model->coda(nodes, prefix, warn, type, binary);
         if (!warn.empty()) {
             _err << "WARNINGS:\n" << warn;
         }
@@ -774,6 +847,40 @@ bool Console::setFactoryActive(string const &name, FactoryType type, bool flag)
     return ok;
 }
 
+template<typename T>
+bool setoption(string const &name, string const &option, double value,
+	       list<T*> const &faclist)
+{
+    bool ans = false;
+    for (auto p = faclist.begin(); p != faclist.end(); ++p) {
+	if ((*p)->name() == name && (*p)->setOption(option, value)) {
+	    ans = true;
+	}
+    }
+    return ans;
+}
+
+bool Console::setFactoryOption(string const &name, FactoryType type,
+			       string const &option, double value)
+{
+    bool ok = false;
+    switch(type) {
+    case SAMPLER_FACTORY:
+	ok = setoption<SamplerFactory>(name, option, value,
+				       Model::samplerFactories());
+	break;
+    case MONITOR_FACTORY:
+	ok = setoption<MonitorFactory>(name, option, value,
+				       Model::monitorFactories());
+	break;
+    case RNG_FACTORY:
+	ok = setoption<RNGFactory>(name, option, value,
+				   Model::rngFactories());
+	break;
+    }
+    return ok;
+}
+
 template<class T>
 vector<pair<string, bool>> listfac(list<T*> const &flist)
 {
@@ -10,6 +10,7 @@
 #include <graph/ScalarStochasticNode.h>
 #include <graph/VectorStochasticNode.h>
 #include <graph/ArrayStochasticNode.h>
+#include <graph/PlateStochasticNode.h>
 #include <graph/AggNode.h>
 #include <graph/NodeError.h>
 #include <sarray/SimpleRange.h>
@@ -74,6 +75,103 @@ namespace jags {
 	return range_list.empty();
     }
     
+    static bool dependsOn(ParseTree const *t, string const &counter)
+    {
+	/* Tests whether expression t uses the given counter */
+	if (t == nullptr) {
+	    return false;
+	}
+	if (t->treeClass() == P_VAR && t->name() == counter) {
+	    return true;
+	}
+	vector<ParseTree*> const &par = t->parameters();
+	for (unsigned long i = 0; i < par.size(); ++i) {
+	    if (dependsOn(par[i], counter)) return true;
+	}
+	return false;
+    }
+
+    static bool isCounter(ParseTree const *t, string const &counter)
+    {
+	return t->treeClass() == P_VAR && t->name() == counter &&
+	    t->parameters().empty();
+    }
+
+    static bool isPlateIndex(ParseTree const *var, string const &counter)
+    {
+	/* 
+	   Tests whether a variable is indexed by the counter in
+	   exactly one dimension, e.g. x[i, j] but not x[i, i] or
+	   x[i + 1, j], and does not use the counter anywhere else.
+	*/
+	if (var->name() == counter) {
+	    return false;
+	}
+	unsigned long ncounter = 0;
+	vector<ParseTree*> const &range_list = var->parameters();
+	for (unsigned long i = 0; i < range_list.size(); ++i) {
+	    if (range_list[i]->parameters().size() != 1) {
+		return false;
+	    }
+	    ParseTree const *index = range_list[i]->parameters()[0];
+	    if (isCounter(index, counter)) {
+		++ncounter;
+	    }
+	    else if (dependsOn(index, counter)) {
+		return false;
+	    }
+	}
+	return ncounter == 1;
+    }
+
+    static bool isPlateExpression(ParseTree const *t, string const &counter)
+    {
+	/*
+	  Tests whether an expression can be evaluated for all values
+	  of the counter by a single node. Functions of the counter
+	  must be scalar functions, which are applied element-wise to
+	  vector arguments.
+	*/
+	if (!dependsOn(t, counter)) {
+	    return true;
+	}
+	switch (t->treeClass()) {
+	case P_VAR:
+	    return isCounter(t, counter) || isPlateIndex(t, counter);
+	case P_FUNCTION:
+	    if (!SCALAR(Compiler::funcTab().find(t->name()))) {
+		return false;
+	    }
+	    for (unsigned long i = 0; i < t->parameters().size(); ++i) {
+		if (!isPlateExpression(t->parameters()[i], counter)) {
+		    return false;
+		}
+	    }
+	    return true;
+	default:
+	    return false;
+	}
+    }
+
+    static bool isPlateParameter(Node const *node)
+    {
+	/*
+	   A subset taken from several nodes cannot be a parameter of
+	   a plate unless it is fixed. Otherwise each of those nodes
+	   would depend on the whole plate, instead of a single
+	   element, and the cost of updating them all would grow with
+	   the square of the size of the plate.
+	*/
+	if (node->isFixed() || dynamic_cast<AggNode const*>(node) == nullptr) {
+	    return true;
+	}
+	vector<Node const *> const &par = node->parents();
+	for (unsigned long i = 1; i < par.size(); ++i) {
+	    if (par[i] != par[0]) return false;
+	}
+	return true;
+    }
+
     typedef pair<vector<unsigned long>, vector<double> > CNodeKey;
 
     /*
@@ -982,6 +1080,13 @@ void Compiler::allocate(ParseTree const *rel)
 
     if (_is_resolved.count(relindex) != 0) return;
 
+    if (!_plate_relations.empty() && !relindex.second.empty()) {
+	//The relation may belong to a plate of the innermost loop
+	vector<unsigned long> outer(relindex.second);
+	outer.pop_back();
+	if (_plate_relations.count(make_pair(rel, outer)) != 0) return;
+    }
+
     ParseTree const * const var = rel->parameters()[0];
     SimpleRange target_range = VariableSubsetRange(var);
 
@@ -1124,6 +1229,250 @@ void Compiler::allocate(ParseTree const *rel)
     
 }
     
+Range Compiler::getPlateRange(ParseTree const *var, string const &counter,
+			      vector<unsigned long> const &counter_range)
+{
+    /*
+      Evaluates the subset of a variable for all values of the
+      counter, or returns a null range if this is not possible.
+      Indices other than the counter must be scalar.
+    */
+    vector<ParseTree*> const &range_list = var->parameters();
+    vector<vector<unsigned long> > scope(range_list.size());
+    for (unsigned long i = 0; i < range_list.size(); ++i) {
+	ParseTree const *index = range_list[i]->parameters()[0];
+	if (isCounter(index, counter)) {
+	    scope[i] = counter_range;
+	}
+	else if (!indexExpression(index, scope[i]) || scope[i].size() != 1 ||
+		 scope[i][0] == 0)
+	{
+	    return Range();
+	}
+    }
+    return Range(scope);
+}
+
+Node *Compiler::getPlateParameter(ParseTree const *t, string const &counter,
+				  vector<unsigned long> const &counter_range)
+{
+    /*
+      Evaluates the expression t for all values of the counter,
+      returning a node of the same length as the counter range, or a
+      scalar node if the expression does not depend on the counter.
+      The expression must satisfy isPlateExpression. If it cannot be
+      evaluated, a NULL pointer is returned.
+    */
+    if (!dependsOn(t, counter)) {
+	return getParameter(t);
+    }
+
+    switch (t->treeClass()) {
+    case P_VAR:
+	if (isCounter(t, counter)) {
+	    vector<double> value(counter_range.begin(), counter_range.end());
+	    return getConstant(vector<unsigned long>(1, value.size()), value,
+			       _model.nchain(), false);
+	}
+	else {
+	    NodeArray *array = _model.symtab().getVariable(t->name());
+	    if (!array) {
+		return nullptr;
+	    }
+	    Range range = getPlateRange(t, counter, counter_range);
+	    if (isNULL(range) ||
+		range.ndim(false) != array->range().ndim(false) ||
+		!array->range().contains(range))
+	    {
+		return nullptr;
+	    }
+	    Node *node = array->getSubset(range, _model);
+	    if (node && !isPlateParameter(node)) {
+		return nullptr;
+	    }
+	    return node;
+	}
+    case P_FUNCTION:
+	{
+	    vector<Node const *> parents;
+	    for (unsigned long i = 0; i < t->parameters().size(); ++i) {
+		Node *node = getPlateParameter(t->parameters()[i], counter,
+					       counter_range);
+		if (!node) {
+		    return nullptr;
+		}
+		parents.push_back(node);
+	    }
+	    FunctionPtr const &func = getFunction(t, funcTab());
+	    return _logicalfactory.getNode(func, parents, _model);
+	}
+    default:
+	throw logic_error("Invalid plate expression");
+    }
+}
+
+Node *Compiler::allocatePlate(ParseTree const *rel, string const &counter,
+			      vector<unsigned long> const &counter_range)
+{
+    /*
+      Creates a single node for all values of the counter of the
+      innermost loop, if the relation can be compiled as a plate.
+      Otherwise returns a NULL pointer, and the relation is
+      compiled one element at a time.
+    */
+    ParseTree const *var = rel->parameters()[0];
+    ParseTree const *rhs = rel->parameters()[1];
+    if (_countertab.getCounter(var->name()) || !isPlateIndex(var, counter)) {
+	return nullptr;
+    }
+    if (rel->treeClass() == P_STOCHREL) {
+	if (rel->parameters().size() != 2 ||
+	    !SCALAR(distTab().find(rhs->name())))
+	{
+	    return nullptr; //Truncated or not scalar
+	}
+	for (unsigned long i = 0; i < rhs->parameters().size(); ++i) {
+	    if (!isPlateExpression(rhs->parameters()[i], counter)) {
+		return nullptr;
+	    }
+	}
+    }
+    else if (rhs->treeClass() != P_FUNCTION || !dependsOn(rhs, counter) ||
+	     !isPlateExpression(rhs, counter))
+    {
+	return nullptr;
+    }
+
+    Range range = getPlateRange(var, counter, counter_range);
+    if (isNULL(range)) {
+	return nullptr;
+    }
+    SimpleRange target_range(range.first(), range.last());
+
+    //Elements that have already been compiled separately
+    vector<unsigned long> values = _countertab.counterValues();
+    values.push_back(0);
+    for (unsigned long i = 0; i < counter_range.size(); ++i) {
+	values.back() = counter_range[i];
+	if (_is_resolved.count(make_pair(rel, values)) != 0) {
+	    return nullptr;
+	}
+    }
+
+    NodeArray *array = _model.symtab().getVariable(var->name());
+    if (array) {
+	if (array->range().ndim(false) != target_range.ndim(false) ||
+	    (array->isLocked() && !array->range().contains(target_range)))
+	{
+	    return nullptr;
+	}
+	//Check for overlap before any nodes are created
+	array->insert(nullptr, target_range);
+    }
+
+    //Check for observed values
+    unsigned long N = target_range.length();
+    vector<double> data;
+    map<string,SArray>::const_iterator q = _data_table.find(var->name());
+    if (q != _data_table.end()) {
+	vector<double> const &data_value = q->second.value();
+	SimpleRange const &data_range = q->second.range();
+	if (!data_range.contains(target_range)) {
+	    return nullptr;
+	}
+	for (RangeIterator p(target_range); !p.atEnd(); p.nextLeft()) {
+	    data.push_back(data_value[data_range.leftOffset(p)]);
+	}
+    }
+    
+    Node *node = nullptr;
+    if (rel->treeClass() == P_STOCHREL) {
+	//Stochastic plates must be fully observed
+	if (data.empty()) {
+	    return nullptr;
+	}
+	for (unsigned long i = 0; i < N; ++i) {
+	    if (jags_isna(data[i])) return nullptr;
+	}
+	vector<Node const *> parameters;
+	for (unsigned long i = 0; i < rhs->parameters().size(); ++i) {
+	    Node *par = getPlateParameter(rhs->parameters()[i], counter,
+					  counter_range);
+	    if (!par) {
+		return nullptr;
+	    }
+	    parameters.push_back(par);
+	}
+	ScalarDist const *dist = SCALAR(distTab().find(rhs->name()));
+	PlateStochasticNode *snode =
+	    new PlateStochasticNode(dist, N, _model.nchain(), parameters);
+	_model.addNode(snode);
+	snode->setData(&data[0], N);
+	node = snode;
+    }
+    else {
+	//Observed logical nodes are reported by allocateLogical
+	for (unsigned long i = 0; i < data.size(); ++i) {
+	    if (!jags_isna(data[i])) return nullptr;
+	}
+	node = getPlateParameter(rhs, counter, counter_range);
+	if (!node || node->length() != N) {
+	    return nullptr;
+	}
+    }
+
+    if (array) {
+	array->insert(node, target_range);
+    }
+    else {
+	_model.symtab().addVariable(var->name(), target_range.upper());
+	_model.symtab().getVariable(var->name())->insert(node, target_range);
+    }
+    return node;
+}
+
+void Compiler::allocatePlates(ParseTree const *loop,
+			      vector<unsigned long> const &counter_range)
+{
+    /*
+      Compiles the relations in the body of a for loop as plates
+      where possible, before the loop is expanded.  A plate is
+      identified by the relation and the values of the counters of
+      the enclosing loops.
+    */
+    if (counter_range.size() < 2) {
+	return;
+    }
+    for (unsigned long i = 1; i < counter_range.size(); ++i) {
+	if (counter_range[i] != counter_range[i-1] + 1) {
+	    return;
+	}
+    }
+
+    string const &counter = loop->parameters()[0]->name();
+    vector<unsigned long> outer = _countertab.counterValues();
+    vector<ParseTree*> const &body = loop->parameters()[1]->parameters();
+
+    //Repeat while new plates are added, since relations in the
+    //same loop may depend on each other
+    bool progress = true;
+    while (progress) {
+	progress = false;
+	for (unsigned long i = 0; i < body.size(); ++i) {
+	    TreeClass tc = body[i]->treeClass();
+	    if (tc != P_STOCHREL && tc != P_DETRMREL) continue;
+	    
+	    pair<ParseTree const *, vector<unsigned long> > key(body[i], outer);
+	    if (_plate_relations.count(key) != 0) continue;
+	    if (allocatePlate(body[i], counter, counter_range)) {
+		_plate_relations.insert(key);
+		_n_resolved++;
+		progress = true;
+	    }
+	}
+    }
+}
+    
 void Compiler::setConstantMask(ParseTree const *rel)
 {
     ParseTree const *var = rel->parameters()[0];
@@ -1346,6 +1695,7 @@ void Compiler::writeRelations(ParseTree const *relations)
     }
 
     _is_resolved.clear();
+    _plate_relations.clear();
 }
 
 void Compiler::traverseBackwards(ParseTree const *relations, CompilerMemFn FUN)
@@ -1370,6 +1720,11 @@ void Compiler::traverseBackwards(ParseTree const *relations, CompilerMemFn FUN)
 	    ParseTree *var = (*p)->parameters()[0];
 	    vector<unsigned long> counter_range = CounterRange(var);
 	    if (!counter_range.empty()) {
+		if (_plates && FUN == &Compiler::allocate &&
+		    _compiler_mode == PERMISSIVE)
+		{
+		    allocatePlates(*p, counter_range);
+		}
 		Counter *counter = _countertab.pushCounter(var->name(),
 							   counter_range);
 		for (; !counter->atEnd(); counter->next()) {
@@ -1403,6 +1758,11 @@ void Compiler::traverseForwards(ParseTree const *relations, CompilerMemFn FUN)
 	    ParseTree *var = (*p)->parameters()[0];
 	    vector<unsigned long> counter_range = CounterRange(var);
 	    if (!counter_range.empty()) {
+		if (_plates && FUN == &Compiler::allocate &&
+		    _compiler_mode == PERMISSIVE)
+		{
+		    allocatePlates(*p, counter_range);
+		}
 		Counter *counter = _countertab.pushCounter(var->name(),
 							   counter_range);
 		for (; !counter->atEnd(); counter->next()) {
@@ -1418,7 +1778,7 @@ Compiler::Compiler(BUGSModel &model, map<string, SArray> const &data_table)
     : _model(model), _countertab(), 
       _data_table(data_table), _n_resolved(0), _n_unresolved(0), 
       _is_resolved(), _compiler_mode(PERMISSIVE),
-      _index_expression(0), _index_nodes()
+      _index_expression(0), _index_nodes(), _plates(false)
 {
     if (_model.nodes().size() != 0)
 	throw invalid_argument("Non empty graph in Compiler constructor");
@@ -1426,6 +1786,11 @@ Compiler::Compiler(BUGSModel &model, map<string, SArray> const &data_table)
 	throw invalid_argument("Non empty symtab in Compiler constructor");
 }
 
+void Compiler::setPlates(bool plates)
+{
+    _plates = plates;
+}
+
 void Compiler::declareVariables(vector<ParseTree*> const &dec_list)
 {
   vector<ParseTree*>::const_iterator p;
@@ -20,6 +20,12 @@ ArrayDist::ArrayDist(string const &name, unsigned int npar)
 			  unsigned long) const
     {
     }
+
+    void ArrayDist::valueScore(double *, double const *,
+			       vector<double const *> const &,
+			       vector<vector<unsigned long>> const &) const
+    {
+    }
     
     void ArrayDist::randomSample(double *, vector<bool> const &,
 				 vector<double const *> const &,
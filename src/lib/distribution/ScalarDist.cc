@@ -91,10 +91,60 @@ bool ScalarDist::isSupportFixed(vector<bool> const &) const
 	return JAGS_NAN;
     }
 
+    void ScalarDist::batchLogDensity(double *density, double const *x,
+				     unsigned long n, PDFType type,
+				     vector<double const *> const &parameters)
+	const
+    {
+	vector<double const *> par(parameters.size());
+	for (unsigned long i = 0; i < n; ++i) {
+	    for (unsigned long j = 0; j < par.size(); ++j) {
+		par[j] = parameters[j] + i;
+	    }
+	    if (checkParameterValue(par)) {
+		density[i] = logDensity(x[i], type, par, nullptr, nullptr);
+	    }
+	    else {
+		density[i] = JAGS_NEGINF;
+	    }
+	}
+    }
+
+    bool ScalarDist::hasBatchLogDensity() const
+    {
+	return false;
+    }
+
+    bool ScalarDist::isNormalizationFixed(vector<bool> const &) const
+    {
+	return false;
+    }
+
+    double ScalarDist::logKernel(double x,
+				 vector<double const *> const &parameters)
+	const
+    {
+	return logDensity(x, PDF_LIKELIHOOD, parameters, nullptr, nullptr);
+    }
+
+    void ScalarDist::batchLogKernel(double *density, double const *x,
+				    unsigned long n,
+				    vector<double const *> const &parameters)
+	const
+    {
+	batchLogDensity(density, x, n, PDF_LIKELIHOOD, parameters);
+    }
+
     double ScalarDist::score(double, std::vector<double const *> const &,
 			     unsigned long) const
     {
 	return 0;
     }
+
+    double ScalarDist::valueScore(double,
+				  std::vector<double const *> const &) const
+    {
+	return 0;
+    }
     
 } //namespace jags
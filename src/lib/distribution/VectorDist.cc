@@ -53,5 +53,11 @@ VectorDist::VectorDist(string const &name, unsigned int npar)
     {
     }
 
+    void VectorDist::valueScore(double *, double const *,
+				vector<double const *> const &,
+				vector<unsigned long> const &) const
+    {
+    }
+
     
 } //namespace jags
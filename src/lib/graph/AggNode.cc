@@ -37,11 +37,16 @@ static vector<Node const *> sub_parents(vector<Node const *> const &parents,
 					vector<unsigned long> const &offsets)
 {
     // Substitute parent nodes that are themselves AggNodes
+    if (parents.size() != offsets.size()) {
+	throw length_error ("Length mismatch in Aggregate Node constructor");
+    }
     vector<Node const *> newparents(parents);
     for (unsigned long i = 0; i < parents.size(); i++) {
 	AggNode const *aggpar = dynamic_cast<AggNode const *>(parents[i]);
 	if (aggpar) {
-	    newparents[i] = aggpar->parents()[offsets[i]];
+	    if (offsets[i] >= aggpar->length())
+		throw out_of_range("Invalid offset in Aggregate Node constructor");
+	    newparents[i] = aggpar->parent(offsets[i]);
 	}
     }
     return newparents;
@@ -56,41 +61,92 @@ static vector<unsigned long> sub_offsets(vector<Node const *> const &parents,
     for (unsigned long i = 0; i < offsets.size(); i++) {
 	AggNode const *aggpar = dynamic_cast<AggNode const *>(parents[i]);
 	if (aggpar) {
-	    newoffsets[i] = aggpar->offsets()[offsets[i]];
+	    newoffsets[i] = aggpar->offset(offsets[i]);
 	}
     }
     return newoffsets;
 }
 
+static bool is_view(vector<Node const *> const &par,
+		    vector<unsigned long> const &off)
+{
+    /* 
+       Tests whether all elements are taken from a single parent at
+       equally spaced offsets
+    */
+    if (par.empty()) return false;
+    unsigned long start = off[0];
+    unsigned long step = 0;
+    if (par.size() > 1) {
+	if (off[1] < start) return false;
+	step = off[1] - start;
+    }
+    for (unsigned long i = 0; i < par.size(); i++) {
+	if (par[i] != par[0] || off[i] != start + i * step) {
+	    return false;
+	}
+    }
+    return true;
+}
+
+static vector<Node const *> agg_parents(vector<Node const *> const &parents, 
+					vector<unsigned long> const &offsets)
+{
+    // A view has its source as its only parent
+    vector<Node const *> par = sub_parents(parents, offsets);
+    if (is_view(par, sub_offsets(parents, offsets))) {
+	par.resize(1);
+    }
+    return par;
+}
+
 AggNode::AggNode(vector<unsigned long> const &dim,
 		 unsigned int nchain,
 		 vector<Node const *> const &parents,
                  vector<unsigned long> const &offsets)
-    : DeterministicNode(dim, nchain, sub_parents(parents, offsets)), 
-      _offsets(sub_offsets(parents, offsets)),
-      _parent_values(_length * nchain), _discrete(true)
+    : DeterministicNode(dim, nchain, agg_parents(parents, offsets)), 
+      _source(nullptr), _start(0), _step(0), _discrete(true)
 {
     // Check argument lengths
-    if (_length != parents.size() || _length != offsets.size()) {
+    if (_length != parents.size()) {
 	throw length_error ("Length mismatch in Aggregate Node constructor");
     }
 
     /* 
        Note that we cannot use the original arguments "parents" and "offsets"
-       due to possible substitution. Use this->parents() and _offsets instead.
+       due to possible substitution. Use this->parents() and the
+       substituted offsets instead. A view has a single parent.
     */
     vector<Node const *> const &par = this->parents();
+    vector<unsigned long> off = sub_offsets(parents, offsets);
 
-    // Check that offsets are valid
-    for (unsigned long i = 0; i < _length; i++) {
-	if (_offsets[i] >= par[i]->length())
+    if (par.size() == 1 && _length > 0) {
+	// Equally spaced elements of a single parent
+	_source = par[0];
+	_start = off[0];
+	_step = _length > 1 ? off[1] - _start : 1;
+	if (off.back() >= _source->length())
 	    throw out_of_range("Invalid offset in Aggregate Node constructor");
+	if (_step == 1) {
+	    // Contiguous subset
+	    shareValues(_source, _start);
+	}
     }
-  
-    // Setup parent values
-    for (unsigned int ch = 0; ch < _nchain; ++ch) {
-	for (unsigned long i = 0; i < _length; ++i) {
-	    _parent_values[i + ch * _length] = par[i]->value(ch) + _offsets[i];
+    else {
+	// Check that offsets are valid
+	for (unsigned long i = 0; i < _length; i++) {
+	    if (off[i] >= par[i]->length())
+		throw out_of_range("Invalid offset in Aggregate Node constructor");
+	}
+	_offsets.swap(off);
+
+	// Setup parent values
+	_parent_values.resize(_length * _nchain);
+	for (unsigned int ch = 0; ch < _nchain; ++ch) {
+	    for (unsigned long i = 0; i < _length; ++i) {
+		_parent_values[i + ch * _length] =
+		    par[i]->value(ch) + _offsets[i];
+	    }
 	}
     }
 
@@ -117,10 +173,22 @@ AggNode::~AggNode()
 
 void AggNode::deterministicSample(unsigned int chain)
 {
-    unsigned long N = _length * chain;
-    for (unsigned long i = 0; i < _length; ++i) {
-	_data[i + N] = *_parent_values[i + N];
+    if (sharesValues()) return;
+
+    double *value = _data + chain * _stride;
+    if (_source) {
+	double const *x = _source->value(chain) + _start;
+	for (unsigned long i = 0; i < _length; ++i) {
+	    value[i] = x[i * _step];
+	}
+    }
+    else {
+	unsigned long N = _length * chain;
+	for (unsigned long i = 0; i < _length; ++i) {
+	    value[i] = *_parent_values[i + N];
+	}
     }
+    incrementVersion(chain);
 }
 
     bool AggNode::hasGradient(Node const *) const
@@ -131,15 +199,38 @@ void AggNode::deterministicSample(unsigned int chain)
     void AggNode::gradient(double *grad, Node const *arg,
 			   unsigned int) const
     {
-	auto par = parents();
+	for (unsigned long p = 0; p < _length; ++p) {
+	    if (parent(p) == arg) {
+		grad[p + _length * offset(p)] += 1;
+	    }
+	}
+    }
+
+    void AggNode::gradientProduct(double *padj, double const *adj,
+				  Node const *arg, unsigned int, double *) const
+    {
+	if (_source) {
+	    if (arg == _source) {
+		double *x = padj + _start;
+		for (unsigned long p = 0; p < _length; ++p) {
+		    x[p * _step] += adj[p];
+		}
+	    }
+	    return;
+	}
+	vector<Node const *> const &par = parents();
 	for (unsigned long p = 0; p < _length; ++p) {
 	    if (par[p] == arg) {
-		unsigned long q = _offsets[p];
-		grad[p + _length * q] += 1;
+		padj[_offsets[p]] += adj[p];
 	    }
 	}
     }
 
+    unsigned long AggNode::gradientWorkLength(Node const *) const
+    {
+	return 0;
+    }
+
     
 /*
 bool AggNode::isLinear(GraphMarks const &linear_marks, bool fixed) const
@@ -173,21 +264,21 @@ bool AggNode::isClosed(set<Node const *> const &ancestors,
 	//embedded in the AggNode
 	Node const *pnode = nullptr;
 	vector<bool> pmask;
-	vector<Node const *> const &par = parents();
-	for (unsigned int i = 0; i < par.size(); ++i) {
-	    if (ancestors.count(par[i])) {
+	for (unsigned long i = 0; i < _length; ++i) {
+	    Node const *par = parent(i);
+	    if (ancestors.count(par)) {
 		if (pnode == nullptr) {
-		    pnode = par[i];
+		    pnode = par;
 		    pmask = vector<bool>(pnode->length(), false);
 		}
 		else {
-		    if (par[i] != pnode) return false;
-		    if (pmask[_offsets[i]]) return false;
+		    if (par != pnode) return false;
+		    if (pmask[offset(i)]) return false;
 		}
-		pmask[_offsets[i]] = true;
+		pmask[offset(i)] = true;
 	    }
 	    else if (fixed) {
-		if (!par[i]->isFixed()) return false;
+		if (!par->isFixed()) return false;
 	    }
 	}
 	if (!allTrue(pmask)) return false;
@@ -242,9 +333,19 @@ bool AggNode::isDiscreteValued() const
   return _discrete;
 }
 
-vector<unsigned long> const &AggNode::offsets() const
+Node const *AggNode::parent(unsigned long i) const
+{
+    return _source ? _source : parents()[i];
+}
+
+unsigned long AggNode::offset(unsigned long i) const
+{
+    return _source ? _start + i * _step : _offsets[i];
+}
+
+bool AggNode::isView() const
 {
-    return _offsets;
+    return sharesValues();
 }
 
 } //namespace jags
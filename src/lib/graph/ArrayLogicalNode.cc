@@ -70,7 +70,8 @@ ArrayLogicalNode::ArrayLogicalNode(ArrayFunction const *function,
 
 void ArrayLogicalNode::deterministicSample(unsigned int chain)
 {
-    _func->evaluate(_data + chain * _length, _parameters[chain], _dims);
+    _func->evaluate(_data + chain * _stride, _parameters[chain], _dims);
+    incrementVersion(chain);
 }
 
     void ArrayLogicalNode::gradient(double *grad, Node const *arg,
@@ -62,12 +62,13 @@ ArrayStochasticNode::ArrayStochasticNode(ArrayDist const *dist,
     }
 }
 
-double ArrayStochasticNode::logDensity(unsigned int chain, PDFType type) const
+double ArrayStochasticNode::calLogDensity(unsigned int chain, PDFType type)
+    const
 {
     if(!_dist->checkParameterValue(_parameters[chain], _dims))
 	return JAGS_NEGINF;
     
-    return _dist->logDensity(_data + _length * chain, type,
+    return _dist->logDensity(_data + chain * _stride, type,
 			     _parameters[chain], _dims);
 }
 
@@ -76,14 +77,32 @@ void ArrayStochasticNode::randomSample(RNG *rng, unsigned int chain)
     vector<bool> const &observed = *this->observedMask();
     if (anyTrue(observed)) {
 	//Partly observed node
-	_dist->randomSample(_data + _length * chain, observed,
+	_dist->randomSample(_data + chain * _stride, observed,
 			    _parameters[chain], _dims, rng);
     }
     else {
 	//Fully unobserved node
-	_dist->randomSample(_data + _length * chain, 
+	_dist->randomSample(_data + chain * _stride, 
 			    _parameters[chain], _dims, rng);
     }
+    incrementVersion(chain);
+}
+
+void ArrayStochasticNode::score(double *s, Node const *parent,
+				 unsigned int chain) const
+{
+    vector<Node const *> const &par = parents();
+    for (unsigned long i = 0; i < _parameters[chain].size(); ++i) {
+	if (par[i] == parent) {
+	    _dist->score(s, _data + chain * _stride, _parameters[chain],
+			 _dims, i);
+	}
+    }
+}
+
+void ArrayStochasticNode::valueScore(double *s, unsigned int chain) const
+{
+    _dist->valueScore(s, _data + chain * _stride, _parameters[chain], _dims);
 }
 
 bool ArrayStochasticNode::checkParentValues(unsigned int chain) const
@@ -1,9 +1,12 @@
 #include <config.h>
 #include <graph/DeterministicNode.h>
 
+#include <algorithm>
+
 using std::vector;
 using std::set;
 using std::array;
+using std::fill;
 
 namespace jags {
 
@@ -102,5 +105,27 @@ bool DeterministicNode::isFixed() const
     {
 	return 0.0;
     }
+
+    void DeterministicNode::gradientProduct(double *padj, double const *adj,
+					    Node const *parent,
+					    unsigned int chain,
+					    double *work) const
+    {
+	unsigned long plen = parent->length();
+	fill(work, work + _length * plen, 0.0);
+	gradient(work, parent, chain);
+	for (unsigned long q = 0; q < plen; ++q) {
+	    double const *Jq = work + _length * q;
+	    for (unsigned long l = 0; l < _length; ++l) {
+		padj[q] += Jq[l] * adj[l];
+	    }
+	}
+    }
+
+    unsigned long DeterministicNode::gradientWorkLength(Node const *parent)
+	const
+    {
+	return _length * parent->length();
+    }
     
 } //namespace jags
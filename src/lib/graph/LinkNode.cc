@@ -37,7 +37,8 @@ LinkNode::LinkNode(LinkFunction const *function, unsigned int nchain,
 
 void LinkNode::deterministicSample(unsigned int chain)
 {
-    _data[chain] = _func->inverseLink(*_parameters[chain][0]);
+    _data[chain * _stride] = _func->inverseLink(*_parameters[chain][0]);
+    incrementVersion(chain);
 }
 
 bool LinkNode::checkParentValues(unsigned int) const
@@ -72,7 +73,7 @@ double LinkNode::grad(unsigned int chain) const
     LinkNode::gradient(double *grad, Node const *arg, unsigned int chain) const
     {
 	if (parents()[0] == arg) {
-	    grad[0] += _func->grad(chain);
+	    grad[0] += _func->grad(*_parameters[chain][0]);
 	}
     }
        
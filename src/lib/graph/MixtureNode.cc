@@ -286,11 +286,27 @@ void MixtureNode::gradient(double *grad, Node const *arg,
     //Gradient is trivially 1 with respect to the active node only
     if (arg == _active_parents[chain]) {
 	for (unsigned int i = 0; i < _length; ++i) {
-	    grad[i] += 1;
+	    grad[i + _length * i] += 1;
 	}
     }
 }
 
+void MixtureNode::gradientProduct(double *padj, double const *adj,
+				  Node const *arg, unsigned int chain,
+				  double *) const
+{
+    if (arg == _active_parents[chain]) {
+	for (unsigned int i = 0; i < _length; ++i) {
+	    padj[i] += adj[i];
+	}
+    }
+}
+
+unsigned long MixtureNode::gradientWorkLength(Node const *) const
+{
+    return 0;
+}
+
 bool MixtureNode::isClosed(set<Node const *> const &ancestors, 
 			   ClosedFuncClass fc, bool fixed) const
 {
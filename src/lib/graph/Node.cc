@@ -3,64 +3,119 @@
 #include <graph/NodeError.h>
 #include <util/nainf.h>
 #include <util/dim.h>
+#include "ValuePlanes.h"
 
 #include <stdexcept>
 #include <algorithm>
+#include <new>
 
 using std::string;
 using std::vector;
 using std::logic_error;
 using std::copy;
-using std::find;
-using std::list;
+using std::size_t;
 
 namespace jags {
 
 class DeterminsticNode;
 class StochasticNode;
 
+static_assert(sizeof(unsigned long) <= sizeof(double),
+	      "Version counter does not fit in value storage");
+
+/*
+   Allocates storage for the values of a node in each chain, preceded
+   by the version counter for that chain, and returns a pointer to
+   the values for chain 0.
+*/
+static double *newValues(unsigned long length, unsigned int nchain,
+			 unsigned long &stride)
+{
+    double *base = allocatePlanes(length + 1, nchain, stride);
+    for (unsigned int n = 0; n < nchain; ++n) {
+	double *slot = base + n * stride;
+	new(slot) unsigned long(0);
+	for (unsigned long i = 1; i <= length; ++i) {
+	    slot[i] = JAGS_NA;
+	}
+    }
+    return base + 1;
+}
+
 Node::Node(vector<unsigned long> const &dim, unsigned int nchain)
-    : _parents(0), _stoch_children(nullptr), _dtrm_children(nullptr), 
-      _dim(getUnique(dim)), _length(product(dim)), _nchain(nchain),
-      _data(nullptr)
+    : _parents(0),
+      _dim(getUnique(dim)), _length(product(dim)),
+      _nchain(nchain), _data(nullptr), _stride(0),
+      _offset(0), _shared(false)
 {
     if (nchain==0)
 	throw logic_error("Node must have at least one chain");
 
-    unsigned long N = _length * _nchain;
-    _data = new double[N];
-    for (unsigned long i = 0; i < N; ++i) {
-	_data[i] = JAGS_NA;
-    }
-
-    _dtrm_children = new list<DeterministicNode*>;
-    _stoch_children = new list<StochasticNode*>;
+    _data = newValues(_length, _nchain, _stride);
 }
 
 Node::Node(vector<unsigned long> const &dim, unsigned int nchain,
 	   vector<Node const *> const &parents)
-    : _parents(parents), _stoch_children(nullptr), _dtrm_children(nullptr), 
+    : _parents(parents),
       _dim(getUnique(dim)), _length(product(dim)),
-      _nchain(nchain), _data(nullptr)
+      _nchain(nchain), _data(nullptr), _stride(0),
+      _offset(0), _shared(false)
 {
     if (nchain==0)
 	throw logic_error("Node must have at least one chain");
 
-    unsigned long N = _length * _nchain;
-    _data = new double[N];
-    for (unsigned long i = 0; i < N; ++i) {
-	_data[i] = JAGS_NA;
-    }
-  
-    _stoch_children = new list<StochasticNode*>;
-    _dtrm_children = new list<DeterministicNode*>;
+    _data = newValues(_length, _nchain, _stride);
 }
 
 Node::~Node()
 {
-    delete [] _data;
-    delete _stoch_children;
-    delete _dtrm_children;
+    if (!_shared) {
+	freePlanes(_data - 1);
+    }
+}
+
+void Node::shareValues(Node const *node, unsigned long offset)
+{
+    if (node->_nchain != _nchain || offset + _length > node->_length) {
+	throw logic_error("Invalid node in Node::shareValues");
+    }
+    if (!_shared) {
+	freePlanes(_data - 1);
+    }
+    _data = node->_data + offset;
+    _stride = node->_stride;
+    _offset = node->_offset + offset;
+    _shared = true;
+}
+
+bool Node::sharesValues() const
+{
+    return _shared;
+}
+
+/*
+   Each Node is preceded by a header that records the arena from
+   which it was allocated, or a null pointer if it was allocated on
+   the heap. The header is 16 bytes long to preserve alignment.
+*/
+static const size_t NODE_HEADER = 16;
+
+void *Node::operator new(size_t size)
+{
+    NodeArena *arena = NodeArena::active();
+    void *raw = arena ? arena->allocate(size + NODE_HEADER) :
+	::operator new(size + NODE_HEADER);
+    *static_cast<NodeArena**>(raw) = arena;
+    return static_cast<char*>(raw) + NODE_HEADER;
+}
+
+void Node::operator delete(void *ptr)
+{
+    if (ptr == nullptr) return;
+    void *raw = static_cast<char*>(ptr) - NODE_HEADER;
+    if (*static_cast<NodeArena**>(raw) == nullptr) {
+	::operator delete(raw);
+    }
 }
 
 vector <Node const *> const &Node::parents() const
@@ -68,14 +123,20 @@ vector <Node const *> const &Node::parents() const
     return _parents;
 }
 
-list<StochasticNode*> const *Node::stochasticChildren() 
+ChildList<StochasticNode> const *Node::stochasticChildren() 
 {
-    return _stoch_children;
+    return &_stoch_children;
 }
 
-list<DeterministicNode*> const *Node::deterministicChildren() 
+ChildList<DeterministicNode> const *Node::deterministicChildren() 
 {
-    return _dtrm_children;
+    return &_dtrm_children;
+}
+
+void Node::freezeChildren(NodeArena &arena)
+{
+    _stoch_children.freeze(arena);
+    _dtrm_children.freeze(arena);
 }
 
 static bool isInitialized(Node const *node, unsigned int n)
@@ -132,23 +193,28 @@ void Node::setValue(double const *value, unsigned long length, unsigned int chai
    if (chain >= _nchain)
       throw NodeError(this, "Invalid chain in Node::setValue");
 
-   copy(value, value + _length, _data + chain * _length);
+   copy(value, value + _length, _data + chain * _stride);
+   incrementVersion(chain);
 }
 
 void Node::swapValue(unsigned int chain1, unsigned int chain2)
 {
-    double *value1 = _data + chain1 * _length;
-    double *value2 = _data + chain2 * _length;
+    if (_shared) return;
+
+    double *value1 = _data + chain1 * _stride;
+    double *value2 = _data + chain2 * _stride;
     for (unsigned int i = 0; i < _length; ++i) {
 	double v = value1[i];
 	value1[i] = value2[i];
 	value2[i] = v;
     }
+    incrementVersion(chain1);
+    incrementVersion(chain2);
 }
 
 double const *Node::value(unsigned int chain) const
 {
-    return _data + chain * _length;
+    return _data + chain * _stride;
 }
 
 vector<unsigned long> const &Node::dim() const
@@ -163,12 +229,12 @@ unsigned long Node::length() const
 
 void Node::addChild(DeterministicNode *node) const
 {
-    _dtrm_children->push_back(node);
+    _dtrm_children.push_back(node);
 }
 
 void Node::addChild(StochasticNode *node) const
 {
-    _stoch_children->push_back(node);
+    _stoch_children.push_back(node);
 }
 
 void Node::removeChild(DeterministicNode *node) const
@@ -177,32 +243,20 @@ void Node::removeChild(DeterministicNode *node) const
        Removes the given node from the list of deterministic children.
        
        When Model::~Model is called, all nodes are deleted in reverse
-       order of construction. In this case, the element of _dtrm_node
-       to remove is the last one. For efficiency, we therefore search
-       for the element of _dtrm_node to remove starting at the
-       end. (NB Searching from the beginning results in quadratic
-       complexity in the size of _dtrm_node, which can cause real
-       efficiency problems when deleting a model)
+       order of construction. In this case, the element of
+       _dtrm_children to remove is the last one, and ChildList::remove
+       searches from the end for efficiency. (NB Searching from the
+       beginning results in quadratic complexity in the number of
+       children, which can cause real efficiency problems when
+       deleting a model)
     */
-    
-    list<DeterministicNode*>::reverse_iterator p =
-	find(_dtrm_children->rbegin(), _dtrm_children->rend(), node);
-    if (p != _dtrm_children->rend()) {
-	//The erase function only accepts iterators. Some shennanigans
-	//are required to convert the reverse iterator correctly.
-	_dtrm_children->erase((++p).base());
-    }
+    _dtrm_children.remove(node);
 }
 
 void Node::removeChild(StochasticNode *node) const
 {
     /* See comments in removeChild for DeterministicNodes */
-    
-    list<StochasticNode*>::reverse_iterator p = 
-	find(_stoch_children->rbegin(), _stoch_children->rend(), node);
-    if (p != _stoch_children->rend()) {
-	_stoch_children->erase((++p).base());
-    }
+    _stoch_children.remove(node);
 }
 
 } //namespace jags
@@ -0,0 +1,73 @@
+#include <config.h>
+#include <graph/NodeArena.h>
+#include "ValuePlanes.h"
+
+using std::size_t;
+using std::vector;
+
+/* Size of a chunk of memory */
+static const size_t CHUNK_SIZE = 1048576;
+/* Alignment of allocations */
+static const size_t ALIGN = 16;
+
+namespace jags {
+
+static NodeArena *&activeArena()
+{
+    //Each thread has its own active arena, so a model compiled in one
+    //thread does not capture nodes created in another
+    static thread_local NodeArena *_active = nullptr;
+    return _active;
+}
+
+NodeArena::NodeArena()
+    : _next(nullptr), _left(0)
+{
+}
+
+NodeArena::~NodeArena()
+{
+    releasePlanes(this);
+    for (unsigned int i = 0; i < _chunks.size(); ++i) {
+	delete [] _chunks[i];
+    }
+}
+
+void *NodeArena::allocate(size_t size)
+{
+    size = (size + ALIGN - 1) / ALIGN * ALIGN;
+    if (size > CHUNK_SIZE / 4) {
+	//Large allocations get their own chunk, leaving the current
+	//chunk in place
+	char *chunk = new char[size];
+	_chunks.push_back(chunk);
+	return chunk;
+    }
+    if (size > _left) {
+	_next = new char[CHUNK_SIZE];
+	_left = CHUNK_SIZE;
+	_chunks.push_back(_next);
+    }
+    void *ptr = _next;
+    _next += size;
+    _left -= size;
+    return ptr;
+}
+
+NodeArena *NodeArena::active()
+{
+    return activeArena();
+}
+
+NodeArena::Scope::Scope(NodeArena *arena)
+    : _previous(activeArena())
+{
+    activeArena() = arena;
+}
+
+NodeArena::Scope::~Scope()
+{
+    activeArena() = _previous;
+}
+
+} /* namespace jags */
@@ -0,0 +1,54 @@
+#include <config.h>
+#include "PlateDist.h"
+#include <distribution/ScalarDist.h>
+
+using std::vector;
+
+namespace jags {
+
+PlateDist::PlateDist(ScalarDist const *dist)
+    : Distribution("plate(" + dist->name() + ")", dist->npar()), _dist(dist)
+{
+}
+
+bool PlateDist::isSupportFixed(vector<bool> const &fixmask) const
+{
+    return _dist->isSupportFixed(fixmask);
+}
+
+bool PlateDist::checkParameterDiscrete(vector<bool> const &mask) const
+{
+    return _dist->checkParameterDiscrete(mask);
+}
+
+bool PlateDist::isDiscreteValued(vector<bool> const &mask) const
+{
+    return _dist->isDiscreteValued(mask);
+}
+
+bool PlateDist::isLocationParameter(unsigned int index) const
+{
+    return _dist->isLocationParameter(index);
+}
+
+bool PlateDist::isScaleParameter(unsigned int index) const
+{
+    return _dist->isScaleParameter(index);
+}
+
+bool PlateDist::fullRank() const
+{
+    return _dist->fullRank();
+}
+
+bool PlateDist::hasScore(unsigned long i) const
+{
+    return _dist->hasScore(i);
+}
+
+bool PlateDist::hasValueScore() const
+{
+    return _dist->hasValueScore();
+}
+
+} //namespace jags
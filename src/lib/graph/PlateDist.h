@@ -0,0 +1,36 @@
+#ifndef PLATE_DIST_H_
+#define PLATE_DIST_H_
+
+#include <distribution/Distribution.h>
+
+namespace jags {
+
+class ScalarDist;
+
+/**
+ * @short Distribution of a PlateStochasticNode
+ *
+ * A PlateDist is the distribution reported by a PlateStochasticNode.
+ * Its properties are those of the scalar distribution of the
+ * elements of the plate, but it has its own name so that samplers
+ * that recognize a distribution by name do not mistake a plate for
+ * a single observation.
+ */
+class PlateDist : public Distribution {
+    ScalarDist const * const _dist;
+public:
+    PlateDist(ScalarDist const *dist);
+    bool isSupportFixed(std::vector<bool> const &fixmask) const override;
+    bool checkParameterDiscrete(std::vector<bool> const &mask)
+	const override;
+    bool isDiscreteValued(std::vector<bool> const &mask) const override;
+    bool isLocationParameter(unsigned int index) const override;
+    bool isScaleParameter(unsigned int index) const override;
+    bool fullRank() const override;
+    bool hasScore(unsigned long i) const override;
+    bool hasValueScore() const override;
+};
+
+} /* namespace jags */
+
+#endif /* PLATE_DIST_H_ */
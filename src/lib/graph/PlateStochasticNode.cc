@@ -0,0 +1,276 @@
+#include <config.h>
+#include <graph/PlateStochasticNode.h>
+#include <graph/NodeError.h>
+#include <distribution/ScalarDist.h>
+#include <util/nainf.h>
+#include "PlateDist.h"
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+using std::vector;
+using std::string;
+using std::unique_ptr;
+using std::min;
+using std::fill;
+using std::isnan;
+
+/* Number of elements evaluated by each call to batchLogDensity */
+#define PLATE_BLOCK 256
+
+namespace jags {
+
+static vector<bool> mkIsVector(vector<Node const *> const &parameters)
+{
+    vector<bool> ans(parameters.size());
+    for (unsigned long i = 0; i < parameters.size(); ++i) {
+	ans[i] = (parameters[i]->length() > 1);
+    }
+    return ans;
+}
+
+static bool mkFixNorm(ScalarDist const *dist,
+		      vector<Node const *> const &params)
+{
+    vector<bool> fixmask(params.size());
+    for (unsigned long i = 0; i < params.size(); ++i) {
+	fixmask[i] = params[i]->isFixed();
+    }
+    return dist->isNormalizationFixed(fixmask);
+}
+
+PlateStochasticNode::PlateStochasticNode(ScalarDist const *dist,
+					 unsigned long length,
+					 unsigned int nchain,
+					 vector<Node const *> const &params)
+    : PlateStochasticNode(unique_ptr<PlateDist>(new PlateDist(dist)),
+			  dist, length, nchain, params)
+{
+}
+
+PlateStochasticNode::PlateStochasticNode(unique_ptr<PlateDist> platedist,
+					 ScalarDist const *dist,
+					 unsigned long length,
+					 unsigned int nchain,
+					 vector<Node const *> const &params)
+    : StochasticNode(vector<unsigned long>(1, length), nchain,
+		     platedist.get(), params, nullptr, nullptr),
+      _platedist(std::move(platedist)), _dist(dist),
+      _isvector(mkIsVector(params)), _fixnorm(mkFixNorm(dist, params))
+{
+    for (unsigned long i = 0; i < params.size(); ++i) {
+	if (params[i]->length() != 1 && params[i]->length() != length) {
+	    string msg("Invalid parameter length in plate of distribution ");
+	    msg.append(dist->name());
+	    throw NodeError(params[i], msg);
+	}
+    }
+}
+
+PlateStochasticNode::~PlateStochasticNode()
+{
+}
+
+ScalarDist const *PlateStochasticNode::elementDistribution() const
+{
+    return _dist;
+}
+
+bool PlateStochasticNode::isVectorParameter(unsigned long i) const
+{
+    return _isvector[i];
+}
+
+double PlateStochasticNode::plateLogDensity(unsigned int chain, PDFType type,
+					    double *elements) const
+{
+    double const *x = _data + chain * _stride;
+    vector<double const *> const &par = _parameters[chain];
+    unsigned long npar = par.size();
+    unsigned long block = min<unsigned long>(PLATE_BLOCK, _length);
+
+    /*
+       The batch functions take one value of each parameter per
+       element, so shared parameters are copied into a buffer of the
+       size of one block.
+    */
+    vector<double> buffer(npar * block);
+    vector<double const *> bpar(npar);
+    for (unsigned long j = 0; j < npar; ++j) {
+	if (!_isvector[j]) {
+	    fill(buffer.begin() + j * block, buffer.begin() + (j + 1) * block,
+		 *par[j]);
+	    bpar[j] = &buffer[j * block];
+	}
+    }
+
+    bool kernel = (type == PDF_LIKELIHOOD && _fixnorm);
+    //Densities are written to elements, if given, or to a block buffer
+    vector<double> blockdensity(elements ? 0 : block);
+    double loglik = 0;
+    for (unsigned long i = 0; i < _length; i += block) {
+	unsigned long n = min(block, _length - i);
+	double *density = elements ? elements + i : &blockdensity[0];
+	for (unsigned long j = 0; j < npar; ++j) {
+	    if (_isvector[j]) {
+		bpar[j] = par[j] + i;
+	    }
+	}
+	if (kernel) {
+	    _dist->batchLogKernel(density, x + i, n, bpar);
+	}
+	else {
+	    _dist->batchLogDensity(density, x + i, n, type, bpar);
+	}
+	for (unsigned long k = 0; k < n; ++k) {
+	    loglik += density[k];
+	}
+    }
+    return loglik;
+}
+
+double PlateStochasticNode::calLogDensity(unsigned int chain, PDFType type)
+    const
+{
+    return plateLogDensity(chain, type, nullptr);
+}
+
+void PlateStochasticNode::elementLogDensity(double *ld, unsigned int chain,
+					    PDFType type) const
+{
+    plateLogDensity(chain, type, ld);
+}
+
+void PlateStochasticNode::randomSample(RNG *rng, unsigned int chain)
+{
+    double *x = _data + chain * _stride;
+    vector<bool> const &observed = *observedMask();
+    vector<double const *> par(_parameters[chain]);
+
+    for (unsigned long i = 0; i < _length; ++i) {
+	if (!observed[i]) {
+	    x[i] = _dist->randomSample(par, nullptr, nullptr, rng);
+	}
+	for (unsigned long j = 0; j < par.size(); ++j) {
+	    if (_isvector[j])
+		++par[j];
+	}
+    }
+    incrementVersion(chain);
+}
+
+void PlateStochasticNode::score(double *s, Node const *parent,
+				unsigned int chain) const
+{
+    double const *x = _data + chain * _stride;
+    vector<Node const *> const &p = parents();
+    for (unsigned long j = 0; j < _parameters[chain].size(); ++j) {
+	if (p[j] != parent) continue;
+
+	vector<double const *> par(_parameters[chain]);
+	for (unsigned long i = 0; i < _length; ++i) {
+	    double sc = _dist->score(x[i], par, j);
+	    if (_isvector[j]) {
+		s[i] += sc;
+	    }
+	    else {
+		s[0] += sc;
+	    }
+	    for (unsigned long k = 0; k < par.size(); ++k) {
+		if (_isvector[k])
+		    ++par[k];
+	    }
+	}
+    }
+}
+
+void PlateStochasticNode::valueScore(double *s, unsigned int chain) const
+{
+    double const *x = _data + chain * _stride;
+    vector<double const *> par(_parameters[chain]);
+    for (unsigned long i = 0; i < _length; ++i) {
+	s[i] += _dist->valueScore(x[i], par);
+	for (unsigned long k = 0; k < par.size(); ++k) {
+	    if (_isvector[k])
+		++par[k];
+	}
+    }
+}
+
+bool PlateStochasticNode::checkParentValues(unsigned int chain) const
+{
+    vector<double const *> par(_parameters[chain]);
+    for (unsigned long i = 0; i < _length; ++i) {
+	if (!_dist->checkParameterValue(par))
+	    return false;
+	bool shared = true;
+	for (unsigned long j = 0; j < par.size(); ++j) {
+	    if (_isvector[j]) {
+		++par[j];
+		shared = false;
+	    }
+	}
+	if (shared) break; //All elements have the same parameters
+    }
+    return true;
+}
+
+void PlateStochasticNode::sp(double *lower, double *upper,
+			     unsigned int chain) const
+{
+    vector<double const *> par(_parameters[chain]);
+    for (unsigned long i = 0; i < _length; ++i) {
+	lower[i] = _dist->l(par);
+	upper[i] = _dist->u(par);
+	for (unsigned long j = 0; j < par.size(); ++j) {
+	    if (_isvector[j])
+		++par[j];
+	}
+    }
+}
+
+string PlateStochasticNode::deparse(vector<string> const &parnames) const
+{
+    string name = _dist->name();
+    name.append("(");
+    for (unsigned long i = 0; i < parnames.size(); ++i) {
+	if (i != 0) {
+	    name.append(",");
+	}
+	name.append(parnames[i]);
+    }
+    name.append(")");
+    return name;
+}
+
+double PlateStochasticNode::KL(unsigned int ch1, unsigned int ch2,
+			       RNG *rng, unsigned int nrep) const
+{
+    vector<double const *> par1(_parameters[ch1]);
+    vector<double const *> par2(_parameters[ch2]);
+    double kl = 0;
+    for (unsigned long i = 0; i < _length; ++i) {
+	double kli = _dist->KL(par1, par2);
+	if (isnan(kli)) {
+	    kli = _dist->KL(par1, par2, nullptr, nullptr, rng, nrep);
+	}
+	bool shared = true;
+	for (unsigned long j = 0; j < par1.size(); ++j) {
+	    if (_isvector[j]) {
+		++par1[j];
+		++par2[j];
+		shared = false;
+	    }
+	}
+	if (shared) {
+	    //All elements have the same parameters
+	    return kli * _length;
+	}
+	kl += kli;
+    }
+    return kl;
+}
+
+} //namespace jags
@@ -45,7 +45,8 @@ ScalarLogicalNode::ScalarLogicalNode(ScalarFunction const *function,
 
 void ScalarLogicalNode::deterministicSample(unsigned int chain)
 {
-    _data[chain] = _func->evaluate(_parameters[chain]);
+    _data[chain * _stride] = _func->evaluate(_parameters[chain]);
+    incrementVersion(chain);
 }
 
 bool ScalarLogicalNode::checkParentValues(unsigned int chain) const
@@ -14,12 +14,27 @@ using std::isnan;
 
 namespace jags {
 
+static bool mkFixNorm(ScalarDist const *dist,
+		      vector<Node const *> const &params,
+		      Node const *lower, Node const *upper)
+{
+    //The normalizing constant of a truncated distribution depends
+    //on all the parameters
+    if (lower || upper) return false;
+
+    vector<bool> fixmask(params.size());
+    for (unsigned long i = 0; i < params.size(); ++i) {
+	fixmask[i] = params[i]->isFixed();
+    }
+    return dist->isNormalizationFixed(fixmask);
+}
+
 ScalarStochasticNode::ScalarStochasticNode(ScalarDist const *dist,
 					   unsigned int nchain,
 					   vector<Node const *> const &params,
 					   Node const *lower, Node const *upper)
     : StochasticNode(vector<unsigned long>(1,1), nchain, dist, params, lower, upper),
-      _dist(dist)
+      _dist(dist), _fixnorm(mkFixNorm(dist, params, lower, upper))
 {
     for(vector<Node const *>::const_iterator p = params.begin();
 	p != params.end(); ++p)
@@ -37,7 +52,8 @@ ScalarStochasticNode::ScalarStochasticNode(ScalarDist const *dist,
     }
 }
 
-double ScalarStochasticNode::logDensity(unsigned int chain, PDFType type) const
+double ScalarStochasticNode::calLogDensity(unsigned int chain, PDFType type)
+    const
 {
     if(!_dist->checkParameterValue(_parameters[chain]))
 	return JAGS_NEGINF;
@@ -45,8 +61,11 @@ double ScalarStochasticNode::logDensity(unsigned int chain, PDFType type) const
     double const *l = lowerLimit(chain);
     double const *u = upperLimit(chain);
     if (l && u && *l > *u) return JAGS_NEGINF;
-    
-    return _dist->logDensity(_data[chain], type, _parameters[chain], l, u);
+
+    if (type == PDF_LIKELIHOOD && _fixnorm) {
+	return _dist->logKernel(_data[chain * _stride], _parameters[chain]);
+    }
+    return _dist->logDensity(_data[chain * _stride], type, _parameters[chain], l, u);
 }
 
 void ScalarStochasticNode::randomSample(RNG *rng, unsigned int chain)
@@ -55,7 +74,8 @@ void ScalarStochasticNode::randomSample(RNG *rng, unsigned int chain)
     double const *u = upperLimit(chain);
     if (l && u && *l > *u) throw NodeError(this, "Inconsistent bounds");
 
-    _data[chain] = _dist->randomSample(_parameters[chain], l, u, rng);
+    _data[chain * _stride] = _dist->randomSample(_parameters[chain], l, u, rng);
+    incrementVersion(chain);
 }  
 
 void ScalarStochasticNode::truncatedSample(RNG *rng, unsigned int chain,
@@ -73,9 +93,26 @@ void ScalarStochasticNode::truncatedSample(RNG *rng, unsigned int chain,
     }
     if (l && u && *l > *u) throw NodeError(this, "Inconsistent bounds");
     
-    _data[chain] = _dist->randomSample(_parameters[chain], l, u, rng);
+    _data[chain * _stride] = _dist->randomSample(_parameters[chain], l, u, rng);
+    incrementVersion(chain);
 }  
 
+void ScalarStochasticNode::score(double *s, Node const *parent,
+				 unsigned int chain) const
+{
+    vector<Node const *> const &par = parents();
+    for (unsigned long i = 0; i < _parameters[chain].size(); ++i) {
+	if (par[i] == parent) {
+	    s[0] += _dist->score(_data[chain * _stride], _parameters[chain], i);
+	}
+    }
+}
+
+void ScalarStochasticNode::valueScore(double *s, unsigned int chain) const
+{
+    s[0] += _dist->valueScore(_data[chain * _stride], _parameters[chain]);
+}
+
 bool ScalarStochasticNode::checkParentValues(unsigned int chain) const
 {
     double const *l = lowerLimit(chain);
@@ -88,6 +125,11 @@ bool ScalarStochasticNode::checkParentValues(unsigned int chain) const
     }
 }
 
+bool ScalarStochasticNode::isNormalizationFixed() const
+{
+    return _fixnorm;
+}
+
 void ScalarStochasticNode::sp(double *lower, double *upper,
 			      unsigned int chain) const
 {
@@ -74,7 +74,7 @@ StochasticNode::StochasticNode(vector<unsigned long> const &dim,
       _observed(getUnique(vector<bool>(_length, false))), 
       _discrete(mkDiscrete(dist, parameters)),
       _depth(mkDepth(parameters)),
-      _parameters(nchain)
+      _cache(_length > 1 ? nchain : 0), _parameters(nchain)
 {
     if (!checkNPar(dist, parameters.size())) {
 	throw DistError(_dist, "Incorrect number of parameters");
@@ -134,6 +134,40 @@ bool StochasticNode::isFixed() const
     return allTrue(*_observed);
 }
 
+void StochasticNode::cacheLogDensity() const
+{
+    if (_cache.empty()) {
+	_cache.resize(nchain());
+    }
+}
+
+double StochasticNode::logDensity(unsigned int chain, PDFType type) const
+{
+    if (_cache.empty()) {
+	return calLogDensity(chain, type);
+    }
+
+    DensityCache &cache = _cache[chain];
+    vector<Node const *> const &par = parents();
+
+    unsigned long v = version(chain);
+    for (unsigned long i = 0; i < par.size(); ++i) {
+	v += par[i]->version(chain);
+    }
+    if (v != cache.version) {
+	cache.version = v;
+	for (unsigned int t = 0; t < 3; ++t) {
+	    cache.valid[t] = false;
+	}
+    }
+
+    if (!cache.valid[type]) {
+	cache.value[type] = calLogDensity(chain, type);
+	cache.valid[type] = true;
+    }
+    return cache.value[type];
+}
+
     bool StochasticNode::isRandomVariable() const
     {
 	return true;
@@ -314,5 +348,25 @@ bool StochasticNode::fullRank() const
 {
     return _dist->fullRank() && allFalse(*_observed);
 }
+
+bool StochasticNode::hasScore(Node const *parent) const
+{
+    if (_lower || _upper) return false;
+
+    vector<Node const *> const &par = parents();
+    bool found = false;
+    for (unsigned long i = 0; i < par.size(); ++i) {
+	if (par[i] == parent) {
+	    if (!_dist->hasScore(i)) return false;
+	    found = true;
+	}
+    }
+    return found;
+}
+
+bool StochasticNode::hasValueScore() const
+{
+    return _dist->hasValueScore();
+}
     
 } //namespace jags
@@ -53,7 +53,7 @@ VSLogicalNode::VSLogicalNode(ScalarFunction const *function,
 
 void VSLogicalNode::deterministicSample(unsigned int chain)
 {
-    double *ans = _data + chain * _length;
+    double *ans = _data + chain * _stride;
     vector<double const *> par(_parameters[chain]);
 	
     for (unsigned int i = 0; i < _length; ++i) {
@@ -63,6 +63,7 @@ void VSLogicalNode::deterministicSample(unsigned int chain)
 		++par[j];
 	}
     }
+    incrementVersion(chain);
 }
 
 bool VSLogicalNode::checkParentValues(unsigned int chain) const
@@ -89,15 +90,44 @@ bool VSLogicalNode::checkParentValues(unsigned int chain) const
 	for (unsigned long i = 0; i < par.size(); ++i) {
 	    if (par[i] != arg) continue;
 	    
+	    //Jacobian is diagonal for vector arguments
 	    for (unsigned int l = 0; l < _length; ++l) {
-		grad[l] += _func->gradient(param, i);
+		grad[_isvector[i] ? l + _length * l : l] +=
+		    _func->gradient(param, i);
 		for (unsigned int k = 0; k < param.size(); ++k) {
 		    if (_isvector[k]) ++param[k];
 		}
 	    }  
+	    param = _parameters[chain];
 	}
     }
 
+    void VSLogicalNode::gradientProduct(double *padj, double const *adj,
+					Node const *arg, unsigned int chain,
+					double *) const
+    {
+	vector<double const *> param(_parameters[chain]);
+
+	auto par = parents();
+	for (unsigned long i = 0; i < par.size(); ++i) {
+	    if (par[i] != arg) continue;
+
+	    for (unsigned int l = 0; l < _length; ++l) {
+		padj[_isvector[i] ? l : 0] +=
+		    _func->gradient(param, i) * adj[l];
+		for (unsigned int k = 0; k < param.size(); ++k) {
+		    if (_isvector[k]) ++param[k];
+		}
+	    }
+	    param = _parameters[chain];
+	}
+    }
+
+    unsigned long VSLogicalNode::gradientWorkLength(Node const *) const
+    {
+	return 0;
+    }
+
     
     /*
 DeterministicNode *
@@ -0,0 +1,194 @@
+#include <config.h>
+#include "ValuePlanes.h"
+#include <graph/NodeArena.h>
+
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <cstdint>
+#include <utility>
+
+using std::map;
+using std::pair;
+using std::mutex;
+using std::lock_guard;
+using std::logic_error;
+using std::uintptr_t;
+
+/* Number of doubles in a cache line */
+static const unsigned long LINE = 64 / sizeof(double);
+/* Number of doubles in each plane of a shared block */
+static const unsigned long PLANE = 2048;
+/* Largest allocation taken from a shared block */
+static const unsigned long SHARED_MAX = 64;
+
+namespace jags {
+
+namespace {
+
+    struct Block {
+	char *raw;            // Memory returned by new
+	unsigned int nchain;  // Number of planes
+	unsigned long used;   // Number of doubles used in each plane
+	unsigned long live;   // Number of live allocations
+	bool shared;          // Shared by small allocations
+	NodeArena const *arena; // Owner, or null if the block is freed
+	                        // with its last allocation
+    };
+
+    typedef pair<NodeArena const *, unsigned int> BlockKey;
+
+    /*
+       Blocks are indexed by the address of their first plane. The
+       tables are never deleted so that nodes with static storage
+       duration may be safely destroyed at exit.
+    */
+    map<double const *, Block> &blocks()
+    {
+	static auto *_blocks = new map<double const *, Block>;
+	return *_blocks;
+    }
+
+    /*
+       Shared block currently used for allocation, indexed by owner
+       and number of chains
+    */
+    map<BlockKey, double*> &current()
+    {
+	static auto *_current = new map<BlockKey, double*>;
+	return *_current;
+    }
+
+    mutex &planeMutex()
+    {
+	static auto *_mutex = new mutex;
+	return *_mutex;
+    }
+
+    double *newBlock(unsigned long size, unsigned int nchain, bool shared,
+		     NodeArena const *arena)
+    {
+	Block block;
+	block.raw = new char[size * nchain * sizeof(double) + 64];
+	block.nchain = nchain;
+	block.used = 0;
+	block.live = 0;
+	block.shared = shared;
+	block.arena = arena;
+
+	uintptr_t addr = reinterpret_cast<uintptr_t>(block.raw);
+	addr = (addr + 63) / 64 * 64;
+	double *base = reinterpret_cast<double*>(addr);
+	blocks()[base] = block;
+	return base;
+    }
+
+}
+
+double *allocatePlanes(unsigned long size, unsigned int nchain,
+		       unsigned long &stride)
+{
+    lock_guard<mutex> lock(planeMutex());
+    NodeArena const *arena = NodeArena::active();
+
+    if (size > SHARED_MAX) {
+	stride = (size + LINE - 1) / LINE * LINE;
+	double *base = newBlock(stride, nchain, false, arena);
+	Block &block = blocks()[base];
+	block.used = stride;
+	block.live = 1;
+	return base;
+    }
+
+    stride = PLANE;
+    double *base = nullptr;
+    BlockKey key(arena, nchain);
+    map<BlockKey, double*>::iterator p = current().find(key);
+    if (p != current().end()) {
+	base = p->second;
+	Block &block = blocks()[base];
+	if (block.used + size > PLANE) {
+	    // Retire the current block
+	    if (block.live == 0 && block.arena == nullptr) {
+		delete [] block.raw;
+		blocks().erase(base);
+	    }
+	    base = nullptr;
+	}
+    }
+    if (base == nullptr) {
+	base = newBlock(PLANE, nchain, true, arena);
+	current()[key] = base;
+    }
+
+    Block &block = blocks()[base];
+    double *ptr = base + block.used;
+    block.used += size;
+    block.live++;
+    return ptr;
+}
+
+void freePlanes(double *ptr)
+{
+    lock_guard<mutex> lock(planeMutex());
+
+    map<double const *, Block>::iterator p = blocks().upper_bound(ptr);
+    if (p == blocks().begin()) {
+	throw logic_error("Invalid pointer in freePlanes");
+    }
+    --p;
+    Block &block = p->second;
+    if (--block.live > 0) {
+	return;
+    }
+    if (block.arena != nullptr) {
+	// A block that holds a single large allocation is released
+	// as soon as it is unused, even if it belongs to an arena, so
+	// that the storage of a node that shares the values of
+	// another node is not kept.
+	if (!block.shared) {
+	    delete [] block.raw;
+	    blocks().erase(p);
+	}
+	return;
+    }
+
+    map<BlockKey, double*>::const_iterator c =
+	current().find(BlockKey(nullptr, block.nchain));
+    if (block.shared && c != current().end() && c->second == p->first) {
+	// Keep the current block for reuse
+	block.used = 0;
+    }
+    else {
+	delete [] block.raw;
+	blocks().erase(p);
+    }
+}
+
+void releasePlanes(NodeArena const *arena)
+{
+    lock_guard<mutex> lock(planeMutex());
+
+    map<double const *, Block>::iterator p = blocks().begin();
+    while (p != blocks().end()) {
+	if (p->second.arena == arena) {
+	    delete [] p->second.raw;
+	    blocks().erase(p++);
+	}
+	else {
+	    ++p;
+	}
+    }
+
+    map<BlockKey, double*>::iterator c = current().begin();
+    while (c != current().end()) {
+	if (c->first.first == arena) {
+	    current().erase(c++);
+	}
+	else {
+	    ++c;
+	}
+    }
+}
+
+} /* namespace jags */
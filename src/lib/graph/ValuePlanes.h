@@ -0,0 +1,45 @@
+#ifndef VALUE_PLANES_H_
+#define VALUE_PLANES_H_
+
+namespace jags {
+
+class NodeArena;
+
+/**
+ * Allocates storage for a node in each of nchain parallel chains.
+ *
+ * The storage for each chain lies in a separate "value plane" so
+ * that parallel chains do not write to the same cache line. Small
+ * allocations are taken from shared blocks that contain one plane
+ * for each chain, so that the values of different nodes in the same
+ * chain are close together in memory. Large allocations have their
+ * own block, with the storage for each chain aligned on a cache line.
+ *
+ * If there is an active NodeArena then the blocks belong to the
+ * arena. Shared blocks are not released by freePlanes, but by
+ * releasePlanes when the arena is destroyed.
+ *
+ * @param size Number of doubles required for each chain
+ * @param nchain Number of chains
+ * @param stride On exit, the distance (in doubles) between the
+ * storage of successive chains.
+ *
+ * @return Pointer to the storage for chain 0. The storage is not
+ * initialized.
+ */
+double *allocatePlanes(unsigned long size, unsigned int nchain,
+		       unsigned long &stride);
+
+/**
+ * Releases storage created by allocatePlanes.
+ */
+void freePlanes(double *ptr);
+
+/**
+ * Releases all storage belonging to the given arena
+ */
+void releasePlanes(NodeArena const *arena);
+
+} /* namespace jags */
+
+#endif /* VALUE_PLANES_H_ */
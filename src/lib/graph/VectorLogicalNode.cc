@@ -77,7 +77,8 @@ VectorLogicalNode::VectorLogicalNode(VectorFunction const *function,
 
 void VectorLogicalNode::deterministicSample(unsigned int chain)
 {
-    _func->evaluate(_data + chain * _length, _parameters[chain], _lengths);
+    _func->evaluate(_data + chain * _stride, _parameters[chain], _lengths);
+    incrementVersion(chain);
 }
 
 bool VectorLogicalNode::checkParentValues(unsigned int chain) const
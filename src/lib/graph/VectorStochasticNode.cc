@@ -63,12 +63,13 @@ VectorStochasticNode::VectorStochasticNode(VectorDist const *dist,
     }
 }
 
-double VectorStochasticNode::logDensity(unsigned int chain, PDFType type) const
+double VectorStochasticNode::calLogDensity(unsigned int chain, PDFType type)
+    const
 {
     if(!_dist->checkParameterValue(_parameters[chain], _lengths))
 	return JAGS_NEGINF;
     
-    return _dist->logDensity(_data + _length * chain, type,
+    return _dist->logDensity(_data + chain * _stride, type,
 			     _parameters[chain], _lengths);
 }
 
@@ -77,14 +78,33 @@ void VectorStochasticNode::randomSample(RNG *rng, unsigned int chain)
     vector<bool> const &observed = *this->observedMask();
     if (anyTrue(observed)) {
 	//Partly observed node
-	_dist->randomSample(_data + _length * chain, observed,
+	_dist->randomSample(_data + chain * _stride, observed,
 			    _parameters[chain], _lengths, rng);
     }
     else {
 	//Fully unobserved node
-	_dist->randomSample(_data + _length * chain, 
+	_dist->randomSample(_data + chain * _stride, 
 			    _parameters[chain], _lengths, rng);
     }
+    incrementVersion(chain);
+}
+
+void VectorStochasticNode::score(double *s, Node const *parent,
+				 unsigned int chain) const
+{
+    vector<Node const *> const &par = parents();
+    for (unsigned long i = 0; i < _parameters[chain].size(); ++i) {
+	if (par[i] == parent) {
+	    _dist->score(s, _data + chain * _stride, _parameters[chain],
+			 _lengths, i);
+	}
+    }
+}
+
+void VectorStochasticNode::valueScore(double *s, unsigned int chain) const
+{
+    _dist->valueScore(s, _data + chain * _stride, _parameters[chain],
+		      _lengths);
 }
 
 bool VectorStochasticNode::checkParentValues(unsigned int chain) const
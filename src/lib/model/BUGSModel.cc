@@ -57,7 +57,7 @@ SymTab &BUGSModel::symtab()
 }
 
 void BUGSModel::coda(vector<NodeId> const &node_ids, string const &stem,
-		     string &warn, string const &type)
+		     string &warn, string const &type, bool binary)
 {
     warn.clear();
 	
@@ -107,10 +107,15 @@ void BUGSModel::coda(vector<NodeId> const &node_ids, string const &stem,
     }
 	
 	unsigned int nwritten = 0;
-    nwritten += CODA0(dump_nodes, stem, warn, type);    
-    nwritten += CODA(dump_nodes, stem, nchain(), warn, type);
-    nwritten += TABLE0(dump_nodes, stem, warn, type);    
-    nwritten += TABLE(dump_nodes, stem, nchain(), warn, type);
+    if (binary) {
+	nwritten += BINARY(dump_nodes, stem, nchain(), warn, type);
+    }
+    else {
+	nwritten += CODA0(dump_nodes, stem, warn, type);    
+	nwritten += CODA(dump_nodes, stem, nchain(), warn, type);
+	nwritten += TABLE0(dump_nodes, stem, warn, type);    
+	nwritten += TABLE(dump_nodes, stem, nchain(), warn, type);
+    }
 	
 	if (nwritten==0) {
 		throw logic_error(string("A Monitor with type ") + 
@@ -119,7 +124,8 @@ void BUGSModel::coda(vector<NodeId> const &node_ids, string const &stem,
 	
 }
 
-void BUGSModel::coda(string const &stem, string &warn, string const &type)
+void BUGSModel::coda(string const &stem, string &warn, string const &type,
+		     bool binary)
 {
     warn.clear();
     
@@ -129,10 +135,15 @@ void BUGSModel::coda(string const &stem, string &warn, string const &type)
     }
     
 	unsigned int nwritten = 0;
-    nwritten += CODA0(monitors(), stem, warn, type);    
-    nwritten += CODA(monitors(), stem, nchain(), warn, type);
-    nwritten += TABLE0(monitors(), stem, warn, type);    
-    nwritten += TABLE(monitors(), stem, nchain(), warn, type);
+    if (binary) {
+	nwritten += BINARY(monitors(), stem, nchain(), warn, type);
+    }
+    else {
+	nwritten += CODA0(monitors(), stem, warn, type);    
+	nwritten += CODA(monitors(), stem, nchain(), warn, type);
+	nwritten += TABLE0(monitors(), stem, warn, type);    
+	nwritten += TABLE(monitors(), stem, nchain(), warn, type);
+    }
 
 	if ( nwritten == 0 ) {
 		if ( type == "*" ) {
@@ -180,7 +191,7 @@ void BUGSModel::setParameters(map<string, SArray> const &param_table,
 	for (unsigned int i = 0; i < state.length(); ++i) {
 	    istate.push_back(static_cast<int>(value[i]));
 	}
-	if (rng(chain)->setState(istate) == false) {
+	if (setRNGState(istate, chain) == false) {
 	    throw runtime_error("Invalid .RNG.state");
 	}
     }
@@ -189,7 +200,7 @@ void BUGSModel::setParameters(map<string, SArray> const &param_table,
 
 bool BUGSModel::setMonitor(string const &name, Range const &range,
 			   unsigned int thin, string const &type,
-			   string &msg)
+			   string &msg, string const &stem)
 {
     for (list<MonitorInfo>::const_iterator i = _bugs_monitors.begin();
 	 i != _bugs_monitors.end(); ++i)
@@ -207,7 +218,7 @@ bool BUGSModel::setMonitor(string const &name, Range const &range,
     for(auto j = faclist.begin(); j != faclist.end(); ++j)
     {
 	if ((*j)->isActive()) {
-	    monitor = (*j)->getMonitor(name, range, this, type, msg);
+	    monitor = (*j)->getMonitor(name, range, this, type, stem, msg);
 	    if (monitor || !msg.empty())
 		break;
 	}
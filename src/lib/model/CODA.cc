@@ -9,6 +9,7 @@
 #include <sstream>
 #include <vector>
 #include <cmath>
+#include <algorithm>
 
 using std::list;
 using std::vector;
@@ -18,6 +19,8 @@ using std::ofstream;
 using std::ostream;
 using std::isnan;
 using std::isfinite;
+using std::min;
+using std::max;
 
 namespace jags {
 
@@ -76,49 +79,72 @@ static void writeDouble(double x, ostream &out)
 	return ans;
     }
     
-static void WriteIndex(MonitorControl const &control,
-		       vector<bool> const &missing,
-		       ofstream &index, unsigned int &lineno)
+/*
+   Maximum number of sampled values that are held in memory at once
+   when writing CODA output.
+*/
+static const unsigned long CODA_BLOCK = 1048576;
+
+static void WriteMonitor(MonitorControl const &control,
+			 vector<ostream*> const &output,
+			 ostream &index, unsigned int &lineno)
 {
     /* 
-       Writes to a coda index file and augments the current line
-       number in the corresponding coda output file(s)
+       Writes to a coda index file and the corresponding coda output
+       files (one for each chain), augmenting the current line number.
+
+       Sampled values are read in blocks of elements so that the
+       memory required does not depend on the size of the monitor.
+       Elements with at least one missing value in at least one chain
+       are omitted.
     */
     Monitor const *monitor = control.monitor();
     if (monitor->poolIterations()) {
 	return;
     }
 
+    unsigned int nchain = output.size();
+    unsigned int niter = control.niter();
     unsigned long nvar = product(monitor->dim());
     vector<string> const &enames = monitor->elementNames();
-    for (unsigned int v = 0; v < nvar; ++v) {
-	if (missing[v]) continue;
-	index << enames[v] << " " << lineno + 1 << " "
-	      << lineno + control.niter() << '\n';
-	lineno += control.niter();
-    }
-}
 
-//Write output file
-static void WriteOutput(MonitorControl const &control, unsigned int chain,
-			vector<bool> const &missing,
-			ofstream &output)
-{
-    Monitor const *monitor = control.monitor();
-    if (monitor->poolIterations()) {
-	return;
-    }
-    
-    vector<double> const &y = monitor->value(chain);
-    unsigned long nvar = product(monitor->dim());
-    for (unsigned int v = 0; v < nvar; ++v) {
-	if (missing[v]) continue;
-	unsigned int iter = control.start();
-	for (unsigned int k = 0; k < control.niter(); ++k) {
-	    output << iter << "  ";
-	    writeDouble(y[k * nvar + v], output);
-	    output << '\n';
-	    iter += control.thin();
+    unsigned long block = CODA_BLOCK / (static_cast<unsigned long>(nchain) *
+					max(niter, 1U));
+    if (block == 0) block = 1;
+
+    vector<vector<double> > y(nchain);
+    for (unsigned long begin = 0; begin < nvar; begin += block) {
+	unsigned long end = min(begin + block, nvar);
+	unsigned long width = end - begin;
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    monitor->values(ch, begin, end, y[ch]);
+	}
+	for (unsigned long v = 0; v < width; ++v) {
+	    bool missing = false;
+	    for (unsigned int ch = 0; ch < nchain && !missing; ++ch) {
+		for (unsigned int k = 0; k < niter; ++k) {
+		    if (jags_isna(y[ch][k * width + v])) {
+			missing = true;
+			break;
+		    }
+		}
+	    }
+	    if (missing) continue;
+
+	    index << enames[begin + v] << " " << lineno + 1 << " "
+		  << lineno + niter << '\n';
+	    lineno += niter;
+
+	    for (unsigned int ch = 0; ch < nchain; ++ch) {
+		ostream &out = *output[ch];
+		unsigned int iter = control.start();
+		for (unsigned int k = 0; k < niter; ++k) {
+		    out << iter << "  ";
+		    writeDouble(y[ch][k * width + v], out);
+		    out << '\n';
+		    iter += control.thin();
+		}
+	    }
 	}
     }
 }
@@ -211,11 +237,8 @@ unsigned int CODA(list<MonitorControl> const &mvec, string const &stem,
 	Monitor const *monitor = p->monitor();
 	if (!monitor->poolChains() && !monitor->poolIterations() &&
 		( type == "*" || type == monitor->type() ) ) {
-	    vector<bool> missing = missingValues(*p, nchain);
-	    WriteIndex(*p, missing, index, lineno);
-	    for (unsigned int ch = 0; ch < nchain; ++ch) {
-		WriteOutput(*p, ch, missing, *output[ch]);
-	    }
+	    WriteMonitor(*p, vector<ostream*>(output.begin(), output.end()),
+			 index, lineno);
 		nwritten++;
 	}
     }
@@ -261,9 +284,7 @@ unsigned int CODA0(list<MonitorControl> const &mvec, string const &stem, string
 	Monitor const *monitor = p->monitor();
 	if (monitor->poolChains() && !monitor->poolIterations() &&
 		( type == "*" || type == monitor->type() ) ) {
-	    vector<bool> missing = missingValues(*p, 1);
-	    WriteIndex(*p, missing, index, lineno);
-	    WriteOutput(*p, 0, missing, output);
+	    WriteMonitor(*p, vector<ostream*>(1, &output), index, lineno);
 		nwritten++;
 	}
     }
@@ -74,6 +74,25 @@ unsigned int TABLE(std::list<MonitorControl> const &mvec, std::string const &pre
 unsigned int TABLE0(std::list<MonitorControl> const &mvec, std::string const &prefix,
 	    std::string &warn, std::string const &type);
 
+/**
+ * Binary output for all monitors. This function opens one output
+ * file "<prefix>trace.bin", which can be read with the TraceFile
+ * class.
+ *
+ * @param mvec List of MonitorControl objects containing monitors to be 
+ * written out.
+ * @param prefix String to be prepended to the output file name
+ * @param nchain Number of chains.
+ * @param warn String that will contain warning messages on exit. It is
+ *        cleared on entry.
+ * @param type Name of the monitor type or "*" for all types
+ * @return The number of monitors written
+ *
+ * @see TraceFile
+ */
+unsigned int BINARY(std::list<MonitorControl> const &mvec, std::string const &prefix,
+	    unsigned int nchain, std::string &warn, std::string const &type);
+
 } //namespace jags
 
 #endif /* CODA_H_ */
@@ -4,6 +4,7 @@
 #include <model/Monitor.h>
 #include <sampler/Sampler.h>
 #include <sampler/SamplerFactory.h>
+#include <sampler/GraphView.h>
 #include <rng/RNGFactory.h>
 #include <rng/RNG.h>
 #include <graph/GraphMarks.h>
@@ -22,6 +23,11 @@
 #include <algorithm>
 #include <functional>
 #include <map>
+#include <atomic>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using std::map;
 using std::binary_function;
@@ -44,6 +50,7 @@ using std::find;
 using std::exception_ptr;
 using std::current_exception;
 using std::rethrow_exception;
+using std::atomic;
 
 namespace jags {
 
@@ -69,15 +76,16 @@ static bool checkClosure(vector<Node*> const &nodes)
 	}
 
 	// Check children
-	list<StochasticNode*> const *sch = (*i)->stochasticChildren();
-	for (list<StochasticNode*>::const_iterator k = sch->begin(); 
+	ChildList<StochasticNode> const *sch = (*i)->stochasticChildren();
+	for (ChildList<StochasticNode>::const_iterator k = sch->begin(); 
 	     k != sch->end(); k++)
 	{
 	    if (graph.find(*k) == graph.end()) return false;
 	}
 	
-	list<DeterministicNode*> const *dch = (*i)->deterministicChildren();
-	for (list<DeterministicNode*>::const_iterator k = dch->begin(); 
+	ChildList<DeterministicNode> const *dch = 
+	    (*i)->deterministicChildren();
+	for (ChildList<DeterministicNode>::const_iterator k = dch->begin(); 
 	     k != dch->end(); k++)
 	{
 	    if (graph.find(*k) == graph.end()) return false;
@@ -88,7 +96,8 @@ static bool checkClosure(vector<Node*> const &nodes)
 
 Model::Model(unsigned int nchain)
     : _samplers(0), _nchain(nchain), _rng(nchain, nullptr), _iteration(0),
-      _is_initialized(false), _adapt(false), _data_gen(false)
+      _is_initialized(false), _adapt(false), _data_gen(false), _nthread(1),
+      _thread_rng_state(nchain)
 {
 }
 
@@ -165,6 +174,14 @@ void Model::initialize(bool datagen)
     if (!checkClosure(_nodes))
 	throw runtime_error("Graph not closed");
 
+    // The graph is now complete. Store the lists of children together
+    // so that they can be traversed efficiently
+    for (vector<Node*>::const_iterator i = _nodes.begin(); 
+	 i != _nodes.end(); ++i)
+    {
+	(*i)->freezeChildren(_arena);
+    }
+
     // Choose random number generators
     chooseRNGs();
 
@@ -173,6 +190,7 @@ void Model::initialize(bool datagen)
     
     // Choose Samplers
     chooseSamplers();
+    chooseSchedule();
     
     if (datagen) {
 	//All extra nodes are sampled
@@ -347,6 +365,300 @@ void Model::chooseSamplers()
     reverse(_samplers.begin(), _samplers.end());
 }
 
+void Model::updateColour(vector<Sampler*> const &samplers,
+			 unsigned int chain)
+{
+    /*
+       The samplers are divided into contiguous blocks, one for each
+       thread. Each block is updated with its own RNG, so the result
+       does not depend on how the blocks are scheduled.
+    */
+    unsigned long nblock = _thread_rng[chain].size() + 1;
+    unsigned long blocksize = (samplers.size() + nblock - 1) / nblock;
+    
+    exception_ptr teptr = nullptr;
+    #pragma omp parallel for num_threads(_nthread)
+    for (unsigned long b = 0; b < nblock; ++b) {
+	RNG *rng = b == 0 ? _rng[chain] : _thread_rng[chain][b-1];
+	unsigned long end = min((b + 1) * blocksize, 
+				static_cast<unsigned long>(samplers.size()));
+	try {
+	    for (unsigned long i = b * blocksize; i < end; ++i) {
+		samplers[i]->update(chain, rng);
+	    }
+	}
+	catch(...) {
+            #pragma omp critical
+	    teptr = current_exception();
+	}
+    }
+
+    if (teptr) {
+	rethrow_exception(teptr);
+    }
+}
+
+void Model::updateChain(unsigned int chain)
+{
+    if (_schedule.empty()) {
+	for (vector<Sampler*>::iterator i = _samplers.begin(); 
+	     i != _samplers.end(); ++i) 
+	{
+	    (*i)->update(chain, _rng[chain]);
+	}
+    }
+    else {
+	for (vector<vector<Sampler*> >::const_iterator c = _schedule.begin();
+	     c != _schedule.end(); ++c)
+	{
+	    if (c->size() == 1) {
+		c->front()->update(chain, _rng[chain]);
+	    }
+	    else {
+		updateColour(*c, chain);
+	    }
+	}
+    }
+		
+    for (vector<Node*>::const_iterator k = _sampled_extra.begin();
+	 k != _sampled_extra.end(); ++k)
+    {
+	if (!(*k)->checkParentValues(chain)) {
+	    throw NodeError(*k, "Invalid parent values");
+	}
+	(*k)->randomSample(_rng[chain], chain);
+    }
+}
+
+bool Model::monitorsDue(unsigned int iteration) const
+{
+    for (list<MonitorControl>::const_iterator k = _monitors.begin(); 
+	 k != _monitors.end(); k++) 
+    {
+	if (k->isDue(iteration)) return true;
+    }
+    return false;
+}
+
+static unsigned int threadSeed(RNG const *rng, unsigned int thread)
+{
+    /*
+       Mixes the state of the chain RNG with the thread number,
+       using the finalizer of the splitmix64 generator.
+    */
+    vector<int> state;
+    rng->getState(state);
+    unsigned long long h = 0x9E3779B97F4A7C15ULL * (thread + 1);
+    for (unsigned long i = 0; i < state.size(); ++i) {
+	h ^= static_cast<unsigned int>(state[i]);
+	h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+	h ^= h >> 31;
+    }
+    return static_cast<unsigned int>(h ^ (h >> 32));
+}
+
+void Model::chooseSchedule()
+{
+    /*
+     * Colours the samplers so that samplers of the same colour can
+     * be updated concurrently within a chain. 
+     *
+     * A sampler writes to its sampled nodes and their deterministic
+     * children, and reads from these nodes, its stochastic children
+     * and the parents of all of them (its Markov blanket).  Two
+     * samplers conflict if one writes to a node the other reads.
+     *
+     * Samplers are visited in update order and each one is given
+     * the lowest colour that is higher than the colour of every
+     * previous sampler it conflicts with. Hence conflicting samplers
+     * are still updated in the order chosen by chooseSamplers.
+     */
+
+    _schedule.clear();
+    _thread_rng.clear();
+    if (_nthread <= 1) return;
+
+    // Map each node to one plus the highest colour of any sampler
+    // that writes to, or reads from, the node
+    map<Node const*, unsigned int> last_write, last_read;
+
+    for (vector<Sampler*>::const_iterator p = _samplers.begin();
+	 p != _samplers.end(); ++p)
+    {
+	GraphView const *gv = (*p)->graphView();
+
+	set<Node const*> writes;
+	writes.insert(gv->nodes().begin(), gv->nodes().end());
+	writes.insert(gv->deterministicChildren().begin(),
+		      gv->deterministicChildren().end());
+
+	set<Node const*> blanket(writes);
+	blanket.insert(gv->stochasticChildren().begin(),
+		       gv->stochasticChildren().end());
+	vector<Node const*> members(blanket.begin(), blanket.end());
+	for (vector<Node const*>::const_iterator i = members.begin();
+	     i != members.end(); ++i)
+	{
+	    vector<Node const*> const &parents = (*i)->parents();
+	    blanket.insert(parents.begin(), parents.end());
+	}
+
+	unsigned int colour = 0;
+	for (set<Node const*>::const_iterator i = blanket.begin();
+	     i != blanket.end(); ++i)
+	{
+	    map<Node const*, unsigned int>::const_iterator q = 
+		last_write.find(*i);
+	    if (q != last_write.end()) colour = max(colour, q->second);
+	}
+	for (set<Node const*>::const_iterator i = writes.begin();
+	     i != writes.end(); ++i)
+	{
+	    map<Node const*, unsigned int>::const_iterator q =
+		last_read.find(*i);
+	    if (q != last_read.end()) colour = max(colour, q->second);
+	}
+
+	for (set<Node const*>::const_iterator i = writes.begin();
+	     i != writes.end(); ++i)
+	{
+	    unsigned int &c = last_write[*i];
+	    c = max(c, colour + 1);
+	}
+	for (set<Node const*>::const_iterator i = blanket.begin();
+	     i != blanket.end(); ++i)
+	{
+	    unsigned int &c = last_read[*i];
+	    c = max(c, colour + 1);
+	}
+	
+	if (colour >= _schedule.size()) {
+	    _schedule.resize(colour + 1);
+	}
+	_schedule[colour].push_back(*p);
+    }
+
+    /* 
+       Each additional thread has its own RNG of the same type as the
+       chain RNG, seeded from the state of the chain RNG without
+       drawing from it, so that the chain RNG produces the same
+       stream whatever the number of threads. A state restored by
+       setRNGState replaces the seed if it is for the same number of
+       threads. The RNGs are owned by the RNG factory, not the model.
+    */
+    _thread_rng.resize(_nchain);
+    for (unsigned int ch = 0; ch < _nchain; ++ch) {
+	for (unsigned int t = 1; t < _nthread; ++t) {
+	    RNG *rng = nullptr;
+	    for (auto p = rngFactories().begin(); p != rngFactories().end();
+		 ++p)
+	    {
+		if ((*p)->isActive()) {
+		    rng = (*p)->makeRNG(_rng[ch]->name(), ch);
+		    if (rng) break;
+		}
+	    }
+	    if (!rng) {
+		throw runtime_error("Cannot generate RNGs for sampler threads");
+	    }
+	    rng->init(threadSeed(_rng[ch], t));
+	    _thread_rng[ch].push_back(rng);
+	}
+	restoreThreadRNGs(ch);
+    }
+}
+
+void Model::restoreThreadRNGs(unsigned int chain)
+{
+    vector<int> &pending = _thread_rng_state[chain];
+    if (pending.empty() || _thread_rng.size() <= chain) return;
+
+    /*
+       The state is only restored if it holds one state, of the same
+       length as the state of the chain RNG, for each thread RNG.
+       Otherwise it was saved with a different number of threads and
+       the thread RNGs keep their seeds.
+    */
+    vector<RNG*> const &trng = _thread_rng[chain];
+    vector<int> current;
+    _rng[chain]->getState(current);
+    unsigned long len = current.size();
+    if (!trng.empty() && pending.size() == trng.size() * len) {
+	for (unsigned long t = 0; t < trng.size(); ++t) {
+	    vector<int> state(pending.begin() + t * len,
+			      pending.begin() + (t + 1) * len);
+	    if (!trng[t]->setState(state)) {
+		throw runtime_error("Invalid RNG state for sampler thread");
+	    }
+	}
+    }
+    pending.clear();
+}
+
+void Model::getRNGState(vector<int> &state, unsigned int chain) const
+{
+    state.clear();
+    if (_rng[chain] == nullptr) return;
+    
+    _rng[chain]->getState(state);
+    if (_thread_rng.size() > chain) {
+	for (unsigned long t = 0; t < _thread_rng[chain].size(); ++t) {
+	    vector<int> tstate;
+	    _thread_rng[chain][t]->getState(tstate);
+	    state.insert(state.end(), tstate.begin(), tstate.end());
+	}
+    }
+}
+
+bool Model::setRNGState(vector<int> const &state, unsigned int chain)
+{
+    RNG *rng = _rng[chain];
+    if (rng == nullptr) return false;
+
+    /* 
+       The chain RNG and the thread RNGs have the same type, so the
+       length of a single state is given by the current state of the
+       chain RNG.
+    */
+    vector<int> current;
+    rng->getState(current);
+    unsigned long len = current.size();
+    if (len == 0 || state.size() <= len) {
+	return rng->setState(state);
+    }
+    if (state.size() % len != 0) {
+	return false;
+    }
+    if (!rng->setState(vector<int>(state.begin(), state.begin() + len))) {
+	return false;
+    }
+    _thread_rng_state[chain].assign(state.begin() + len, state.end());
+    restoreThreadRNGs(chain);
+    return true;
+}
+
+void Model::setSamplerThreads(unsigned int nthread)
+{
+    if (nthread == 0) {
+	throw logic_error("Invalid number of sampler threads");
+    }
+    _nthread = nthread;
+    if (_is_initialized) {
+	chooseSchedule();
+    }
+}
+
+unsigned int Model::samplerThreads() const
+{
+    return _nthread;
+}
+
+vector<vector<Sampler*> > const &Model::samplerSchedule() const
+{
+    return _schedule;
+}
+
 void Model::update(unsigned int niter)
 {
     if (!_is_initialized) {
@@ -358,46 +670,153 @@ void Model::update(unsigned int niter)
        indivual threads so they can be handled by the Console.
     */
     exception_ptr teptr = nullptr;
-    
-    for (unsigned int iter = 0; iter < niter; ++iter) {    
+    atomic<unsigned int> stop(niter); // Iterations done before a failure
+    unsigned int const start = _iteration;
+    unsigned int nserial = 0; // Monitors updated on a single thread
+    vector<unsigned int> nmonitor(_nchain, 0); // Monitors updated by chain
 
-        #pragma omp parallel for num_threads(_nchain)
-	for (unsigned int n = 0; n < _nchain; ++n) {
-	    try {
-		for (vector<Sampler*>::iterator i = _samplers.begin(); 
-		     i != _samplers.end(); ++i) 
-		{
-		    (*i)->update(n, _rng[n]);
+    /*
+       A single parallel region covers the whole block of niter
+       iterations, so there is no fork/join per iteration.  If the
+       team is smaller than the number of chains then each thread
+       takes every nthread-th chain.
+
+       Threads only meet when monitors are due. In between, each
+       thread runs its chains as fast as it can. When a chain throws
+       an exception, the failing iteration is recorded in stop,
+       which only ever decreases, and every thread tests it before
+       updating a chain. A thread that is ahead of the failing chain
+       may already have updated its own chains further, but no
+       monitor records an iteration at or after the failure, and the
+       model reports the iteration before the failure as the last
+       one done.
+
+       Monitors that update by chain hold their state separately for
+       each chain, and are updated by the thread that runs the chain.
+       Other monitors are updated on a single thread. If any monitor
+       fails, the values already recorded for the iteration are
+       rolled back, so that every monitor has the same number of
+       iterations for every chain.
+    */
+    #pragma omp parallel num_threads(_nchain)
+    {
+	unsigned int thread = 0, nthread = 1;
+#ifdef _OPENMP
+	thread = omp_get_thread_num();
+	nthread = omp_get_num_threads();
+#endif
+	for (unsigned int iter = 0; iter < niter; ++iter) {
+
+	    for (unsigned int n = thread; n < _nchain; n += nthread) {
+		if (iter >= stop) break;
+		try {
+		    updateChain(n);
 		}
-		
-		for (vector<Node*>::const_iterator k = _sampled_extra.begin();
-		     k != _sampled_extra.end(); ++k)
-		{
-		    if (!(*k)->checkParentValues(n)) {
-			throw NodeError(*k, "Invalid parent values");
+		catch(...) {
+                    #pragma omp critical
+		    {
+			if (iter < stop) {
+			    teptr = current_exception();
+			    stop = iter;
+			}
 		    }
-		    (*k)->randomSample(_rng[n], n);
 		}
 	    }
-	    catch(...) {
-		teptr = current_exception();
-	    }
-	    
-	}
-
-	if (teptr) {
-	    rethrow_exception(teptr);
-	}
-	
-	_iteration++;
 
-	for (list<MonitorControl>::iterator k = _monitors.begin(); 
-	     k != _monitors.end(); k++) 
-	{
-	    k->update(_iteration);
+	    unsigned int iteration = start + iter + 1;
+	    if (!monitorsDue(iteration)) continue;
+
+	    /*
+	       All chains must finish the iteration before monitors are
+	       updated. Between here and the next barrier, only a
+	       monitor failure can change stop, and it sets stop to
+	       iter, so every thread takes the same decisions.
+	    */
+            #pragma omp barrier
+	    if (iter >= stop) break;
+
+            #pragma omp single
+	    {
+		nserial = 0;
+		try {
+		    for (list<MonitorControl>::iterator k = 
+			     _monitors.begin(); k != _monitors.end(); k++) 
+		    {
+			k->update(iteration);
+			++nserial;
+		    }
+		}
+		catch(...) {
+                    #pragma omp critical
+		    {
+			if (iter < stop) {
+			    teptr = current_exception();
+			    stop = iter;
+			}
+		    }
+		}
+	    }
+	    for (unsigned int n = thread; n < _nchain; n += nthread) {
+		nmonitor[n] = 0;
+		if (iter >= stop) continue;
+		try {
+		    for (list<MonitorControl>::iterator k =
+			     _monitors.begin(); k != _monitors.end(); k++)
+		    {
+			k->update(iteration, n);
+			++nmonitor[n];
+		    }
+		}
+		catch(...) {
+                    #pragma omp critical
+		    {
+			if (iter < stop) {
+			    teptr = current_exception();
+			    stop = iter;
+			}
+		    }
+		}
+	    }
+	    /*
+	       A monitor may read the values of other chains, so no
+	       chain can start the next iteration until all monitors
+	       are updated.
+	    */
+            #pragma omp barrier
+	    if (iter >= stop) {
+		/*
+		   Each monitor discards the iteration for the chains it
+		   has already recorded. A monitor that cannot roll back
+		   keeps its values, and the original error is reported.
+		*/
+		for (unsigned int n = thread; n < _nchain; n += nthread) {
+		    list<MonitorControl>::iterator k = _monitors.begin();
+		    for (unsigned int i = 0; i < nmonitor[n]; ++i, ++k) {
+			try {
+			    k->rollback(iteration, n);
+			}
+			catch(...) {}
+		    }
+		}
+                #pragma omp single
+		{
+		    list<MonitorControl>::iterator k = _monitors.begin();
+		    for (unsigned int i = 0; i < nserial; ++i, ++k) {
+			try {
+			    k->rollback(iteration);
+			}
+			catch(...) {}
+		    }
+		}
+		break;
+	    }
 	}
     }
 
+    _iteration = start + stop;
+    if (teptr) {
+	rethrow_exception(teptr);
+    }
 }
 
 unsigned int Model::iteration() const
@@ -556,7 +975,7 @@ bool Model::setRNG(string const &name, unsigned int chain)
 
   for (auto p = rngFactories().begin(); p != rngFactories().end(); ++p) {
       if ((*p)->isActive()) {
-	  RNG *rng = (*p)->makeRNG(name);
+	  RNG *rng = (*p)->makeRNG(name, chain);
 	  if (rng) {
 	      /* NO! RNGs are owned by the factory, not the model
 	      if (_rng[chain])
@@ -611,4 +1030,9 @@ vector<StochasticNode*> const &Model::stochasticNodes() const
 	return _nodes;
     }
 
+NodeArena &Model::arena()
+{
+    return _arena;
+}
+
 } //namespace jags
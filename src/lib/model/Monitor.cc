@@ -26,6 +26,41 @@ Monitor::Monitor(string const &type, Node const *node)
 Monitor::~Monitor()
 {}
 
+void Monitor::update()
+{
+    unsigned int nchain = nodes()[0]->nchain();
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	update(ch);
+    }
+}
+
+void Monitor::update(unsigned int)
+{
+    throw logic_error("Monitor " + _type + " cannot be updated by chain");
+}
+
+void Monitor::rollback()
+{
+    unsigned int nchain = nodes()[0]->nchain();
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	rollback(ch);
+    }
+}
+
+void Monitor::rollback(unsigned int)
+{
+    throw logic_error("Monitor " + _type + " cannot be rolled back");
+}
+
+bool Monitor::updatesByChain() const
+{
+    return false;
+}
+
+void Monitor::setIterations(unsigned int, unsigned int)
+{
+}
+
 string const &Monitor::type() const
 {
     return _type;
@@ -56,6 +91,21 @@ void Monitor::setElementNames(vector<string> const &names)
     _elt_names = names;
 }
 
+void Monitor::values(unsigned int chain, unsigned long begin,
+		     unsigned long end, vector<double> &x) const
+{
+    vector<double> const &y = value(chain);
+    unsigned long nvar = product(dim());
+    unsigned long niter = y.size() / nvar;
+    unsigned long width = end - begin;
+
+    x.resize(niter * width);
+    for (unsigned long k = 0; k < niter; ++k) {
+	copy(y.begin() + k * nvar + begin, y.begin() + k * nvar + end,
+	     x.begin() + k * width);
+    }
+}
+
 SArray Monitor::dump(bool flat) const
 {
     unsigned int nchain = poolChains() ? 1 : nodes()[0]->nchain();
@@ -16,6 +16,7 @@ MonitorControl::MonitorControl (Monitor *monitor, unsigned int start,
    if (thin == 0) {
 	throw invalid_argument("Illegal thinning interval");
     }
+    _monitor->setIterations(start, thin);
 }
 
 unsigned int MonitorControl::start() const
@@ -43,17 +44,45 @@ Monitor const *MonitorControl::monitor() const
     return _monitor;
 }
 
+bool MonitorControl::isDue(unsigned int iteration) const
+{
+    return iteration >= _start && (iteration - _start) % _thin == 0;
+}
+
 void MonitorControl::update(unsigned int iteration)
 {
-    if (iteration < _start || (iteration - _start) % _thin != 0) {
-	return;
-    }
-    else {
-	_monitor->update();
+    if (isDue(iteration)) {
+	if (!_monitor->updatesByChain()) {
+	    _monitor->update();
+	}
 	_niter++;
     }
 }
 
+void MonitorControl::update(unsigned int iteration, unsigned int chain)
+{
+    if (_monitor->updatesByChain() && isDue(iteration)) {
+	_monitor->update(chain);
+    }
+}
+
+void MonitorControl::rollback(unsigned int iteration)
+{
+    if (isDue(iteration)) {
+	if (!_monitor->updatesByChain()) {
+	    _monitor->rollback();
+	}
+	_niter--;
+    }
+}
+
+void MonitorControl::rollback(unsigned int iteration, unsigned int chain)
+{
+    if (_monitor->updatesByChain() && isDue(iteration)) {
+	_monitor->rollback(chain);
+    }
+}
+
 bool MonitorControl::operator==(MonitorControl const &rhs) const
 {
     return (_monitor == rhs._monitor &&
@@ -0,0 +1,15 @@
+#include <config.h>
+#include <model/MonitorFactory.h>
+
+using std::string;
+
+namespace jags {
+
+Monitor *MonitorFactory::getMonitor(string const &name, Range const &range,
+				    BUGSModel *model, string const &type,
+				    string const &, string &msg)
+{
+    return getMonitor(name, range, model, type, msg);
+}
+
+} /* namespace jags */
@@ -4,6 +4,7 @@
 #include <graph/Node.h>
 #include <util/nainf.h>
 #include <util/dim.h>
+#include <sarray/RangeIterator.h>
 
 #include <string>
 #include <stdexcept>
@@ -170,6 +171,22 @@ string SymTab::getName(Node const *node) const
     return node->deparse(parnames);
 }
 
+vector<string> SymTab::getElementNames(Node const *node) const
+{
+    map<string, NodeArray*>::const_iterator p;
+    for (p = _varTable.begin(); p != _varTable.end(); ++p) {
+	Range node_range = p->second->getRange(node);
+	if (!isNULL(node_range)) {
+	    vector<string> names;
+	    for (RangeIterator i(node_range); !i.atEnd(); i.nextLeft()) {
+		names.push_back(p->first + printIndex(i));
+	    }
+	    return names;
+	}
+    }
+    return vector<string>(1, getName(node));
+}
+
     void SymTab::lock() {
 	map<string, NodeArray*>::iterator p;
 	for (p = _varTable.begin(); p != _varTable.end(); ++p) {
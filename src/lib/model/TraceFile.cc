@@ -0,0 +1,355 @@
+#include <config.h>
+#include <model/TraceFile.h>
+#include <model/Monitor.h>
+#include <util/dim.h>
+#include <util/binaryio.h>
+#include "CODA.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+using std::string;
+using std::vector;
+using std::list;
+using std::ofstream;
+using std::ostream;
+using std::ios;
+using std::runtime_error;
+using std::logic_error;
+using std::min;
+using std::max;
+using std::memcmp;
+using std::uint64_t;
+
+static const char TRACE_MAGIC[8] = {'J','A','G','S','B','I','N','\0'};
+static const uint64_t TRACE_BYTE_ORDER = 0x0102030405060708ULL;
+static const uint64_t TRACE_VERSION = 1;
+static const unsigned long POOL_CHAINS = 1;
+static const unsigned long POOL_ITERATIONS = 2;
+
+/* Maximum number of sampled values held in memory by the writer */
+static const unsigned long BINARY_BLOCK = 1048576;
+
+namespace jags {
+
+/* Serialization of the header */
+
+string TraceFile::fileHeader(unsigned long n)
+{
+    string out(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    putInt(TRACE_BYTE_ORDER, out);
+    putInt(TRACE_VERSION, out);
+    putInt(n, out);
+    return out;
+}
+
+string TraceFile::recordHeader(Record const &r)
+{
+    string out;
+    putString(r.name, out);
+    putString(r.type, out);
+    putInt(r.dim.size(), out);
+    for (unsigned int j = 0; j < r.dim.size(); ++j) {
+	putInt(r.dim[j], out);
+    }
+    putInt(r.nchain, out);
+    putInt(r.niter, out);
+    putInt(r.start, out);
+    putInt(r.thin, out);
+    putInt(r.flags, out);
+    putInt(r.offset, out);
+    if (!(r.flags & CONTINUED)) {
+	unsigned long nvar = product(r.dim);
+	for (unsigned long v = 0; v < nvar; ++v) {
+	    putString(v < r.elt_names.size() ? r.elt_names[v] : string(), out);
+	}
+    }
+    return out;
+}
+
+static TraceFile::Record makeRecord(MonitorControl const &control,
+				    unsigned int nchain)
+{
+    Monitor const *monitor = control.monitor();
+    TraceFile::Record r;
+    r.name = monitor->name();
+    r.type = monitor->type();
+    r.dim = monitor->dim();
+    r.nchain = monitor->poolChains() ? 1 : nchain;
+    r.niter = monitor->poolIterations() ? 1 : control.niter();
+    r.start = control.start();
+    r.thin = control.thin();
+    r.flags = 0;
+    if (monitor->poolChains()) r.flags |= POOL_CHAINS;
+    if (monitor->poolIterations()) r.flags |= POOL_ITERATIONS;
+    r.offset = 0;
+    r.elt_names = monitor->elementNames();
+    return r;
+}
+
+static void writeData(MonitorControl const &control, unsigned int nchain,
+		      ostream &out)
+{
+    /*
+       Writes the values of a monitor in columns, reading them in
+       blocks of elements to bound the memory required.
+    */
+    Monitor const *monitor = control.monitor();
+    if (monitor->poolChains()) nchain = 1;
+    unsigned long niter = monitor->poolIterations() ? 1 : control.niter();
+    unsigned long nvar = product(monitor->dim());
+
+    unsigned long block = BINARY_BLOCK / (nchain * max(niter, 1UL));
+    if (block == 0) block = 1;
+
+    vector<vector<double> > y(nchain);
+    vector<double> column(niter);
+    for (unsigned long begin = 0; begin < nvar; begin += block) {
+	unsigned long end = min(begin + block, nvar);
+	unsigned long width = end - begin;
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    monitor->values(ch, begin, end, y[ch]);
+	    if (y[ch].size() != niter * width) {
+		throw logic_error("Inconsistent number of iterations in Monitor");
+	    }
+	}
+	for (unsigned long v = 0; v < width; ++v) {
+	    for (unsigned int ch = 0; ch < nchain; ++ch) {
+		for (unsigned long k = 0; k < niter; ++k) {
+		    column[k] = y[ch][k * width + v];
+		}
+		out.write(reinterpret_cast<char const*>(column.data()),
+			  niter * sizeof(double));
+	    }
+	}
+    }
+}
+
+unsigned int BINARY(list<MonitorControl> const &mvec, string const &stem,
+		    unsigned int nchain, string &warn, string const &type)
+{
+    list<MonitorControl const*> dump;
+    for (list<MonitorControl>::const_iterator p = mvec.begin();
+	 p != mvec.end(); ++p)
+    {
+	if (type == "*" || type == p->monitor()->type()) {
+	    dump.push_back(&(*p));
+	}
+    }
+    if (dump.empty())
+	return 0;
+
+    /*
+       The size of the header does not depend on the offsets, so we
+       can calculate them before the header is written.
+    */
+    vector<TraceFile::Record> records;
+    unsigned long offset = TraceFile::fileHeader(dump.size()).size();
+    for (list<MonitorControl const*>::const_iterator p = dump.begin();
+	 p != dump.end(); ++p)
+    {
+	records.push_back(makeRecord(**p, nchain));
+	offset += TraceFile::recordHeader(records.back()).size();
+    }
+    offset = alignOffset(offset);
+    string header = TraceFile::fileHeader(records.size());
+    for (unsigned int i = 0; i < records.size(); ++i) {
+	TraceFile::Record &r = records[i];
+	r.offset = offset;
+	offset += product(r.dim) * r.nchain * r.niter * sizeof(double);
+	header.append(TraceFile::recordHeader(r));
+    }
+
+    string oname = stem + "trace.bin";
+    ofstream out(oname.c_str(), ios::binary);
+    if (!out) {
+	warn.append(string("Failed to open file ") + oname + "\n");
+	return 0;
+    }
+    out.write(header.data(), header.size());
+    string padding(records[0].offset - header.size(), '\0');
+    out.write(padding.data(), padding.size());
+    for (list<MonitorControl const*>::const_iterator p = dump.begin();
+	 p != dump.end(); ++p)
+    {
+	writeData(**p, nchain, out);
+    }
+    out.close();
+    if (!out) {
+	warn.append(string("Failed to write file ") + oname + "\n");
+	return 0;
+    }
+    return dump.size();
+}
+
+/* Reader */
+
+/*
+   Multiplies n by x, returning false if the product would exceed
+   limit. Sizes read from a corrupt file could otherwise overflow.
+*/
+static bool multiply(unsigned long &n, unsigned long x, unsigned long limit)
+{
+    if (x != 0 && n > limit / x) {
+	return false;
+    }
+    n *= x;
+    return true;
+}
+
+TraceFile::TraceFile(string const &file)
+    : _file(file)
+{
+    char const *data = _file.data();
+    unsigned long size = _file.size();
+    unsigned long pos = 0;
+    if (size < sizeof(TRACE_MAGIC) ||
+	memcmp(data, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0)
+    {
+	throw runtime_error(file + " is not a binary trace file");
+    }
+    pos += sizeof(TRACE_MAGIC);
+    if (getInt(data, size, pos) != TRACE_BYTE_ORDER) {
+	throw runtime_error(file + " was written with a different byte order");
+    }
+    if (getInt(data, size, pos) != TRACE_VERSION) {
+	throw runtime_error(file + " has an unsupported version");
+    }
+    uint64_t nmonitor = getInt(data, size, pos);
+    for (uint64_t i = 0; i < nmonitor; ++i) {
+	Record r;
+	r.name = getString(data, size, pos);
+	r.type = getString(data, size, pos);
+	uint64_t ndim = getInt(data, size, pos);
+	for (uint64_t j = 0; j < ndim; ++j) {
+	    r.dim.push_back(getInt(data, size, pos));
+	}
+	r.nchain = getInt(data, size, pos);
+	r.niter = getInt(data, size, pos);
+	r.start = getInt(data, size, pos);
+	r.thin = getInt(data, size, pos);
+	r.flags = getInt(data, size, pos);
+	r.offset = getInt(data, size, pos);
+	if (r.offset % sizeof(double) != 0 || r.offset > size) {
+	    throw runtime_error(string("Truncated data in ") + file);
+	}
+	/* Each element name takes at least 8 bytes of the header */
+	unsigned long nvar = 1;
+	for (unsigned long j = 0; j < r.dim.size(); ++j) {
+	    if (!multiply(nvar, r.dim[j], size / sizeof(uint64_t))) {
+		throw runtime_error(string("Invalid dimension in ") + file);
+	    }
+	}
+	unsigned long length = nvar;
+	unsigned long limit = (size - r.offset) / sizeof(double);
+	if (!multiply(length, r.nchain, limit) ||
+	    !multiply(length, r.niter, limit))
+	{
+	    throw runtime_error(string("Truncated data in ") + file);
+	}
+	if (r.flags & CONTINUED) {
+	    //Element names are those of the previous record
+	    if (i == 0 || _records.back().name != r.name ||
+		_records.back().dim != r.dim)
+	    {
+		throw runtime_error(string("Invalid continued record in ") +
+				    file);
+	    }
+	    r.elt_names = _records.back().elt_names;
+	}
+	else {
+	    for (unsigned long v = 0; v < nvar; ++v) {
+		r.elt_names.push_back(getString(data, size, pos));
+	    }
+	}
+	_records.push_back(r);
+    }
+}
+
+TraceFile::Record const &TraceFile::record(unsigned int i) const
+{
+    if (i >= _records.size()) {
+	throw logic_error("Invalid monitor index in TraceFile");
+    }
+    return _records[i];
+}
+
+unsigned int TraceFile::size() const
+{
+    return _records.size();
+}
+
+unsigned int TraceFile::find(string const &name) const
+{
+    for (unsigned int i = 0; i < _records.size(); ++i) {
+	if (_records[i].name == name) return i;
+    }
+    return _records.size();
+}
+
+string const &TraceFile::name(unsigned int i) const
+{
+    return record(i).name;
+}
+
+string const &TraceFile::type(unsigned int i) const
+{
+    return record(i).type;
+}
+
+vector<unsigned long> const &TraceFile::dim(unsigned int i) const
+{
+    return record(i).dim;
+}
+
+vector<string> const &TraceFile::elementNames(unsigned int i) const
+{
+    return record(i).elt_names;
+}
+
+unsigned int TraceFile::nchain(unsigned int i) const
+{
+    return record(i).nchain;
+}
+
+unsigned long TraceFile::niter(unsigned int i) const
+{
+    return record(i).niter;
+}
+
+unsigned long TraceFile::start(unsigned int i) const
+{
+    return record(i).start;
+}
+
+unsigned long TraceFile::thin(unsigned int i) const
+{
+    return record(i).thin;
+}
+
+bool TraceFile::poolChains(unsigned int i) const
+{
+    return record(i).flags & POOL_CHAINS;
+}
+
+bool TraceFile::poolIterations(unsigned int i) const
+{
+    return record(i).flags & POOL_ITERATIONS;
+}
+
+double const *TraceFile::column(unsigned int i, unsigned long v,
+				unsigned int chain) const
+{
+    Record const &r = record(i);
+    if (v >= r.elt_names.size() || chain >= r.nchain) {
+	throw logic_error("Invalid column in TraceFile");
+    }
+    unsigned long col = v * r.nchain + chain;
+    return reinterpret_cast<double const*>(_file.data() + r.offset) +
+	col * r.niter;
+}
+
+} /* namespace jags */
@@ -22,6 +22,27 @@ double RNG::fixup(double x)
     return x;
 }
 
+void RNG::uniform(double *x, unsigned long n)
+{
+    for (unsigned long i = 0; i < n; ++i) {
+	x[i] = uniform();
+    }
+}
+
+void RNG::normal(double *x, unsigned long n)
+{
+    for (unsigned long i = 0; i < n; ++i) {
+	x[i] = normal();
+    }
+}
+
+void RNG::exponential(double *x, unsigned long n)
+{
+    for (unsigned long i = 0; i < n; ++i) {
+	x[i] = exponential();
+    }
+}
+
 string const &RNG::name() const
 {
    return _name;
@@ -0,0 +1,13 @@
+#include <config.h>
+#include <rng/RNGFactory.h>
+
+using std::string;
+
+namespace jags {
+
+RNG *RNGFactory::makeRNG(string const &name, unsigned int)
+{
+    return makeRNG(name);
+}
+
+} /* namespace jags */
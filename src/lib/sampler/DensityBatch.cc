@@ -0,0 +1,143 @@
+#include <config.h>
+#include <sampler/DensityBatch.h>
+#include <graph/ScalarStochasticNode.h>
+#include <distribution/ScalarDist.h>
+
+#include <map>
+
+using std::vector;
+using std::map;
+
+/* Smallest group of nodes worth evaluating as a batch */
+static const unsigned long MIN_BATCH = 2;
+
+namespace jags {
+
+DensityBatch::DensityBatch(ScalarDist const *dist,
+			   vector<StochasticNode const *> const &nodes)
+    : _dist(dist), _nodes(nodes), _fixnorm(true)
+{
+    unsigned long n = nodes.size();
+    unsigned long npar = dist->npar();
+    unsigned int nchain = nodes.empty() ? 0 : nodes[0]->nchain();
+
+    _address.resize(nchain);
+    _work.resize(nchain);
+    _par.resize(nchain);
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	vector<double const *> &address = _address[ch];
+	address.resize(n * (npar + 1));
+	for (unsigned long i = 0; i < n; ++i) {
+	    address[i] = nodes[i]->value(ch);
+	    vector<Node const *> const &par = nodes[i]->parents();
+	    for (unsigned long j = 0; j < npar; ++j) {
+		address[n * (j + 1) + i] = par[j]->value(ch);
+	    }
+	}
+	//Values and parameters, followed by the densities
+	_work[ch].resize(n * (npar + 2));
+	_par[ch].resize(npar);
+    }
+
+    for (unsigned long i = 0; i < n; ++i) {
+	ScalarStochasticNode const *snode =
+	    dynamic_cast<ScalarStochasticNode const *>(nodes[i]);
+	if (!snode || !snode->isNormalizationFixed()) {
+	    _fixnorm = false;
+	    break;
+	}
+    }
+}
+
+vector<StochasticNode const *> const &DensityBatch::nodes() const
+{
+    return _nodes;
+}
+
+double DensityBatch::logDensity(unsigned int chain, PDFType type) const
+{
+    vector<double const *> const &address = _address[chain];
+    vector<double> &work = _work[chain];
+    vector<double const *> &par = _par[chain];
+    unsigned long n = _nodes.size();
+    unsigned long m = address.size();
+
+    for (unsigned long k = 0; k < m; ++k) {
+	work[k] = *address[k];
+    }
+    for (unsigned long j = 0; j < par.size(); ++j) {
+	par[j] = &work[n * (j + 1)];
+    }
+
+    double *density = &work[m];
+    if (type == PDF_LIKELIHOOD && _fixnorm) {
+	_dist->batchLogKernel(density, &work[0], n, par);
+    }
+    else {
+	_dist->batchLogDensity(density, &work[0], n, type, par);
+    }
+
+    double lp = 0;
+    for (unsigned long i = 0; i < n; ++i) {
+	lp += density[i];
+    }
+    return lp;
+}
+
+bool DensityBatch::canBatch(StochasticNode const *node)
+{
+    if (node->length() != 1 || node->lowerBound() || node->upperBound())
+	return false;
+
+    ScalarDist const *dist =
+	dynamic_cast<ScalarDist const *>(node->distribution());
+    return dist && dist->hasBatchLogDensity() &&
+	node->parents().size() == dist->npar();
+}
+
+void DensityBatch::makeBatches(vector<StochasticNode *> const &nodes,
+			       vector<DensityBatch> &batches,
+			       vector<StochasticNode *> &other)
+{
+    vector<ScalarDist const *> dists;
+    vector<vector<StochasticNode const *> > groups;
+    map<ScalarDist const *, unsigned long> index;
+
+    for (unsigned long i = 0; i < nodes.size(); ++i) {
+	if (!canBatch(nodes[i])) continue;
+	ScalarDist const *dist =
+	    dynamic_cast<ScalarDist const *>(nodes[i]->distribution());
+	map<ScalarDist const *, unsigned long>::const_iterator p =
+	    index.find(dist);
+	if (p == index.end()) {
+	    index[dist] = groups.size();
+	    dists.push_back(dist);
+	    groups.push_back(vector<StochasticNode const *>(1, nodes[i]));
+	}
+	else {
+	    groups[p->second].push_back(nodes[i]);
+	}
+    }
+
+    batches.clear();
+    for (unsigned long g = 0; g < groups.size(); ++g) {
+	if (groups[g].size() >= MIN_BATCH) {
+	    batches.push_back(DensityBatch(dists[g], groups[g]));
+	}
+    }
+
+    other.clear();
+    for (unsigned long i = 0; i < nodes.size(); ++i) {
+	bool batched = false;
+	if (canBatch(nodes[i])) {
+	    ScalarDist const *dist =
+		dynamic_cast<ScalarDist const *>(nodes[i]->distribution());
+	    batched = groups[index[dist]].size() >= MIN_BATCH;
+	}
+	if (!batched) {
+	    other.push_back(nodes[i]);
+	}
+    }
+}
+
+} /* namespace jags */
@@ -7,6 +7,7 @@
 
 #include <stdexcept>
 #include <set>
+#include <map>
 #include <list>
 #include <string>
 #include <cmath>
@@ -14,6 +15,9 @@
 
 using std::vector;
 using std::set;
+using std::map;
+using std::pair;
+using std::fill;
 using std::list;
 using std::runtime_error;
 using std::logic_error;
@@ -22,6 +26,8 @@ using std::copy;
 using std::fpclassify;
 using std::isnan;
 using std::isfinite;
+using std::fabs;
+using std::max;
 
 static unsigned int sumLength(vector<jags::StochasticNode *> const &nodes)
 {
@@ -38,7 +44,8 @@ namespace jags {
 GraphView::GraphView(vector<StochasticNode *> const &nodes, Graph const &graph,
 		     bool multilevel)
     : _length(sumLength(nodes)), _nodes(nodes), _stoch_children(0),
-      _determ_children(0), _multilevel(false)
+      _determ_children(0), _multilevel(false), _adjoint_length(0),
+      _jacobian_length(0)
 {
     //Sanity check on node
     //FIXME: Could use a templated version of countChains here
@@ -49,6 +56,8 @@ GraphView::GraphView(vector<StochasticNode *> const &nodes, Graph const &graph,
     }
     classifyChildren(nodes, graph, _stoch_children, _determ_children,
 		     multilevel);
+    DensityBatch::makeBatches(_stoch_children, _batches, _unbatched);
+    setAdjointLinks();
 }
 
 vector<StochasticNode *> const &GraphView::nodes() const
@@ -91,14 +100,14 @@ static bool classifyNode(DeterministicNode *dnode,
 	return true;
     
     bool informative = false;
-    list<StochasticNode*>::const_iterator p; 
+    ChildList<StochasticNode>::const_iterator p; 
     for (p = dnode->stochasticChildren()->begin(); 
 	 p != dnode->stochasticChildren()->end(); ++p)
     {
 	if (classifyNode(*p, sample_graph, sset, slist))
 	    informative = true;
     }
-    list<DeterministicNode*>::const_iterator q;
+    ChildList<DeterministicNode>::const_iterator q;
     for (q = dnode->deterministicChildren()->begin();
 	 q != dnode->deterministicChildren()->end(); ++q)
     {
@@ -130,14 +139,15 @@ void GraphView::classifyChildren(vector<StochasticNode *> const &nodes,
 	if (!graph.contains(*p)) {
 	    throw logic_error("Sampled node outside of sampling graph");
 	}
-	list<StochasticNode*> const *sch = (*p)->stochasticChildren();
-	for (list<StochasticNode*>::const_iterator q = sch->begin();
+	ChildList<StochasticNode> const *sch = (*p)->stochasticChildren();
+	for (ChildList<StochasticNode>::const_iterator q = sch->begin();
 	     q != sch->end(); ++q)
 	{
 	    classifyNode(*q, graph, sset, slist);
 	}
-	list<DeterministicNode*> const *dch = (*p)->deterministicChildren();
-	for (list<DeterministicNode*>::const_iterator q = dch->begin();
+	ChildList<DeterministicNode> const *dch = 
+	    (*p)->deterministicChildren();
+	for (ChildList<DeterministicNode>::const_iterator q = dch->begin();
 	     q != dch->end(); ++q)
 	{
 	    classifyNode(*q, graph, sset, slist, dset, dlist);
@@ -203,11 +213,7 @@ double GraphView::logFullConditional(unsigned int chain) const
 	lprior += (*p)->logDensity(chain, pdf_prior);
     }
   
-    double llike = 0.0;
-    vector<StochasticNode *>::const_iterator q = _stoch_children.begin();
-    for (; q != _stoch_children.end(); ++q) {
-	llike += (*q)->logDensity(chain, PDF_LIKELIHOOD);
-    }
+    double llike = logChildDensity(chain);
 
     double lfc = lprior + llike;
     if(isnan(lfc)) {
@@ -239,6 +245,7 @@ double GraphView::logFullConditional(unsigned int chain) const
 	}
 
 	//Check likelihood
+	vector<StochasticNode *>::const_iterator q;
 	for (q = _stoch_children.begin(); q != _stoch_children.end(); ++q) {
 	    if (isnan((*q)->logDensity(chain, PDF_LIKELIHOOD))) {
 		throw NodeError(*q, "Failure to calculate log density");
@@ -260,6 +267,23 @@ double GraphView::logFullConditional(unsigned int chain) const
     return lfc;
 }
 
+double GraphView::logChildDensity(unsigned int chain) const
+{
+    /* 
+       Log likelihood contribution of the stochastic children.
+       Children that share a distribution are evaluated in batches.
+    */
+    double llik = 0.0;
+    for (unsigned int b = 0; b < _batches.size(); ++b) {
+	llik += _batches[b].logDensity(chain, PDF_LIKELIHOOD);
+    }
+    vector<StochasticNode *>::const_iterator q = _unbatched.begin();
+    for (; q != _unbatched.end(); ++q) {
+	llik += (*q)->logDensity(chain, PDF_LIKELIHOOD);
+    }
+    return llik;
+}
+
 double GraphView::logPrior(unsigned int chain) const
 {
     //In a multi-level GraphView we need to calculate the full log
@@ -287,15 +311,11 @@ double GraphView::logPrior(unsigned int chain) const
 
 double GraphView::logLikelihood(unsigned int chain) const
 {
-    double llik = 0.0;
-
-    vector<StochasticNode *>::const_iterator q = _stoch_children.begin();
-    for (; q != _stoch_children.end(); ++q) {
-	llik += (*q)->logDensity(chain, PDF_LIKELIHOOD);
-    }
+    double llik = logChildDensity(chain);
   
     if(isnan(llik)) {
 	//Try to find where the calculation went wrong
+	vector<StochasticNode *>::const_iterator q;
 	for (q = _stoch_children.begin(); q != _stoch_children.end(); ++q) {
 	    if (isnan((*q)->logDensity(chain, PDF_LIKELIHOOD))) {
 		throw NodeError(*q, "Failure to calculate log likelihood");
@@ -309,6 +329,172 @@ double GraphView::logLikelihood(unsigned int chain) const
     return llik;
 }
 
+bool GraphView::hasGradient() const
+{
+    for (unsigned int i = 0; i < _determ_children.size(); ++i) {
+	DeterministicNode const *dnode = _determ_children[i];
+	vector<Node const *> const &par = dnode->parents();
+	for (unsigned int j = 0; j < par.size(); ++j) {
+	    if (isDependent(par[j]) && !dnode->hasGradient(par[j]))
+		return false;
+	}
+    }
+
+    //In a multilevel GraphView, the prior densities of the sampled
+    //nodes may also depend on other sampled nodes
+    vector<StochasticNode*> snodes(_stoch_children);
+    snodes.insert(snodes.end(), _nodes.begin(), _nodes.end());
+    for (unsigned int i = 0; i < snodes.size(); ++i) {
+	vector<Node const *> const &par = snodes[i]->parents();
+	for (unsigned int j = 0; j < par.size(); ++j) {
+	    if (isDependent(par[j]) && !snodes[i]->hasScore(par[j]))
+		return false;
+	}
+    }
+    for (unsigned int i = 0; i < _nodes.size(); ++i) {
+	if (!_nodes[i]->hasValueScore())
+	    return false;
+    }
+    return true;
+}
+
+static void addLinks(Node const *node,
+		     map<Node const*, unsigned long> const &offset,
+		     vector<pair<unsigned int, unsigned long> > &links)
+{
+    /* 
+       Records the index of each distinct parent of node that has an
+       adjoint, together with the offset of the adjoint
+    */
+    vector<Node const *> const &par = node->parents();
+    for (unsigned int j = 0; j < par.size(); ++j) {
+	map<Node const*, unsigned long>::const_iterator o = offset.find(par[j]);
+	if (o == offset.end()) continue;
+	bool seen = false;
+	for (unsigned int k = 0; k < j; ++k) {
+	    if (par[k] == par[j]) {
+		seen = true;
+		break;
+	    }
+	}
+	if (!seen) links.push_back(pair<unsigned int, unsigned long>(j, o->second));
+    }
+}
+
+void GraphView::setAdjointLinks()
+{
+    /*
+       Adjoints are stored in a single array: first the sampled nodes,
+       in the same order as the values used by getValue and setValue,
+       then their deterministic children.
+    */
+    map<Node const*, unsigned long> offset;
+    unsigned long n = 0;
+    for (unsigned int i = 0; i < _nodes.size(); ++i) {
+	offset[_nodes[i]] = n;
+	n += _nodes[i]->length();
+    }
+    for (unsigned int i = 0; i < _determ_children.size(); ++i) {
+	offset[_determ_children[i]] = n;
+	_determ_offset.push_back(n);
+	n += _determ_children[i]->length();
+    }
+
+    _score_links.resize(_stoch_children.size() + _nodes.size());
+    for (unsigned int i = 0; i < _stoch_children.size(); ++i) {
+	addLinks(_stoch_children[i], offset, _score_links[i]);
+    }
+    if (_multilevel) {
+	for (unsigned int i = 0; i < _nodes.size(); ++i) {
+	    addLinks(_nodes[i], offset,
+		     _score_links[_stoch_children.size() + i]);
+	}
+    }
+
+    unsigned long njac = 0;
+    _gradient_links.resize(_determ_children.size());
+    for (unsigned int i = 0; i < _determ_children.size(); ++i) {
+	DeterministicNode const *dnode = _determ_children[i];
+	addLinks(dnode, offset, _gradient_links[i]);
+	vector<Node const *> const &par = dnode->parents();
+	for (unsigned int k = 0; k < _gradient_links[i].size(); ++k) {
+	    Node const *parent = par[_gradient_links[i][k].first];
+	    njac = max(njac, dnode->gradientWorkLength(parent));
+	}
+    }
+
+    _adjoint_length = n;
+    _jacobian_length = njac;
+
+    //Work space is allocated on first use
+    unsigned int nch = _nodes.empty() ? 0 : _nodes[0]->nchain();
+    _adjoint.resize(nch);
+    _jacobian.resize(nch);
+}
+
+void GraphView::logFullConditionalGradient(unsigned int chain,
+					   double *grad) const
+{
+    /* 
+       Adjoints are the derivatives of the log full conditional
+       with respect to the values of the sampled nodes and their
+       deterministic children.
+    */
+    vector<double> &adjoint = _adjoint[chain];
+    if (adjoint.empty()) {
+	adjoint.resize(_adjoint_length);
+	_jacobian[chain].resize(_jacobian_length);
+    }
+    fill(adjoint.begin(), adjoint.end(), 0.0);
+
+    for (unsigned int i = 0; i < _score_links.size(); ++i) {
+	vector<pair<unsigned int, unsigned long> > const &links =
+	    _score_links[i];
+	if (links.empty()) continue;
+	StochasticNode const *snode = i < _stoch_children.size() ?
+	    _stoch_children[i] : _nodes[i - _stoch_children.size()];
+	vector<Node const *> const &par = snode->parents();
+	for (unsigned int k = 0; k < links.size(); ++k) {
+	    snode->score(&adjoint[links[k].second], par[links[k].first],
+			 chain);
+	}
+    }
+
+    //Propagate adjoints back through the deterministic children 
+    double *J = _jacobian[chain].empty() ? 0 : &_jacobian[chain][0];
+    for (unsigned int i = _determ_children.size(); i > 0; --i) {
+	DeterministicNode const *dnode = _determ_children[i-1];
+	double const *a = &adjoint[_determ_offset[i-1]];
+	unsigned long len = dnode->length();
+	bool zero = true;
+	for (unsigned long l = 0; l < len; ++l) {
+	    if (a[l] != 0) {
+		zero = false;
+		break;
+	    }
+	}
+	if (zero) continue;
+	
+	vector<Node const *> const &par = dnode->parents();
+	vector<pair<unsigned int, unsigned long> > const &links =
+	    _gradient_links[i-1];
+	for (unsigned int k = 0; k < links.size(); ++k) {
+	    dnode->gradientProduct(&adjoint[links[k].second], a,
+				   par[links[k].first], chain, J);
+	}
+    }
+
+    //Derivative of the prior density of each sampled node with
+    //respect to its own value
+    double *a = &adjoint[0];
+    for (unsigned int i = 0; i < _nodes.size(); ++i) {
+	_nodes[i]->valueScore(a, chain);
+	a += _nodes[i]->length();
+    }
+
+    copy(adjoint.begin(), adjoint.begin() + _length, grad);
+}
+
 vector<StochasticNode *> const &GraphView::stochasticChildren() const
 {
   return _stoch_children;
@@ -9,9 +9,14 @@
 #include <graph/LinkNode.h>
 #include <graph/Node.h>
 
+#include <algorithm>
+
 using std::vector;
 using std::set;
 using std::list;
+using std::sort;
+using std::unique;
+using std::lower_bound;
 
 namespace jags {
 
@@ -107,11 +112,12 @@ bool checkLinear(GraphView const *gv, bool fixed, bool link)
 	    // A link function is allowed if no other deterministic
 	    // nodes in the GraphView depend on it.
 	    set<DeterministicNode*> dset;
-	    list<DeterministicNode*> const *dc = dn[j]->deterministicChildren();
+	    ChildList<DeterministicNode> const *dc = 
+		dn[j]->deterministicChildren();
 #ifndef _RWSTD_NO_MEMBER_TEMPLATES
 	    dset.insert(dc->begin(), dc->end());
 #else
-	    for (list<DeterministicNode*>::const_iterator p = dc->begin(); 
+	    for (ChildList<DeterministicNode>::const_iterator p = dc->begin(); 
 		 p != dc->end(); ++p) 
             {
 	        dset.insert(*p);
@@ -131,6 +137,140 @@ bool checkLinear(GraphView const *gv, bool fixed, bool link)
     return true;
 }
 
+bool checkLinearCoef(GraphView const *gv, bool link)
+{
+    if (!checkLinear(gv, false, link)) return false;
+
+    set<Node const*> dependents;
+    dependents.insert(gv->nodes().begin(), gv->nodes().end());
+
+    vector<DeterministicNode *> const &dn = gv->deterministicChildren();
+    for (unsigned int j = 0; j < dn.size(); ++j) {
+	if (isLink(dn[j])) continue;
+	vector<Node const *> const &par = dn[j]->parents();
+	for (unsigned int k = 0; k < par.size(); ++k) {
+	    if (dependents.count(par[k]) && !dn[j]->hasGradient(par[k])) {
+		return false;
+	    }
+	}
+	dependents.insert(dn[j]);
+    }
+    return true;
+}
+
+typedef std::pair<Node const*, unsigned long> NodeOffset;
+
+static bool lessNode(NodeOffset const &a, NodeOffset const &b)
+{
+    return a.first < b.first;
+}
+
+static double *findJacobian(vector<NodeOffset> const &offset,
+			    vector<double> &jac, Node const *node)
+{
+    vector<NodeOffset>::const_iterator p =
+	lower_bound(offset.begin(), offset.end(), NodeOffset(node, 0),
+		    lessNode);
+    if (p == offset.end() || p->first != node) return nullptr;
+    return &jac[p->second];
+}
+
+void linearCoef(GraphView const *gv, vector<Node const *> const &nodes,
+		unsigned int chain, vector<double> &coef)
+{
+    unsigned long ncol = gv->length();
+    vector<StochasticNode *> const &snodes = gv->nodes();
+    vector<DeterministicNode *> const &dn = gv->deterministicChildren();
+
+    /*
+       The Jacobian of each node in the GraphView with respect to the
+       sampled nodes is stored in column-major order in a single
+       buffer. A sorted vector gives the offset of each node in the
+       buffer.
+    */
+    vector<NodeOffset> offset;
+    offset.reserve(snodes.size() + dn.size());
+    unsigned long size = 0;
+    for (unsigned int i = 0; i < snodes.size(); ++i) {
+	offset.push_back(NodeOffset(snodes[i], size));
+	size += snodes[i]->length() * ncol;
+    }
+    for (unsigned int j = 0; j < dn.size(); ++j) {
+	if (isLink(dn[j])) continue;
+	offset.push_back(NodeOffset(dn[j], size));
+	size += dn[j]->length() * ncol;
+    }
+    sort(offset.begin(), offset.end(), lessNode);
+    vector<double> jac(size, 0.0);
+
+    //Sampled nodes are identity functions of themselves
+    unsigned long c = 0;
+    for (unsigned int i = 0; i < snodes.size(); ++i) {
+	unsigned long len = snodes[i]->length();
+	double *J = findJacobian(offset, jac, snodes[i]);
+	for (unsigned long l = 0; l < len; ++l) {
+	    J[l + len * (c + l)] = 1;
+	}
+	c += len;
+    }
+
+    //Chain rule, in topological order
+    vector<double> grad;
+    vector<Node const *> dpar;
+    for (unsigned int j = 0; j < dn.size(); ++j) {
+	if (isLink(dn[j])) continue;
+	unsigned long len = dn[j]->length();
+	double *J = findJacobian(offset, jac, dn[j]);
+
+	//Parents that depend on the sampled nodes, each counted once
+	//as the gradient already sums over repeated arguments
+	vector<Node const *> const &par = dn[j]->parents();
+	dpar.clear();
+	for (unsigned int k = 0; k < par.size(); ++k) {
+	    if (findJacobian(offset, jac, par[k])) dpar.push_back(par[k]);
+	}
+	if (dpar.size() > 1) {
+	    sort(dpar.begin(), dpar.end());
+	    dpar.erase(unique(dpar.begin(), dpar.end()), dpar.end());
+	}
+
+	for (unsigned int k = 0; k < dpar.size(); ++k) {
+	    double const *Jp = findJacobian(offset, jac, dpar[k]);
+	    unsigned long plen = dpar[k]->length();
+	    grad.assign(len * plen, 0.0);
+	    dn[j]->gradient(&grad[0], dpar[k], chain);
+	    for (unsigned long col = 0; col < ncol; ++col) {
+		for (unsigned long q = 0; q < plen; ++q) {
+		    double t = Jp[q + plen * col];
+		    if (t == 0) continue;
+		    for (unsigned long l = 0; l < len; ++l) {
+			J[l + len * col] += grad[l + len * q] * t;
+		    }
+		}
+	    }
+	}
+    }
+
+    unsigned long nrow = 0;
+    for (unsigned int i = 0; i < nodes.size(); ++i) {
+	nrow += nodes[i]->length();
+    }
+    coef.assign(nrow * ncol, 0.0);
+    unsigned long r = 0;
+    for (unsigned int i = 0; i < nodes.size(); ++i) {
+	unsigned long len = nodes[i]->length();
+	double const *J = findJacobian(offset, jac, nodes[i]);
+	if (J) {
+	    for (unsigned long col = 0; col < ncol; ++col) {
+		for (unsigned long l = 0; l < len; ++l) {
+		    coef[r + l + nrow * col] = J[l + len * col];
+		}
+	    }
+	}
+	r += len;
+    }
+}
+
 bool checkScale(GraphView const *gv, bool fixed)
 {
     vector<DeterministicNode *> const &dnodes = gv->deterministicChildren();
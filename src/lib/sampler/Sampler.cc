@@ -21,4 +21,9 @@ vector<StochasticNode*> const &Sampler::nodes() const
     return _gv->nodes();
 }
 
+GraphView const *Sampler::graphView() const
+{
+    return _gv;
+}
+
 } //namespace jags
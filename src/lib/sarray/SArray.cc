@@ -4,6 +4,7 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <utility>
 
 using std::vector;
 using std::logic_error;
@@ -25,6 +26,13 @@ SArray::SArray(SArray const &orig)
 {
 }
 
+SArray::SArray(SArray &&orig)
+    : _range(orig._range), _value(std::move(orig._value)),
+      _discrete(orig._discrete), _s_dimnames(std::move(orig._s_dimnames)),
+      _dimnames(std::move(orig._dimnames))
+{
+}
+
 SimpleRange const &SArray::range() const
 {
     return _range;
@@ -41,6 +49,17 @@ void SArray::setValue(vector<double> const &x)
     }
 }
 
+void SArray::setValue(vector<double> &&x)
+{
+    if (x.size() != _value.size()) {
+	throw length_error("Length mismatch error in SArray::setValue");
+    }
+    else {
+	_value.swap(x);
+	_discrete = false;
+    }
+}
+
 void SArray::setValue(double value, unsigned long i)
 {
     if (i >= _range.length()) {
@@ -1,8 +1,11 @@
 #include <testlib.h>
+#include <sampler/GraphView.h>
+
 #include <cfloat>
 #include <cmath>
 
 using std::sqrt;
+using std::vector;
 
 JAGSFixture::JAGSFixture()
     : tol(sqrt(DBL_EPSILON)), 
@@ -27,3 +30,25 @@ JAGSFixture::JAGSFixture()
     TTF[0] = true; TTF[1] = true; TTF[2] = false;
     TTT[0] = true; TTT[1] = true; TTT[2] = true;
 }
+
+vector<double> 
+numLogFullConditionalGradient(jags::GraphView const *gv, unsigned int chain,
+			      double delta)
+{
+    unsigned int N = gv->length();
+    vector<double> x(N), grad(N);
+    gv->getValue(x, chain);
+    for (unsigned int i = 0; i < N; ++i) {
+	double xi = x[i];
+	x[i] = xi + delta;
+	gv->setValue(x, chain);
+	double lp1 = gv->logFullConditional(chain);
+	x[i] = xi - delta;
+	gv->setValue(x, chain);
+	double lp0 = gv->logFullConditional(chain);
+	x[i] = xi;
+	grad[i] = (lp1 - lp0) / (2 * delta);
+    }
+    gv->setValue(x, chain);
+    return grad;
+}
@@ -15,4 +15,9 @@ namespace jags {
     {
 	return _active;
     }
+
+    bool Factory::setOption(std::string const &, double)
+    {
+	return false;
+    }
 }
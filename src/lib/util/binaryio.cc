@@ -0,0 +1,123 @@
+#include <config.h>
+#include <util/binaryio.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+#define USE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using std::string;
+using std::ifstream;
+using std::ios;
+using std::runtime_error;
+using std::memcpy;
+using std::uint64_t;
+
+namespace jags {
+
+    void putInt(uint64_t x, string &out)
+    {
+	out.append(reinterpret_cast<char const*>(&x), sizeof(x));
+    }
+
+    void putString(string const &s, string &out)
+    {
+	putInt(s.size(), out);
+	out.append(s);
+    }
+
+    uint64_t getInt(char const *data, unsigned long size, unsigned long &pos)
+    {
+	if (pos + sizeof(uint64_t) > size) {
+	    throw runtime_error("Truncated header in binary file");
+	}
+	uint64_t x;
+	memcpy(&x, data + pos, sizeof(x));
+	pos += sizeof(x);
+	return x;
+    }
+
+    string getString(char const *data, unsigned long size, unsigned long &pos)
+    {
+	uint64_t n = getInt(data, size, pos);
+	if (n > size - pos) {
+	    throw runtime_error("Truncated header in binary file");
+	}
+	string s(data + pos, n);
+	pos += n;
+	return s;
+    }
+
+    unsigned long alignOffset(unsigned long offset)
+    {
+	return (offset + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+    }
+
+    MappedFile::MappedFile(string const &file)
+	: _data(nullptr), _size(0), _mapped(false)
+    {
+#ifdef USE_MMAP
+	int fd = open(file.c_str(), O_RDONLY);
+	if (fd < 0) {
+	    throw runtime_error(string("Failed to open file ") + file);
+	}
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+	    void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED,
+			      fd, 0);
+	    if (addr != MAP_FAILED) {
+		_data = static_cast<char const*>(addr);
+		_size = st.st_size;
+		_mapped = true;
+	    }
+	}
+	close(fd);
+#endif
+	if (!_mapped) {
+	    ifstream in(file.c_str(), ios::binary);
+	    if (!in) {
+		throw runtime_error(string("Failed to open file ") + file);
+	    }
+	    in.seekg(0, ios::end);
+	    _size = in.tellg();
+	    in.seekg(0, ios::beg);
+	    /* Allocate doubles so that values are aligned */
+	    double *buffer = new double[_size / sizeof(double) + 1];
+	    in.read(reinterpret_cast<char*>(buffer), _size);
+	    if (!in) {
+		delete [] buffer;
+		throw runtime_error(string("Failed to read file ") + file);
+	    }
+	    _data = reinterpret_cast<char const*>(buffer);
+	}
+    }
+
+    MappedFile::~MappedFile()
+    {
+#ifdef USE_MMAP
+	if (_mapped) {
+	    munmap(const_cast<char*>(_data), _size);
+	    return;
+	}
+#endif
+	delete [] reinterpret_cast<double const*>(_data);
+    }
+
+    char const *MappedFile::data() const
+    {
+	return _data;
+    }
+
+    unsigned long MappedFile::size() const
+    {
+	return _size;
+    }
+
+} /* namespace jags */
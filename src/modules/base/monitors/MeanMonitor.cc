@@ -15,28 +15,45 @@ namespace base {
     MeanMonitor::MeanMonitor(NodeArraySubset const &subset)
 	: Monitor("mean", subset.nodes()), _subset(subset),
 	  _values(subset.nchain(), vector<double>(subset.length())),
-	  _n(0)
+	  _n(subset.nchain(), 0)
     {
 	
     }
     
-    void MeanMonitor::update()
-    {
-	_n++;
-	for (unsigned int ch = 0; ch < _values.size(); ++ch) {
-	    vector<double> value = _subset.value(ch);
-	    vector<double> &rmean  = _values[ch];
-	    for (unsigned int i = 0; i < value.size(); ++i) {
-		if (jags_isna(value[i])) {
-		    rmean[i] = JAGS_NA;
-		}
-		else {
-		    rmean[i] -= (rmean[i] - value[i])/_n;
-		}
+    void MeanMonitor::update(unsigned int chain)
+    {
+	unsigned int n = ++_n[chain];
+	vector<double> value = _subset.value(chain);
+	vector<double> &rmean  = _values[chain];
+	for (unsigned int i = 0; i < value.size(); ++i) {
+	    if (jags_isna(value[i])) {
+		rmean[i] = JAGS_NA;
+	    }
+	    else {
+		rmean[i] -= (rmean[i] - value[i])/n;
 	    }
 	}
     }
 
+    void MeanMonitor::rollback(unsigned int chain)
+    {
+	// The node values are unchanged since the last update, so the
+	// previous running mean can be recovered from them
+	unsigned int n = _n[chain]--;
+	vector<double> value = _subset.value(chain);
+	vector<double> &rmean = _values[chain];
+	for (unsigned int i = 0; i < value.size(); ++i) {
+	    if (!jags_isna(rmean[i])) {
+		rmean[i] = n > 1 ? (n * rmean[i] - value[i]) / (n - 1) : 0;
+	    }
+	}
+    }
+
+    bool MeanMonitor::updatesByChain() const
+    {
+	return true;
+    }
+
     vector<double> const &MeanMonitor::value(unsigned int chain) const
     {
 	return _values[chain];
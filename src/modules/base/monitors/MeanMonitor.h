@@ -15,10 +15,12 @@ namespace base {
     class MeanMonitor : public Monitor {
 	NodeArraySubset _subset;
 	std::vector<std::vector<double> > _values; // sampled values
-	unsigned int _n;
+	std::vector<unsigned int> _n;
     public:
 	MeanMonitor(NodeArraySubset const &subset);
-	void update() override;
+	void update(unsigned int chain) override;
+	void rollback(unsigned int chain) override;
+	bool updatesByChain() const override;
 	std::vector<double> const &value(unsigned int chain) const override;
 	std::vector<unsigned long> dim() const override;
 	bool poolChains() const override;
@@ -14,34 +14,65 @@ namespace base {
 
     PoolMeanMonitor::PoolMeanMonitor(NodeArraySubset const &subset)
 	: Monitor("poolmean", subset.nodes()), _subset(subset),
-	  _values(subset.length()),
-	  _n(0)
+	  _means(subset.nchain(), vector<double>(subset.length())),
+	  _n(subset.nchain(), 0),
+	  _values(subset.length())
     {
-	
     }
-    
-    void PoolMeanMonitor::update()
-    {
 
-		for (unsigned int ch = 0; ch < _subset.nchain(); ++ch) {
+    void PoolMeanMonitor::update(unsigned int chain)
+    {
+	unsigned int n = ++_n[chain];
+	vector<double> value = _subset.value(chain);
+	vector<double> &rmean = _means[chain];
+	for (unsigned int i = 0; i < value.size(); ++i) {
+	    if (jags_isna(value[i])) {
+		rmean[i] = JAGS_NA;
+	    }
+	    else {
+		rmean[i] -= (rmean[i] - value[i])/n;
+	    }
+	}
+    }
 
-			// Each chain counts as an iteration:
-			_n++;
+    void PoolMeanMonitor::rollback(unsigned int chain)
+    {
+	// The node values are unchanged since the last update, so the
+	// previous running mean can be recovered from them
+	unsigned int n = _n[chain]--;
+	vector<double> value = _subset.value(chain);
+	vector<double> &rmean = _means[chain];
+	for (unsigned int i = 0; i < value.size(); ++i) {
+	    if (!jags_isna(rmean[i])) {
+		rmean[i] = n > 1 ? (n * rmean[i] - value[i]) / (n - 1) : 0;
+	    }
+	}
+    }
 
-		    vector<double> value = _subset.value(ch);
-		    for (unsigned int i = 0; i < value.size(); ++i) {
-			        if (jags_isna(value[i])) {
-				    _values[i] = JAGS_NA;
-				}
-				else {
-				    _values[i] -= (_values[i] - value[i])/_n;
-				}
-			}
-		}
+    bool PoolMeanMonitor::updatesByChain() const
+    {
+	return true;
     }
 
     vector<double> const &PoolMeanMonitor::value(unsigned int) const
     {
+	// Each chain counts as an iteration, so the pooled mean is
+	// the mean of the chain means weighted by their length
+	unsigned int ntotal = 0;
+	for (unsigned int ch = 0; ch < _n.size(); ++ch) {
+	    ntotal += _n[ch];
+	}
+	for (unsigned int i = 0; i < _values.size(); ++i) {
+	    double sum = 0;
+	    for (unsigned int ch = 0; ch < _means.size(); ++ch) {
+		if (jags_isna(_means[ch][i])) {
+		    sum = JAGS_NA;
+		    break;
+		}
+		sum += _n[ch] * _means[ch][i];
+	    }
+	    _values[i] = (jags_isna(sum) || ntotal == 0) ? sum : sum / ntotal;
+	}
 	return _values;
     }
 
@@ -14,11 +14,14 @@ namespace base {
      */
     class PoolMeanMonitor : public Monitor {
 	NodeArraySubset _subset;
-	std::vector<double> _values; // sampled values
-	unsigned int _n;
+	std::vector<std::vector<double> > _means; // running mean by chain
+	std::vector<unsigned int> _n;
+	mutable std::vector<double> _values; // pooled mean
     public:
 	PoolMeanMonitor(NodeArraySubset const &subset);
-	void update() override;
+	void update(unsigned int chain) override;
+	void rollback(unsigned int chain) override;
+	bool updatesByChain() const override;
 	std::vector<double> const &value(unsigned int chain) const override;
 	std::vector<unsigned long> dim() const override;
 	bool poolChains() const override;
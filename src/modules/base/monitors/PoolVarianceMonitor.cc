@@ -14,48 +14,98 @@ namespace base {
 
     PoolVarianceMonitor::PoolVarianceMonitor(NodeArraySubset const &subset)
 	: Monitor("poolvariance", subset.nodes()), _subset(subset),
-	  _means(subset.length()),
-	  _mms(subset.length()),
-	  _variances(subset.length()),
-	  _n(0)
+	  _means(subset.nchain(), vector<double>(subset.length())),
+	  _mms(subset.nchain(), vector<double>(subset.length())),
+	  _n(subset.nchain(), 0),
+	  _variances(subset.length())
     {
     }
-    
-    void PoolVarianceMonitor::update()
+
+    void PoolVarianceMonitor::update(unsigned int chain)
     {
+	unsigned int n = ++_n[chain];
+	vector<double> value = _subset.value(chain);
+	vector<double> &rmean = _means[chain];
+	vector<double> &rmm = _mms[chain];
+	for (unsigned int i = 0; i < value.size(); ++i) {
+	    if (jags_isna(value[i])) {
+		rmean[i] = JAGS_NA;
+		rmm[i] = JAGS_NA;
+	    }
+	    else {
+		double delta = value[i] - rmean[i];
+		rmean[i] += delta / n;
+		rmm[i] += delta * (value[i] - rmean[i]);
+	    }
+	}
+    }
 
-		for (unsigned int ch = 0; ch < _subset.nchain(); ++ch) {
-		
-			// Each chain counts as an iteration:
-			_n++;
-		
-		    vector<double> value = _subset.value(ch);
-		    for (unsigned int i = 0; i < value.size(); ++i) {
-				if (jags_isna(value[i])) {
-				    _means[i] = JAGS_NA;
-					_mms[i] = JAGS_NA;
-					_variances[i] = JAGS_NA;
-				}
-				else {
-					double delta = value[i] - _means[i];
-					_means[i] += delta / _n;
-					_mms[i] += delta * (value[i] - _means[i]);
-				}
-			}
-		}
-		
-		// Variance itself only needs to be calculated once per iteration:
-		for (unsigned int i = 0; i < _variances.size(); ++i) {
-		    _variances[i] = _mms[i] / static_cast<double>(_n - 1);
-		}
-		
+    void PoolVarianceMonitor::rollback(unsigned int chain)
+    {
+	// Reverses the last update using the node values, which are
+	// unchanged since the update
+	unsigned int n = _n[chain]--;
+	vector<double> value = _subset.value(chain);
+	vector<double> &rmean = _means[chain];
+	vector<double> &rmm = _mms[chain];
+	for (unsigned int i = 0; i < value.size(); ++i) {
+	    if (jags_isna(rmean[i]) || jags_isna(rmm[i])) continue;
+	    if (n > 1) {
+		double mean = (n * rmean[i] - value[i]) / (n - 1);
+		rmm[i] -= (value[i] - mean) * (value[i] - rmean[i]);
+		rmean[i] = mean;
+	    }
+	    else {
+		rmean[i] = 0;
+		rmm[i] = 0;
+	    }
+	}
+    }
+
+    bool PoolVarianceMonitor::updatesByChain() const
+    {
+	return true;
     }
 
     vector<double> const &PoolVarianceMonitor::value(unsigned int) const
     {
+	/* 
+	   Each chain counts as an iteration. The sums of squared
+	   deviations of the chains are combined with the squared
+	   deviations of the chain means from the pooled mean.
+	*/
+	unsigned int ntotal = 0;
+	for (unsigned int ch = 0; ch < _n.size(); ++ch) {
+	    ntotal += _n[ch];
+	}
+	if (ntotal == 0) {
+	    return _variances;
+	}
+	for (unsigned int i = 0; i < _variances.size(); ++i) {
+	    double mean = 0;
+	    bool na = false;
+	    for (unsigned int ch = 0; ch < _means.size(); ++ch) {
+		if (jags_isna(_means[ch][i]) || jags_isna(_mms[ch][i])) {
+		    na = true;
+		    break;
+		}
+		mean += _n[ch] * _means[ch][i];
+	    }
+	    if (na) {
+		_variances[i] = JAGS_NA;
+		continue;
+	    }
+	    mean /= ntotal;
+	    double mm = 0;
+	    for (unsigned int ch = 0; ch < _means.size(); ++ch) {
+		double delta = _means[ch][i] - mean;
+		mm += _mms[ch][i] + _n[ch] * delta * delta;
+	    }
+	    _variances[i] = mm / static_cast<double>(ntotal - 1);
+	}
 	return _variances;
     }
-    
+
     vector<unsigned long> PoolVarianceMonitor::dim() const
     {
 	return _subset.dim();
@@ -14,14 +14,16 @@ namespace base {
      */
     class PoolVarianceMonitor : public Monitor {
 	NodeArraySubset _subset;
-	std::vector<double> _means;
-	std::vector<double> _mms;
-	std::vector<double> _variances;
-	unsigned int _n;
+	std::vector<std::vector<double> > _means;
+	std::vector<std::vector<double> > _mms;
+	std::vector<unsigned int> _n;
+	mutable std::vector<double> _variances;
 	
     public:
 	PoolVarianceMonitor(NodeArraySubset const &subset);
-	void update() override;
+	void update(unsigned int chain) override;
+	void rollback(unsigned int chain) override;
+	bool updatesByChain() const override;
 	std::vector<double> const &value(unsigned int chain) const override;
 	std::vector<unsigned long> dim() const override;
 	bool poolChains() const override;
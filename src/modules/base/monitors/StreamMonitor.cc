@@ -0,0 +1,360 @@
+#include <config.h>
+
+#include "StreamMonitor.h"
+
+#include <model/TraceFile.h>
+#include <util/binaryio.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+using std::vector;
+using std::string;
+using std::to_string;
+using std::copy;
+using std::max;
+using std::runtime_error;
+using std::mutex;
+using std::unique_lock;
+using std::thread;
+
+/* Number of records for which space is first reserved in a file */
+static const unsigned long MIN_RECORDS = 8;
+
+namespace jags {
+namespace base {
+
+    StreamMonitor::StreamMonitor(NodeArraySubset const &subset,
+				 string const &prefix,
+				 unsigned long chunkSize)
+	: Monitor("stream", subset.nodes()), _subset(subset),
+	  _nvar(subset.length()), _chunkSize(max(chunkSize, _nvar)),
+	  _headSize(0), _firstSize(0), _nextSize(0), _start(1), _thin(1),
+	  _niter(subset.nchain(), 0), _fileNames(subset.nchain()),
+	  _files(subset.nchain(), nullptr), _segments(subset.nchain()),
+	  _capacity(subset.nchain(), 0), _fileSize(subset.nchain(), 0),
+	  _chunks(subset.nchain()),
+	  _busy(false), _stop(false), _error(false),
+	  _values(subset.nchain())
+    {
+	for (unsigned int ch = 0; ch < _files.size(); ++ch) {
+	    _fileNames[ch] = prefix + "chain" + to_string(ch + 1) + ".bin";
+	    _files[ch] = std::fopen(_fileNames[ch].c_str(), "w+b");
+	    if (_files[ch] == nullptr) {
+		for (unsigned int i = 0; i < ch; ++i) {
+		    std::fclose(_files[i]);
+		}
+		throw runtime_error(string("Failed to open file ") +
+				    _fileNames[ch]);
+	    }
+	    _chunks[ch].reserve(_chunkSize);
+	}
+    }
+
+    StreamMonitor::~StreamMonitor()
+    {
+	//Values that do not fill a chunk are written before closing
+	for (unsigned int ch = 0; ch < _chunks.size(); ++ch) {
+	    if (!_chunks[ch].empty()) {
+		push(ch);
+	    }
+	}
+	{
+	    unique_lock<mutex> lock(_mutex);
+	    _stop = true;
+	}
+	_cond.notify_all();
+	if (_writer.joinable()) {
+	    _writer.join();
+	}
+	for (unsigned int ch = 0; ch < _files.size(); ++ch) {
+	    std::fclose(_files[ch]);
+	}
+    }
+
+    void StreamMonitor::setIterations(unsigned int start, unsigned int thin)
+    {
+	_start = start;
+	_thin = thin;
+    }
+
+    string StreamMonitor::recordHeader(Segment const &segment,
+				       bool continued) const
+    {
+	TraceFile::Record r;
+	r.name = name();
+	r.type = type();
+	r.dim = _subset.dim();
+	r.nchain = 1;
+	r.niter = segment.niter;
+	r.start = segment.start;
+	r.thin = _thin;
+	r.flags = continued ? TraceFile::CONTINUED : 0;
+	r.offset = segment.offset;
+	if (!continued) {
+	    r.elt_names = elementNames();
+	}
+	return TraceFile::recordHeader(r);
+    }
+
+    unsigned long StreamMonitor::recordOffset(unsigned long i) const
+    {
+	//Position of record i, which is also the end of the first i
+	//records
+	return i == 0 ? _headSize : _headSize + _firstSize + (i - 1) * _nextSize;
+    }
+
+    bool StreamMonitor::writeChunk(unsigned int chain, vector<double> const &x)
+    {
+	/*
+	   Appends a chunk to the file for the given chain as a new
+	   record. Space for the records is reserved after the file
+	   header, and is doubled when it is full, after moving any
+	   chunks that overlap the enlarged header to the end of the
+	   file. Each chunk is therefore moved a bounded number of
+	   times on average. The number of records is written last.
+	*/
+	std::FILE *file = _files[chain];
+	vector<Segment> &segments = _segments[chain];
+	unsigned long &capacity = _capacity[chain];
+	unsigned long &size = _fileSize[chain];
+
+	Segment segment;
+	segment.niter = x.size() / _nvar;
+	segment.start = segments.empty() ? _start :
+	    segments.back().start + segments.back().niter * _thin;
+	segment.offset = 0;
+
+	if (_firstSize == 0) {
+	    //The size of a record does not depend on the segment
+	    _headSize = TraceFile::fileHeader(0).size();
+	    _firstSize = recordHeader(segment, false).size();
+	    _nextSize = recordHeader(segment, true).size();
+	}
+
+	if (segments.size() == capacity) {
+	    capacity = max(2 * capacity, MIN_RECORDS);
+	    unsigned long hsize = alignOffset(recordOffset(capacity));
+	    if (size < hsize) {
+		string padding(hsize - size, '\0');
+		if (std::fseek(file, size, SEEK_SET) != 0 ||
+		    std::fwrite(padding.data(), 1, padding.size(), file) !=
+		    padding.size())
+		{
+		    return false;
+		}
+		size = hsize;
+	    }
+
+	    vector<char> buffer;
+	    for (unsigned int i = 0; i < segments.size(); ++i) {
+		Segment &s = segments[i];
+		if (s.offset >= hsize) continue;
+		unsigned long n = s.niter * _nvar * sizeof(double);
+		buffer.resize(n);
+		if (std::fseek(file, s.offset, SEEK_SET) != 0 ||
+		    std::fread(buffer.data(), 1, n, file) != n ||
+		    std::fseek(file, size, SEEK_SET) != 0 ||
+		    std::fwrite(buffer.data(), 1, n, file) != n)
+		{
+		    return false;
+		}
+		s.offset = size;
+		size += n;
+		string record = recordHeader(s, i > 0);
+		if (std::fseek(file, recordOffset(i), SEEK_SET) != 0 ||
+		    std::fwrite(record.data(), 1, record.size(), file) !=
+		    record.size())
+		{
+		    return false;
+		}
+	    }
+	}
+
+	//Values are written in columns, as in a binary trace file
+	segment.offset = size;
+	vector<double> column(x.size());
+	for (unsigned long k = 0; k < segment.niter; ++k) {
+	    for (unsigned long v = 0; v < _nvar; ++v) {
+		column[v * segment.niter + k] = x[k * _nvar + v];
+	    }
+	}
+	if (std::fseek(file, size, SEEK_SET) != 0 ||
+	    std::fwrite(column.data(), sizeof(double), column.size(), file)
+	    != column.size())
+	{
+	    return false;
+	}
+	size += column.size() * sizeof(double);
+
+	string record = recordHeader(segment, !segments.empty());
+	string header = TraceFile::fileHeader(segments.size() + 1);
+	if (std::fseek(file, recordOffset(segments.size()), SEEK_SET) != 0 ||
+	    std::fwrite(record.data(), 1, record.size(), file) !=
+	    record.size() ||
+	    std::fseek(file, 0, SEEK_SET) != 0 ||
+	    std::fwrite(header.data(), 1, header.size(), file) !=
+	    header.size() ||
+	    std::fflush(file) != 0)
+	{
+	    return false;
+	}
+	segments.push_back(segment);
+	return true;
+    }
+
+    void StreamMonitor::write()
+    {
+	/*
+	   Main loop of the background writer thread, which stops when
+	   the queue is empty after the monitor is deleted.
+	*/
+	unique_lock<mutex> lock(_mutex);
+	while (true) {
+	    _cond.wait(lock, [this] { return _stop || !_queue.empty(); });
+	    if (_queue.empty()) break;
+
+	    Chunk chunk = std::move(_queue.front());
+	    _queue.pop_front();
+	    _busy = true;
+	    lock.unlock();
+	    _cond.notify_all();
+
+	    bool ok = writeChunk(chunk.first, chunk.second);
+
+	    lock.lock();
+	    _busy = false;
+	    if (!ok) _error = true;
+	    _cond.notify_all();
+	}
+    }
+
+    void StreamMonitor::push(unsigned int chain)
+    {
+	/*
+	   Passes the values collected for the given chain to the
+	   writer. If the writer has fallen behind, we wait for it so
+	   that the memory used by the queue is bounded.
+	*/
+	unique_lock<mutex> lock(_mutex);
+	unsigned long max_queue = 2 * _files.size();
+	_cond.wait(lock, [this, max_queue] {
+		return _error || _queue.size() < max_queue; });
+	if (!_error) {
+	    //Values are discarded after an error, which is reported
+	    //when they are read.
+	    _queue.emplace_back(chain, std::move(_chunks[chain]));
+	    if (!_writer.joinable()) {
+		_writer = thread(&StreamMonitor::write, this);
+	    }
+	}
+	_chunks[chain].clear();
+	_chunks[chain].reserve(_chunkSize);
+	lock.unlock();
+	_cond.notify_all();
+    }
+
+    void StreamMonitor::update(unsigned int chain)
+    {
+	//A full chunk is passed to the writer when the next values
+	//arrive, so that the last values can still be rolled back
+	if (_chunks[chain].size() >= _chunkSize) {
+	    push(chain);
+	}
+	vector<double> v = _subset.value(chain);
+	_chunks[chain].insert(_chunks[chain].end(), v.begin(), v.end());
+	++_niter[chain];
+    }
+
+    void StreamMonitor::rollback(unsigned int chain)
+    {
+	_chunks[chain].resize(_chunks[chain].size() - _nvar);
+	--_niter[chain];
+    }
+
+    bool StreamMonitor::updatesByChain() const
+    {
+	return true;
+    }
+
+    void StreamMonitor::read(unsigned int chain, unsigned long begin,
+			     unsigned long end, vector<double> &x) const
+    {
+	/*
+	   Reads values from the file, followed by the values that have
+	   not yet been passed to the writer. This must be called with
+	   the mutex locked and the queue empty.
+	*/
+	if (_error) {
+	    throw runtime_error(string("Failed to write file ") +
+				_fileNames[chain]);
+	}
+
+	unsigned long width = end - begin;
+	unsigned long niter = _niter[chain];
+	x.resize(niter * width);
+
+	/* The columns of a block of elements are contiguous */
+	std::FILE *file = _files[chain];
+	vector<double> buffer;
+	unsigned long nfile = 0;
+	for (Segment const &s : _segments[chain]) {
+	    buffer.resize(width * s.niter);
+	    if (std::fseek(file, s.offset + begin * s.niter * sizeof(double),
+			   SEEK_SET) != 0 ||
+		std::fread(buffer.data(), sizeof(double), buffer.size(), file)
+		!= buffer.size())
+	    {
+		throw runtime_error(string("Failed to read file ") +
+				    _fileNames[chain]);
+	    }
+	    for (unsigned long v = 0; v < width; ++v) {
+		for (unsigned long k = 0; k < s.niter; ++k) {
+		    x[(nfile + k) * width + v] = buffer[v * s.niter + k];
+		}
+	    }
+	    nfile += s.niter;
+	}
+
+	vector<double> const &tail = _chunks[chain];
+	for (unsigned long k = nfile; k < niter; ++k) {
+	    unsigned long offset = (k - nfile) * _nvar;
+	    copy(tail.begin() + offset + begin, tail.begin() + offset + end,
+		 x.begin() + k * width);
+	}
+    }
+
+    void StreamMonitor::values(unsigned int chain, unsigned long begin,
+			       unsigned long end, vector<double> &x) const
+    {
+	unique_lock<mutex> lock(_mutex);
+	_cond.wait(lock, [this] { return _queue.empty() && !_busy; });
+	read(chain, begin, end, x);
+    }
+
+    vector<double> const &StreamMonitor::value(unsigned int chain) const
+    {
+	unique_lock<mutex> lock(_mutex);
+	_cond.wait(lock, [this] { return _queue.empty() && !_busy; });
+	if (_values[chain].size() != _niter[chain] * _nvar) {
+	    read(chain, 0, _nvar, _values[chain]);
+	}
+	return _values[chain];
+    }
+
+    vector<unsigned long> StreamMonitor::dim() const
+    {
+	return _subset.dim();
+    }
+
+    bool StreamMonitor::poolChains() const
+    {
+	return false;
+    }
+
+    bool StreamMonitor::poolIterations() const
+    {
+	return false;
+    }
+
+}}
@@ -0,0 +1,117 @@
+#ifndef STREAM_MONITOR_H_
+#define STREAM_MONITOR_H_
+
+#include <model/Monitor.h>
+#include <model/NodeArraySubset.h>
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <utility>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace jags {
+    namespace base {
+
+	/**
+	 * @short Streams sampled values of a given Node to disk
+	 *
+	 * A StreamMonitor records the same values as a TraceMonitor,
+	 * but instead of keeping the whole trace in memory, the values
+	 * are written to a file for each chain as they are sampled.
+	 * Values are collected in chunks of bounded size and written by
+	 * a background thread, so that the sampler does not wait for
+	 * disk output unless the writer falls behind.  Chains are
+	 * updated concurrently and share the writer.
+	 *
+	 * The files are binary trace files that can be read with the
+	 * TraceFile class. Each chunk is written as a separate record,
+	 * with the name of the monitor and the first iteration of the
+	 * chunk. Only the first record holds the element names: the
+	 * others are marked as continuing it. The file is flushed after
+	 * each chunk, so the values written so far can be read if the
+	 * process stops before the CODA command. The values that do not
+	 * fill a chunk are written when the monitor is deleted.
+	 *
+	 * CODA output reads the values back in blocks using the values
+	 * member function.  The value member function loads the whole
+	 * trace for a chain into memory, so should be avoided for large
+	 * monitors.
+	 */
+	class StreamMonitor : public Monitor {
+	    typedef std::pair<unsigned int, std::vector<double> > Chunk;
+	    /* Location of a chunk in the file for a chain */
+	    struct Segment {
+		unsigned long start;
+		unsigned long niter;
+		unsigned long offset;
+	    };
+	    NodeArraySubset _subset;
+	    unsigned long _nvar;
+	    unsigned long _chunkSize;
+	    unsigned long _headSize;
+	    unsigned long _firstSize;
+	    unsigned long _nextSize;
+	    unsigned int _start;
+	    unsigned int _thin;
+	    std::vector<unsigned long> _niter;
+	    std::vector<std::string> _fileNames;
+	    std::vector<std::FILE*> _files;
+	    std::vector<std::vector<Segment> > _segments;
+	    std::vector<unsigned long> _capacity;
+	    std::vector<unsigned long> _fileSize;
+	    std::vector<std::vector<double> > _chunks;
+	    std::deque<Chunk> _queue;
+	    mutable std::mutex _mutex;
+	    mutable std::condition_variable _cond;
+	    std::thread _writer;
+	    bool _busy;
+	    bool _stop;
+	    bool _error;
+	    mutable std::vector<std::vector<double> > _values;
+	    void write();
+	    bool writeChunk(unsigned int chain, std::vector<double> const &x);
+	    std::string recordHeader(Segment const &segment,
+				     bool continued) const;
+	    unsigned long recordOffset(unsigned long i) const;
+	    void push(unsigned int chain);
+	    void read(unsigned int chain, unsigned long begin,
+		      unsigned long end, std::vector<double> &x) const;
+	  public:
+	    /**
+	     * Constructor
+	     *
+	     * @param subset Subset of the node array to monitor
+	     * @param prefix Prefix of the file names. The file for
+	     * chain n is "<prefix>chain<n>.bin". Existing files are
+	     * overwritten.
+	     * @param chunkSize Number of values collected for a chain
+	     * before they are written. A chunk always holds at least
+	     * one iteration.
+	     */
+	    StreamMonitor(NodeArraySubset const &subset,
+			  std::string const &prefix,
+			  unsigned long chunkSize = 65536);
+	    ~StreamMonitor() override;
+	    StreamMonitor(StreamMonitor const &) = delete;
+	    StreamMonitor &operator=(StreamMonitor const &) = delete;
+	    void update(unsigned int chain) override;
+	    void rollback(unsigned int chain) override;
+	    bool updatesByChain() const override;
+	    void setIterations(unsigned int start, unsigned int thin) override;
+	    std::vector<double> const &value(unsigned int chain) const override;
+	    void values(unsigned int chain, unsigned long begin,
+			unsigned long end,
+			std::vector<double> &x) const override;
+	    std::vector<unsigned long> dim() const override;
+	    bool poolChains() const override;
+	    bool poolIterations() const override;
+	};
+
+    }
+}
+
+#endif /* STREAM_MONITOR_H_ */
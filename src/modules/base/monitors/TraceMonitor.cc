@@ -17,12 +17,20 @@ namespace base {
     {
     }
     
-    void TraceMonitor::update()
+    void TraceMonitor::update(unsigned int chain)
     {
-	for (unsigned int ch = 0; ch < _values.size(); ++ch) {
-	    vector<double> v = _subset.value(ch);
-	    _values[ch].insert(_values[ch].end(), v.begin(), v.end());
-	}
+	vector<double> v = _subset.value(chain);
+	_values[chain].insert(_values[chain].end(), v.begin(), v.end());
+    }
+
+    void TraceMonitor::rollback(unsigned int chain)
+    {
+	_values[chain].resize(_values[chain].size() - _subset.length());
+    }
+
+    bool TraceMonitor::updatesByChain() const
+    {
+	return true;
     }
 
     vector<double> const &TraceMonitor::value(unsigned int chain) const
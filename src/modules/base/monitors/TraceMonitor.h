@@ -17,7 +17,9 @@ namespace jags {
 	    std::vector<std::vector<double> > _values; // sampled values
 	  public:
 	    TraceMonitor(NodeArraySubset const &subset);
-	    void update() override;
+	    void update(unsigned int chain) override;
+	    void rollback(unsigned int chain) override;
+	    bool updatesByChain() const override;
 	    std::vector<double> const &value(unsigned int chain) const override;
 	    std::vector<unsigned long> dim() const override;
 	    bool poolChains() const override;
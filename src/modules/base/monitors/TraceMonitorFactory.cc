@@ -1,11 +1,14 @@
 #include "TraceMonitorFactory.h"
 #include "TraceMonitor.h"
+#include "StreamMonitor.h"
 
 #include <model/BUGSModel.h>
 #include <graph/Graph.h>
 #include <graph/Node.h>
 #include <sarray/RangeIterator.h>
 
+#include <cctype>
+
 using std::set;
 using std::string;
 using std::vector;
@@ -13,13 +16,42 @@ using std::vector;
 namespace jags {
 namespace base {
 
+    static string streamPrefix(string const &stem, string const &name)
+    {
+	/*
+	   Files written by a stream monitor are named after the monitor,
+	   using the given stem. Characters of the name that may not be
+	   valid in a file name are replaced by underscores.
+	*/
+	string prefix = stem + "stream_";
+	for (char c : name) {
+	    bool valid = std::isalnum(static_cast<unsigned char>(c)) ||
+		c == '.' || c == '_';
+	    prefix.push_back(valid ? c : '_');
+	}
+	while (prefix[prefix.size() - 1] == '_') {
+	    prefix.erase(prefix.size() - 1);
+	}
+	return prefix + "_";
+    }
+
     Monitor *TraceMonitorFactory::getMonitor(string const &name,
 					     Range const &range,
 					     BUGSModel *model,
 					     string const &type,
 					     string &msg)
     {
-	if (type != "trace")
+	return getMonitor(name, range, model, type, "CODA", msg);
+    }
+
+    Monitor *TraceMonitorFactory::getMonitor(string const &name,
+					     Range const &range,
+					     BUGSModel *model,
+					     string const &type,
+					     string const &stem,
+					     string &msg)
+    {
+	if (type != "trace" && type != "stream")
 	    return nullptr;
 
 	NodeArray *array = model->symtab().getVariable(name);
@@ -28,7 +60,14 @@ namespace base {
 	    return nullptr;
 	}
 
-	TraceMonitor *m = new TraceMonitor(NodeArraySubset(array, range));
+	Monitor *m = nullptr;
+	if (type == "trace") {
+	    m = new TraceMonitor(NodeArraySubset(array, range));
+	}
+	else {
+	    m = new StreamMonitor(NodeArraySubset(array, range),
+				  streamPrefix(stem, name + printRange(range)));
+	}
 	
 	//Set name attributes 
 	m->setName(name + printRange(range));
@@ -12,6 +12,9 @@ namespace base {
 	Monitor *getMonitor(std::string const &name, Range const &range, 
 			    BUGSModel *model, std::string const &type,
 			    std::string &msg) override;
+	Monitor *getMonitor(std::string const &name, Range const &range, 
+			    BUGSModel *model, std::string const &type,
+			    std::string const &stem, std::string &msg) override;
 	std::string name() const override;
     };
     
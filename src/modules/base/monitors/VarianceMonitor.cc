@@ -17,52 +17,73 @@ namespace base {
 	  _means(subset.nchain(), vector<double>(subset.length())),
 	  _mms(subset.nchain(), vector<double>(subset.length())),
 	  _variances(subset.nchain(), vector<double>(subset.length())),
-	  _n(0)
+	  _n(subset.nchain(), 0)
     {
     }
     
-    void VarianceMonitor::update()
+    void VarianceMonitor::update(unsigned int chain)
     {
-	_n++;
-	for (unsigned int ch = 0; ch < _means.size(); ++ch) {
-	    vector<double> value = _subset.value(ch);
-	    vector<double> &rmean  = _means[ch];
-	    vector<double> &rmm  = _mms[ch];
-		vector<double> &rvar  = _variances[ch];		
-	    for (unsigned int i = 0; i < value.size(); ++i) {
-		if (jags_isna(value[i])) {
-		    rmean[i] = JAGS_NA;
-			rmm[i] = JAGS_NA;
-			rvar[i] = JAGS_NA;
-		}
-		else {
-			double delta = value[i] - rmean[i];
-			rmean[i] += delta / _n;
-			rmm[i] += delta * (value[i] - rmean[i]);
-			
-			/* 
-			[MD - 2016-03-31]
-			The variance would be more efficiently calculated on-demand,
-			but the functions are all marked as const except this one.
-			It is possible to get around this restriction, but the value
-			function is const for a good reason, so hacking around this
-			seems to me to be a bad idea.
-			I do have an alternative implementation that calculates
-			variance on demand, which we could consider using for the
-			sake of efficiency...  
-			*/
-			rvar[i] = rmm[i] / static_cast<double>(_n - 1);
-			
-		}
+	unsigned int n = ++_n[chain];
+	vector<double> value = _subset.value(chain);
+	vector<double> &rmean  = _means[chain];
+	vector<double> &rmm  = _mms[chain];
+	for (unsigned int i = 0; i < value.size(); ++i) {
+	    if (jags_isna(value[i])) {
+		rmean[i] = JAGS_NA;
+		rmm[i] = JAGS_NA;
+	    }
+	    else {
+		double delta = value[i] - rmean[i];
+		rmean[i] += delta / n;
+		rmm[i] += delta * (value[i] - rmean[i]);
+	    }
 	}
+    }
+
+    void VarianceMonitor::rollback(unsigned int chain)
+    {
+	// Reverses the last update using the node values, which are
+	// unchanged since the update
+	unsigned int n = _n[chain]--;
+	vector<double> value = _subset.value(chain);
+	vector<double> &rmean = _means[chain];
+	vector<double> &rmm = _mms[chain];
+	for (unsigned int i = 0; i < value.size(); ++i) {
+	    if (jags_isna(rmean[i]) || jags_isna(rmm[i])) continue;
+	    if (n > 1) {
+		double mean = (n * rmean[i] - value[i]) / (n - 1);
+		rmm[i] -= (value[i] - mean) * (value[i] - rmean[i]);
+		rmean[i] = mean;
+	    }
+	    else {
+		rmean[i] = 0;
+		rmm[i] = 0;
+	    }
 	}
     }
 
+    bool VarianceMonitor::updatesByChain() const
+    {
+	return true;
+    }
+
     vector<double> const &VarianceMonitor::value(unsigned int chain) const
     {
-		return _variances[chain];
+	// The variance is calculated on demand from the running sum of
+	// squared deviations
+	vector<double> const &rmm = _mms[chain];
+	vector<double> &rvar = _variances[chain];
+	for (unsigned int i = 0; i < rvar.size(); ++i) {
+	    if (jags_isna(rmm[i])) {
+		rvar[i] = JAGS_NA;
+	    }
+	    else {
+		rvar[i] = rmm[i] / static_cast<double>(_n[chain] - 1);
+	    }
 	}
-	
+	return rvar;
+    }
+
     vector<unsigned long> VarianceMonitor::dim() const
     {
 	return _subset.dim();
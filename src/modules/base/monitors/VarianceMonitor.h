@@ -16,12 +16,14 @@ namespace base {
 	NodeArraySubset _subset;
 	std::vector<std::vector<double> > _means;
 	std::vector<std::vector<double> > _mms;
-	std::vector<std::vector<double> > _variances;
-	unsigned int _n;
+	mutable std::vector<std::vector<double> > _variances;
+	std::vector<unsigned int> _n;
 	
     public:
 	VarianceMonitor(NodeArraySubset const &subset);
-	void update() override;
+	void update(unsigned int chain) override;
+	void rollback(unsigned int chain) override;
+	bool updatesByChain() const override;
 	std::vector<double> const &value(unsigned int chain) const override;
 	std::vector<unsigned long> dim() const override;
 	bool poolChains() const override;
@@ -0,0 +1,437 @@
+#include "testbasemon.h"
+
+#include "TraceMonitor.h"
+#include "MeanMonitor.h"
+#include "VarianceMonitor.h"
+#include "PoolMeanMonitor.h"
+#include "PoolVarianceMonitor.h"
+#include "StreamMonitor.h"
+
+#include "../rngs/BaseRNGFactory.h"
+
+#include <graph/ConstantNode.h>
+#include <graph/NodeArena.h>
+#include <model/Model.h>
+#include <model/NodeArray.h>
+#include <model/NodeArraySubset.h>
+#include <model/MonitorControl.h>
+#include <model/TraceFile.h>
+
+#include <vector>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <cstdio>
+
+using std::vector;
+using std::list;
+using std::unique_ptr;
+using std::runtime_error;
+using std::string;
+using std::to_string;
+
+using jags::Monitor;
+using jags::MonitorControl;
+using jags::Model;
+using jags::ConstantNode;
+using jags::NodeArena;
+using jags::NodeArray;
+using jags::NodeArraySubset;
+using jags::SimpleRange;
+using jags::TraceFile;
+using jags::base::TraceMonitor;
+using jags::base::MeanMonitor;
+using jags::base::VarianceMonitor;
+using jags::base::PoolMeanMonitor;
+using jags::base::PoolVarianceMonitor;
+using jags::base::StreamMonitor;
+
+void BaseMonTest::setUp()
+{
+    _rngfac = new jags::base::BaseRNGFactory;
+    Model::rngFactories().push_back(_rngfac);
+}
+
+void BaseMonTest::tearDown()
+{
+    Model::rngFactories().remove(_rngfac);
+    delete _rngfac;
+}
+
+static vector<Monitor*> makeMonitors(NodeArraySubset const &subset)
+{
+    vector<Monitor*> m;
+    m.push_back(new TraceMonitor(subset));
+    m.push_back(new MeanMonitor(subset));
+    m.push_back(new VarianceMonitor(subset));
+    m.push_back(new PoolMeanMonitor(subset));
+    m.push_back(new PoolVarianceMonitor(subset));
+    return m;
+}
+
+static void freeMonitors(vector<Monitor*> &m)
+{
+    for (unsigned int i = 0; i < m.size(); ++i) {
+	delete m[i];
+    }
+}
+
+void BaseMonTest::pooled()
+{
+    /*
+      Monitors keep a running mean and sum of squared deviations for
+      each chain. The pooled values must agree with the mean and
+      variance of the whole sample, and the values for each chain
+      with the sample for that chain.
+    */
+    unsigned int const nchain = 3;
+    unsigned int const niter = 9;
+
+    ConstantNode node(vector<unsigned long>(1, 2), vector<double>(2, 0),
+		      nchain, true);
+    NodeArray array("x", vector<unsigned long>(1, 2), nchain);
+    array.insert(&node, SimpleRange(vector<unsigned long>(1, 1),
+				    vector<unsigned long>(1, 2)));
+    NodeArraySubset subset(&array, SimpleRange());
+    vector<Monitor*> m = makeMonitors(subset);
+
+    //Chains have different means, so the pooled variance includes
+    //the variance between chains
+    vector<vector<double> > x(nchain);
+    for (unsigned int t = 0; t < niter; ++t) {
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    double v[2] = {10.0 * ch + (t % 4) - 0.5 * t, 1e6 + t * t * 0.1};
+	    x[ch].push_back(v[0]);
+	    node.setValue(v, 2, ch);
+	    for (unsigned int i = 0; i < m.size(); ++i) {
+		m[i]->update(ch);
+	    }
+	}
+    }
+
+    double mean = 0, ss = 0;
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	double cmean = 0, css = 0;
+	for (unsigned int t = 0; t < niter; ++t) {
+	    cmean += x[ch][t] / niter;
+	    mean += x[ch][t] / (niter * nchain);
+	}
+	for (unsigned int t = 0; t < niter; ++t) {
+	    css += (x[ch][t] - cmean) * (x[ch][t] - cmean);
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(cmean, m[1]->value(ch)[0], tol);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(css / (niter - 1), m[2]->value(ch)[0],
+				     tol);
+    }
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	for (unsigned int t = 0; t < niter; ++t) {
+	    ss += (x[ch][t] - mean) * (x[ch][t] - mean);
+	}
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(mean, m[3]->value(0)[0], tol);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ss / (niter * nchain - 1),
+				 m[4]->value(0)[0], tol);
+
+    //A large offset does not spoil the variance
+    double var2 = 0, mean2 = 0;
+    for (unsigned int t = 0; t < niter; ++t) {
+	mean2 += t * t * 0.1 / niter;
+    }
+    for (unsigned int t = 0; t < niter; ++t) {
+	var2 += (t * t * 0.1 - mean2) * (t * t * 0.1 - mean2) * nchain;
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(var2 / (niter * nchain - 1),
+				 m[4]->value(0)[1], 1e-6);
+
+    freeMonitors(m);
+}
+
+void BaseMonTest::rollback()
+{
+    /*
+      Monitors that record an extra iteration and then roll it back
+      must give the same values as monitors that never recorded it.
+      Only the chain that is rolled back is affected.
+    */
+    unsigned int const nchain = 2;
+    double x[4][2] = {{1.5, -2}, {0.25, 3}, {-1, 0.5}, {7, 2.5}};
+    double extra[2] = {100, -50};
+
+    ConstantNode node(vector<unsigned long>(1, 2), vector<double>(2, 0),
+		      nchain, true);
+    NodeArray array("x", vector<unsigned long>(1, 2), nchain);
+    array.insert(&node, SimpleRange(vector<unsigned long>(1, 1),
+				    vector<unsigned long>(1, 2)));
+    NodeArraySubset subset(&array, SimpleRange());
+
+    vector<Monitor*> m1 = makeMonitors(subset);
+    vector<Monitor*> m2 = makeMonitors(subset);
+
+    for (unsigned int t = 0; t < 4; ++t) {
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    double v[2] = {x[t][0] + ch, x[t][1] * (ch + 1)};
+	    node.setValue(v, 2, ch);
+	    for (unsigned int i = 0; i < m1.size(); ++i) {
+		m1[i]->update(ch);
+		m2[i]->update(ch);
+	    }
+	}
+	if (t == 0 || t == 2) {
+	    //Chain 0 of the second set of monitors records an extra
+	    //iteration, which is then rolled back
+	    node.setValue(extra, 2, 0);
+	    for (unsigned int i = 0; i < m2.size(); ++i) {
+		m2[i]->update(0);
+		m2[i]->rollback(0);
+	    }
+	}
+    }
+
+    for (unsigned int i = 0; i < m1.size(); ++i) {
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    vector<double> const &v1 = m1[i]->value(ch);
+	    vector<double> const &v2 = m2[i]->value(ch);
+	    CPPUNIT_ASSERT_EQUAL(v1.size(), v2.size());
+	    for (unsigned int j = 0; j < v1.size(); ++j) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(v1[j], v2[j], tol);
+	    }
+	}
+    }
+
+    //Rolling back every iteration of a chain leaves it empty
+    MeanMonitor mean(subset);
+    node.setValue(extra, 2, 1);
+    mean.update(1);
+    mean.rollback(1);
+    vector<double> const &v = mean.value(1);
+    CPPUNIT_ASSERT_EQUAL(0.0, v[0]);
+    CPPUNIT_ASSERT_EQUAL(0.0, v[1]);
+
+    node.setValue(extra, 2, 1);
+    VarianceMonitor var(subset);
+    var.update(1);
+    var.update(1);
+    var.rollback(1);
+    var.rollback(1);
+    var.update(1);
+    var.update(1);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, var.value(1)[0], tol);
+
+    freeMonitors(m1);
+    freeMonitors(m2);
+}
+
+namespace {
+
+    /* Monitor that fails once, for the given chain and update */
+    class FailMonitor : public Monitor {
+	unsigned int _chain, _fail;
+	vector<unsigned int> _n;
+	vector<double> _values;
+    public:
+	FailMonitor(ConstantNode const *node, unsigned int chain,
+		    unsigned int fail)
+	    : Monitor("fail", node), _chain(chain), _fail(fail),
+	      _n(node->nchain(), 0), _values(1, 0)
+	{}
+	void update(unsigned int chain) override {
+	    if (chain == _chain && _n[chain] + 1 == _fail) {
+		_fail = 0;
+		throw runtime_error("Monitor failure");
+	    }
+	    ++_n[chain];
+	}
+	void rollback(unsigned int chain) override {
+	    --_n[chain];
+	}
+	unsigned int niter(unsigned int chain) const {
+	    return _n[chain];
+	}
+	bool updatesByChain() const override { return true; }
+	bool poolChains() const override { return false; }
+	bool poolIterations() const override { return true; }
+	vector<unsigned long> dim() const override {
+	    return vector<unsigned long>(1, 1);
+	}
+	vector<double> const &value(unsigned int) const override {
+	    return _values;
+	}
+    };
+
+}
+
+static void checkIterations(Model const &model, unsigned int nchain,
+			    unsigned int niter, unsigned int length,
+			    TraceMonitor const *trace,
+			    FailMonitor const *fail)
+{
+    for (MonitorControl const &c : model.monitors()) {
+	CPPUNIT_ASSERT_EQUAL(niter, c.niter());
+    }
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(niter * length),
+			     trace->value(ch).size());
+	CPPUNIT_ASSERT_EQUAL(niter, fail->niter(ch));
+    }
+}
+
+void BaseMonTest::model_failure()
+{
+    /*
+      When a monitor fails for one chain, the iteration is discarded
+      by every monitor for every chain, so the monitors stay in step
+      with each other and with the model.
+    */
+    unsigned int const nchain = 3;
+    Model model(nchain);
+    ConstantNode *node = nullptr;
+    {
+	NodeArena::Scope scope(&model.arena());
+	node = new ConstantNode(vector<unsigned long>(1, 2),
+				vector<double>(2, 1), nchain, true);
+	model.addNode(node);
+    }
+    model.initialize(false);
+
+    NodeArray array("x", vector<unsigned long>(1, 2), nchain);
+    array.insert(node, SimpleRange(vector<unsigned long>(1, 1),
+				   vector<unsigned long>(1, 2)));
+    NodeArraySubset subset(&array, SimpleRange());
+
+    unique_ptr<TraceMonitor> trace(new TraceMonitor(subset));
+    unique_ptr<MeanMonitor> mean(new MeanMonitor(subset));
+    unique_ptr<FailMonitor> fail(new FailMonitor(node, 1, 3));
+    unique_ptr<PoolVarianceMonitor> pvar(new PoolVarianceMonitor(subset));
+    model.addMonitor(trace.get(), 1);
+    model.addMonitor(mean.get(), 1);
+    model.addMonitor(fail.get(), 1);
+    model.addMonitor(pvar.get(), 1);
+
+    //The third iteration fails after the monitors before the failing
+    //one have recorded it for chain 1, and all monitors for chain 0
+    //and chain 2 may have recorded it
+    CPPUNIT_ASSERT_THROW(model.update(5), runtime_error);
+    CPPUNIT_ASSERT_EQUAL(2U, model.iteration());
+    checkIterations(model, nchain, 2, 2, trace.get(), fail.get());
+
+    //The model continues from the last complete iteration
+    model.update(4);
+    CPPUNIT_ASSERT_EQUAL(6U, model.iteration());
+    checkIterations(model, nchain, 6, 2, trace.get(), fail.get());
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, mean->value(ch)[0], tol);
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, pvar->value(0)[0], tol);
+
+    model.removeMonitor(trace.get());
+    model.removeMonitor(mean.get());
+    model.removeMonitor(fail.get());
+    model.removeMonitor(pvar.get());
+}
+
+static void checkStream(string const &file, unsigned int nrecord,
+			vector<vector<double> > const &x,
+			vector<string> const &names)
+{
+    /*
+      Reads a file written by a stream monitor, which has one record
+      for each chunk of 2 iterations, and checks that the records
+      together hold the values of all iterations in x.
+    */
+    TraceFile trace(file);
+    CPPUNIT_ASSERT_EQUAL(nrecord, trace.size());
+    unsigned long niter = 0;
+    for (unsigned int i = 0; i < nrecord; ++i) {
+	CPPUNIT_ASSERT_EQUAL(string("x"), trace.name(i));
+	CPPUNIT_ASSERT_EQUAL(string("stream"), trace.type(i));
+	CPPUNIT_ASSERT(trace.elementNames(i) == names);
+	CPPUNIT_ASSERT_EQUAL(1U, trace.nchain(i));
+	CPPUNIT_ASSERT_EQUAL(5 + 4 * i, static_cast<unsigned int>(trace.start(i)));
+	CPPUNIT_ASSERT_EQUAL(2UL, trace.thin(i));
+	unsigned long n = trace.niter(i);
+	CPPUNIT_ASSERT(n == 2 || (n == 1 && i == nrecord - 1));
+	for (unsigned long v = 0; v < names.size(); ++v) {
+	    double const *column = trace.column(i, v, 0);
+	    for (unsigned long k = 0; k < n; ++k) {
+		CPPUNIT_ASSERT_EQUAL(x[niter + k][v], column[k]);
+	    }
+	}
+	niter += n;
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned long>(x.size()), niter);
+}
+
+void BaseMonTest::stream()
+{
+    /*
+      A stream monitor writes a record to the file for each chain
+      when a chunk is full. With chunks of 2 iterations, the header
+      must be enlarged twice, moving the chunks that it overlaps, and
+      the file must remain readable at each stage. Only the first
+      record holds the element names.
+    */
+    unsigned int const nchain = 2;
+    unsigned int const nvar = 3;
+
+    ConstantNode node(vector<unsigned long>(1, nvar),
+		      vector<double>(nvar, 0), nchain, true);
+    NodeArray array("x", vector<unsigned long>(1, nvar), nchain);
+    array.insert(&node, SimpleRange(vector<unsigned long>(1, 1),
+				    vector<unsigned long>(1, nvar)));
+    NodeArraySubset subset(&array, SimpleRange());
+    vector<string> names;
+    for (unsigned int v = 0; v < nvar; ++v) {
+	names.push_back("x[" + to_string(v + 1) + "]");
+    }
+
+    unique_ptr<StreamMonitor> m(new StreamMonitor(subset, "teststream_",
+						  2 * nvar));
+    m->setName("x");
+    m->setElementNames(names);
+    m->setIterations(5, 2);
+
+    vector<vector<vector<double> > > x(nchain);
+    for (unsigned int t = 0; t < 41; ++t) {
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    vector<double> v = {t + 0.5 * ch, -1.0 * t, 100.0 * ch + t * t};
+	    if (t == 10) {
+		//Rolled back values are not written
+		node.setValue(&v[0], nvar, ch);
+		m->update(ch);
+		m->rollback(ch);
+		v[0] = -v[0];
+	    }
+	    x[ch].push_back(v);
+	    node.setValue(&v[0], nvar, ch);
+	    m->update(ch);
+	}
+	if (t == 18) {
+	    //After 19 iterations, 9 chunks have been written and the
+	    //last values are waiting for the next chunk
+	    vector<double> const &v = m->value(1);
+	    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(19 * nvar), v.size());
+	    CPPUNIT_ASSERT_EQUAL(x[1][18][2], v[18 * nvar + 2]);
+	    vector<vector<double> > y(x[1].begin(), x[1].begin() + 18);
+	    checkStream("teststream_chain2.bin", 9, y, names);
+	}
+    }
+
+    //Values can be read in blocks of elements, while some are still
+    //waiting to be written
+    vector<double> y;
+    m->values(0, 1, 3, y);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(41 * 2), y.size());
+    for (unsigned int t = 0; t < 41; ++t) {
+	CPPUNIT_ASSERT_EQUAL(x[0][t][1], y[2 * t]);
+	CPPUNIT_ASSERT_EQUAL(x[0][t][2], y[2 * t + 1]);
+    }
+
+    //The remaining values are written when the monitor is deleted
+    m.reset();
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	string file = "teststream_chain" + to_string(ch + 1) + ".bin";
+	checkStream(file, 21, x[ch], names);
+	std::remove(file.c_str());
+    }
+}
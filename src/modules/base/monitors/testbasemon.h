@@ -0,0 +1,31 @@
+#ifndef BASE_MON_TEST_H_
+#define BASE_MON_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <testlib.h>
+
+namespace jags {
+    class RNGFactory;
+}
+
+class BaseMonTest : public CppUnit::TestFixture, public JAGSFixture
+{
+    CPPUNIT_TEST_SUITE( BaseMonTest );
+    CPPUNIT_TEST( pooled );
+    CPPUNIT_TEST( rollback );
+    CPPUNIT_TEST( model_failure );
+    CPPUNIT_TEST( stream );
+    CPPUNIT_TEST_SUITE_END();
+
+    jags::RNGFactory *_rngfac;
+
+public:
+    void setUp();
+    void tearDown();
+    void pooled();
+    void rollback();
+    void model_failure();
+    void stream();
+};
+
+#endif /* BASE_MON_TEST_H_ */
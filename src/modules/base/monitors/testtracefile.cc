@@ -0,0 +1,298 @@
+#include <config.h>
+#include "testtracefile.h"
+
+#include "TraceMonitor.h"
+#include "MeanMonitor.h"
+#include "PoolVarianceMonitor.h"
+
+#include "../rngs/BaseRNGFactory.h"
+
+#include <graph/ConstantNode.h>
+#include <graph/NodeArena.h>
+#include <model/BUGSModel.h>
+#include <model/NodeArray.h>
+#include <model/NodeArraySubset.h>
+#include <model/TraceFile.h>
+#include <util/binaryio.h>
+#include <util/nainf.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+
+using std::ofstream;
+using std::ios;
+using std::string;
+using std::vector;
+using std::runtime_error;
+using std::memcmp;
+using std::uint64_t;
+using std::uintptr_t;
+using std::isnan;
+
+using jags::Model;
+using jags::BUGSModel;
+using jags::ConstantNode;
+using jags::NodeArena;
+using jags::NodeArray;
+using jags::NodeArraySubset;
+using jags::SimpleRange;
+using jags::TraceFile;
+using jags::MappedFile;
+using jags::putInt;
+using jags::putString;
+using jags::getInt;
+using jags::getString;
+using jags::alignOffset;
+using jags::base::TraceMonitor;
+using jags::base::MeanMonitor;
+using jags::base::PoolVarianceMonitor;
+
+static const char *TEMP_FILE = "testtracefile.tmp";
+static const char *TRACE_FILE = "testtracefile_trace.bin";
+
+void TraceFileTest::setUp()
+{
+    _rngfac = new jags::base::BaseRNGFactory;
+    Model::rngFactories().push_back(_rngfac);
+}
+
+void TraceFileTest::tearDown()
+{
+    Model::rngFactories().remove(_rngfac);
+    delete _rngfac;
+    std::remove(TEMP_FILE);
+    std::remove(TRACE_FILE);
+}
+
+static void writeFile(string const &contents)
+{
+    ofstream out(TEMP_FILE, ios::binary);
+    out.write(contents.data(), contents.size());
+}
+
+static bool same(double x, double y)
+{
+    return isnan(x) ? isnan(y) && jags_isna(x) == jags_isna(y) : x == y;
+}
+
+void TraceFileTest::binaryio()
+{
+    string h;
+    putInt(0x0102030405060708ULL, h);
+    putString("abc", h);
+    putString("", h);
+    putInt(7, h);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(35), h.size());
+
+    unsigned long pos = 0;
+    CPPUNIT_ASSERT(getInt(h.data(), h.size(), pos) == 0x0102030405060708ULL);
+    CPPUNIT_ASSERT_EQUAL(string("abc"), getString(h.data(), h.size(), pos));
+    CPPUNIT_ASSERT_EQUAL(string(), getString(h.data(), h.size(), pos));
+    CPPUNIT_ASSERT(getInt(h.data(), h.size(), pos) == 7);
+    CPPUNIT_ASSERT_EQUAL(h.size(), static_cast<size_t>(pos));
+    CPPUNIT_ASSERT_THROW(getInt(h.data(), h.size(), pos), runtime_error);
+
+    //Truncated headers
+    pos = 8;
+    CPPUNIT_ASSERT_THROW(getString(h.data(), 18, pos), runtime_error);
+    pos = 0;
+    CPPUNIT_ASSERT_THROW(getInt(h.data(), 7, pos), runtime_error);
+    string bad;
+    putInt(~0ULL, bad);
+    bad.append("xyz");
+    pos = 0;
+    CPPUNIT_ASSERT_THROW(getString(bad.data(), bad.size(), pos),
+			 runtime_error);
+
+    CPPUNIT_ASSERT_EQUAL(0UL, alignOffset(0));
+    CPPUNIT_ASSERT_EQUAL(8UL, alignOffset(1));
+    CPPUNIT_ASSERT_EQUAL(8UL, alignOffset(8));
+    CPPUNIT_ASSERT_EQUAL(16UL, alignOffset(9));
+
+    //Mapped files hold the contents of the file, aligned for doubles
+    writeFile(h);
+    {
+	MappedFile file(TEMP_FILE);
+	CPPUNIT_ASSERT_EQUAL(35UL, file.size());
+	CPPUNIT_ASSERT(memcmp(h.data(), file.data(), h.size()) == 0);
+	CPPUNIT_ASSERT_EQUAL(static_cast<uintptr_t>(0),
+			     reinterpret_cast<uintptr_t>(file.data()) %
+			     sizeof(double));
+    }
+    writeFile("");
+    {
+	MappedFile file(TEMP_FILE);
+	CPPUNIT_ASSERT_EQUAL(0UL, file.size());
+    }
+    std::remove(TEMP_FILE);
+    CPPUNIT_ASSERT_THROW(MappedFile file(TEMP_FILE), runtime_error);
+}
+
+void TraceFileTest::round_trip()
+{
+    /*
+      Values written by the CODA command in binary format are read
+      back unchanged, including missing values, for monitors that
+      pool over iterations or chains.
+    */
+    unsigned int const nchain = 2;
+    BUGSModel model(nchain);
+    ConstantNode *node = nullptr;
+    {
+	NodeArena::Scope scope(&model.arena());
+	node = new ConstantNode(vector<unsigned long>(1, 2),
+				vector<double>(2, 0), nchain, true);
+	model.addNode(node);
+    }
+    model.initialize(false);
+
+    NodeArray array("x", vector<unsigned long>(1, 2), nchain);
+    array.insert(node, SimpleRange(vector<unsigned long>(1, 1),
+				   vector<unsigned long>(1, 2)));
+    NodeArraySubset subset(&array, SimpleRange());
+    vector<string> names = {"x[1]", "x[2]"};
+
+    TraceMonitor trace(subset);
+    MeanMonitor mean(subset);
+    PoolVarianceMonitor pvar(subset);
+    jags::Monitor *m[3] = {&trace, &mean, &pvar};
+    for (unsigned int i = 0; i < 3; ++i) {
+	m[i]->setName("x");
+	m[i]->setElementNames(names);
+    }
+    model.addMonitor(&trace, 1);
+    model.addMonitor(&mean, 2);
+    model.addMonitor(&pvar, 1);
+
+    for (unsigned int t = 0; t < 8; ++t) {
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    double v[2] = {0.1 * t - ch, 1.0E6 + t * ch};
+	    if (t == 3 && ch == 1) v[0] = JAGS_NA;
+	    node->setValue(v, 2, ch);
+	}
+	model.update(1);
+    }
+
+    string warn;
+    model.coda("testtracefile_", warn, "*", true);
+    CPPUNIT_ASSERT_EQUAL(string(), warn);
+
+    TraceFile file(TRACE_FILE);
+    CPPUNIT_ASSERT_EQUAL(3U, file.size());
+    CPPUNIT_ASSERT_EQUAL(0U, file.find("x"));
+    CPPUNIT_ASSERT_EQUAL(3U, file.find("y"));
+    for (unsigned int i = 0; i < 3; ++i) {
+	CPPUNIT_ASSERT_EQUAL(string("x"), file.name(i));
+	CPPUNIT_ASSERT_EQUAL(m[i]->type(), file.type(i));
+	CPPUNIT_ASSERT(file.dim(i) == vector<unsigned long>(1, 2));
+	CPPUNIT_ASSERT(file.elementNames(i) == names);
+	CPPUNIT_ASSERT_EQUAL(m[i]->poolChains(), file.poolChains(i));
+	CPPUNIT_ASSERT_EQUAL(m[i]->poolIterations(), file.poolIterations(i));
+	CPPUNIT_ASSERT_EQUAL(1UL, file.start(i));
+	unsigned int nch = m[i]->poolChains() ? 1 : nchain;
+	CPPUNIT_ASSERT_EQUAL(nch, file.nchain(i));
+	unsigned long niter = file.niter(i);
+	for (unsigned int ch = 0; ch < nch; ++ch) {
+	    vector<double> const &value = m[i]->value(ch);
+	    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2 * niter), value.size());
+	    for (unsigned long v = 0; v < 2; ++v) {
+		double const *column = file.column(i, v, ch);
+		for (unsigned long k = 0; k < niter; ++k) {
+		    CPPUNIT_ASSERT(same(value[2 * k + v], column[k]));
+		}
+	    }
+	}
+    }
+    CPPUNIT_ASSERT_EQUAL(8UL, file.niter(0));
+    CPPUNIT_ASSERT_EQUAL(1UL, file.thin(0));
+    CPPUNIT_ASSERT_EQUAL(2UL, file.thin(1));
+    CPPUNIT_ASSERT(jags_isna(file.column(0, 0, 1)[3]));
+    CPPUNIT_ASSERT_THROW(file.column(0, 2, 0), std::logic_error);
+    CPPUNIT_ASSERT_THROW(file.column(2, 0, 1), std::logic_error);
+
+    model.removeMonitor(&trace);
+    model.removeMonitor(&mean);
+    model.removeMonitor(&pvar);
+}
+
+static string traceFile(TraceFile::Record r, unsigned long nvalue)
+{
+    /* A file containing a single record and nvalue values */
+    string out = TraceFile::fileHeader(1);
+    r.offset = alignOffset(out.size() + TraceFile::recordHeader(r).size());
+    out.append(TraceFile::recordHeader(r));
+    out.resize(r.offset, '\0');
+    for (unsigned long i = 0; i < nvalue; ++i) {
+	double x = i;
+	out.append(reinterpret_cast<char const*>(&x), sizeof(x));
+    }
+    return out;
+}
+
+void TraceFileTest::truncated()
+{
+    /*
+      A file that is truncated, or has sizes too large for the file,
+      is rejected, including sizes whose product overflows.
+    */
+    TraceFile::Record r;
+    r.name = "y";
+    r.type = "trace";
+    r.dim = vector<unsigned long>(1, 3);
+    r.nchain = 2;
+    r.niter = 4;
+    r.start = 11;
+    r.thin = 1;
+    r.flags = 0;
+    r.offset = 0;
+    r.elt_names = {"y[1]", "y[2]", "y[3]"};
+
+    string contents = traceFile(r, 24);
+    writeFile(contents);
+    {
+	TraceFile file(TEMP_FILE);
+	CPPUNIT_ASSERT_EQUAL(1U, file.size());
+	CPPUNIT_ASSERT_EQUAL(11UL, file.start(0));
+	CPPUNIT_ASSERT(file.elementNames(0) == r.elt_names);
+	//Columns for element 2, chain 2
+	CPPUNIT_ASSERT_EQUAL(12.0, file.column(0, 1, 1)[0]);
+	CPPUNIT_ASSERT_EQUAL(15.0, file.column(0, 1, 1)[3]);
+    }
+
+    unsigned long header = TraceFile::fileHeader(1).size() +
+	TraceFile::recordHeader(r).size();
+    unsigned long len[] = {0, 4, 20, 40, header - 1, header,
+			   contents.size() - 1,
+			   contents.size() - sizeof(double)};
+    for (unsigned long n : len) {
+	writeFile(contents.substr(0, n));
+	CPPUNIT_ASSERT_THROW(TraceFile file(TEMP_FILE), runtime_error);
+    }
+
+    //The number of values overflows
+    TraceFile::Record r2 = r;
+    r2.nchain = 4;
+    r2.niter = 1UL << 62;
+    writeFile(traceFile(r2, 24));
+    CPPUNIT_ASSERT_THROW(TraceFile file(TEMP_FILE), runtime_error);
+
+    //The number of elements overflows
+    r2 = r;
+    r2.dim = vector<unsigned long>(2, 1UL << 32);
+    r2.niter = 0;
+    r2.elt_names.clear();
+    writeFile(traceFile(r2, 0));
+    CPPUNIT_ASSERT_THROW(TraceFile file(TEMP_FILE), runtime_error);
+
+    //A continued record must follow a record for the same monitor
+    r2 = r;
+    r2.flags = TraceFile::CONTINUED;
+    writeFile(traceFile(r2, 24));
+    CPPUNIT_ASSERT_THROW(TraceFile file(TEMP_FILE), runtime_error);
+}
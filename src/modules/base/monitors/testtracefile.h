@@ -0,0 +1,29 @@
+#ifndef TRACE_FILE_TEST_H_
+#define TRACE_FILE_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <testlib.h>
+
+namespace jags {
+    class RNGFactory;
+}
+
+class TraceFileTest : public CppUnit::TestFixture, public JAGSFixture
+{
+    CPPUNIT_TEST_SUITE( TraceFileTest );
+    CPPUNIT_TEST( binaryio );
+    CPPUNIT_TEST( round_trip );
+    CPPUNIT_TEST( truncated );
+    CPPUNIT_TEST_SUITE_END();
+
+    jags::RNGFactory *_rngfac;
+
+public:
+    void setUp();
+    void tearDown();
+    void binaryio();
+    void round_trip();
+    void truncated();
+};
+
+#endif /* TRACE_FILE_TEST_H_ */
@@ -3,6 +3,7 @@
 #include "MarsagliaRNG.h"
 #include "SuperDuperRNG.h"
 #include "MersenneTwisterRNG.h"
+#include "PhiloxRNG.h"
 
 #include <ctime>
 #include <climits>
@@ -70,6 +71,11 @@ namespace base {
     }
 
     RNG * BaseRNGFactory::makeRNG(string const &name)
+    {
+	return makeRNG(name, 0);
+    }
+
+    RNG * BaseRNGFactory::makeRNG(string const &name, unsigned int chain)
     {
 	unsigned int seed = static_cast<unsigned int>(time(nullptr));
 
@@ -82,6 +88,8 @@ namespace base {
 	    rng = new SuperDuperRNG(seed, DEFAULT_NORM_KIND);
 	else if (name == "base::Mersenne-Twister")
 	    rng = new MersenneTwisterRNG(seed, DEFAULT_NORM_KIND);
+	else if (name == "base::Philox")
+	    rng = new PhiloxRNG(seed, chain, DEFAULT_NORM_KIND);
 	else
 	    return nullptr;
 
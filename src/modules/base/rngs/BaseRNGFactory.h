@@ -8,6 +8,10 @@ namespace base {
     
 /**
  * @short Factory object for Base Random Number Generators
+ *
+ * The Philox generator is only created by name. The stream number
+ * of a Philox RNG is the index of its chain, so the RNGs of different
+ * chains are independent even if they are given the same seed.
  */
     class BaseRNGFactory : public RNGFactory
     {
@@ -20,6 +24,7 @@ namespace base {
 	void setSeed(unsigned int seed) override;
 	std::vector<RNG *> makeRNGs(unsigned int n) override;
 	RNG * makeRNG(std::string const &name) override;
+	RNG * makeRNG(std::string const &name, unsigned int chain) override;
 	std::string name() const override;
     };
 
@@ -0,0 +1,204 @@
+#include <config.h>
+#include "PhiloxRNG.h"
+
+/*
+  Philox4x32-10 from
+
+  Salmon JK, Moraes MA, Dror RO, Shaw DE (2011) Parallel random
+  numbers: as easy as 1, 2, 3. Proceedings of the International
+  Conference for High Performance Computing, Networking, Storage and
+  Analysis.
+*/
+
+using std::vector;
+using std::uint32_t;
+using std::uint64_t;
+
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+#define PHILOX_ROUNDS 10
+
+/* Number of blocks generated together by the bulk generator */
+#define NLANE 8
+
+namespace jags {
+namespace base {
+
+    static inline void philoxRound(uint32_t &c0, uint32_t &c1, uint32_t &c2,
+				   uint32_t &c3, uint32_t k0, uint32_t k1)
+    {
+	uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * c0;
+	uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * c2;
+	uint32_t hi0 = static_cast<uint32_t>(p0 >> 32);
+	uint32_t lo0 = static_cast<uint32_t>(p0);
+	uint32_t hi1 = static_cast<uint32_t>(p1 >> 32);
+	uint32_t lo1 = static_cast<uint32_t>(p1);
+	c0 = hi1 ^ c1 ^ k0;
+	c1 = lo1;
+	c2 = hi0 ^ c3 ^ k1;
+	c3 = lo0;
+    }
+
+    static void philox(uint32_t const counter[4], uint32_t const key[2],
+		       uint32_t block[4])
+    {
+	uint32_t c0 = counter[0], c1 = counter[1];
+	uint32_t c2 = counter[2], c3 = counter[3];
+	uint32_t k0 = key[0], k1 = key[1];
+	for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+	    philoxRound(c0, c1, c2, c3, k0, k1);
+	    k0 += PHILOX_W0;
+	    k1 += PHILOX_W1;
+	}
+	block[0] = c0; block[1] = c1; block[2] = c2; block[3] = c3;
+    }
+
+    static inline double toDouble(uint32_t a, uint32_t b)
+    {
+	/* Uses 53 bits from a and b. The result is in (0,1) */
+	/* The shifted values are converted via int, which vectorizes */
+	int ia = static_cast<int>(a >> 5), ib = static_cast<int>(b >> 6);
+	return (ia * 67108864.0 + ib + 0.5) / 9007199254740992.0;
+    }
+
+    /* Adds n to a 128-bit counter */
+    static void advance(uint32_t counter[4], uint64_t n)
+    {
+	uint64_t lo = counter[0] | static_cast<uint64_t>(counter[1]) << 32;
+	uint64_t hi = counter[2] | static_cast<uint64_t>(counter[3]) << 32;
+	uint64_t newlo = lo + n;
+	if (newlo < lo) ++hi;
+	counter[0] = static_cast<uint32_t>(newlo);
+	counter[1] = static_cast<uint32_t>(newlo >> 32);
+	counter[2] = static_cast<uint32_t>(hi);
+	counter[3] = static_cast<uint32_t>(hi >> 32);
+    }
+
+    /* Subtracts 1 from a 128-bit counter */
+    static void retreat(uint32_t counter[4])
+    {
+	uint64_t lo = counter[0] | static_cast<uint64_t>(counter[1]) << 32;
+	uint64_t hi = counter[2] | static_cast<uint64_t>(counter[3]) << 32;
+	if (lo == 0) --hi;
+	--lo;
+	counter[0] = static_cast<uint32_t>(lo);
+	counter[1] = static_cast<uint32_t>(lo >> 32);
+	counter[2] = static_cast<uint32_t>(hi);
+	counter[3] = static_cast<uint32_t>(hi >> 32);
+    }
+
+    PhiloxRNG::PhiloxRNG(unsigned int seed, unsigned int stream,
+			 NormKind norm_kind)
+	: RmathRNG("base::Philox", norm_kind)
+    {
+	_key[1] = stream;
+	init(seed);
+    }
+
+    void PhiloxRNG::init(unsigned int seed)
+    {
+	/* Initial scrambling */
+	for(unsigned int j = 0; j < 50; j++)
+	    seed = (69069 * seed + 1);
+
+	_key[0] = seed;
+	for (int i = 0; i < 4; ++i) {
+	    _counter[i] = 0;
+	    _block[i] = 0;
+	}
+	_pos = 2;
+    }
+
+    double PhiloxRNG::uniform()
+    {
+	if (_pos == 2) {
+	    philox(_counter, _key, _block);
+	    advance(_counter, 1);
+	    _pos = 0;
+	}
+	double x = toDouble(_block[2 * _pos], _block[2 * _pos + 1]);
+	++_pos;
+	return x;
+    }
+
+    void PhiloxRNG::uniform(double *x, unsigned long n)
+    {
+	unsigned long i = 0;
+
+	//Use the rest of the current block
+	while (i < n && _pos < 2) {
+	    x[i++] = uniform();
+	}
+
+	//Generate NLANE blocks at a time. The rounds are applied to
+	//all lanes together so that they can be vectorized.
+	while (n - i >= 2 * NLANE) {
+	    uint32_t c0[NLANE], c1[NLANE], c2[NLANE], c3[NLANE];
+	    for (unsigned int l = 0; l < NLANE; ++l) {
+		uint32_t counter[4] = {_counter[0], _counter[1],
+				       _counter[2], _counter[3]};
+		advance(counter, l);
+		c0[l] = counter[0]; c1[l] = counter[1];
+		c2[l] = counter[2]; c3[l] = counter[3];
+	    }
+	    uint32_t k0 = _key[0], k1 = _key[1];
+	    for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+		#pragma omp simd
+		for (unsigned int l = 0; l < NLANE; ++l) {
+		    philoxRound(c0[l], c1[l], c2[l], c3[l], k0, k1);
+		}
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	    }
+	    for (unsigned int l = 0; l < NLANE; ++l) {
+		x[i + 2 * l] = toDouble(c0[l], c1[l]);
+		x[i + 2 * l + 1] = toDouble(c2[l], c3[l]);
+	    }
+	    advance(_counter, NLANE);
+	    i += 2 * NLANE;
+	}
+
+	while (i < n) {
+	    x[i++] = uniform();
+	}
+    }
+
+    bool PhiloxRNG::setState(vector<int> const &state)
+    {
+	if (state.size() != 7)
+	    return false;
+
+	unsigned int pos = static_cast<unsigned int>(state[6]);
+	if (pos > 2)
+	    return false;
+
+	_key[0] = static_cast<uint32_t>(state[0]);
+	_key[1] = static_cast<uint32_t>(state[1]);
+	for (int i = 0; i < 4; ++i) {
+	    _counter[i] = static_cast<uint32_t>(state[i + 2]);
+	}
+	_pos = pos;
+	if (_pos < 2) {
+	    //Regenerate the current block from the previous counter
+	    uint32_t counter[4] = {_counter[0], _counter[1],
+				   _counter[2], _counter[3]};
+	    retreat(counter);
+	    philox(counter, _key, _block);
+	}
+	return true;
+    }
+
+    void PhiloxRNG::getState(vector<int> &state) const
+    {
+	state.clear();
+	state.push_back(static_cast<int>(_key[0]));
+	state.push_back(static_cast<int>(_key[1]));
+	for (int i = 0; i < 4; ++i) {
+	    state.push_back(static_cast<int>(_counter[i]));
+	}
+	state.push_back(static_cast<int>(_pos));
+    }
+
+}}
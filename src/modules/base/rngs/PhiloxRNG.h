@@ -0,0 +1,51 @@
+#ifndef PHILOX_RNG_H_
+#define PHILOX_RNG_H_
+
+#include <rng/RmathRNG.h>
+
+#include <cstdint>
+
+namespace jags {
+namespace base {
+
+    /**
+     * @short Philox4x32-10 counter-based generator
+     *
+     * The Philox generator of Salmon et al (2011) produces each block
+     * of four 32-bit values by applying a keyed bijection to a 128-bit
+     * counter. Since blocks do not depend on each other, arrays of
+     * uniforms can be generated several blocks at a time with SIMD
+     * instructions, and any two keys give independent streams.
+     *
+     * The key has two words: the first is set from the seed and the
+     * second is a stream number, which is not changed by init. Each
+     * uniform value uses two 32-bit words, so it has 53 bits of
+     * precision.
+     */
+    class PhiloxRNG : public RmathRNG
+    {
+	std::uint32_t _key[2];
+	std::uint32_t _counter[4]; // Counter for the next block
+	std::uint32_t _block[4];   // Current block
+	unsigned int _pos;         // Number of values used from _block
+    public:
+	/**
+	 * @param seed Seed used to set the first word of the key
+	 * @param stream Stream number, used as the second word of the key
+	 * @param norm_kind Algorithm for normal random variables
+	 */
+	PhiloxRNG(unsigned int seed, unsigned int stream, NormKind norm_kind);
+	void init(unsigned int seed) override;
+	bool setState(std::vector<int> const &state) override;
+	void getState(std::vector<int> &state) const override;
+	double uniform() override;
+	/**
+	 * Fills x with the same values as n successive calls to
+	 * uniform().
+	 */
+	void uniform(double *x, unsigned long n) override;
+    };
+
+}}
+
+#endif /* PHILOX_RNG_H_ */
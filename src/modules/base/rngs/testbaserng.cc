@@ -0,0 +1,240 @@
+#include "testbaserng.h"
+
+#include "BaseRNGFactory.h"
+#include <rng/RNG.h>
+#include <model/Model.h>
+
+#include <vector>
+#include <string>
+
+using std::vector;
+using std::string;
+using jags::RNG;
+using jags::Model;
+
+static const char *rngNames[] = {
+    "base::Wichmann-Hill", "base::Marsaglia-Multicarry",
+    "base::Super-Duper", "base::Mersenne-Twister", "base::Philox"
+};
+
+static const unsigned int NRNG = 5;
+
+void BaseRNGTest::setUp()
+{
+    _factory = new jags::base::BaseRNGFactory;
+}
+
+void BaseRNGTest::tearDown()
+{
+    delete _factory;
+}
+
+void BaseRNGTest::name()
+{
+    CPPUNIT_ASSERT_EQUAL(string("base::BaseRNG"), _factory->name());
+    for (unsigned int i = 0; i < NRNG; ++i) {
+	RNG *rng = _factory->makeRNG(rngNames[i], 0);
+	CPPUNIT_ASSERT(rng != nullptr);
+	CPPUNIT_ASSERT_EQUAL(string(rngNames[i]), rng->name());
+	rng = _factory->makeRNG(rngNames[i]);
+	CPPUNIT_ASSERT(rng != nullptr);
+	CPPUNIT_ASSERT_EQUAL(string(rngNames[i]), rng->name());
+    }
+    CPPUNIT_ASSERT(_factory->makeRNG("base::Undefined", 0) == nullptr);
+    CPPUNIT_ASSERT(_factory->makeRNG("base::Undefined") == nullptr);
+}
+
+static double toDouble(unsigned int a, unsigned int b)
+{
+    //Uses the top 27 bits of a and the top 26 bits of b
+    return ((a >> 5) * 67108864.0 + (b >> 6) + 0.5) / 9007199254740992.0;
+}
+
+void BaseRNGTest::philox_block(unsigned int const counter[4],
+			       unsigned int const key[2],
+			       unsigned int const block[4])
+{
+    /*
+       Set the state so that the next block is generated from the
+       given counter and key, and check the uniforms made from it.
+    */
+    RNG *rng = _factory->makeRNG("base::Philox", 0);
+    vector<int> state(7);
+    state[0] = static_cast<int>(key[0]);
+    state[1] = static_cast<int>(key[1]);
+    for (unsigned int i = 0; i < 4; ++i) {
+	state[i + 2] = static_cast<int>(counter[i]);
+    }
+    state[6] = 2;
+    CPPUNIT_ASSERT(rng->setState(state));
+    CPPUNIT_ASSERT_EQUAL(toDouble(block[0], block[1]), rng->uniform());
+    CPPUNIT_ASSERT_EQUAL(toDouble(block[2], block[3]), rng->uniform());
+}
+
+void BaseRNGTest::philox()
+{
+    /*
+       Known answers for Philox4x32-10 from the Random123 library of
+       Salmon et al (2011)
+    */
+    unsigned int c0[4] = {0, 0, 0, 0};
+    unsigned int k0[2] = {0, 0};
+    unsigned int b0[4] = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+    philox_block(c0, k0, b0);
+
+    unsigned int c1[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+    unsigned int k1[2] = {0xffffffff, 0xffffffff};
+    unsigned int b1[4] = {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd};
+    philox_block(c1, k1, b1);
+
+    unsigned int c2[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+    unsigned int k2[2] = {0xa4093822, 0x299f31d0};
+    unsigned int b2[4] = {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1};
+    philox_block(c2, k2, b2);
+}
+
+void BaseRNGTest::stream()
+{
+    /*
+       The Philox stream depends only on the seed and the chain, not
+       on how many RNGs the factory has already made.
+    */
+    RNG *a0 = _factory->makeRNG("base::Philox", 0);
+    RNG *a1 = _factory->makeRNG("base::Philox", 1);
+    RNG *b0 = _factory->makeRNG("base::Philox", 0);
+    a0->init(314159);
+    a1->init(314159);
+    b0->init(314159);
+
+    vector<int> sa0, sa1, sb0;
+    a0->getState(sa0);
+    a1->getState(sa1);
+    b0->getState(sb0);
+    CPPUNIT_ASSERT(sa0 == sb0);
+    CPPUNIT_ASSERT(sa0 != sa1);
+
+    bool differ = false;
+    for (unsigned int i = 0; i < 10; ++i) {
+	double x = a0->uniform();
+	CPPUNIT_ASSERT_EQUAL(x, b0->uniform());
+	if (x != a1->uniform()) differ = true;
+    }
+    CPPUNIT_ASSERT(differ);
+}
+
+void BaseRNGTest::state_rng(RNG *rng)
+{
+    /*
+       Restoring a saved state must reproduce the same values. An odd
+       number of draws leaves the Philox generator part way through
+       a block.
+    */
+    rng->init(271828);
+    for (unsigned int i = 0; i < 7; ++i) {
+	rng->uniform();
+    }
+    vector<int> state;
+    rng->getState(state);
+    vector<double> x(25);
+    for (unsigned int i = 0; i < x.size(); ++i) {
+	x[i] = rng->uniform();
+    }
+
+    CPPUNIT_ASSERT_MESSAGE(rng->name(), rng->setState(state));
+    vector<int> state2;
+    rng->getState(state2);
+    CPPUNIT_ASSERT_MESSAGE(rng->name(), state == state2);
+    for (unsigned int i = 0; i < x.size(); ++i) {
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(rng->name(), x[i], rng->uniform());
+    }
+
+    //A state of the wrong length is rejected
+    vector<int> bad(state);
+    bad.push_back(0);
+    CPPUNIT_ASSERT_MESSAGE(rng->name(), !rng->setState(bad));
+}
+
+void BaseRNGTest::state()
+{
+    for (unsigned int i = 0; i < NRNG; ++i) {
+	state_rng(_factory->makeRNG(rngNames[i], 0));
+    }
+}
+
+void BaseRNGTest::bulk_rng(RNG *rng)
+{
+    /* Bulk generation gives the same values as successive calls */
+    rng->init(161803);
+    vector<int> state;
+    rng->getState(state);
+
+    unsigned int n[3] = {3, 40, 1};
+    vector<double> x;
+    for (unsigned int k = 0; k < 3; ++k) {
+	vector<double> y(n[k]);
+	rng->uniform(&y[0], n[k]);
+	x.insert(x.end(), y.begin(), y.end());
+    }
+
+    rng->setState(state);
+    for (unsigned int i = 0; i < x.size(); ++i) {
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(rng->name(), rng->uniform(), x[i]);
+    }
+}
+
+void BaseRNGTest::bulk()
+{
+    for (unsigned int i = 0; i < NRNG; ++i) {
+	bulk_rng(_factory->makeRNG(rngNames[i], 0));
+    }
+}
+
+void BaseRNGTest::thread_state()
+{
+    /*
+       The state of a chain includes the states of the RNGs of the
+       sampler threads. A saved state is restored with the same
+       number of threads. With a different number of threads, only
+       the chain RNG is restored and the thread RNGs keep their
+       seeds.
+    */
+    Model::rngFactories().push_back(_factory);
+
+    Model model(1);
+    model.setSamplerThreads(3);
+    model.initialize(false);
+    vector<int> chain;
+    model.rng(0)->getState(chain);
+    unsigned long len = chain.size();
+    vector<int> state;
+    model.getRNGState(state, 0);
+    CPPUNIT_ASSERT_EQUAL(3 * len, static_cast<unsigned long>(state.size()));
+
+    model.rng(0)->uniform();
+    CPPUNIT_ASSERT(model.setRNGState(state, 0));
+    vector<int> state2;
+    model.getRNGState(state2, 0);
+    CPPUNIT_ASSERT(state == state2);
+
+    //A state for 3 threads, restored with 2 threads
+    Model model2(1);
+    CPPUNIT_ASSERT(model2.setRNG(model.rng(0)->name(), 0));
+    model2.setSamplerThreads(2);
+    model2.initialize(false);
+    vector<int> state3;
+    model2.getRNGState(state3, 0);
+    CPPUNIT_ASSERT_EQUAL(2 * len, static_cast<unsigned long>(state3.size()));
+    CPPUNIT_ASSERT(model2.setRNGState(state, 0));
+    vector<int> state4;
+    model2.getRNGState(state4, 0);
+    CPPUNIT_ASSERT(vector<int>(state.begin(), state.begin() + len) ==
+		   vector<int>(state4.begin(), state4.begin() + len));
+    CPPUNIT_ASSERT(vector<int>(state3.begin() + len, state3.end()) ==
+		   vector<int>(state4.begin() + len, state4.end()));
+
+    //A state of the wrong length is rejected
+    state.pop_back();
+    CPPUNIT_ASSERT(!model.setRNGState(state, 0));
+
+    Model::rngFactories().remove(_factory);
+}
@@ -0,0 +1,44 @@
+#ifndef BASE_RNG_TEST_H_
+#define BASE_RNG_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace jags {
+    struct RNG;
+    namespace base {
+	class BaseRNGFactory;
+    }
+}
+
+class BaseRNGTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( BaseRNGTest );
+    CPPUNIT_TEST( name );
+    CPPUNIT_TEST( philox );
+    CPPUNIT_TEST( stream );
+    CPPUNIT_TEST( state );
+    CPPUNIT_TEST( bulk );
+    CPPUNIT_TEST( thread_state );
+    CPPUNIT_TEST_SUITE_END();
+
+    jags::base::BaseRNGFactory *_factory;
+    
+    void philox_block(unsigned int const counter[4],
+		      unsigned int const key[2],
+		      unsigned int const block[4]);
+    void state_rng(jags::RNG *rng);
+    void bulk_rng(jags::RNG *rng);
+    
+  public:
+    void setUp();
+    void tearDown();
+
+    void name();
+    void philox();
+    void stream();
+    void state();
+    void bulk();
+    void thread_state();
+};
+
+#endif /* BASE_RNG_TEST_H_ */
@@ -1,7 +1,13 @@
 #include "testbase.h"
 #include "functions/testbasefun.h"
+#include "rngs/testbaserng.h"
+#include "monitors/testbasemon.h"
+#include "monitors/testtracefile.h"
 #include <cppunit/extensions/HelperMacros.h>
 
 void init_base_test() {
     CPPUNIT_TEST_SUITE_REGISTRATION( BaseFunTest );
+    CPPUNIT_TEST_SUITE_REGISTRATION( BaseRNGTest );
+    CPPUNIT_TEST_SUITE_REGISTRATION( BaseMonTest );
+    CPPUNIT_TEST_SUITE_REGISTRATION( TraceFileTest );
 }
@@ -93,4 +93,26 @@ bool DBern::isDiscreteValued(vector<bool> const &) const
 	return s;
     }
     
+    void DBern::batchLogDensity(double *density, double const *x,
+				unsigned long n, PDFType,
+				vector<double const *> const &par) const
+    {
+	double const *prob = par[0];
+	for (unsigned long i = 0; i < n; ++i) {
+	    double d = 0;
+	    if (prob[i] >= 0 && prob[i] <= 1) {
+		if (x[i] == 1)
+		    d = prob[i];
+		else if (x[i] == 0)
+		    d = 1 - prob[i];
+	    }
+	    density[i] = d == 0 ? JAGS_NEGINF : log(d);
+	}
+    }
+
+    bool DBern::hasBatchLogDensity() const
+    {
+	return true;
+    }
+
 }}
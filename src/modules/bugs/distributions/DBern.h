@@ -35,6 +35,11 @@ public:
     bool hasScore(unsigned long i) const override;
     double score(double x, std::vector<double const *> const &parameters,
 		 unsigned long i) const override;
+    void batchLogDensity(double *density, double const *x, unsigned long n,
+			 PDFType type,
+			 std::vector<double const *> const &parameters)
+	const override;
+    bool hasBatchLogDensity() const override;
 		 
 };
 
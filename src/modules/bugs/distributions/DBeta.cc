@@ -101,4 +101,17 @@ double DBeta::KL(vector<double const *> const &par1,
 	}
     }
     
+
+    bool DBeta::hasValueScore() const
+    {
+	return true;
+    }
+
+    double DBeta::valueScore(double x, vector<double const *> const &par) const
+    {
+	double a = *par[0];
+	double b = *par[1];
+	return (a - 1)/x - (b - 1)/(1 - x);
+    }
+
 }}
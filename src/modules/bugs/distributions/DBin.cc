@@ -16,6 +16,24 @@ using std::string;
 /* BUGS parameterization is in opposite order to R parameterization */
 #define SIZE(par) (*par[1])
 #define PROB(par) (*par[0])
+#define R_D_nonint(x)     (fabs((x) - floor((x)+0.5)) > 1e-7)
+
+/* Binomial log density without the binomial coefficient */
+static inline double binomKernel(double x, double p, double n)
+{
+    if (x < 0 || x > n || R_D_nonint(x)) {
+	return JAGS_NEGINF;
+    }
+    else if (p == 0) {
+	return x == 0 ? 0 : JAGS_NEGINF;
+    }
+    else if (p == 1) {
+	return x == n ? 0 : JAGS_NEGINF;
+    }
+    else {
+	return x * log(p) + (n - x) * log1p(-p);
+    }
+}
 
 namespace jags {
 namespace bugs {
@@ -118,4 +136,52 @@ double DBin::KL(vector<double const *> const &par0,
 	return x/p - (N - x)/(1 - p);
     }
 
+    void DBin::batchLogDensity(double *density, double const *x,
+			       unsigned long n, PDFType,
+			       vector<double const *> const &par) const
+    {
+	double const *prob = par[0];
+	double const *size = par[1];
+	for (unsigned long i = 0; i < n; ++i) {
+	    if (size[i] >= 0 && prob[i] >= 0 && prob[i] <= 1) {
+		density[i] = dbinom(x[i], size[i], prob[i], true);
+	    }
+	    else {
+		density[i] = JAGS_NEGINF;
+	    }
+	}
+    }
+
+    bool DBin::hasBatchLogDensity() const
+    {
+	return true;
+    }
+
+    bool DBin::isNormalizationFixed(vector<bool> const &fixmask) const
+    {
+	return fixmask[1];
+    }
+
+    double DBin::logKernel(double x, vector<double const *> const &par)
+	const
+    {
+	return binomKernel(x, PROB(par), SIZE(par));
+    }
+
+    void DBin::batchLogKernel(double *density, double const *x,
+			      unsigned long n,
+			      vector<double const *> const &par) const
+    {
+	double const *prob = par[0];
+	double const *size = par[1];
+	for (unsigned long i = 0; i < n; ++i) {
+	    if (size[i] >= 0 && prob[i] >= 0 && prob[i] <= 1) {
+		density[i] = binomKernel(x[i], prob[i], size[i]);
+	    }
+	    else {
+		density[i] = JAGS_NEGINF;
+	    }
+	}
+    }
+
 }}
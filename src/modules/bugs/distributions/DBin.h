@@ -43,6 +43,21 @@ class DBin : public RScalarDist {
   bool hasScore(unsigned long i) const override;
   double score(double x, std::vector<double const *> const &parameters,
 	       unsigned long i) const override;
+  void batchLogDensity(double *density, double const *x, unsigned long n,
+		       PDFType type,
+		       std::vector<double const *> const &parameters)
+      const override;
+  bool hasBatchLogDensity() const override;
+  /**
+   * The binomial coefficient is fixed when n is fixed
+   */
+  bool isNormalizationFixed(std::vector<bool> const &fixmask)
+      const override;
+  double logKernel(double x, std::vector<double const *> const &parameters)
+      const override;
+  void batchLogKernel(double *density, double const *x, unsigned long n,
+		      std::vector<double const *> const &parameters)
+      const override;
 };
 
 }}
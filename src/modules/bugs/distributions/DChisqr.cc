@@ -88,5 +88,14 @@ double DChisqr::r(vector<double const *> const &par, RNG *rng) const
 	return (log(x/2) - digamma(DF(parameters)/2))/2;
     }
 
+    bool DChisqr::hasValueScore() const
+    {
+	return true;
+    }
+
+    double DChisqr::valueScore(double x, vector<double const *> const &par) const
+    {
+	return (DF(par)/2 - 1)/x - 0.5;
+    }
 
 }}
@@ -119,4 +119,15 @@ double DDexp::r(vector<double const *> const &par, RNG *rng) const
 	return SCALE(parameters) - fabs(x - MU(parameters));
     }
 
+    bool DDexp::hasValueScore() const
+    {
+	return true;
+    }
+
+    double DDexp::valueScore(double x, vector<double const *> const &par) const
+    {
+	double y = x - MU(par);
+	return y > 0 ? -RATE(par) : (y < 0 ? RATE(par) : 0);
+    }
+
 }}
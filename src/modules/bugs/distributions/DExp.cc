@@ -71,4 +71,15 @@ double DExp::KL(vector<double const *> const &par0,
     {
 	return SCALE(parameters) - x;
     }
+
+    bool DExp::hasValueScore() const
+    {
+	return true;
+    }
+
+    double DExp::valueScore(double x, vector<double const *> const &par) const
+    {
+	return -(*par[0]);
+    }
+
 }}
@@ -36,6 +36,9 @@ class DExp : public RScalarDist {
   bool hasScore(unsigned long i) const override;    
   double score(double x, std::vector<double const *> const &parameters,
 	       unsigned long i) const override;
+  bool hasValueScore() const override;
+  double valueScore(double x, std::vector<double const *> const &parameters)
+      const override;
 };
 
 }}
@@ -75,4 +75,16 @@ double DF::r(vector<double const *> const &par, RNG *rng) const
 		- digamma(d1/2) - digamma((d1 + d2)/2))/2;
     }
 
+    bool DF::hasValueScore() const
+    {
+	return true;
+    }
+
+    double DF::valueScore(double x, vector<double const *> const &par) const
+    {
+	double d1 = *par[0];
+	double d2 = *par[1];
+	return (d1/2 - 1)/x - (d1 + d2) * d1 / (2 * (d2 + d1 * x));
+    }
+
 }}
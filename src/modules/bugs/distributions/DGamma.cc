@@ -96,4 +96,44 @@ double DGamma::KL(vector<double const *> const &par0,
 	}
     }
 
+    void DGamma::batchLogDensity(double *density, double const *x,
+				 unsigned long n, PDFType type,
+				 vector<double const *> const &par) const
+    {
+	double const *shape = par[0];
+	double const *rate = par[1];
+	for (unsigned long i = 0; i < n; ++i) {
+	    if (!(shape[i] > 0 && rate[i] > 0)) {
+		density[i] = JAGS_NEGINF;
+	    }
+	    else if (type != PDF_PRIOR) {
+		density[i] = dgamma(x[i], shape[i], 1/rate[i], true);
+	    }
+	    else if (x[i] < 0) {
+		density[i] = JAGS_NEGINF;
+	    }
+	    else if (x[i] == 0) {
+		density[i] = xlog0(shape[i] - 1, true);
+	    }
+	    else {
+		density[i] = (shape[i] - 1) * log(x[i]) - rate[i] * x[i];
+	    }
+	}
+    }
+
+    bool DGamma::hasBatchLogDensity() const
+    {
+	return true;
+    }
+
+    bool DGamma::hasValueScore() const
+    {
+	return true;
+    }
+
+    double DGamma::valueScore(double x, vector<double const *> const &par) const
+    {
+	return (SHAPE(par) - 1)/x - RATE(par);
+    }
+
 }}
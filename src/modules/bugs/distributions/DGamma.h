@@ -36,6 +36,14 @@ class DGamma : public RScalarDist {
   bool hasScore(unsigned long i) const override;
   double score(double x, std::vector<double const *> const &pars,
 	       unsigned long i) const override;
+  bool hasValueScore() const override;
+  double valueScore(double x, std::vector<double const *> const &pars)
+      const override;
+  void batchLogDensity(double *density, double const *x, unsigned long n,
+		       PDFType type,
+		       std::vector<double const *> const &parameters)
+      const override;
+  bool hasBatchLogDensity() const override;
 };
 
 }}
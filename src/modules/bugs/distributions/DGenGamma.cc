@@ -3,6 +3,8 @@
 
 #include <JRmath.h>
 
+#include <cmath>
+
 /* if x ~ dgen.gamma(r, mu, beta) then (mu*x)^beta ~ dgamma(r, 1) */
 
 using std::vector;
@@ -126,4 +128,17 @@ double DGenGamma::KL(vector<double const *> const &par0,
 
     }
 
+    bool DGenGamma::hasValueScore() const
+    {
+	return true;
+    }
+
+    double DGenGamma::valueScore(double x, vector<double const *> const &par) const
+    {
+	double r = SHAPE(par);
+	double mu = URATE(par);
+	double beta = POW(par);
+	return (beta * r - 1)/x - beta * mu * pow(mu * x, beta - 1);
+    }
+
 }}
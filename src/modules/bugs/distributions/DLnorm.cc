@@ -87,4 +87,14 @@ DLnorm::KL(vector<double const *> const &par0,
 	}
     }
 
+    bool DLnorm::hasValueScore() const
+    {
+	return true;
+    }
+
+    double DLnorm::valueScore(double x, vector<double const *> const &par) const
+    {
+	return -(1 + TAU(par) * (log(x) - MU(par)))/x;
+    }
+
 }}
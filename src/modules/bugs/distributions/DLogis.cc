@@ -3,6 +3,8 @@
 
 #include <JRmath.h>
 
+#include <cmath>
+
 using std::vector;
 
 #define MU(par) (*par[0])
@@ -73,4 +75,15 @@ DLogis::r(vector<double const *> const &par, RNG *rng) const
 	}
     }
 
+    bool DLogis::hasValueScore() const
+    {
+	return true;
+    }
+
+    double DLogis::valueScore(double x, vector<double const *> const &par) const
+    {
+	double lambda = LAMBDA(par);
+	return -lambda * tanh(lambda * (x - MU(par))/2);
+    }
+
 }}
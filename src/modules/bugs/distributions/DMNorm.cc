@@ -282,4 +282,24 @@ void DMNorm::score(double *s, double const *x,
     }
 }
 
+bool DMNorm::hasValueScore() const
+{
+    return true;
+}
+
+void DMNorm::valueScore(double *s, double const *x,
+			vector<double const *> const &parameters,
+			vector<vector<unsigned long>> const &dims) const
+{
+    double const * mu = parameters[0];
+    double const * T = parameters[1];
+    unsigned long m = dims[0][0];
+
+    for (unsigned long j = 0; j < m; ++j) {
+	for (unsigned long k = 0; k < m; ++k) {
+	    s[j] -= T[j + k * m] * (x[k] - mu[k]);
+	}
+    }
+}
+
 }}
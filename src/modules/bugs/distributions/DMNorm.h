@@ -74,6 +74,11 @@ public:
 	     std::vector<double const *> const &parameters,
 	     std::vector<std::vector<unsigned long>> const &dims, 
 	     unsigned long i) const override;
+  bool hasValueScore() const override;
+  void valueScore(double *s, double const *x,
+		  std::vector<double const *> const &parameters,
+		  std::vector<std::vector<unsigned long>> const &dims)
+      const override;
     
 };
 
@@ -14,6 +14,7 @@ using std::string;
 
 #define PROB(par) (*par[0])
 #define SIZE(par) (*par[1])
+#define R_D_nonint(x)     (fabs((x) - floor((x)+0.5)) > 1e-7)
 
 namespace jags {
 namespace bugs {
@@ -126,4 +127,29 @@ double DNegBin::KL(vector<double const *> const &par0,
 	}
     }
 
+    bool DNegBin::isNormalizationFixed(vector<bool> const &fixmask) const
+    {
+	return fixmask[1];
+    }
+
+    double DNegBin::logKernel(double x, vector<double const *> const &par)
+	const
+    {
+	double p = PROB(par);
+	double r = SIZE(par);
+
+	if (!std::isfinite(r)) {
+	    return d(x, PDF_LIKELIHOOD, par, true);
+	}
+	if (x < 0 || !std::isfinite(x) || R_D_nonint(x)) {
+	    return JAGS_NEGINF;
+	}
+	else if (r == 0 || p == 1) {
+	    return x == 0 ? 0 : JAGS_NEGINF;
+	}
+	else {
+	    return r * log(p) + x * log1p(-p);
+	}
+    }
+
 }}
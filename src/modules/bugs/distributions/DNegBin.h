@@ -36,6 +36,14 @@ class DNegBin : public RScalarDist {
   bool hasScore(unsigned long i) const override;
   double score(double x, std::vector<double const *> const &parameters,
 	       unsigned long i) const override;
+  /**
+   * The normalizing constant depends only on x and r, so it is fixed
+   * when r is fixed
+   */
+  bool isNormalizationFixed(std::vector<bool> const &fixmask)
+      const override;
+  double logKernel(double x, std::vector<double const *> const &parameters)
+      const override;
 };
 
 }}
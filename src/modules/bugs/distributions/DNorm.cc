@@ -118,4 +118,41 @@ double DNorm::randomSample(vector<double const *> const &par,
     }
 
     
+    void DNorm::batchLogDensity(double *density, double const *x,
+				unsigned long n, PDFType,
+				vector<double const *> const &par) const
+    {
+	double const *mu = par[0];
+	double const *tau = par[1];
+	for (unsigned long i = 0; i < n; ++i) {
+	    if (tau[i] > 0 && tau[i] < JAGS_POSINF) {
+		double y = x[i] - mu[i];
+		density[i] = 0.5 * log(tau[i]) - M_LN_SQRT_2PI
+		    - 0.5 * tau[i] * y * y;
+	    }
+	    else if (tau[i] > 0) {
+		//Point mass at the mean
+		density[i] = dnorm(x[i], mu[i], 0, true);
+	    }
+	    else {
+		density[i] = JAGS_NEGINF;
+	    }
+	}
+    }
+
+    bool DNorm::hasBatchLogDensity() const
+    {
+	return true;
+    }
+
+    bool DNorm::hasValueScore() const
+    {
+	return true;
+    }
+
+    double DNorm::valueScore(double x, vector<double const *> const &par) const
+    {
+	return -TAU(par) * (x - MU(par));
+    }
+
 }}
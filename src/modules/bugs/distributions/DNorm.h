@@ -44,6 +44,14 @@ class DNorm : public RScalarDist {
   bool hasScore(unsigned long i) const override;
   double score(double x, std::vector<double const *> const &parameters,
 	       unsigned long i) const override;    
+  bool hasValueScore() const override;
+  double valueScore(double x, std::vector<double const *> const &parameters)
+      const override;
+  void batchLogDensity(double *density, double const *x, unsigned long n,
+		       PDFType type,
+		       std::vector<double const *> const &parameters)
+      const override;
+  bool hasBatchLogDensity() const override;
 };
 
 }}
@@ -116,4 +116,14 @@ bool DPar::isSupportFixed(vector<bool> const &fixmask) const
 	return 1/ALPHA(parameters) + log(C(parameters)) - log(x);
     }
 
+    bool DPar::hasValueScore() const
+    {
+	return true;
+    }
+
+    double DPar::valueScore(double x, vector<double const *> const &par) const
+    {
+	return -(ALPHA(par) + 1)/x;
+    }
+
 }}
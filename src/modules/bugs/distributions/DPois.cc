@@ -76,10 +76,47 @@ double DPois::r(vector<double const *> const &par, RNG *rng) const
 	return lambda0 * (log(lambda0) - log(lambda1)) - lambda0 + lambda1;
     }
 
+    bool DPois::hasScore(unsigned long i) const
+    {
+	return true;
+    }
+
     double DPois::score(double x, vector<double const *> const &par,
 			unsigned long i) const
     {
 	return x/LAMBDA(par) - 1;
     }
 
+    void DPois::batchLogDensity(double *density, double const *x,
+				unsigned long n, PDFType type,
+				vector<double const *> const &par) const
+    {
+	double const *lambda = par[0];
+	if (type != PDF_LIKELIHOOD) {
+	    for (unsigned long i = 0; i < n; ++i) {
+		density[i] = lambda[i] >= 0 ? 
+		    dpois(x[i], lambda[i], true) : JAGS_NEGINF;
+	    }
+	    return;
+	}
+	//Likelihood without the normalizing constant, as in d()
+	for (unsigned long i = 0; i < n; ++i) {
+	    double y = JAGS_NEGINF;
+	    if (lambda[i] >= 0 && x[i] >= 0 && !(lambda[i] == 0 && x[i] != 0)
+		&& !R_D_nonint(x[i]) && isfinite(lambda[i]))
+	    {
+		y = -lambda[i];
+		if (lambda[i] > 0) {
+		    y += x[i] * log(lambda[i]);
+		}
+	    }
+	    density[i] = y;
+	}
+    }
+
+    bool DPois::hasBatchLogDensity() const
+    {
+	return true;
+    }
+
 }}
@@ -33,8 +33,14 @@ class DPois : public RScalarDist {
       const override;
   double KL(std::vector<double const *> const &par0,
 	    std::vector<double const *> const &par1) const override;
+  bool hasScore(unsigned long i) const override;
   double score(double x, std::vector<double const *> const &parameters,
 	       unsigned long i) const override;
+  void batchLogDensity(double *density, double const *x, unsigned long n,
+		       PDFType type,
+		       std::vector<double const *> const &parameters)
+      const override;
+  bool hasBatchLogDensity() const override;
 };
 
 }}
@@ -87,4 +87,17 @@ double DT::r(vector<double const *> const &par, RNG *rng) const
 	return score;
     }
 
+    bool DT::hasValueScore() const
+    {
+	return true;
+    }
+
+    double DT::valueScore(double x, vector<double const *> const &par) const
+    {
+	double mu = MU(par);
+	double tau = TAU(par);
+	double df = DF(par);
+	return -(df + 1) * (x - mu) * tau / (df + (x - mu) * (x - mu) * tau);
+    }
+
 }}
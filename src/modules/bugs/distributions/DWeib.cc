@@ -77,4 +77,16 @@ namespace bugs {
 	}
     }
 
+    bool DWeib::hasValueScore() const
+    {
+	return true;
+    }
+
+    double DWeib::valueScore(double x, vector<double const *> const &par) const
+    {
+	double shape = SHAPE(par);
+	double rate = RATE(par);
+	return (shape - 1)/x - rate * shape * pow(x, shape - 1);
+    }
+
 }}
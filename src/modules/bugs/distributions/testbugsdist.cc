@@ -35,6 +35,7 @@
 #include "DWish.h"
 
 #include <MersenneTwisterRNG.h>
+#include <util/nainf.h>
 #include <JRmath.h>
 
 #include <cmath>
@@ -802,4 +803,265 @@ void BugsDistTest::dkw()
     dkwtest(_dweib, mkPar(2, 2));
     dkwtest(_dweib, mkPar(0.3, 0.5));
 }
+
+void BugsDistTest::batch_scalar(ScalarDist const *dist,
+				vector<double> const &x,
+				vector<vector<double> > const &par)
+{
+    /*
+       Test batched log density calculations against the scalar
+       log density, for all combinations of values and parameters
+    */
+
+    CPPUNIT_ASSERT_MESSAGE(dist->name(), dist->hasBatchLogDensity());
+    CPPUNIT_ASSERT_MESSAGE(dist->name(), checkNPar(dist, par.size()));
+
+    //Expand all combinations into structure-of-arrays form
+    unsigned long n = x.size();
+    for (unsigned long j = 0; j < par.size(); ++j) {
+	n *= par[j].size();
+    }
+    vector<double> xb(n);
+    vector<vector<double> > parb(par.size(), vector<double>(n));
+    for (unsigned long i = 0; i < n; ++i) {
+	unsigned long k = i;
+	xb[i] = x[k % x.size()];
+	k /= x.size();
+	for (unsigned long j = 0; j < par.size(); ++j) {
+	    parb[j][i] = par[j][k % par[j].size()];
+	    k /= par[j].size();
+	}
+    }
+    vector<double const *> pb(par.size());
+    for (unsigned long j = 0; j < par.size(); ++j) {
+	pb[j] = &parb[j][0];
+    }
+
+    jags::PDFType types[3] = {jags::PDF_FULL, jags::PDF_PRIOR,
+			      jags::PDF_LIKELIHOOD};
+    vector<double> density(n);
+    for (unsigned int t = 0; t < 3; ++t) {
+	dist->batchLogDensity(&density[0], &xb[0], n, types[t], pb);
+	vector<double const *> ps(par.size());
+	for (unsigned long i = 0; i < n; ++i) {
+	    for (unsigned long j = 0; j < par.size(); ++j) {
+		ps[j] = &parb[j][i];
+	    }
+	    double y = JAGS_NEGINF;
+	    if (dist->checkParameterValue(ps)) {
+		y = dist->logDensity(xb[i], types[t], ps, 0, 0);
+	    }
+	    if (isfinite(y)) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(dist->name(), y,
+						     density[i],
+						     tol * max(1.0, abs(y)));
+	    }
+	    else if (isnan(y)) {
+		CPPUNIT_ASSERT_MESSAGE(dist->name(), isnan(density[i]));
+	    }
+	    else {
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(dist->name(), y, density[i]);
+	    }
+	}
+    }
+}
+
+void BugsDistTest::batch()
+{
+    /* Batched log densities: see batch_scalar for details */
+
+    vector<double> xr = {-3.5, -1, 0, 0.2, 1, 2.7, 15, JAGS_POSINF};
+    vector<double> xd = {-1, 0, 1, 2, 3, 7, 20};
     
+    batch_scalar(_dnorm, xr, {{-2, 0, 1.5, JAGS_POSINF},
+			      {-1, 0, 0.01, 1, 30, JAGS_POSINF}});
+    batch_scalar(_dpois, xd, {{-1, 0, 0.3, 4, 100, JAGS_POSINF}});
+    batch_scalar(_dbern, xd, {{-0.1, 0, 0.25, 1, 1.5}});
+    batch_scalar(_dbin, xd, {{-0.1, 0, 0.3, 0.9, 1},
+			     {-1, 0, 1, 5, 20}});
+    batch_scalar(_dgamma, xr, {{-1, 0, 0.3, 1, 2.5, 1e4},
+			       {-1, 0, 0.1, 1, 7}});
+}
+
+void BugsDistTest::kernel_scalar(ScalarDist const *dist,
+				 vector<double> const &x,
+				 vector<vector<double> > const &par,
+				 unsigned long fixed)
+{
+    /*
+       When parameter "fixed" is fixed, the full log density and the
+       log kernel must differ by a term that depends only on x and
+       the fixed parameter. Check this for all combinations of values
+       and valid parameters.
+    */
+
+    vector<bool> fixmask(par.size(), false);
+    CPPUNIT_ASSERT_MESSAGE(dist->name(), !dist->isNormalizationFixed(fixmask));
+    fixmask[fixed] = true;
+    CPPUNIT_ASSERT_MESSAGE(dist->name(), dist->isNormalizationFixed(fixmask));
+
+    unsigned long ncomb = 1;
+    for (unsigned long j = 0; j < par.size(); ++j) {
+	ncomb *= par[j].size();
+    }
+    vector<double const *> ps(par.size());
+    for (unsigned long i = 0; i < x.size(); ++i) {
+	vector<double> cst(par[fixed].size(), JAGS_NAN);
+	for (unsigned long c = 0; c < ncomb; ++c) {
+	    unsigned long k = c, kfix = 0;
+	    for (unsigned long j = 0; j < par.size(); ++j) {
+		if (j == fixed) kfix = k % par[j].size();
+		ps[j] = &par[j][k % par[j].size()];
+		k /= par[j].size();
+	    }
+	    if (!dist->checkParameterValue(ps)) continue;
+	    
+	    double full = dist->logDensity(x[i], jags::PDF_FULL, ps, 0, 0);
+	    double y = dist->logKernel(x[i], ps);
+	    if (!isfinite(full)) {
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(dist->name(), full, y);
+		continue;
+	    }
+	    CPPUNIT_ASSERT_MESSAGE(dist->name(), isfinite(y));
+	    if (isnan(cst[kfix])) {
+		cst[kfix] = full - y;
+	    }
+	    else {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(dist->name(), cst[kfix],
+						     full - y,
+						     tol * max(1.0, abs(full)));
+	    }
+	}
+    }
+}
+
+void BugsDistTest::kernel()
+{
+    /* Likelihood without fixed normalizing constant */
+
+    vector<double> xd = {-1, 0, 1, 2, 3, 7, 20};
+
+    kernel_scalar(_dbin, xd, {{0, 0.01, 0.3, 0.9, 1},
+			      {0, 1, 5, 20, 100}}, 1);
+    kernel_scalar(_dnegbin, xd, {{0.01, 0.3, 0.9, 1},
+				 {0, 0.5, 1, 5, 20}}, 1);
+
+    /* Batched kernel must agree with the scalar version */
+    vector<double> prob = {-0.1, 0, 0.3, 0.9, 1, 0.3};
+    vector<double> size = {5, 5, 20, 2, 7, -1};
+    vector<double> x = {2, 0, 20, 1, 7, 0};
+    vector<double const *> pb = {&prob[0], &size[0]};
+    vector<double> density(x.size());
+    _dbin->batchLogKernel(&density[0], &x[0], x.size(), pb);
+    for (unsigned long i = 0; i < x.size(); ++i) {
+	vector<double const *> ps = {&prob[i], &size[i]};
+	double y = JAGS_NEGINF;
+	if (_dbin->checkParameterValue(ps)) {
+	    y = _dbin->logKernel(x[i], ps);
+	}
+	CPPUNIT_ASSERT_EQUAL(y, density[i]);
+    }
+}
+
+void BugsDistTest::factor()
+{
+    /*
+       Multivariate normal distributions share cached factorizations
+       of their matrix parameters. Modify the matrix in place and
+       check that the log density is calculated with the new value.
+    */
+
+    unsigned long m = 3;
+    vector<double> x = {1, -1, 0.5};
+    vector<double> mu = {0.5, 0, -1};
+    vector<double> d = {2, 0.5, 4};
+    vector<double> M(m * m, 0);
+    vector<vector<unsigned long> > dims = {{m}, {m, m}};
+    vector<double const *> par = {&mu[0], &M[0]};
+
+    for (unsigned int r = 0; r < 4; ++r) {
+	double ld = 0, qprec = 0, qvar = 0;
+	for (unsigned long i = 0; i < m; ++i) {
+	    double di = d[i] * (r + 1);
+	    M[i * m + i] = di;
+	    ld += log(di);
+	    qprec += di * (x[i] - mu[i]) * (x[i] - mu[i]);
+	    qvar += (x[i] - mu[i]) * (x[i] - mu[i]) / di;
+	}
+	for (unsigned int k = 0; k < 2; ++k) {
+	    double y = _dmnorm->logDensity(&x[0], jags::PDF_FULL, par, dims);
+	    CPPUNIT_ASSERT_DOUBLES_EQUAL((ld - qprec)/2 - m * M_LN_SQRT_2PI,
+					 y, tol);
+	    y = _dmnormvc->logDensity(&x[0], jags::PDF_FULL, par, dims);
+	    CPPUNIT_ASSERT_DOUBLES_EQUAL(-(ld + qvar)/2 - m * M_LN_SQRT_2PI,
+					 y, tol);
+	}
+    }
+}
+
+void BugsDistTest::value_score_scalar(ScalarDist const *dist,
+				      vector<double> const &x,
+				      vector<double> const &par)
+{
+    /*
+       The derivative of the log density with respect to the value
+       must agree with a central difference
+    */
+    CPPUNIT_ASSERT_MESSAGE(dist->name(), dist->hasValueScore());
+    vector<double const *> ps(par.size());
+    for (unsigned long j = 0; j < par.size(); ++j) {
+	ps[j] = &par[j];
+    }
+    CPPUNIT_ASSERT_MESSAGE(dist->name(), dist->checkParameterValue(ps));
+    for (unsigned long i = 0; i < x.size(); ++i) {
+	double h = 1.0E-6 * max(fabs(x[i]), 1.0);
+	double lp1 = dist->logDensity(x[i] + h, jags::PDF_FULL, ps, 0, 0);
+	double lp0 = dist->logDensity(x[i] - h, jags::PDF_FULL, ps, 0, 0);
+	double numscore = (lp1 - lp0) / (2 * h);
+	double score = dist->valueScore(x[i], ps);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(dist->name(), numscore, score,
+					     1.0E-5 * max(fabs(numscore), 1.0));
+    }
+}
+
+void BugsDistTest::value_score()
+{
+    vector<double> xpos = {0.1, 0.5, 1, 2.5, 7};
+    vector<double> xunit = {0.05, 0.3, 0.5, 0.8, 0.95};
+    vector<double> xreal = {-3, -0.5, 0.2, 1, 4};
+
+    value_score_scalar(_dnorm, xreal, {0.5, 2});
+    value_score_scalar(_dt, xreal, {-1, 0.5, 3});
+    value_score_scalar(_dlogis, xreal, {1, 1.5});
+    value_score_scalar(_ddexp, xreal, {0.1, 2});
+    value_score_scalar(_dgamma, xpos, {2.5, 0.7});
+    value_score_scalar(_dexp, xpos, {1.3});
+    value_score_scalar(_dlnorm, xpos, {0.2, 3});
+    value_score_scalar(_dweib, xpos, {1.5, 0.8});
+    value_score_scalar(_dchisqr, xpos, {3});
+    value_score_scalar(_df, xpos, {4, 7});
+    value_score_scalar(_dgengamma, xpos, {2, 1.5, 1.2});
+    value_score_scalar(_dbeta, xunit, {2, 3.5});
+    value_score_scalar(_dpar, {1.2, 2, 5}, {3, 1});
+
+    /* Multivariate normal */
+    CPPUNIT_ASSERT(_dmnorm->hasValueScore());
+    unsigned long m = 2;
+    vector<double> x = {1, -0.5};
+    vector<double> mu = {0.5, 0.25};
+    vector<double> T = {2, 0.5, 0.5, 1};
+    vector<vector<unsigned long> > dims = {{m}, {m, m}};
+    vector<double const *> par = {&mu[0], &T[0]};
+    vector<double> score(m, 0);
+    _dmnorm->valueScore(&score[0], &x[0], par, dims);
+    for (unsigned long i = 0; i < m; ++i) {
+	double h = 1.0E-6;
+	vector<double> x1(x), x0(x);
+	x1[i] += h;
+	x0[i] -= h;
+	double numscore =
+	    (_dmnorm->logDensity(&x1[0], jags::PDF_FULL, par, dims) -
+	     _dmnorm->logDensity(&x0[0], jags::PDF_FULL, par, dims)) / (2*h);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(numscore, score[i], 1.0E-5);
+    }
+}
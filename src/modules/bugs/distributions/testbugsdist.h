@@ -22,6 +22,10 @@ class BugsDistTest : public CppUnit::TestFixture, public JAGSFixture
     CPPUNIT_TEST( rscalar );
     CPPUNIT_TEST( kl );
     CPPUNIT_TEST( dkw );
+    CPPUNIT_TEST( batch );
+    CPPUNIT_TEST( kernel );
+    CPPUNIT_TEST( factor );
+    CPPUNIT_TEST( value_score );
     CPPUNIT_TEST_SUITE_END(  );
 
     jags::RNG *_rng;
@@ -73,6 +77,19 @@ class BugsDistTest : public CppUnit::TestFixture, public JAGSFixture
     void dkwtest(jags::RScalarDist const *dist,
 		 std::vector<double const *> const &par,
 		 unsigned int N=10000, double pthresh=0.001);
+
+    void batch_scalar(jags::ScalarDist const *dist,
+		      std::vector<double> const &x,
+		      std::vector<std::vector<double> > const &par);
+
+    void kernel_scalar(jags::ScalarDist const *dist,
+		       std::vector<double> const &x,
+		       std::vector<std::vector<double> > const &par,
+		       unsigned long fixed);
+
+    void value_score_scalar(jags::ScalarDist const *dist,
+			    std::vector<double> const &x,
+			    std::vector<double> const &par);
     
   public:
     void setUp();
@@ -85,6 +102,10 @@ class BugsDistTest : public CppUnit::TestFixture, public JAGSFixture
 
     void kl();
     void dkw();
+    void batch();
+    void kernel();
+    void factor();
+    void value_score();
 };
 
 #endif /* BUGS_DIST_TEST_H */
@@ -14,45 +14,148 @@
 using std::log;
 using std::fabs;
 using std::copy;
+using std::equal;
 using std::vector;
 
 namespace jags {
 namespace bugs {
 
-double logdet(double const *a, unsigned long n)
-{
-   // Log determinant of n x n symmetric positive-definite matrix a */
-  
-  unsigned long N = n*n;
-  vector <double> acopy(N);
-  copy(a, a + N, acopy.begin());
+namespace {
 
-  vector<double> w(n);
-  int lwork = -1;
-  double worktest = 0;
-  int info = 0;
-  int ni = asInteger(n);
-  jags_dsyev("N","L", &ni, &acopy[0], &ni, &w[0], &worktest, &lwork, &info);
-  if (info != 0) {
-    throwRuntimeError("unable to calculate workspace size for dsyev");
-  }
-  lwork = static_cast<int>(worktest);
-  vector<double> work(static_cast<unsigned long>(lwork));
-  jags_dsyev("N","L", &ni, &acopy[0], &ni, &w[0], &work[0], &lwork, &info);
-  if (info != 0) {
-    throwRuntimeError("unable to calculate eigenvalues in dsyev");
-  }
+    /*
+       Factorization of a symmetric positive definite matrix.
 
-  if (w[0] <= 0) {
-      throwRuntimeError("Non positive definite matrix in call to logdet");
-  }
+       Distributions see only the values of their parameters, not
+       the nodes that hold them. However, the value of a node is
+       stored at a fixed address in each chain, so factorizations are
+       indexed by the address of the matrix. Before a factorization is
+       reused it is validated against a copy of the matrix, which
+       costs O(n^2) instead of the O(n^3) required to recalculate it.
+       It is therefore invalidated only when the value changes.
+    */
+    struct SPDFactor {
+	double const *address;  // Address of the matrix, or null if unused
+	unsigned long n;        // Number of rows or columns
+	vector<double> value;   // Copy of the matrix
+	vector<double> chol;    // Lower triangular Cholesky factor
+	vector<double> inverse; // Inverse, or empty if not yet calculated
+	double logdet;          // Log determinant
+	unsigned long stamp;    // Time of last use
+	SPDFactor() : address(nullptr), n(0), logdet(0), stamp(0) {}
+	void clear()
+	{
+	    address = nullptr;
+	    vector<double>().swap(value);
+	    vector<double>().swap(chol);
+	    vector<double>().swap(inverse);
+	}
+	unsigned long size() const
+	{
+	    return value.capacity() + chol.capacity() + inverse.capacity();
+	}
+    };
 
-  double logdet = 0;
-  for (unsigned long i = 0; i < n; i++) {
-    logdet += log(w[i]);
-  }
+    /* Maximum number of factorizations held by each thread */
+    const unsigned int NFACTOR = 8;
+    /* Maximum number of doubles held by each thread */
+    const unsigned long FACTOR_MAX = 1UL << 20;
+
+    /*
+       Each thread has its own cache, so that chains updated in
+       parallel do not need to synchronize.
+    */
+    struct FactorCache {
+	SPDFactor factors[NFACTOR];
+	unsigned long clock;
+	FactorCache() : clock(0) {}
+    };
+
+    thread_local FactorCache factorCache;
+
+    /*
+       Returns the factorization of the n x n symmetric positive
+       definite matrix A, or null if A is not positive definite. Only
+       the lower triangle of A is used.
+    */
+    SPDFactor *factorize(double const *A, unsigned long n)
+    {
+	FactorCache &cache = factorCache;
+	unsigned long N = n * n;
+
+	SPDFactor *f = nullptr;
+	for (unsigned int i = 0; i < NFACTOR; ++i) {
+	    SPDFactor &g = cache.factors[i];
+	    if (g.address == A && g.n == n) {
+		f = &g;
+		break;
+	    }
+	}
+	if (f && equal(A, A + N, f->value.begin())) {
+	    f->stamp = ++cache.clock;
+	    return f;
+	}
+	if (f == nullptr) {
+	    //Replace the least recently used factorization
+	    f = &cache.factors[0];
+	    for (unsigned int i = 1; i < NFACTOR; ++i) {
+		if (cache.factors[i].stamp < f->stamp) {
+		    f = &cache.factors[i];
+		}
+	    }
+	}
+
+	f->address = nullptr;
+	f->n = n;
+	f->value.assign(A, A + N);
+	f->chol.assign(A, A + N);
+	f->inverse.clear();
+
+	int info = 0;
+	int ni = asInteger(n);
+	jags_dpotrf("L", &ni, f->chol.data(), &ni, &info);
+	if (info < 0) {
+	    throwLogicError("Illegal argument in dpotrf");
+	}
+	else if (info > 0) {
+	    return nullptr;
+	}
+	double ld = 0;
+	for (unsigned long i = 0; i < n; ++i) {
+	    ld += log(f->chol[i * n + i]);
+	}
+	f->logdet = 2 * ld;
+	f->address = A;
+	f->stamp = ++cache.clock;
+
+	//Release the least recently used factorizations if the cache
+	//is too large
+	for (;;) {
+	    unsigned long total = 0;
+	    SPDFactor *lru = nullptr;
+	    for (unsigned int i = 0; i < NFACTOR; ++i) {
+		SPDFactor &g = cache.factors[i];
+		total += g.size();
+		if (&g != f && g.address && (!lru || g.stamp < lru->stamp)) {
+		    lru = &g;
+		}
+	    }
+	    if (total <= FACTOR_MAX || lru == nullptr) break;
+	    lru->clear();
+	}
+
+	return f;
+    }
+
+}
 
-  return logdet;
+double logdet(double const *a, unsigned long n)
+{
+    // Log determinant of n x n symmetric positive-definite matrix a
+    SPDFactor const *f = factorize(a, n);
+    if (f == nullptr) {
+	throwRuntimeError("Non positive definite matrix in call to logdet");
+    }
+    return f->logdet;
 }
 
 /*
@@ -125,31 +228,31 @@ double det(double const *a, int n)
 bool inverse_chol (double *X, double const *A, unsigned long n)
 {
     /* invert n x n symmetric positive definite matrix A. Put result in X*/
-    //FIXME: This needs testing after being rewritten
-    
-    unsigned long N = n*n;
-    copy(A, A + N, X);
 
-    int info = 0;
-    int ni = asInteger(n);
-    jags_dpotrf ("L", &ni, X, &ni, &info);
-    if (info < 0) {
-	throwLogicError("Illegal argument in inverse_chol");
-    }
-    else if (info > 0) {
+    SPDFactor *f = factorize(A, n);
+    if (f == nullptr) {
 	throwRuntimeError("Cannot invert matrix: not positive definite");
     }
-    jags_dpotri ("L", &ni, X, &ni, &info); 
-    if (info != 0) {
-	throwRuntimeError("Cannot invert symmetric positive definite matrix");
-    }
 
-    //Copy lower to upper triangle
-    for (unsigned long i = 0; i < n; ++i) {
-	for (unsigned long j = 0; j < i; ++j) {
-	    X[i*n + j] = X[j*n + i];
+    vector<double> &inverse = f->inverse;
+    if (inverse.empty()) {
+	inverse = f->chol;
+	int info = 0;
+	int ni = asInteger(n);
+	jags_dpotri ("L", &ni, inverse.data(), &ni, &info); 
+	if (info != 0) {
+	    inverse.clear();
+	    throwRuntimeError("Cannot invert symmetric positive definite matrix");
+	}
+
+	//Copy lower to upper triangle
+	for (unsigned long i = 0; i < n; ++i) {
+	    for (unsigned long j = 0; j < i; ++j) {
+		inverse[i*n + j] = inverse[j*n + i];
+	    }
 	}
     }
+    copy(inverse.begin(), inverse.end(), X);
 
     return true;
 }
@@ -28,6 +28,10 @@ bool inverse_lu (double *X, double const *A, unsigned long n);
  * the lower triangle of the matrix (in column-major order) is used.
  *
  * @param n number or rows or columns in the matrix
+ *
+ * The Cholesky factorization and the inverse are cached, and shared
+ * with logdet, so repeated calls with an unchanged matrix at the
+ * same address take O(n^2) time.
  */
 bool inverse_chol (double *X, double const *A, unsigned long n);
 
@@ -38,6 +42,9 @@ bool inverse_chol (double *X, double const *A, unsigned long n);
  * the lower triangle (in column-major order) is used.
  *
  * @param n number or rows or columns in the matrix
+ *
+ * The log determinant is calculated from the Cholesky factorization,
+ * which is cached as described for inverse_chol.
  */
 double logdet(double const *A, unsigned long n);
 
@@ -80,12 +80,10 @@ namespace jags {
 	//Check that parent is entirely contained in anode with
 	//offsets in ascending order
 
-	vector<Node const *> const &par = anode->parents();
-	vector<unsigned long> const &off = anode->offsets();
-
 	unsigned int j = 0;
-	for (unsigned int i = 0; i < par.size(); ++i) {
-	    if (par[i] == param && off[i] != j++) return false;
+	for (unsigned long i = 0; i < anode->length(); ++i) {
+	    if (anode->parent(i) == param && anode->offset(i) != j++)
+		return false;
 	}
 	if (j != param->length()) return false;
 	    
@@ -196,24 +194,23 @@ namespace jags {
 	    }
 	    else if (AggNode const *a = dynamic_cast<AggNode const*>(dchild[i]))
 	    {
-		vector<Node const *> const &par_i = a->parents();
-		vector<unsigned long> const &off_i = a->offsets();
-		
 		Node const *target = (j == ULONG_MAX) ? 
 		    static_cast<Node const *>(snode) : 
 		    static_cast<Node const *>(dchild[j]);
 		
 		if (j == ULONG_MAX || offsets[j].empty()) {
-		    for (unsigned int k = 0; k < par_i.size(); ++k) {
-			if (par_i[k] == target) {
+		    for (unsigned long k = 0; k < a->length(); ++k) {
+			if (a->parent(k) == target) {
 			    offsets[i].push_back(k);
 			}
 		    }
 		}
 		else {
 		    unsigned int p = 0;
-		    for (unsigned int k = 0; k < par_i.size(); ++k) {
-			if (par_i[k] == target && off_i[k] == offsets[j][p]) {
+		    for (unsigned long k = 0; k < a->length(); ++k) {
+			if (a->parent(k) == target &&
+			    a->offset(k) == offsets[j][p])
+			{
 			    offsets[i].push_back(k);
 			    p++;
 			}
@@ -350,10 +347,10 @@ namespace jags {
 		gv->deterministicChildren();
 	    for (unsigned long d = 0; d < dchild.size(); ++d) {
 	
-		list<StochasticNode *> const *dc = 
+		ChildList<StochasticNode> const *dc = 
 		    dchild[d]->stochasticChildren();
 
-		for (list<StochasticNode *>::const_iterator q = dc->begin(); 
+		for (ChildList<StochasticNode>::const_iterator q = dc->begin(); 
 		     q != dc->end(); ++q) 
 		{
 		    map<StochasticNode const *, unsigned long >::iterator r = smap.find(*q);
@@ -51,6 +51,47 @@ getScale(StochasticNode const *snode, ConjugateDist d, unsigned int chain)
 }
 
 
+static void addChild(double &r, double &mu, ConjugateDist d, double coef,
+		     double Y, double m)
+{
+    //Add the contribution of a single observation Y, with location
+    //parameter m, to the shape r and rate mu of the posterior
+    switch(d) {
+    case GAMMA:
+	r += m;
+	mu += coef * Y ;
+	break;
+    case EXP:
+	r += 1;
+	mu += coef * Y;
+	break;
+    case NORM:
+	r += 0.5;
+	mu += coef * (Y - m) * (Y - m) / 2;
+	break;
+    case POIS:
+	r += Y;
+	mu += coef;
+	break;
+    case DEXP:
+	r += 1;
+	mu += coef * fabs(Y - m);
+	break;
+    case WEIB:
+	r += 1; 
+	mu += coef * pow(Y, m);
+	break;
+    case LNORM:
+	r+= 0.5;
+	mu += coef * (log(Y) - m) * (log(Y) - m) / 2;
+	break;
+    case BERN: case BETA: case BIN: case CAT: case CHISQ: case DIRCH:
+    case LOGIS: case MNORM: case MULTI: case NEGBIN: case PAR: case T:
+    case UNIF: case WISH: case OTHERDIST:	
+	throwLogicError("Invalid distribution in Conjugate Gamma method"); 
+    }
+}
+
 static void calCoef(double *coef, SingletonGraphView const *gv,
 		    vector<ConjugateDist> const &child_dist, unsigned int chain)
 {   
@@ -113,13 +154,20 @@ bool ConjugateGamma::canSample(StochasticNode *snode, Graph const &graph)
 	if (isBounded(stoch_nodes[i])) {
 	    return false; //Bounded
 	}
-	switch(getDist(stoch_nodes[i])) {
+	bool plate = isPlate(stoch_nodes[i]);
+	switch(getElementDist(stoch_nodes[i])) {
 	case EXP: case POIS:
+	    if (plate && stoch_nodes[i]->parents()[0]->length() != 1) {
+		return false; //scale parameter not shared by plate
+	    }
 	    break;
 	case GAMMA: case NORM: case DEXP: case WEIB: case LNORM:
 	    if (gv.isDependent(stoch_nodes[i]->parents()[0])) {
 		return false; //non-scale parameter depends on snode
 	    }
+	    if (plate && stoch_nodes[i]->parents()[1]->length() != 1) {
+		return false; //scale parameter not shared by plate
+	    }
 	    break;
 	case BERN: case BETA: case BIN: case CAT: case CHISQ: case DIRCH:
 	case LOGIS: case MNORM: case MULTI: case NEGBIN: case PAR: case T:
@@ -188,41 +236,19 @@ void ConjugateGamma::update(unsigned int chain, RNG *rng) const
 
 	    StochasticNode const *schild = stoch_children[i];
 	    vector<Node const*> const &cparam = schild->parents();
-	    double Y = *schild->value(chain);
-	    double m = *cparam[0]->value(chain); //location parameter 
-	    switch(_child_dist[i]) {
-	    case GAMMA:
-		r += m;
-		mu += coef_i * Y ;
-		break;
-	    case EXP:
-		r += 1;
-		mu += coef_i * Y;
-		break;
-	    case NORM:
-		r += 0.5;
-		mu += coef_i * (Y - m) * (Y - m) / 2;
-		break;
-	    case POIS:
-		r += Y;
-		mu += coef_i;
-		break;
-	    case DEXP:
-		r += 1;
-		mu += coef_i * fabs(Y - m);
-		break;
-	    case WEIB:
-		r += 1; 
-		mu += coef_i * pow(Y, m);
-		break;
-	    case LNORM:
-		r+= 0.5;
-		mu += coef_i * (log(Y) - m) * (log(Y) - m) / 2;
-		break;
-	    case BERN: case BETA: case BIN: case CAT: case CHISQ: case DIRCH:
-	    case LOGIS: case MNORM: case MULTI: case NEGBIN: case PAR: case T:
-	    case UNIF: case WISH: case OTHERDIST:	
-		throwLogicError("Invalid distribution in Conjugate Gamma method"); 
+	    double const *Y = schild->value(chain);
+	    double const *m = cparam[0]->value(chain); //location parameter 
+	    if (isPlate(schild)) {
+		//The scale parameter is shared by all elements
+		unsigned long N = schild->length();
+		bool mvec = cparam[0]->length() > 1;
+		for (unsigned long k = 0; k < N; ++k) {
+		    addChild(r, mu, _child_dist[i], coef_i, Y[k],
+			     m[mvec ? k : 0]);
+		}
+	    }
+	    else {
+		addChild(r, mu, _child_dist[i], coef_i, *Y, *m);
 	    }
 	}
     }
@@ -147,12 +147,68 @@ static unsigned int sumChildrenLength(SingletonGraphView const *gv)
 
 ConjugateMNormal::ConjugateMNormal(SingletonGraphView const *gv)
     : ConjugateMethod(gv), _betas(nullptr), 
-      _length_betas(sumChildrenLength(gv) * gv->length())
+      _length_betas(sumChildrenLength(gv) * gv->length()),
+      _scalar_work(nchain(gv))
 {
+    vector<StochasticNode *> const &children = gv->stochasticChildren();
+    for (unsigned long j = 0; j < children.size(); ++j) {
+	if (children[j]->length() == 1) {
+	    _scalar.push_back(j);
+	}
+    }
+
     if(checkLinear(gv, true)) {
 	_betas = new double[_length_betas];
 	calBeta(_betas, gv, 0);
     }
+    else {
+	return;
+    }
+
+    /* 
+       With fixed coefficients, the contribution of the scalar
+       children to the posterior precision is also fixed if their
+       precisions are. In this case we calculate it once here.
+    */
+    unsigned long nrow = gv->length();
+    unsigned long nscalar = _scalar.size();
+    if (nscalar == 0) return;
+    for (unsigned long s = 0; s < nscalar; ++s) {
+	if (!children[_scalar[s]]->parents()[1]->isFixed()) return;
+    }
+
+    vector<double> B(nrow * nscalar);
+    double const *beta_j = _betas;
+    for (unsigned long j = 0, s = 0; j < children.size(); ++j) {
+	if (s < nscalar && _scalar[s] == j) {
+	    double w = sqrt(children[j]->parents()[1]->value(0)[0]);
+	    for (unsigned long i = 0; i < nrow; ++i) {
+		B[s * nrow + i] = w * beta_j[i];
+	    }
+	    ++s;
+	}
+	beta_j += children[j]->length() * nrow;
+    }
+
+    _scalar_prec.assign(nrow * nrow, 0);
+    int ni = asInteger(nrow);
+    int ns = asInteger(nscalar);
+    double d1 = 1, zero = 0;
+    jags_dsyrk("L", "N", &ni, &ns, &d1, B.data(), &ni, &zero,
+	       _scalar_prec.data(), &ni);
+
+    if (nscalar < children.size()) {
+	//Pack unweighted coefficients of scalar children
+	beta_j = _betas;
+	for (unsigned long j = 0, s = 0; j < children.size(); ++j) {
+	    if (s < nscalar && _scalar[s] == j) {
+		_scalar_betas.insert(_scalar_betas.end(), beta_j,
+				     beta_j + nrow);
+		++s;
+	    }
+	    beta_j += children[j]->length() * nrow;
+	}
+    }
 }
 
 ConjugateMNormal::~ConjugateMNormal()
@@ -283,11 +339,23 @@ void ConjugateMNormal::update(unsigned int chain, RNG *rng) const
 	   - mu_j is the mean of child j
 	   - Y_j is the value of child j
 	   
-	   We make use of BLAS routines for efficiency.
+	   We make use of BLAS routines for efficiency. The scalar
+	   children are stacked into a single matrix, so that their
+	   contribution can be added with one call to dsyrk and one to
+	   dgemv, instead of one BLAS-2 call per child.
 
 	 */
+	unsigned long nscalar = _scalar.size();
+	bool cached = !_scalar_prec.empty();
+	vector<double> resid(nscalar);
+	vector<double> &B = _scalar_work[chain];
+	if (!cached) {
+	    B.resize(nrow * nscalar);
+	}
+
+	int ni = asInteger(nrow);
 	double const *beta_j = betas;
-	for (unsigned long j = 0; j < nchildren; ++j) {
+	for (unsigned long j = 0, s = 0; j < nchildren; ++j) {
 	    
 	    StochasticNode const *schild = stoch_children[j];
 	    double const *Y = schild->value(chain);
@@ -295,14 +363,20 @@ void ConjugateMNormal::update(unsigned int chain, RNG *rng) const
 	    double const *tau = schild->parents()[1]->value(chain);
 	    unsigned long nrow_child = schild->length();
 
-	    int ni = asInteger(nrow);
-	    
 	    if (nrow_child == 1) {
 		// Scalar children: normal
-		double alpha = tau[0];
-		jags_dsyr("L", &ni, &alpha, beta_j, &i1, A.data(), &ni);
-		alpha *= (Y[0] - mu[0]);
-		jags_daxpy(&ni, &alpha, beta_j, &i1, b.data(), &i1);
+		if (cached) {
+		    resid[s] = tau[0] * (Y[0] - mu[0]);
+		}
+		else {
+		    //Weight coefficients and residuals by sqrt(tau)
+		    double w = sqrt(tau[0]);
+		    resid[s] = w * (Y[0] - mu[0]);
+		    for (unsigned long i = 0; i < nrow; ++i) {
+			B[s * nrow + i] = w * beta_j[i];
+		    }
+		}
+		++s;
 	    }
 	    else {
 		// Vector children: multivariate normal
@@ -324,6 +398,24 @@ void ConjugateMNormal::update(unsigned int chain, RNG *rng) const
 	    beta_j += nrow_child * nrow;
 	}
 
+	if (nscalar > 0) {
+	    int ns = asInteger(nscalar);
+	    if (cached) {
+		int Ni = asInteger(N);
+		jags_daxpy(&Ni, &d1, _scalar_prec.data(), &i1, A.data(), &i1);
+		double const *S = _scalar_betas.empty() ?
+		    betas : _scalar_betas.data();
+		jags_dgemv("N", &ni, &ns, &d1, S, &ni, resid.data(), &i1,
+			   &d1, b.data(), &i1);
+	    }
+	    else {
+		jags_dsyrk("L", "N", &ni, &ns, &d1, B.data(), &ni, &d1,
+			   A.data(), &ni);
+		jags_dgemv("N", &ni, &ns, &d1, B.data(), &ni, resid.data(),
+			   &i1, &d1, b.data(), &i1);
+	    }
+	}
+
 	if (temp_beta) {
 	    delete [] betas;
 	}
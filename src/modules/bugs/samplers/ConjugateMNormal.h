@@ -3,6 +3,8 @@
 
 #include "ConjugateMethod.h"
 
+#include <vector>
+
 namespace jags {
     
     class Graph;
@@ -25,6 +27,16 @@ namespace bugs {
 class ConjugateMNormal : public ConjugateMethod {
   double *_betas;
   const unsigned int _length_betas;
+  /* Indices of the scalar (normal) children */
+  std::vector<unsigned long> _scalar;
+  /* Coefficients of the scalar children packed into a matrix, if the
+     coefficients are fixed and there are also vector children */
+  std::vector<double> _scalar_betas;
+  /* Contribution of the scalar children to the posterior precision,
+     if both their coefficients and their precisions are fixed */
+  std::vector<double> _scalar_prec;
+  /* Workspace for the precision-weighted coefficients, per chain */
+  mutable std::vector<std::vector<double> > _scalar_work;
  public:
   ConjugateMNormal(SingletonGraphView const *gv);
   ~ConjugateMNormal() override;
@@ -2,7 +2,9 @@
 
 #include <sampler/SingletonGraphView.h>
 #include <graph/StochasticNode.h>
+#include <graph/PlateStochasticNode.h>
 #include <distribution/Distribution.h>
+#include <distribution/ScalarDist.h>
 #include <module/ModuleError.h>
 
 #include <map>
@@ -15,7 +17,7 @@ using std::string;
 namespace jags {
 namespace bugs {
 
-ConjugateDist getDist(StochasticNode const *snode)
+static ConjugateDist getDist(string const &name)
 {
     static map<string, ConjugateDist> dist_table;
     if (dist_table.empty()) {
@@ -41,8 +43,7 @@ ConjugateDist getDist(StochasticNode const *snode)
 	dist_table["dweib"] = WEIB;
 	dist_table["dwish"] = WISH;
     }
-  
-    string const &name = snode->distribution()->name();
+
     map<string, ConjugateDist>::iterator p(dist_table.find(name));
 
     if (p == dist_table.end())
@@ -51,13 +52,35 @@ ConjugateDist getDist(StochasticNode const *snode)
 	return p->second;
 }
 
+ConjugateDist getDist(StochasticNode const *snode)
+{
+    return getDist(snode->distribution()->name());
+}
+
+ConjugateDist getElementDist(StochasticNode const *snode)
+{
+    PlateStochasticNode const *plate = 
+	dynamic_cast<PlateStochasticNode const *>(snode);
+    if (plate) {
+	return getDist(plate->elementDistribution()->name());
+    }
+    else {
+	return getDist(snode);
+    }
+}
+
+bool isPlate(StochasticNode const *snode)
+{
+    return dynamic_cast<PlateStochasticNode const *>(snode) != nullptr;
+}
+
 
 static vector<ConjugateDist> getChildDist(SingletonGraphView const *gv)
 {
     vector<ConjugateDist> ans;
     vector<StochasticNode *> const &child = gv->stochasticChildren();
     for (unsigned int i = 0; i < child.size(); ++i) {
-	ans.push_back(getDist(child[i]));
+	ans.push_back(getElementDist(child[i]));
     }
     return ans;
 }
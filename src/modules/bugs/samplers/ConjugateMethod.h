@@ -26,6 +26,25 @@ enum ConjugateDist {
  */
 ConjugateDist getDist(StochasticNode const *snode);
 
+/**
+ * Returns the distribution of each element of a stochastic node. For
+ * a PlateStochasticNode, this is the distribution of its elements,
+ * which is not recognized by getDist. For any other node it is the
+ * same as getDist.
+ */
+ConjugateDist getElementDist(StochasticNode const *snode);
+
+/**
+ * Tests whether a stochastic node is a PlateStochasticNode
+ */
+bool isPlate(StochasticNode const *snode);
+
+/**
+ * Base class for conjugate sample methods. The distributions of the
+ * stochastic children are given by getElementDist, so samplers that
+ * accept plates as stochastic children must check for them with
+ * isPlate when using _child_dist.
+ */
 class ConjugateMethod : public ImmutableSampleMethod
 {
 protected:
@@ -39,9 +39,9 @@ static void calBeta(double *beta, SingletonGraphView const *gv,
 
     double *bp = beta;    
     for (unsigned int i = 0; i < stoch_children.size(); ++i) {
-	StochasticNode const *child = stoch_children[i];
-	unsigned long nrow = child->length();
-	double const *mu = child->parents()[0]->value(chain);
+	Node const *mean = stoch_children[i]->parents()[0];
+	unsigned long nrow = mean->length();
+	double const *mu = mean->value(chain);
 	for (unsigned long j = 0; j < nrow; ++j) {
 	    bp[j] = mu[j];
 	}
@@ -52,9 +52,9 @@ static void calBeta(double *beta, SingletonGraphView const *gv,
 
     bp = beta;    
     for (unsigned int i = 0; i < stoch_children.size(); ++i) {
-	StochasticNode const *child = stoch_children[i];
-	unsigned long nrow = child->length();
-	double const *mu = child->parents()[0]->value(chain);
+	Node const *mean = stoch_children[i]->parents()[0];
+	unsigned long nrow = mean->length();
+	double const *mu = mean->value(chain);
 	for (unsigned long j = 0; j < nrow; ++j) {
 	    bp[j] -= mu[j];
 	}
@@ -71,7 +71,8 @@ ConjugateNormal::ConjugateNormal(SingletonGraphView const *gv)
 	vector<StochasticNode *> const &children = 
 	    gv->stochasticChildren();
 	for (unsigned int i = 0; i < children.size(); ++i) {
-	    _length_betas += children[i]->length();
+	    //The mean of a plate may be shared by all elements
+	    _length_betas += children[i]->parents()[0]->length();
 	}
 
 	if (checkLinear(gv, true)) {
@@ -111,7 +112,7 @@ bool ConjugateNormal::canSample(StochasticNode *snode, Graph const &graph)
 
     // Check stochastic children
     for (unsigned int i = 0; i < schild.size(); ++i) {
-	switch (getDist(schild[i])) {
+	switch (getElementDist(schild[i])) {
 	case NORM: case MNORM:
 	    break;
 	case BERN: case BETA: case BIN: case CAT: case CHISQ: case DEXP:
@@ -164,10 +165,16 @@ void ConjugateNormal::update(unsigned int chain, RNG *rng) const
 	// univariate normal. We know alpha = 0, beta = 1.
 
 	for (unsigned long i = 0; i < nchildren; ++i) {
-	    double Y = *stoch_children[i]->value(chain);
-	    double tau = *stoch_children[i]->parents()[1]->value(chain);
-	    A += (Y - xold) * tau;
-	    B += tau;
+	    StochasticNode const *child = stoch_children[i];
+	    double const *Y = child->value(chain);
+	    double const *tau = child->parents()[1]->value(chain);
+	    unsigned long N = child->length();
+	    bool tvec = child->parents()[1]->length() > 1;
+	    for (unsigned long k = 0; k < N; ++k) {
+		double tau_k = tau[tvec ? k : 0];
+		A += (Y[k] - xold) * tau_k;
+		B += tau_k;
+	    }
 	}
 
     }
@@ -191,8 +198,25 @@ void ConjugateNormal::update(unsigned int chain, RNG *rng) const
 	    double const *Y = child->value(chain);
 	    double const *tau = child->parents()[1]->value(chain);
 	    double const *alpha = child->parents()[0]->value(chain);
-	    unsigned long nrow = child->length();
 
+	    if (isPlate(child)) {
+		//Independent elements with mean and precision either
+		//shared or given separately for each element
+		unsigned long N = child->length();
+		unsigned long nmean = child->parents()[0]->length();
+		bool mvec = nmean > 1;
+		bool tvec = child->parents()[1]->length() > 1;
+		for (unsigned long k = 0; k < N; ++k) {
+		    unsigned long km = mvec ? k : 0;
+		    double tau_beta_k = tau[tvec ? k : 0] * bp[km];
+		    A += (Y[k] - alpha[km]) * tau_beta_k;
+		    B += bp[km] * tau_beta_k;
+		}
+		bp += nmean;
+		continue;
+	    }
+
+	    unsigned long nrow = child->length();
 	    for (unsigned long k = 0; k < nrow; ++k) {
 		double tau_beta_k = 0;
 		for (unsigned long k2 = 0; k2 < nrow; ++k2) {
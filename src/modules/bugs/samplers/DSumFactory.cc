@@ -22,7 +22,7 @@ namespace bugs {
 
 static StochasticNode const *getDSumChild(StochasticNode *node)
 {
-    list<StochasticNode*>::const_iterator p;
+    ChildList<StochasticNode>::const_iterator p;
     for (p = node->stochasticChildren()->begin(); 
 	 p != node->stochasticChildren()->end(); ++p) 
     {
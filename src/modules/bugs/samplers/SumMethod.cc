@@ -150,14 +150,15 @@ namespace jags {
 	    for (vector<DeterministicNode*>::const_reverse_iterator p =
 		     dc.rbegin(); p != dc.rend(); ++p)
 	    {
-		list<StochasticNode*> const *psc = (*p)->stochasticChildren();
+		ChildList<StochasticNode> const *psc =
+		    (*p)->stochasticChildren();
 		if (find(psc->begin(), psc->end(), sumchild) != psc->end()) {
 		    lgraph.insert(*p);
 		}
 		else {
-		    list<DeterministicNode*> const *pdc =
+		    ChildList<DeterministicNode> const *pdc =
 			(*p)->deterministicChildren();
-		    for(list<DeterministicNode*>::const_iterator q =
+		    for(ChildList<DeterministicNode>::const_iterator q =
 			    pdc->begin(); q != pdc->end(); ++q)
 		    {
 			if (lgraph.contains(*q)) {
@@ -0,0 +1,169 @@
+/*
+  Benchmark for running chains in parallel on a large model.
+
+  Builds the Poisson log-linear model
+
+  theta[j] ~ dnorm(0, 0.5)
+  y[j] ~ dpois(exp(theta[j]))
+
+  with J parameters, and updates each theta[j] with the slice
+  sampler. As in Model::update, the chains run in a single OpenMP
+  parallel region with one thread for each chain. The benchmark is
+  repeated for 1, 2, 4, ... chains up to the given maximum.
+
+  Each chain only writes to its own values, so with one core per
+  chain the time per iteration should not grow with the number of
+  chains. Growth indicates that the chains interfere, for example
+  because the values of different chains share cache lines. The
+  checksum depends only on the seeds, so it can be used to check
+  that a change to the storage of node values does not change the
+  samples.
+
+  Usage: chainbench [J [maxchain [niter]]]
+*/
+
+#include <config.h>
+
+#include <DNorm.h>
+#include <DPois.h>
+#include <Exp.h>
+#include <MersenneTwisterRNG.h>
+#include <SliceFactory.h>
+
+#include <graph/Graph.h>
+#include <graph/ConstantNode.h>
+#include <graph/ScalarStochasticNode.h>
+#include <graph/LinkNode.h>
+#include <sampler/Sampler.h>
+
+#include <iostream>
+#include <vector>
+#include <list>
+#include <chrono>
+#include <cstdlib>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using std::vector;
+using std::list;
+using std::cout;
+using std::endl;
+using std::atoi;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+using namespace jags;
+
+static void run(unsigned int J, unsigned int nchain, unsigned int niter)
+{
+    bugs::DNorm dnorm;
+    bugs::DPois dpois;
+    bugs::Exp exp;
+
+    //SliceFactory.h also declares Graph outside the jags namespace
+    jags::Graph graph;
+    vector<Node*> nodes;
+    list<jags::StochasticNode*> theta;
+
+    ConstantNode *zero = new ConstantNode(0.0, nchain, true);
+    ConstantNode *prec = new ConstantNode(0.5, nchain, true);
+    nodes.push_back(zero);
+    nodes.push_back(prec);
+    for (unsigned int j = 0; j < J; ++j) {
+	vector<Node const*> tpar = {zero, prec};
+	ScalarStochasticNode *t =
+	    new ScalarStochasticNode(&dnorm, nchain, tpar, nullptr, nullptr);
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    double v = 0.1 * ch;
+	    t->setValue(&v, 1, ch);
+	}
+	nodes.push_back(t);
+	graph.insert(t);
+	theta.push_back(t);
+
+	vector<Node const*> epar = {t};
+	LinkNode *e = new LinkNode(&exp, nchain, epar);
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    e->deterministicSample(ch);
+	}
+	nodes.push_back(e);
+	graph.insert(e);
+
+	vector<Node const*> ypar = {e};
+	ScalarStochasticNode *y =
+	    new ScalarStochasticNode(&dpois, nchain, ypar, nullptr, nullptr);
+	double yv = j % 5;
+	y->setData(&yv, 1);
+	nodes.push_back(y);
+	graph.insert(y);
+    }
+
+    base::SliceFactory factory;
+    vector<Sampler*> samplers = factory.makeSamplers(theta, graph);
+    vector<RNG*> rngs;
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	rngs.push_back(new base::MersenneTwisterRNG(11 + ch,
+						    KINDERMAN_RAMAGE));
+    }
+
+    steady_clock::time_point t0 = steady_clock::now();
+    #pragma omp parallel num_threads(nchain)
+    {
+	unsigned int thread = 0, nthread = 1;
+#ifdef _OPENMP
+	thread = omp_get_thread_num();
+	nthread = omp_get_num_threads();
+#endif
+	for (unsigned int iter = 0; iter < niter; ++iter) {
+	    for (unsigned int n = thread; n < nchain; n += nthread) {
+		for (Sampler *s : samplers) {
+		    s->update(n, rngs[n]);
+		}
+	    }
+            #pragma omp barrier
+	}
+    }
+    double t = duration<double>(steady_clock::now() - t0).count();
+
+    double checksum = 0;
+    unsigned int j = 0;
+    for (jags::StochasticNode const *node : theta) {
+	++j;
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    checksum += node->value(ch)[0] * j;
+	}
+    }
+    cout << nchain << " chains: " << t / niter << " s/iteration, checksum "
+	 << checksum << endl;
+
+    for (RNG *rng : rngs) {
+	delete rng;
+    }
+    for (Sampler *s : samplers) {
+	delete s;
+    }
+    for (unsigned int i = nodes.size(); i > 0; --i) {
+	delete nodes[i-1];
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int J = argc > 1 ? atoi(argv[1]) : 100000;
+    unsigned int maxchain = argc > 2 ? atoi(argv[2]) : 8;
+    unsigned int niter = argc > 3 ? atoi(argv[3]) : 10;
+
+    unsigned int nproc = 1;
+#ifdef _OPENMP
+    nproc = omp_get_num_procs();
+#endif
+    cout.precision(10);
+    cout << J << " parameters, " << niter << " iterations, "
+	 << nproc << " processors" << endl;
+    for (unsigned int nchain = 1; nchain <= maxchain; nchain *= 2) {
+	run(J, nchain, niter);
+    }
+    return 0;
+}
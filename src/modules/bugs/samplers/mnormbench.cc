@@ -0,0 +1,182 @@
+/*
+  Benchmark for ConjugateMNormal with many scalar normal children.
+
+  Builds the normal linear regression
+
+  beta ~ dmnorm(m0, T0)
+  eta[i] <- inprod(X[i,], beta)
+  y[i] ~ dnorm(eta[i], tau)
+
+  with N observations and P coefficients, and reports the number of
+  iterations per second of ConjugateMNormal::update. The precision
+  tau is fixed in the first run and stochastic in the second. The
+  first case uses the posterior precision cached by the constructor,
+  the second recalculates it with one call to dsyrk per iteration.
+
+  For comparison, the benchmark also times the accumulation of the
+  posterior precision with one rank-1 update (dsyr, daxpy) per child,
+  which was the previous implementation. This accumulation alone
+  gives an upper bound on the speed of the previous update.
+
+  Usage: mnormbench [N [P [niter]]]
+*/
+
+#include <config.h>
+
+#include "ConjugateMNormal.h"
+#include <DNorm.h>
+#include <DMNorm.h>
+#include <InProd.h>
+#include <MersenneTwisterRNG.h>
+#include <blas.h>
+
+#include <graph/Graph.h>
+#include <graph/ConstantNode.h>
+#include <graph/ScalarStochasticNode.h>
+#include <graph/ArrayStochasticNode.h>
+#include <graph/VectorLogicalNode.h>
+#include <sampler/SingletonGraphView.h>
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+using std::vector;
+using std::cout;
+using std::endl;
+using std::atoi;
+using std::copy;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+using namespace jags;
+
+static double since(steady_clock::time_point t0)
+{
+    return duration<double>(steady_clock::now() - t0).count();
+}
+
+static void run(unsigned int N, unsigned int P, unsigned int niter,
+		bool fixed)
+{
+    bugs::DNorm dnorm;
+    bugs::DMNorm dmnorm;
+    bugs::InProd inprod;
+    base::MersenneTwisterRNG rng(1234, KINDERMAN_RAMAGE);
+
+    Graph graph;
+    vector<Node*> nodes;
+
+    vector<unsigned long> dP(1, P), dPP(2, P);
+    vector<double> prec(P * P, 0);
+    for (unsigned int i = 0; i < P; ++i) {
+	prec[i * P + i] = 1.0E-2;
+    }
+    ConstantNode *m0 = new ConstantNode(dP, vector<double>(P, 0), 1, true);
+    ConstantNode *T0 = new ConstantNode(dPP, prec, 1, true);
+    nodes.push_back(m0);
+    nodes.push_back(T0);
+
+    vector<Node const*> bpar = {m0, T0};
+    ArrayStochasticNode *beta = new ArrayStochasticNode(&dmnorm, 1, bpar);
+    beta->setValue(vector<double>(P, 0).data(), P, 0);
+    nodes.push_back(beta);
+    graph.insert(beta);
+
+    ConstantNode *zero = new ConstantNode(0.0, 1, true);
+    ConstantNode *one = new ConstantNode(1.0, 1, true);
+    nodes.push_back(zero);
+    nodes.push_back(one);
+    Node *tau = nullptr;
+    if (fixed) {
+	tau = new ConstantNode(2.0, 1, true);
+    }
+    else {
+	vector<Node const*> tpar = {zero, one};
+	ScalarStochasticNode *t =
+	    new ScalarStochasticNode(&dnorm, 1, tpar, nullptr, nullptr);
+	double tval = 2.0;
+	t->setValue(&tval, 1, 0);
+	tau = t;
+    }
+    nodes.push_back(tau);
+
+    for (unsigned int i = 0; i < N; ++i) {
+	vector<double> x(P);
+	x[0] = 1;
+	for (unsigned int j = 1; j < P; ++j) {
+	    x[j] = rng.normal();
+	}
+	ConstantNode *Xi = new ConstantNode(dP, x, 1, true);
+	nodes.push_back(Xi);
+	vector<Node const*> epar = {Xi, beta};
+	VectorLogicalNode *eta = new VectorLogicalNode(&inprod, 1, epar);
+	nodes.push_back(eta);
+	graph.insert(eta);
+	vector<Node const*> ypar = {eta, tau};
+	ScalarStochasticNode *yi =
+	    new ScalarStochasticNode(&dnorm, 1, ypar, nullptr, nullptr);
+	double y = x[1] + rng.normal();
+	yi->setData(&y, 1);
+	nodes.push_back(yi);
+	graph.insert(yi);
+	eta->deterministicSample(0);
+    }
+
+    SingletonGraphView gv(beta, graph);
+    bugs::ConjugateMNormal method(&gv);
+
+    steady_clock::time_point t0 = steady_clock::now();
+    for (unsigned int it = 0; it < niter; ++it) {
+	method.update(0, &rng);
+    }
+    double t = since(t0);
+    cout << "ConjugateMNormal::update, "
+	 << (fixed ? "fixed" : "stochastic") << " precision: "
+	 << niter / t << " iterations/sec" << endl;
+
+    if (fixed) {
+	//Previous implementation: one rank-1 update per child
+	vector<StochasticNode *> const &children = gv.stochasticChildren();
+	vector<double> X(N * P);
+	for (unsigned int i = 0; i < N; ++i) {
+	    double const *xi = children[i]->parents()[0]->parents()[0]->value(0);
+	    copy(xi, xi + P, X.begin() + i * P);
+	}
+	vector<double> A(P * P), b(P);
+	int ni = P, i1 = 1;
+	t0 = steady_clock::now();
+	for (unsigned int it = 0; it < niter; ++it) {
+	    for (unsigned int i = 0; i < N; ++i) {
+		double const *Y = children[i]->value(0);
+		double const *mu = children[i]->parents()[0]->value(0);
+		double alpha = children[i]->parents()[1]->value(0)[0];
+		jags_dsyr("L", &ni, &alpha, &X[i * P], &i1, A.data(), &ni);
+		alpha *= (Y[0] - mu[0]);
+		jags_daxpy(&ni, &alpha, &X[i * P], &i1, b.data(), &i1);
+	    }
+	}
+	t = since(t0);
+	cout << "Rank-1 accumulation only (previous implementation): "
+	     << niter / t << " iterations/sec" << endl;
+    }
+
+    for (unsigned int i = nodes.size(); i > 0; --i) {
+	delete nodes[i-1];
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int N = argc > 1 ? atoi(argv[1]) : 50000;
+    unsigned int P = argc > 2 ? atoi(argv[2]) : 30;
+    unsigned int niter = argc > 3 ? atoi(argv[3]) : 100;
+
+    cout << N << " observations, " << P << " coefficients, "
+	 << niter << " iterations" << endl;
+    run(N, P, niter, true);
+    run(N, P, niter, false);
+    return 0;
+}
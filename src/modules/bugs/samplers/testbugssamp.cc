@@ -0,0 +1,821 @@
+#include "testbugssamp.h"
+
+#include <DNorm.h>
+#include <DPois.h>
+#include <DMNorm.h>
+#include <DGamma.h>
+#include <Exp.h>
+#include <InProd.h>
+#include "ConjugateMNormal.h"
+#include "ConjugateNormal.h"
+#include "ConjugateGamma.h"
+
+#include <graph/Graph.h>
+#include <graph/ConstantNode.h>
+#include <graph/ScalarStochasticNode.h>
+#include <graph/ArrayStochasticNode.h>
+#include <graph/PlateStochasticNode.h>
+#include <graph/LinkNode.h>
+#include <graph/VectorLogicalNode.h>
+#include <graph/AggNode.h>
+#include <sampler/GraphView.h>
+#include <sampler/SingletonGraphView.h>
+#include <sampler/Linear.h>
+#include <rng/RNG.h>
+
+#include <vector>
+#include <cmath>
+
+using std::vector;
+using std::fabs;
+using std::max;
+using std::log;
+using std::exp;
+
+using jags::Node;
+using jags::Graph;
+using jags::ConstantNode;
+using jags::StochasticNode;
+using jags::ScalarStochasticNode;
+using jags::ArrayStochasticNode;
+using jags::PlateStochasticNode;
+using jags::LinkNode;
+using jags::VectorLogicalNode;
+using jags::AggNode;
+using jags::GraphView;
+using jags::linearCoef;
+using jags::SingletonGraphView;
+
+void BugsSampTest::setUp()
+{
+    _dnorm = new jags::bugs::DNorm;
+    _dpois = new jags::bugs::DPois;
+    _dmnorm = new jags::bugs::DMNorm;
+    _exp = new jags::bugs::Exp;
+    _inprod = new jags::bugs::InProd;
+}
+
+void BugsSampTest::tearDown()
+{
+    delete _dnorm;
+    delete _dpois;
+    delete _dmnorm;
+    delete _exp;
+    delete _inprod;
+}
+
+static void checkGradient(GraphView const *gv)
+{
+    //Compare analytic gradient with central differences
+    vector<double> grad(gv->length());
+    gv->logFullConditionalGradient(0, &grad[0]);
+    vector<double> numgrad = numLogFullConditionalGradient(gv, 0, 1.0E-5);
+    for (unsigned int i = 0; i < grad.size(); ++i) {
+	double tol = 1.0E-5 * max(fabs(numgrad[i]), 1.0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(numgrad[i], grad[i], tol);
+    }
+}
+
+static void freeNodes(vector<Node*> &nodes)
+{
+    //Delete in reverse order of creation so children go first
+    for (unsigned int i = nodes.size(); i > 0; --i) {
+	delete nodes[i-1];
+    }
+    nodes.clear();
+}
+
+void BugsSampTest::gradient()
+{
+    /*
+      Log-linear Poisson regression with a normal response sharing
+      the same linear predictor:
+
+      beta ~ dmnorm(m0, T0)
+      eta[i] <- inprod(X[i,], beta)
+      y[i] ~ dpois(exp(eta[i]))
+      z[i] ~ dnorm(eta[i], 2)
+    */
+    Graph graph;
+    vector<Node*> nodes;
+
+    vector<unsigned long> d2(1, 2), d22(2, 2);
+    double t0[4] = {1.5, 0.5, 0.5, 2.0};
+    ConstantNode *m0 = new ConstantNode(d2, vector<double>(2, 0.5), 1, true);
+    ConstantNode *T0 = new ConstantNode(d22, vector<double>(t0, t0 + 4), 1,
+					true);
+    ConstantNode *tau = new ConstantNode(2.0, 1, true);
+    nodes.push_back(m0);
+    nodes.push_back(T0);
+    nodes.push_back(tau);
+
+    vector<Node const*> bpar = {m0, T0};
+    ArrayStochasticNode *beta = new ArrayStochasticNode(_dmnorm, 1, bpar);
+    double b[2] = {0.2, -0.3};
+    beta->setValue(b, 2, 0);
+    nodes.push_back(beta);
+    graph.insert(beta);
+
+    double x[4][2] = {{1, 0.5}, {1, -1.2}, {1, 2.1}, {1, 0.0}};
+    double y[4] = {2, 0, 5, 1};
+    double z[4] = {0.1, -0.7, 1.3, 0.4};
+    for (unsigned int i = 0; i < 4; ++i) {
+	ConstantNode *Xi = new ConstantNode(d2, vector<double>(x[i], x[i] + 2),
+					    1, true);
+	nodes.push_back(Xi);
+	vector<Node const*> epar = {Xi, beta};
+	VectorLogicalNode *eta = new VectorLogicalNode(_inprod, 1, epar);
+	nodes.push_back(eta);
+	graph.insert(eta);
+	vector<Node const*> lpar = {eta};
+	LinkNode *lambda = new LinkNode(_exp, 1, lpar);
+	nodes.push_back(lambda);
+	graph.insert(lambda);
+	vector<Node const*> ypar = {lambda};
+	ScalarStochasticNode *yi = 
+	    new ScalarStochasticNode(_dpois, 1, ypar, nullptr, nullptr);
+	yi->setData(&y[i], 1);
+	nodes.push_back(yi);
+	graph.insert(yi);
+	vector<Node const*> zpar = {eta, tau};
+	ScalarStochasticNode *zi = 
+	    new ScalarStochasticNode(_dnorm, 1, zpar, nullptr, nullptr);
+	zi->setData(&z[i], 1);
+	nodes.push_back(zi);
+	graph.insert(zi);
+	eta->deterministicSample(0);
+	lambda->deterministicSample(0);
+    }
+
+    vector<StochasticNode*> snodes(1, beta);
+    GraphView gv(snodes, graph);
+    CPPUNIT_ASSERT(gv.hasGradient());
+    checkGradient(&gv);
+
+    freeNodes(nodes);
+}
+
+void BugsSampTest::multilevel_gradient()
+{
+    /*
+      Hierarchical normal model with a contrast of the random
+      effects, sampled jointly with the mean:
+
+      mu ~ dnorm(0, 0.01)
+      theta[j] ~ dnorm(mu, 1.5)
+      y[j] ~ dnorm(theta[j], 1)
+      z ~ dnorm(inprod(w, theta), 1)
+    */
+    Graph graph;
+    vector<Node*> nodes;
+
+    ConstantNode *zero = new ConstantNode(0.0, 1, true);
+    ConstantNode *prec = new ConstantNode(0.01, 1, true);
+    ConstantNode *tau = new ConstantNode(1.5, 1, true);
+    ConstantNode *one = new ConstantNode(1.0, 1, true);
+    nodes.push_back(zero);
+    nodes.push_back(prec);
+    nodes.push_back(tau);
+    nodes.push_back(one);
+
+    vector<Node const*> mpar = {zero, prec};
+    ScalarStochasticNode *mu = 
+	new ScalarStochasticNode(_dnorm, 1, mpar, nullptr, nullptr);
+    double m = 0.7;
+    mu->setValue(&m, 1, 0);
+    nodes.push_back(mu);
+    graph.insert(mu);
+
+    unsigned int J = 3;
+    double th[3] = {1.1, -0.4, 2.3};
+    double y[3] = {0.8, -1.0, 2.9};
+    vector<StochasticNode*> snodes(1, mu);
+    vector<Node const*> thpar;
+    for (unsigned int j = 0; j < J; ++j) {
+	vector<Node const*> tpar = {mu, tau};
+	ScalarStochasticNode *theta = 
+	    new ScalarStochasticNode(_dnorm, 1, tpar, nullptr, nullptr);
+	theta->setValue(&th[j], 1, 0);
+	nodes.push_back(theta);
+	graph.insert(theta);
+	snodes.push_back(theta);
+	thpar.push_back(theta);
+
+	vector<Node const*> ypar = {theta, one};
+	ScalarStochasticNode *yj = 
+	    new ScalarStochasticNode(_dnorm, 1, ypar, nullptr, nullptr);
+	yj->setData(&y[j], 1);
+	nodes.push_back(yj);
+	graph.insert(yj);
+    }
+
+    vector<unsigned long> dJ(1, J);
+    AggNode *thvec = new AggNode(dJ, 1, thpar, vector<unsigned long>(J, 0));
+    nodes.push_back(thvec);
+    graph.insert(thvec);
+    double w[3] = {1, -2, 1};
+    ConstantNode *wnode = new ConstantNode(dJ, vector<double>(w, w + 3), 1, 
+					   true);
+    nodes.push_back(wnode);
+    vector<Node const*> cpar = {wnode, thvec};
+    VectorLogicalNode *contrast = new VectorLogicalNode(_inprod, 1, cpar);
+    nodes.push_back(contrast);
+    graph.insert(contrast);
+    vector<Node const*> zpar = {contrast, one};
+    ScalarStochasticNode *z = 
+	new ScalarStochasticNode(_dnorm, 1, zpar, nullptr, nullptr);
+    double zval = 0.5;
+    z->setData(&zval, 1);
+    nodes.push_back(z);
+    graph.insert(z);
+    thvec->deterministicSample(0);
+    contrast->deterministicSample(0);
+
+    GraphView gv(snodes, graph, true);
+    CPPUNIT_ASSERT(gv.hasGradient());
+    checkGradient(&gv);
+
+    freeNodes(nodes);
+}
+
+void BugsSampTest::truncated_gradient()
+{
+    /*
+      The normalizing constant of a truncated child depends on its
+      parameters, so no gradient is available:
+
+      mu ~ dnorm(0, 1)
+      y ~ dnorm(mu, 1) T(0,)
+    */
+    Graph graph;
+    vector<Node*> nodes;
+
+    ConstantNode *zero = new ConstantNode(0.0, 1, true);
+    ConstantNode *one = new ConstantNode(1.0, 1, true);
+    nodes.push_back(zero);
+    nodes.push_back(one);
+    
+    vector<Node const*> mpar = {zero, one};
+    ScalarStochasticNode *mu = 
+	new ScalarStochasticNode(_dnorm, 1, mpar, nullptr, nullptr);
+    nodes.push_back(mu);
+    graph.insert(mu);
+
+    vector<Node const*> ypar = {mu, one};
+    ScalarStochasticNode *y = 
+	new ScalarStochasticNode(_dnorm, 1, ypar, zero, nullptr);
+    double yval = 1.0;
+    y->setData(&yval, 1);
+    nodes.push_back(y);
+    graph.insert(y);
+
+    vector<StochasticNode*> snodes(1, mu);
+    GraphView gv(snodes, graph);
+    CPPUNIT_ASSERT(!gv.hasGradient());
+
+    freeNodes(nodes);
+}
+
+void BugsSampTest::linear_coef()
+{
+    /*
+      Log-linear Poisson regression in which the second covariate is
+      an unobserved stochastic node, so the design matrix is not fixed:
+
+      beta ~ dmnorm(m0, T0)
+      s ~ dnorm(0, 1)
+      X[i,] <- c(x[i], s)
+      eta[i] <- inprod(X[i,], beta)
+      y[i] ~ dpois(exp(eta[i]))
+    */
+    Graph graph;
+    vector<Node*> nodes;
+
+    vector<unsigned long> d2(1, 2), d22(2, 2);
+    double t0[4] = {1.5, 0.5, 0.5, 2.0};
+    ConstantNode *m0 = new ConstantNode(d2, vector<double>(2, 0.5), 1, true);
+    ConstantNode *T0 = new ConstantNode(d22, vector<double>(t0, t0 + 4), 1,
+					true);
+    ConstantNode *zero = new ConstantNode(0.0, 1, true);
+    ConstantNode *one = new ConstantNode(1.0, 1, true);
+    nodes.push_back(m0);
+    nodes.push_back(T0);
+    nodes.push_back(zero);
+    nodes.push_back(one);
+
+    vector<Node const*> bpar = {m0, T0};
+    ArrayStochasticNode *beta = new ArrayStochasticNode(_dmnorm, 1, bpar);
+    double b[2] = {0.2, -0.3};
+    beta->setValue(b, 2, 0);
+    nodes.push_back(beta);
+    graph.insert(beta);
+
+    vector<Node const*> spar = {zero, one};
+    ScalarStochasticNode *s = 
+	new ScalarStochasticNode(_dnorm, 1, spar, nullptr, nullptr);
+    double sval = 1.7;
+    s->setValue(&sval, 1, 0);
+    nodes.push_back(s);
+    graph.insert(s);
+
+    double x[3] = {0.5, -1.2, 2.1};
+    double y[3] = {2, 0, 5};
+    vector<Node const*> lp;
+    for (unsigned int i = 0; i < 3; ++i) {
+	ConstantNode *xi = new ConstantNode(x[i], 1, true);
+	nodes.push_back(xi);
+	vector<Node const*> xpar = {xi, s};
+	AggNode *Xi = new AggNode(d2, 1, xpar, vector<unsigned long>(2, 0));
+	nodes.push_back(Xi);
+	graph.insert(Xi);
+	vector<Node const*> epar = {Xi, beta};
+	VectorLogicalNode *eta = new VectorLogicalNode(_inprod, 1, epar);
+	nodes.push_back(eta);
+	graph.insert(eta);
+	lp.push_back(eta);
+	vector<Node const*> lpar = {eta};
+	LinkNode *lambda = new LinkNode(_exp, 1, lpar);
+	nodes.push_back(lambda);
+	graph.insert(lambda);
+	vector<Node const*> ypar = {lambda};
+	ScalarStochasticNode *yi = 
+	    new ScalarStochasticNode(_dpois, 1, ypar, nullptr, nullptr);
+	yi->setData(&y[i], 1);
+	nodes.push_back(yi);
+	graph.insert(yi);
+	Xi->deterministicSample(0);
+	eta->deterministicSample(0);
+	lambda->deterministicSample(0);
+    }
+
+    vector<StochasticNode*> snodes(1, beta);
+    GraphView gv(snodes, graph);
+    CPPUNIT_ASSERT(jags::checkLinear(&gv, false, true));
+    CPPUNIT_ASSERT(!jags::checkLinear(&gv, true, true));
+    CPPUNIT_ASSERT(jags::checkLinearCoef(&gv, true));
+    CPPUNIT_ASSERT(!jags::checkLinearCoef(&gv, false));
+
+    vector<double> coef;
+    linearCoef(&gv, lp, 0, coef);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), coef.size());
+    for (unsigned int i = 0; i < 3; ++i) {
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(x[i], coef[i], 1.0E-12);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(sval, coef[i + 3], 1.0E-12);
+    }
+
+    //The values of the graph are unchanged
+    CPPUNIT_ASSERT_EQUAL(b[0], beta->value(0)[0]);
+    CPPUNIT_ASSERT_EQUAL(b[1], beta->value(0)[1]);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(x[0] * b[0] + sval * b[1],
+				 lp[0]->value(0)[0], 1.0E-12);
+
+    freeNodes(nodes);
+}
+
+static double dmnorm2(double const *y, double const *m, double const *T)
+{
+    //Log density of a bivariate normal with precision T
+    double d0 = y[0] - m[0], d1 = y[1] - m[1];
+    double q = T[0] * d0 * d0 + 2 * T[1] * d0 * d1 + T[3] * d1 * d1;
+    return 0.5 * log(T[0] * T[3] - T[1] * T[2]) - log(2 * M_PI) - q / 2;
+}
+
+void BugsSampTest::density_cache()
+{
+    /*
+      The cached log density of a multivariate stochastic node must
+      be refreshed when the value of the node or of any ancestor
+      changes:
+
+      mu ~ dnorm(0, 1)
+      m <- c(mu, mu)
+      y ~ dmnorm(m, T)
+    */
+    Graph graph;
+    vector<Node*> nodes;
+
+    ConstantNode *zero = new ConstantNode(0.0, 2, true);
+    ConstantNode *one = new ConstantNode(1.0, 2, true);
+    nodes.push_back(zero);
+    nodes.push_back(one);
+
+    vector<Node const*> mpar = {zero, one};
+    ScalarStochasticNode *mu = 
+	new ScalarStochasticNode(_dnorm, 2, mpar, nullptr, nullptr);
+    double m[2] = {0.3, -1.2};
+    mu->setValue(&m[0], 1, 0);
+    mu->setValue(&m[1], 1, 1);
+    nodes.push_back(mu);
+    graph.insert(mu);
+
+    vector<unsigned long> d2(1, 2), d22(2, 2);
+    vector<Node const*> apar = {mu, mu};
+    AggNode *mm = new AggNode(d2, 2, apar, vector<unsigned long>(2, 0));
+    nodes.push_back(mm);
+    graph.insert(mm);
+
+    double t0[4] = {1.5, 0.5, 0.5, 2.0};
+    ConstantNode *T = new ConstantNode(d22, vector<double>(t0, t0 + 4), 2,
+				       true);
+    nodes.push_back(T);
+    vector<Node const*> ypar = {mm, T};
+    ArrayStochasticNode *y = new ArrayStochasticNode(_dmnorm, 2, ypar);
+    double yval[2] = {0.4, -0.1};
+    y->setData(yval, 2);
+    nodes.push_back(y);
+    graph.insert(y);
+
+    vector<StochasticNode*> snodes(1, mu);
+    GraphView gv(snodes, graph);
+    for (unsigned int ch = 0; ch < 2; ++ch) {
+	mm->deterministicSample(ch);
+    }
+
+    for (unsigned int ch = 0; ch < 2; ++ch) {
+	double mv[2] = {m[ch], m[ch]};
+	double ly = dmnorm2(yval, mv, t0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(ly, y->logDensity(ch, jags::PDF_FULL),
+				     1.0E-12);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(ly, y->logDensity(ch, jags::PDF_FULL),
+				     1.0E-12);
+    }
+
+    //Change the value of the sampled node in chain 0 only
+    double m0 = 0.8;
+    unsigned long v = mu->version(0);
+    gv.setValue(&m0, 1, 0);
+    CPPUNIT_ASSERT(mu->version(0) != v);
+    double mv0[2] = {m0, m0};
+    double mv1[2] = {m[1], m[1]};
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(dmnorm2(yval, mv0, t0),
+				 y->logDensity(0, jags::PDF_FULL), 1.0E-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(dmnorm2(yval, mv1, t0),
+				 y->logDensity(1, jags::PDF_FULL), 1.0E-12);
+
+    //Swapping chains swaps the densities
+    mu->swapValue(0, 1);
+    mm->swapValue(0, 1);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(dmnorm2(yval, mv1, t0),
+				 y->logDensity(0, jags::PDF_FULL), 1.0E-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(dmnorm2(yval, mv0, t0),
+				 y->logDensity(1, jags::PDF_FULL), 1.0E-12);
+
+    //Changing the value of the node itself
+    double ynew[2] = {-0.5, 1.1};
+    y->setValue(ynew, 2, 0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(dmnorm2(ynew, mv1, t0),
+				 y->logDensity(0, jags::PDF_FULL), 1.0E-12);
+
+    freeNodes(nodes);
+}
+
+void BugsSampTest::aggregate_view()
+{
+    /*
+      A contiguous subset of a single node shares the values of the
+      node, without copying. Other subsets copy their values.
+
+      b ~ dmnorm(m, T)
+      c <- b[2:3]
+      d <- b[c(1,3)]
+      e <- c[2]
+      y ~ dmnorm(c, T2)
+    */
+    Graph graph;
+    vector<Node*> nodes;
+
+    vector<unsigned long> d1(1, 1), d2(1, 2), d3(1, 3), d22(2, 2);
+    double t[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+    double t2[4] = {1.5, 0.5, 0.5, 2.0};
+    ConstantNode *M = new ConstantNode(d3, vector<double>(3, 0), 2, true);
+    ConstantNode *T = new ConstantNode(vector<unsigned long>(2, 3),
+				       vector<double>(t, t + 9), 2, true);
+    ConstantNode *T2 = new ConstantNode(d22, vector<double>(t2, t2 + 4),
+					2, true);
+    nodes.push_back(M);
+    nodes.push_back(T);
+    nodes.push_back(T2);
+
+    vector<Node const*> bpar = {M, T};
+    ArrayStochasticNode *b = new ArrayStochasticNode(_dmnorm, 2, bpar);
+    double b0[2][3] = {{0.1, 0.2, 0.3}, {-1, -2, -3}};
+    for (unsigned int ch = 0; ch < 2; ++ch) {
+	b->setValue(b0[ch], 3, ch);
+    }
+    nodes.push_back(b);
+    graph.insert(b);
+
+    vector<Node const*> bb = {b, b};
+    AggNode *c = new AggNode(d2, 2, bb, {1, 2});
+    AggNode *d = new AggNode(d2, 2, bb, {0, 2});
+    AggNode *e = new AggNode(d1, 2, vector<Node const*>(1, c), {1});
+    nodes.push_back(c);
+    nodes.push_back(d);
+    nodes.push_back(e);
+    graph.insert(c);
+    graph.insert(d);
+    graph.insert(e);
+    CPPUNIT_ASSERT(c->isView());
+    CPPUNIT_ASSERT(!d->isView());
+    CPPUNIT_ASSERT(e->isView());
+    CPPUNIT_ASSERT(e->parents()[0] == b);
+    //Equally spaced subsets keep their source as their only parent
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), c->parents().size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), d->parents().size());
+    CPPUNIT_ASSERT(c->parent(1) == b);
+    CPPUNIT_ASSERT_EQUAL(2UL, c->offset(1));
+    CPPUNIT_ASSERT_EQUAL(2UL, e->offset(0));
+    CPPUNIT_ASSERT_EQUAL(2UL, d->offset(1));
+
+    vector<Node const*> ypar = {c, T2};
+    ArrayStochasticNode *y = new ArrayStochasticNode(_dmnorm, 2, ypar);
+    double yval[2] = {0.4, -0.1};
+    y->setData(yval, 2);
+    nodes.push_back(y);
+    graph.insert(y);
+
+    vector<StochasticNode*> snodes(1, b);
+    GraphView gv(snodes, graph);
+    double b1[3] = {0.7, -0.8, 0.9};
+    for (unsigned int pass = 0; pass < 2; ++pass) {
+	for (unsigned int ch = 0; ch < 2; ++ch) {
+	    double const *bv = b->value(ch);
+	    d->deterministicSample(ch);
+	    CPPUNIT_ASSERT(c->value(ch) == bv + 1);
+	    CPPUNIT_ASSERT_EQUAL(b->version(ch), c->version(ch));
+	    CPPUNIT_ASSERT_EQUAL(bv[2], e->value(ch)[0]);
+	    CPPUNIT_ASSERT_EQUAL(bv[0], d->value(ch)[0]);
+	    CPPUNIT_ASSERT_EQUAL(bv[2], d->value(ch)[1]);
+	    CPPUNIT_ASSERT_DOUBLES_EQUAL(dmnorm2(yval, bv + 1, t2),
+					 y->logDensity(ch, jags::PDF_FULL),
+					 1.0E-12);
+	}
+	//Change the value of b in chain 0 only
+	gv.setValue(b1, 3, 0);
+    }
+
+    freeNodes(nodes);
+}
+
+namespace {
+    /* 
+       Degenerate RNG that always returns the mean of the requested
+       distribution. A conjugate normal sampler using this RNG moves
+       the sampled node to its posterior mean.
+    */
+    struct MeanRNG : public jags::RNG
+    {
+	MeanRNG() : RNG("mean") {}
+	void init(unsigned int) override {}
+	void getState(vector<int> &) const override {}
+	bool setState(vector<int> const &) override { return true; }
+	double uniform() override { return 0.5; }
+	double normal() override { return 0; }
+	double exponential() override { return 1; }
+    };
+}
+
+void BugsSampTest::conjugate_mnormal()
+{
+    /*
+      Normal linear regression with a multivariate normal prior, and
+      an additional multivariate normal child:
+
+      beta ~ dmnorm(m0, T0)
+      eta[i] <- inprod(X[i,], beta)
+      y[i] ~ dnorm(eta[i], tau[i])
+      z ~ dmnorm(beta, T1)
+
+      The scalar children are handled together by ConjugateMNormal.
+      Their precisions are fixed in the first pass, so that their
+      contribution to the posterior precision is calculated once by
+      the constructor, and stochastic in the second pass.
+    */
+    for (unsigned int pass = 0; pass < 2; ++pass) {
+	bool fixed = (pass == 0);
+	Graph graph;
+	vector<Node*> nodes;
+
+	vector<unsigned long> d2(1, 2), d22(2, 2);
+	double m0[2] = {0.5, -0.5};
+	double t0[4] = {1.5, 0.5, 0.5, 2.0};
+	double t1[4] = {3.0, -1.0, -1.0, 1.0};
+	ConstantNode *M0 = new ConstantNode(d2, vector<double>(m0, m0 + 2),
+					    1, true);
+	ConstantNode *T0 = new ConstantNode(d22, vector<double>(t0, t0 + 4),
+					    1, true);
+	ConstantNode *T1 = new ConstantNode(d22, vector<double>(t1, t1 + 4),
+					    1, true);
+	ConstantNode *zero = new ConstantNode(0.0, 1, true);
+	ConstantNode *one = new ConstantNode(1.0, 1, true);
+	nodes.push_back(M0);
+	nodes.push_back(T0);
+	nodes.push_back(T1);
+	nodes.push_back(zero);
+	nodes.push_back(one);
+
+	vector<Node const*> bpar = {M0, T0};
+	ArrayStochasticNode *beta = new ArrayStochasticNode(_dmnorm, 1, bpar);
+	double b0[2] = {0.2, -0.3};
+	beta->setValue(b0, 2, 0);
+	nodes.push_back(beta);
+	graph.insert(beta);
+
+	double x[4][2] = {{1, 0.5}, {1, -1.2}, {1, 2.1}, {1, 0.3}};
+	double y[4] = {1.1, -0.4, 2.5, 0.7};
+	double tau[4] = {2.0, 0.5, 1.0, 4.0};
+	for (unsigned int i = 0; i < 4; ++i) {
+	    Node *taui = nullptr;
+	    if (fixed) {
+		taui = new ConstantNode(tau[i], 1, true);
+	    }
+	    else {
+		vector<Node const*> tpar = {zero, one};
+		ScalarStochasticNode *t = 
+		    new ScalarStochasticNode(_dnorm, 1, tpar, nullptr, nullptr);
+		t->setValue(&tau[i], 1, 0);
+		taui = t;
+	    }
+	    nodes.push_back(taui);
+	    ConstantNode *Xi = 
+		new ConstantNode(d2, vector<double>(x[i], x[i] + 2), 1, true);
+	    nodes.push_back(Xi);
+	    vector<Node const*> epar = {Xi, beta};
+	    VectorLogicalNode *eta = new VectorLogicalNode(_inprod, 1, epar);
+	    nodes.push_back(eta);
+	    graph.insert(eta);
+	    vector<Node const*> ypar = {eta, taui};
+	    ScalarStochasticNode *yi = 
+		new ScalarStochasticNode(_dnorm, 1, ypar, nullptr, nullptr);
+	    yi->setData(&y[i], 1);
+	    nodes.push_back(yi);
+	    graph.insert(yi);
+	    eta->deterministicSample(0);
+	}
+
+	double z[2] = {0.9, 0.1};
+	vector<Node const*> zpar = {beta, T1};
+	ArrayStochasticNode *zn = new ArrayStochasticNode(_dmnorm, 1, zpar);
+	zn->setData(z, 2);
+	nodes.push_back(zn);
+	graph.insert(zn);
+
+	SingletonGraphView gv(beta, graph);
+	CPPUNIT_ASSERT(jags::bugs::ConjugateMNormal::canSample(beta, graph));
+	jags::bugs::ConjugateMNormal method(&gv);
+	MeanRNG rng;
+	method.update(0, &rng);
+
+	//Posterior precision A and A %*% (posterior mean)
+	double A[4], b[2];
+	for (unsigned int k = 0; k < 4; ++k) {
+	    A[k] = t0[k] + t1[k];
+	}
+	for (unsigned int r = 0; r < 2; ++r) {
+	    b[r] = t0[2*r] * m0[0] + t0[2*r+1] * m0[1] +
+		t1[2*r] * z[0] + t1[2*r+1] * z[1];
+	}
+	for (unsigned int i = 0; i < 4; ++i) {
+	    for (unsigned int r = 0; r < 2; ++r) {
+		for (unsigned int c = 0; c < 2; ++c) {
+		    A[2*r + c] += tau[i] * x[i][r] * x[i][c];
+		}
+		b[r] += tau[i] * x[i][r] * y[i];
+	    }
+	}
+	double det = A[0] * A[3] - A[1] * A[2];
+	double mean[2] = {(A[3] * b[0] - A[1] * b[1]) / det,
+			  (A[0] * b[1] - A[2] * b[0]) / det};
+
+	double const *bnew = beta->value(0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(mean[0], bnew[0], tol);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(mean[1], bnew[1], tol);
+
+	freeNodes(nodes);
+    }
+}
+
+void BugsSampTest::conjugate_plate()
+{
+    /*
+      Normal observations compiled as a single plate:
+
+      b ~ dnorm(m0, t0)
+      y[i] ~ dnorm(b, tau[i])
+
+      In the first pass the mean of the plate is b itself, and in
+      the second pass it is an aggregate node repeating b, so that
+      the conjugate normal sampler has a deterministic child. The
+      precision is then given a gamma prior, with shared precision
+      and separate means for each observation:
+
+      tau ~ dgamma(r0, mu0)
+      z[i] ~ dnorm(m[i], tau)
+    */
+    jags::bugs::DGamma dgamma;
+    double const m0 = 0.5, t0 = 0.25;
+    double y[4] = {1.1, -0.4, 2.5, 0.7};
+    double tau[4] = {2.0, 0.5, 1.0, 4.0};
+    vector<unsigned long> d4(1, 4);
+
+    for (unsigned int pass = 0; pass < 2; ++pass) {
+	Graph graph;
+	vector<Node*> nodes;
+	ConstantNode *M0 = new ConstantNode(m0, 1, true);
+	ConstantNode *T0 = new ConstantNode(t0, 1, true);
+	ConstantNode *T = new ConstantNode(d4, vector<double>(tau, tau + 4),
+					   1, true);
+	nodes.push_back(M0);
+	nodes.push_back(T0);
+	nodes.push_back(T);
+
+	vector<Node const*> bpar = {M0, T0};
+	ScalarStochasticNode *b = 
+	    new ScalarStochasticNode(_dnorm, 1, bpar, nullptr, nullptr);
+	double b0 = -1;
+	b->setValue(&b0, 1, 0);
+	nodes.push_back(b);
+	graph.insert(b);
+
+	Node *mean = b;
+	if (pass == 1) {
+	    vector<Node const*> apar(4, b);
+	    AggNode *a = new AggNode(d4, 1, apar, vector<unsigned long>(4, 0));
+	    a->deterministicSample(0);
+	    nodes.push_back(a);
+	    graph.insert(a);
+	    mean = a;
+	}
+
+	vector<Node const*> ypar = {mean, T};
+	PlateStochasticNode *yn = new PlateStochasticNode(_dnorm, 4, 1, ypar);
+	yn->setData(y, 4);
+	nodes.push_back(yn);
+	graph.insert(yn);
+
+	//Plates are not recognized as normal by name
+	CPPUNIT_ASSERT(yn->distribution()->name() != "dnorm");
+	double ly = 0;
+	for (unsigned int i = 0; i < 4; ++i) {
+	    ly += 0.5 * log(tau[i]) - 0.5 * tau[i] * (y[i] - b0) * (y[i] - b0)
+		- 0.5 * log(2 * M_PI);
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(ly, yn->logDensity(0, jags::PDF_FULL),
+				     tol);
+
+	SingletonGraphView gv(b, graph);
+	CPPUNIT_ASSERT(jags::bugs::ConjugateNormal::canSample(b, graph));
+	jags::bugs::ConjugateNormal method(&gv);
+	MeanRNG rng;
+	method.update(0, &rng);
+
+	double A = t0 * m0, B = t0;
+	for (unsigned int i = 0; i < 4; ++i) {
+	    A += tau[i] * y[i];
+	    B += tau[i];
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(A/B, b->value(0)[0], tol);
+
+	freeNodes(nodes);
+    }
+
+    Graph graph;
+    vector<Node*> nodes;
+    double const r0 = 2, mu0 = 1.5;
+    double m[4] = {1.0, 0.0, 2.0, 1.0};
+    ConstantNode *R0 = new ConstantNode(r0, 1, true);
+    ConstantNode *MU0 = new ConstantNode(mu0, 1, true);
+    ConstantNode *M = new ConstantNode(d4, vector<double>(m, m + 4), 1, true);
+    nodes.push_back(R0);
+    nodes.push_back(MU0);
+    nodes.push_back(M);
+
+    vector<Node const*> tpar = {R0, MU0};
+    ScalarStochasticNode *t =
+	new ScalarStochasticNode(&dgamma, 1, tpar, nullptr, nullptr);
+    double t1 = 1;
+    t->setValue(&t1, 1, 0);
+    nodes.push_back(t);
+    graph.insert(t);
+
+    vector<Node const*> zpar = {M, t};
+    PlateStochasticNode *zn = new PlateStochasticNode(_dnorm, 4, 1, zpar);
+    zn->setData(y, 4);
+    nodes.push_back(zn);
+    graph.insert(zn);
+
+    SingletonGraphView gv(t, graph);
+    CPPUNIT_ASSERT(jags::bugs::ConjugateGamma::canSample(t, graph));
+    jags::bugs::ConjugateGamma method(&gv);
+    MeanRNG rng;
+    method.update(0, &rng);
+
+    //With a zero normal deviate, rgamma returns (shape - 1/2)/rate
+    double r = r0 + 2, mu = mu0;
+    for (unsigned int i = 0; i < 4; ++i) {
+	mu += (y[i] - m[i]) * (y[i] - m[i]) / 2;
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL((r - 0.5)/mu, t->value(0)[0], tol);
+
+    freeNodes(nodes);
+}
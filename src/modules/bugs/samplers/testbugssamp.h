@@ -0,0 +1,46 @@
+#ifndef BUGS_SAMP_TEST_H
+#define BUGS_SAMP_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <testlib.h>
+
+namespace jags {
+    class RScalarDist;
+    class ArrayDist;
+    class LinkFunction;
+    class VectorFunction;
+}
+
+class BugsSampTest : public CppUnit::TestFixture, public JAGSFixture
+{
+    CPPUNIT_TEST_SUITE( BugsSampTest );
+    CPPUNIT_TEST( gradient );
+    CPPUNIT_TEST( multilevel_gradient );
+    CPPUNIT_TEST( truncated_gradient );
+    CPPUNIT_TEST( linear_coef );
+    CPPUNIT_TEST( density_cache );
+    CPPUNIT_TEST( aggregate_view );
+    CPPUNIT_TEST( conjugate_mnormal );
+    CPPUNIT_TEST( conjugate_plate );
+    CPPUNIT_TEST_SUITE_END();
+
+    jags::RScalarDist *_dnorm;
+    jags::RScalarDist *_dpois;
+    jags::ArrayDist *_dmnorm;
+    jags::LinkFunction *_exp;
+    jags::VectorFunction *_inprod;
+
+public:
+    void setUp();
+    void tearDown();
+    void gradient();
+    void multilevel_gradient();
+    void truncated_gradient();
+    void linear_coef();
+    void density_cache();
+    void aggregate_view();
+    void conjugate_mnormal();
+    void conjugate_plate();
+};
+
+#endif /* BUGS_SAMP_TEST_H */
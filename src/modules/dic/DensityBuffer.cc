@@ -0,0 +1,73 @@
+#include <config.h>
+
+#include "DensityBuffer.h"
+
+#include <graph/PlateStochasticNode.h>
+
+using std::vector;
+
+namespace jags {
+    namespace dic {
+
+	DensityBuffer::DensityBuffer(vector<Node const *> const &nodes,
+				     bool elements)
+	    : _nodes(nodes), _plates(nodes.size(), nullptr), _size(0)
+	{
+	    unsigned int nchain = nodes.empty() ? 0 : nodes[0]->nchain();
+	    for (unsigned int t = 0; t < 3; ++t) {
+		_values[t].resize(nchain);
+	    }
+	    for (unsigned long i = 0; i < nodes.size(); ++i) {
+		StochasticNode const *snode =
+		    dynamic_cast<StochasticNode const *>(nodes[i]);
+		if (snode) {
+		    snode->cacheLogDensity();
+		}
+		if (elements) {
+		    _plates[i] =
+			dynamic_cast<PlateStochasticNode const *>(nodes[i]);
+		}
+		_size += _plates[i] ? _plates[i]->length() : 1;
+	    }
+	}
+
+	vector<Node const *> const &DensityBuffer::nodes() const
+	{
+	    return _nodes;
+	}
+
+	vector<double> const &DensityBuffer::logDensity(unsigned int chain,
+							PDFType type)
+	{
+	    vector<double> &value = _values[type][chain];
+	    value.resize(_size);
+	    unsigned long k = 0;
+	    for (unsigned long i = 0; i < _nodes.size(); ++i) {
+		if (_plates[i]) {
+		    _plates[i]->elementLogDensity(&value[k], chain, type);
+		    k += _plates[i]->length();
+		}
+		else {
+		    value[k++] = _nodes[i]->logDensity(chain, type);
+		}
+	    }
+	    return value;
+	}
+
+	unsigned long DensityBuffer::size() const
+	{
+	    return _size;
+	}
+
+	bool DensityBuffer::hasPlate(vector<Node const *> const &nodes)
+	{
+	    for (unsigned long i = 0; i < nodes.size(); ++i) {
+		if (dynamic_cast<PlateStochasticNode const *>(nodes[i])) {
+		    return true;
+		}
+	    }
+	    return false;
+	}
+
+    }
+}
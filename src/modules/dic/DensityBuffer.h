@@ -0,0 +1,80 @@
+#ifndef DENSITY_BUFFER_H_
+#define DENSITY_BUFFER_H_
+
+#include <distribution/Distribution.h>
+
+#include <vector>
+
+namespace jags {
+
+    class Node;
+    class PlateStochasticNode;
+
+    namespace dic {
+
+	/**
+	 * @short Log densities of a set of nodes for a monitor
+	 *
+	 * Several monitors in the dic module may be set on the same
+	 * observed stochastic nodes: the deviance, WAIC and the
+	 * density monitors all need the log density of every node at
+	 * each iteration.  A DensityBuffer turns on the log density
+	 * cache of each stochastic node (see
+	 * StochasticNode#cacheLogDensity), so that each log density is
+	 * calculated once per chain and iteration, however many
+	 * monitors use it.  The cache belongs to the node, and so to
+	 * the model, so no state is shared between monitors.
+	 *
+	 * A plate (see PlateStochasticNode) is a single node with
+	 * the joint density of many observations.  Monitors that
+	 * need the density of each observation must ask for plates to
+	 * be expanded into their elements.
+	 *
+	 * The buffer of each chain is separate, so different chains
+	 * may be used concurrently.
+	 */
+	class DensityBuffer {
+	    std::vector<Node const *> _nodes;
+	    std::vector<PlateStochasticNode const *> _plates;
+	    unsigned long _size;
+	    std::vector<std::vector<double> > _values[3];
+	  public:
+	    /**
+	     * Constructor. This must not be called while the model is
+	     * being updated.
+	     *
+	     * @param nodes Nodes for which log densities are calculated
+	     * @param elements If true, the log density of each element
+	     * of a plate is given separately, instead of the log
+	     * density of the whole plate.
+	     */
+	    DensityBuffer(std::vector<Node const *> const &nodes,
+			  bool elements = false);
+	    /**
+	     * Returns the nodes in the buffer
+	     */
+	    std::vector<Node const *> const &nodes() const;
+	    /**
+	     * Returns the number of log densities, which is the number
+	     * of nodes unless plates are expanded.
+	     */
+	    unsigned long size() const;
+	    /**
+	     * Returns the log densities of all nodes for the given
+	     * chain, in the same order as the nodes, with the elements
+	     * of an expanded plate in order.  Only the log densities
+	     * that are out of date are recalculated, except for the
+	     * elements of a plate, which are not cached.
+	     */
+	    std::vector<double> const &logDensity(unsigned int chain,
+						  PDFType type);
+	    /**
+	     * Tests whether any of the given nodes is a plate
+	     */
+	    static bool hasPlate(std::vector<Node const *> const &nodes);
+	};
+
+    }
+}
+
+#endif /* DENSITY_BUFFER_H_ */
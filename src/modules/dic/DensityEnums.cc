@@ -1,5 +1,10 @@
+#include <config.h>
+#include <util/nainf.h>
+
 #include "DensityEnums.h"
 
+#include <cmath>
+
 using std::string;
 
 namespace jags {
@@ -107,5 +112,26 @@ namespace dic {
 		return true;
 		
 	}
+
+	bool acceptsPlates(MonitorType monitor_type)
+	{
+		return monitor_type != PD && monitor_type != POPT &&
+			monitor_type != POPTTOTAL && monitor_type != POPTTOTALREP;
+	}
+
+	double densityValue(double logdensity, DensityType density_type)
+	{
+		if (jags_isna(logdensity)) {
+			// Don't try and convert NA to density or deviance
+			return logdensity;
+		}
+		else if (density_type == DENSITY) {
+			return std::exp(logdensity);
+		}
+		else if (density_type == DEVIANCE) {
+			return -2.0 * logdensity;
+		}
+		return logdensity;
+	}
  
 }}
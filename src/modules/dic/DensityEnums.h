@@ -30,6 +30,24 @@ namespace dic {
 	*/
 	bool getMonitorDensityTypes(std::string const &type, 
 		MonitorType &monitor_type, DensityType &density_type);
+
+	/**
+	* @short Tests whether a monitor type gives correct results for plates
+	*
+	* A plate is a single node with the joint density of many
+	* observations.  Density monitors expand plates into their
+	* elements, and totals are sums over elements, but pD for each
+	* node and popt cannot be calculated for the elements of a
+	* plate.
+	*/
+	bool acceptsPlates(MonitorType monitor_type);
+
+	/**
+	* @short Converts a log density to the given density type
+	*
+	* Missing values are returned unchanged.
+	*/
+	double densityValue(double logdensity, DensityType density_type);
 	
 }
 }
@@ -6,12 +6,10 @@
 
 #include "DensityMean.h"
 
-#include <cmath>
 #include <stdexcept>
 
 using std::vector;
 using std::string;
-using std::exp;
 using std::logic_error;
 
 namespace jags {
@@ -20,8 +18,10 @@ namespace dic {
     DensityMean::DensityMean(vector<Node const *> const &nodes, vector<unsigned long> const &dim,
 		DensityType const density_type, string const &monitor_name)
 	: Monitor(monitor_name, nodes), _nodes(nodes),
-	  _values(nodes[0]->nchain(), vector<double>(nodes.size(), 0.0)),
-	  _density_type(density_type), _dim(dim), _nchain(nodes[0]->nchain()), _n(0)
+	  _density(nodes, true),
+	  _values(nodes[0]->nchain(), vector<double>(_density.size(), 0.0)),
+	  _density_type(density_type), _dim(dim), _nchain(nodes[0]->nchain()),
+	  _n(_nchain, 0)
     {
 		// Sanity check that input arguments match to this function:
 		
@@ -47,29 +47,43 @@ namespace dic {
 		}
     }
 
-    void DensityMean::update()
+    void DensityMean::update(unsigned int chain)
     {
-		_n++;
-		for (unsigned int ch = 0; ch < _nchain; ++ch) {
-		    vector<double> &rmean  = _values[ch];			
-		    for (unsigned int i = 0; i < _nodes.size(); ++i) {
-				double newval = _nodes[i]->logDensity(ch, PDF_FULL);
-				if (jags_isna(newval)) {
-				    rmean[i] = JAGS_NA;
-				}
-				else {
-					if( _density_type == DENSITY ) {
-						newval = exp(newval);
-					}
-					else if ( _density_type == DEVIANCE ) {
-						newval = -2.0 * newval;
-					}
-				    rmean[i] -= (rmean[i] - newval)/_n;
-				}
-		    }
-		}
+	vector<double> const &logdensity =
+	    _density.logDensity(chain, PDF_FULL);
+	unsigned int n = ++_n[chain];
+	vector<double> &rmean  = _values[chain];
+	for (unsigned int i = 0; i < _density.size(); ++i) {
+	    double newval = densityValue(logdensity[i], _density_type);
+	    if (jags_isna(newval)) {
+		rmean[i] = JAGS_NA;
+	    }
+	    else {
+		rmean[i] -= (rmean[i] - newval)/n;
+	    }
+	}
     }
-	
+
+    void DensityMean::rollback(unsigned int chain)
+    {
+	// The log densities are unchanged since the last update, so
+	// the previous running mean can be recovered from them
+	vector<double> const &logdensity =
+	    _density.logDensity(chain, PDF_FULL);
+	unsigned int n = _n[chain]--;
+	vector<double> &rmean = _values[chain];
+	for (unsigned int i = 0; i < _density.size(); ++i) {
+	    if (jags_isna(rmean[i])) continue;
+	    double newval = densityValue(logdensity[i], _density_type);
+	    rmean[i] = n > 1 ? (n * rmean[i] - newval) / (n - 1) : 0;
+	}
+    }
+
+    bool DensityMean::updatesByChain() const
+    {
+	return true;
+    }
+
     vector<double> const &DensityMean::value(unsigned int chain) const
     {
 	return _values[chain];
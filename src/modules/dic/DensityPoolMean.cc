@@ -6,12 +6,10 @@
 
 #include "DensityPoolMean.h"
 
-#include <cmath>
 #include <stdexcept>
 
 using std::vector;
 using std::string;
-using std::exp;
 using std::logic_error;
 
 namespace jags {
@@ -19,8 +17,11 @@ namespace dic {
 
     DensityPoolMean::DensityPoolMean(vector<Node const *> const &nodes, vector<unsigned long> const &dim,
 		DensityType const density_type, string const &monitor_name)
-	: Monitor(monitor_name, nodes), _nodes(nodes), _values(nodes.size(), 0.0),
-	  _density_type(density_type), _dim(dim), _nchain(nodes[0]->nchain()), _n(0) 
+	: Monitor(monitor_name, nodes), _nodes(nodes),
+	  _density(nodes, true), _values(_density.size(), 0.0),
+	  _density_type(density_type), _dim(dim), _nchain(nodes[0]->nchain()), _n(0),
+	  _chain_means(_nchain, vector<double>(_density.size(), 0.0)),
+	  _chain_n(_nchain, 0)
     {
 		// Sanity check that input arguments match to this function:
 		
@@ -59,28 +60,95 @@ namespace dic {
     void DensityPoolMean::update()
     {
 		_n++;
-		for (unsigned int i = 0; i < _nodes.size(); ++i) {
+		vector<double const *> logdensity(_nchain);
+		for (unsigned int ch = 0; ch < _nchain; ++ch) {
+		    logdensity[ch] = _density.logDensity(ch, PDF_FULL).data();
+		}
+		for (unsigned int i = 0; i < _density.size(); ++i) {
 		    double newval = 0.0;
 		    for (unsigned int ch = 0; ch < _nchain; ++ch) {
-				newval += _nodes[i]->logDensity(ch, PDF_FULL) / _nchain;
+				newval += logdensity[ch][i] / _nchain;
 		    }
+			newval = densityValue(newval, _density_type);
 			if (jags_isna(newval)) {
 			    _values[i] = JAGS_NA;
 			}
 			else {
-				if( _density_type == DENSITY ) {
-					newval = exp(newval);
-				}
-				else if ( _density_type == DEVIANCE ) {
-					newval = -2.0 * newval;
-				}
 			    _values[i] -= (_values[i] - newval)/_n;
 			}
 		}
     }
+
+    void DensityPoolMean::rollback()
+    {
+		// The log densities are unchanged since the last update, so
+		// the previous running mean can be recovered from them
+		unsigned int n = _n--;
+		vector<double const *> logdensity(_nchain);
+		for (unsigned int ch = 0; ch < _nchain; ++ch) {
+		    logdensity[ch] = _density.logDensity(ch, PDF_FULL).data();
+		}
+		for (unsigned int i = 0; i < _density.size(); ++i) {
+			if (jags_isna(_values[i])) continue;
+		    double newval = 0.0;
+		    for (unsigned int ch = 0; ch < _nchain; ++ch) {
+				newval += logdensity[ch][i] / _nchain;
+		    }
+			newval = densityValue(newval, _density_type);
+			_values[i] = n > 1 ? (n * _values[i] - newval) / (n - 1) : 0;
+		}
+    }
 	
+    void DensityPoolMean::update(unsigned int chain)
+    {
+	vector<double> const &logdensity =
+	    _density.logDensity(chain, PDF_FULL);
+	unsigned int n = ++_chain_n[chain];
+	vector<double> &rmean = _chain_means[chain];
+	for (unsigned int i = 0; i < _density.size(); ++i) {
+	    double newval = densityValue(logdensity[i], _density_type);
+	    if (jags_isna(newval)) {
+		rmean[i] = JAGS_NA;
+	    }
+	    else {
+		rmean[i] -= (rmean[i] - newval)/n;
+	    }
+	}
+    }
+
+    void DensityPoolMean::rollback(unsigned int chain)
+    {
+	vector<double> const &logdensity =
+	    _density.logDensity(chain, PDF_FULL);
+	unsigned int n = _chain_n[chain]--;
+	vector<double> &rmean = _chain_means[chain];
+	for (unsigned int i = 0; i < _density.size(); ++i) {
+	    if (jags_isna(rmean[i])) continue;
+	    double newval = densityValue(logdensity[i], _density_type);
+	    rmean[i] = n > 1 ? (n * rmean[i] - newval) / (n - 1) : 0;
+	}
+    }
+
+    bool DensityPoolMean::updatesByChain() const
+    {
+	return _density_type != DENSITY;
+    }
+
     vector<double> const &DensityPoolMean::value(unsigned int ) const
     {
+	if (updatesByChain() && _chain_n[0] > 0) {
+	    for (unsigned int i = 0; i < _values.size(); ++i) {
+		double mean = 0.0;
+		for (unsigned int ch = 0; ch < _nchain; ++ch) {
+		    if (jags_isna(_chain_means[ch][i])) {
+			mean = JAGS_NA;
+			break;
+		    }
+		    mean += _chain_means[ch][i] / _nchain;
+		}
+		_values[i] = mean;
+	    }
+	}
 	return _values;
     }
 
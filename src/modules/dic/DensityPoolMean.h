@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "DensityEnums.h"
+#include "DensityBuffer.h"
 
 namespace jags {
     namespace dic {
@@ -15,19 +16,31 @@ namespace jags {
    	 * @short Stores running mean values (pooled between chains) of density/log density/deviance for a given Node
 	 *
 	 * Note that this class is used by both NodeDensityMonitorFactory and ObsStochDensMonitorFactory
+	 *
+	 * The log density and deviance are linear in the log density of
+	 * each chain, so they are updated by chain and pooled when they
+	 * are read. The density is the exponential of the log density
+	 * averaged over chains, so it is updated for all chains together.
    	 */
    	class DensityPoolMean : public Monitor {
  	  protected:
    	    std::vector<Node const *> const _nodes;
-   	    std::vector<double> _values; // density/log density/deviance corresponding to sampled values
+   	    DensityBuffer _density;
+   	    mutable std::vector<double> _values; // density/log density/deviance corresponding to sampled values
 		DensityType const _density_type;  // enum is defined in model/Monitor.h
 		std::vector<unsigned long> const _dim;
 		unsigned int const _nchain;
 		unsigned int _n;
+		std::vector<std::vector<double> > _chain_means; // running means by chain
+		std::vector<unsigned int> _chain_n;
    	  public:
    	    DensityPoolMean(std::vector<Node const *> const &nodes, std::vector<unsigned long> const &dim, 
 				DensityType const density_type, std::string const &monitor_name);
    	    void update() override;
+   	    void update(unsigned int chain) override;
+   	    void rollback() override;
+   	    void rollback(unsigned int chain) override;
+   	    bool updatesByChain() const override;
    	    std::vector<double> const &value(unsigned int chain) const override;
    	    std::vector<unsigned long> dim() const override;
    	    bool poolChains() const override;
@@ -6,12 +6,10 @@
 
 #include "DensityPoolVariance.h"
 
-#include <cmath>
 #include <stdexcept>
 
 using std::vector;
 using std::string;
-using std::exp;
 using std::logic_error;
 
 namespace jags {
@@ -19,9 +17,13 @@ namespace dic {
 
     DensityPoolVariance::DensityPoolVariance(vector<Node const *> const &nodes, vector<unsigned long> const &dim,
 		DensityType const density_type, string const &monitor_name)
-	: Monitor(monitor_name, nodes), _nodes(nodes), 
-	  _means(nodes.size(), 0.0), _mms(nodes.size(), 0.0), _variances(nodes.size(), 0.0),
-	  _density_type(density_type), _dim(dim), _nchain(nodes[0]->nchain()), _n(0)
+	: Monitor(monitor_name, nodes), _nodes(nodes),
+	  _density(nodes, true),
+	  _means(nodes[0]->nchain(), vector<double>(_density.size(), 0.0)),
+	  _mms(nodes[0]->nchain(), vector<double>(_density.size(), 0.0)),
+	  _variances(_density.size(), 0.0),
+	  _density_type(density_type), _dim(dim), _nchain(nodes[0]->nchain()),
+	  _n(_nchain, 0)
     {
 		
 		// Sanity check that input arguments match to this function:
@@ -48,46 +50,90 @@ namespace dic {
 		}
     }
 
-    void DensityPoolVariance::update()
+    void DensityPoolVariance::update(unsigned int chain)
     {
+	vector<double> const &logdensity =
+	    _density.logDensity(chain, PDF_FULL);
+	unsigned int n = ++_n[chain];
+	vector<double> &rmean = _means[chain];
+	vector<double> &rmm = _mms[chain];
+	for (unsigned int i = 0; i < _density.size(); ++i) {
+	    double newval = densityValue(logdensity[i], _density_type);
+	    if (jags_isna(newval)) {
+		rmean[i] = JAGS_NA;
+		rmm[i] = JAGS_NA;
+	    }
+	    else {
+		double delta = newval - rmean[i];
+		rmean[i] += delta / n;
+		rmm[i] += delta * (newval - rmean[i]);
+	    }
+	}
+    }
+
+    void DensityPoolVariance::rollback(unsigned int chain)
+    {
+	// Reverses the last update using the log densities, which are
+	// unchanged since the update
+	vector<double> const &logdensity =
+	    _density.logDensity(chain, PDF_FULL);
+	unsigned int n = _n[chain]--;
+	vector<double> &rmean = _means[chain];
+	vector<double> &rmm = _mms[chain];
+	for (unsigned int i = 0; i < _density.size(); ++i) {
+	    if (jags_isna(rmean[i]) || jags_isna(rmm[i])) continue;
+	    if (n > 1) {
+		double newval = densityValue(logdensity[i], _density_type);
+		double mean = (n * rmean[i] - newval) / (n - 1);
+		rmm[i] -= (newval - mean) * (newval - rmean[i]);
+		rmean[i] = mean;
+	    }
+	    else {
+		rmean[i] = 0;
+		rmm[i] = 0;
+	    }
+	}
+    }
+
+    bool DensityPoolVariance::updatesByChain() const
+    {
+	return true;
+    }
 
-		for (unsigned int i = 0; i < _nodes.size(); ++i) {
-		    for (unsigned int ch = 0; ch < _nchain; ++ch) {
-				double newval = _nodes[i]->logDensity(ch, PDF_FULL);
-				if (jags_isna(newval)) {
-				    _means[i] = JAGS_NA;
-				    _mms[i] = JAGS_NA;
-				    _variances[i] = JAGS_NA;
-				}
-				else {
-					if( _density_type == DENSITY ) {
-						newval = exp(newval);
-					}
-					else if ( _density_type == DEVIANCE ) {
-						newval = -2.0 * newval;
-					}
-					
-					// _n is incremented after the loop so the current sample is:
-					unsigned int effn = _n + ch + 1;
-					double delta = newval - _means[i];
-					
-					_means[i] += delta / effn;
-					_mms[i] += delta * (newval - _means[i]);
-				}
-			}
-			
-			// Only necessary to update this once per iteration:
-			_variances[i] = _mms[i] / (double) (_n + _nchain - 1);			
-		}
-		
-		// Here _n is the total number of iterations * chains:
-  	  	_n += _nchain;
-		// Note: it is incremented after the loop as each chain counts as an iteration
-		
-   }
-	
     vector<double> const &DensityPoolVariance::value(unsigned int ) const
     {
+	// Each chain counts as an iteration. The sums of squared
+	// deviations of the chains are combined with the squared
+	// deviations of the chain means from the pooled mean.
+	unsigned int ntotal = 0;
+	for (unsigned int ch = 0; ch < _nchain; ++ch) {
+	    ntotal += _n[ch];
+	}
+	if (ntotal == 0) {
+	    return _variances;
+	}
+	for (unsigned int i = 0; i < _variances.size(); ++i) {
+	    double mean = 0.0;
+	    bool na = false;
+	    for (unsigned int ch = 0; ch < _nchain; ++ch) {
+		if (jags_isna(_means[ch][i]) || jags_isna(_mms[ch][i])) {
+		    na = true;
+		    break;
+		}
+		mean += _n[ch] * _means[ch][i];
+	    }
+	    if (na) {
+		_variances[i] = JAGS_NA;
+		continue;
+	    }
+	    mean /= ntotal;
+	    double mm = 0.0;
+	    for (unsigned int ch = 0; ch < _nchain; ++ch) {
+		double delta = _means[ch][i] - mean;
+		mm += _mms[ch][i] + _n[ch] * delta * delta;
+	    }
+	    _variances[i] = mm / (double) (ntotal - 1);
+	}
 	return _variances;
     }
 
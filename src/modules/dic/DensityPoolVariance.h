@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "DensityEnums.h"
+#include "DensityBuffer.h"
 
 namespace jags {
     namespace dic {
@@ -18,17 +19,20 @@ namespace jags {
    	 */
    	class DensityPoolVariance : public Monitor {
    	    std::vector<Node const *> const _nodes;
-		std::vector<double> _means;
-		std::vector<double> _mms;
-		std::vector<double> _variances;
+   	    DensityBuffer _density;
+		std::vector<std::vector<double> > _means;
+		std::vector<std::vector<double> > _mms;
+		mutable std::vector<double> _variances;
 		DensityType const _density_type;  // enum is defined in model/Monitor.h
 		std::vector<unsigned long> const _dim;
 		unsigned int const _nchain;
-		unsigned int _n;
+		std::vector<unsigned int> _n;
    	  public:
    	    DensityPoolVariance(std::vector<Node const *> const &nodes, std::vector<unsigned long> const &dim, 
 				DensityType const density_type, std::string const &monitor_name);
-   	    void update() override;
+   	    void update(unsigned int chain) override;
+   	    void rollback(unsigned int chain) override;
+   	    bool updatesByChain() const override;
    	    std::vector<double> const &value(unsigned int chain) const override;
    	    std::vector<unsigned long> dim() const override;
    	    bool poolChains() const override;
@@ -19,7 +19,8 @@ namespace dic {
 
     DensityTotal::DensityTotal(vector<Node const *> const &nodes, vector<unsigned long> const &,
 		DensityType const density_type, string const &monitor_name)
-	: Monitor(monitor_name, nodes), _nodes(nodes), _values(nodes[0]->nchain()),
+	: Monitor(monitor_name, nodes), _nodes(nodes),
+	  _density(nodes), _values(nodes[0]->nchain()),
 	  _density_type(density_type), _dim(vector<unsigned long> (1,1)), _nchain(nodes[0]->nchain())
     {
 		// This monitor pools between variables so ignores the dim it is passed
@@ -60,25 +61,36 @@ namespace dic {
 
     }
 
-    void DensityTotal::update()
+    void DensityTotal::update(unsigned int chain)
     {
-		for (unsigned int ch = 0; ch < _nchain; ++ch) {
-			double total = 0.0;
-		    for (unsigned int i = 0; i < _nodes.size(); ++i) {
-				total += _nodes[i]->logDensity(ch, PDF_FULL);
-		    }
-			if (jags_isna(total)) {
-			    // Don't try and convert NA to density or deviance
-			}else if( _density_type == DENSITY ) {
-				total = exp(total);
-			}
-			else if ( _density_type == DEVIANCE ) {
-				total = -2.0 * total;
-			}
-		    _values[ch].push_back(total);
-		}
+	vector<double> const &logdensity =
+	    _density.logDensity(chain, PDF_FULL);
+	double total = 0.0;
+	for (unsigned int i = 0; i < _nodes.size(); ++i) {
+	    total += logdensity[i];
+	}
+	if (jags_isna(total)) {
+	    // Don't try and convert NA to density or deviance
+	}
+	else if( _density_type == DENSITY ) {
+	    total = exp(total);
+	}
+	else if ( _density_type == DEVIANCE ) {
+	    total = -2.0 * total;
+	}
+	_values[chain].push_back(total);
+    }
+
+    void DensityTotal::rollback(unsigned int chain)
+    {
+	_values[chain].pop_back();
     }
-	
+
+    bool DensityTotal::updatesByChain() const
+    {
+	return true;
+    }
+
     vector<double> const &DensityTotal::value(unsigned int chain) const
     {
 	return _values[chain];
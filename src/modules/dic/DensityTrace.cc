@@ -19,7 +19,8 @@ namespace dic {
 
     DensityTrace::DensityTrace(vector<Node const *> const &nodes, vector<unsigned long> const &dim,
 		DensityType const density_type, string const &monitor_name)
-	: Monitor(monitor_name, nodes), _nodes(nodes), _values(nodes[0]->nchain()),
+	: Monitor(monitor_name, nodes), _nodes(nodes),
+	  _density(nodes, true), _values(nodes[0]->nchain()),
 	  _density_type(density_type), _dim(dim), _nchain(nodes[0]->nchain())
 
     {
@@ -47,24 +48,35 @@ namespace dic {
 		}
     }
 
-    void DensityTrace::update()
+    void DensityTrace::update(unsigned int chain)
     {
-		for (unsigned int ch = 0; ch < _nchain; ++ch) {
-		    for (unsigned int i = 0; i < _nodes.size(); ++i) {
-				double newval = _nodes[i]->logDensity(ch, PDF_FULL);
-				if (jags_isna(newval)) {
-				    // Don't try and convert NA to density or deviance
-				}else if( _density_type == DENSITY ) {
-					newval = exp(newval);
-				}
-				else if ( _density_type == DEVIANCE ) {
-					newval = -2.0 * newval;
-				}
-			    _values[ch].push_back(newval);
-		    }
-		}
+	vector<double> const &logdensity =
+	    _density.logDensity(chain, PDF_FULL);
+	for (unsigned int i = 0; i < _density.size(); ++i) {
+	    double newval = logdensity[i];
+	    if (jags_isna(newval)) {
+		// Don't try and convert NA to density or deviance
+	    }
+	    else if( _density_type == DENSITY ) {
+		newval = exp(newval);
+	    }
+	    else if ( _density_type == DEVIANCE ) {
+		newval = -2.0 * newval;
+	    }
+	    _values[chain].push_back(newval);
+	}
+    }
+
+    void DensityTrace::rollback(unsigned int chain)
+    {
+	_values[chain].resize(_values[chain].size() - _density.size());
     }
-	
+
+    bool DensityTrace::updatesByChain() const
+    {
+	return true;
+    }
+
     vector<double> const &DensityTrace::value(unsigned int chain) const
     {
 	return _values[chain];
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "DensityEnums.h"
+#include "DensityBuffer.h"
 
 namespace jags {
     namespace dic {
@@ -19,6 +20,7 @@ namespace jags {
    	class DensityTrace : public Monitor {
  	  protected:
    	    std::vector<Node const *> const _nodes;
+   	    DensityBuffer _density;
    	    std::vector<std::vector<double> > _values; // density/log density/deviance corresponding to sampled values
 		DensityType const _density_type;  // enum is defined in model/Monitor.h
 		std::vector<unsigned long> const _dim;
@@ -26,7 +28,9 @@ namespace jags {
    	  public:
    	    DensityTrace(std::vector<Node const *> const &nodes, std::vector<unsigned long> const &dim, 
 			 DensityType const density_type, std::string const &monitor_name);
-   	    void update() override;
+   	    void update(unsigned int chain) override;
+   	    void rollback(unsigned int chain) override;
+   	    bool updatesByChain() const override;
    	    std::vector<double> const &value(unsigned int chain) const override;
    	    std::vector<unsigned long> dim() const override;
    	    bool poolChains() const override;
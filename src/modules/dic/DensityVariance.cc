@@ -6,7 +6,6 @@
 
 #include "DensityVariance.h"
 
-#include <cmath>
 #include <stdexcept>
 
 using std::vector;
@@ -18,11 +17,13 @@ namespace dic {
 
     DensityVariance::DensityVariance(vector<Node const *> const &nodes, vector<unsigned long> const &dim,
 		DensityType const density_type, string const &monitor_name)
-	: Monitor(monitor_name, nodes), _nodes(nodes), 
-	  _means(nodes[0]->nchain(), vector<double>(nodes.size(), 0.0)),
-	  _mms(nodes[0]->nchain(), vector<double>(nodes.size(), 0.0)),
-	  _variances(nodes[0]->nchain(), vector<double>(nodes.size(), 0.0)),
-	  _density_type(density_type), _dim(dim), _nchain(nodes[0]->nchain()), _n(0)
+	: Monitor(monitor_name, nodes), _nodes(nodes),
+	  _density(nodes, true),
+	  _means(nodes[0]->nchain(), vector<double>(_density.size(), 0.0)),
+	  _mms(nodes[0]->nchain(), vector<double>(_density.size(), 0.0)),
+	  _variances(nodes[0]->nchain(), vector<double>(_density.size(), 0.0)),
+	  _density_type(density_type), _dim(dim), _nchain(nodes[0]->nchain()),
+	  _n(_nchain, 0)
     {
 		// Sanity check that input arguments match to this function:
 		
@@ -48,40 +49,69 @@ namespace dic {
 		}
     }
 
-    void DensityVariance::update()
+    void DensityVariance::update(unsigned int chain)
     {
-		_n++;
-		for (unsigned int ch = 0; ch < _nchain; ++ch) {
-		    vector<double> &rmean  = _means[ch];
-		    vector<double> &rmm  = _mms[ch];
-			vector<double> &rvar  = _variances[ch];		
-		    for (unsigned int i = 0; i < _nodes.size(); ++i) {
-				double newval = _nodes[i]->logDensity(ch, PDF_FULL);
-				if (jags_isna(newval)) {
-				    rmean[i] = JAGS_NA;
-					rmm[i] = JAGS_NA;
-					rvar[i] = JAGS_NA;
-				}
-				else {
-					if( _density_type == DENSITY ) {
-						newval = std::exp(newval);
-					}
-					else if ( _density_type == DEVIANCE ) {
-						newval = -2.0 * newval;
-					}
+	vector<double> const &logdensity =
+	    _density.logDensity(chain, PDF_FULL);
+	unsigned int n = ++_n[chain];
+	vector<double> &rmean  = _means[chain];
+	vector<double> &rmm  = _mms[chain];
+	for (unsigned int i = 0; i < _density.size(); ++i) {
+	    double newval = densityValue(logdensity[i], _density_type);
+	    if (jags_isna(newval)) {
+		rmean[i] = JAGS_NA;
+		rmm[i] = JAGS_NA;
+	    }
+	    else {
+		double delta = newval - rmean[i];
+		rmean[i] += delta / n;
+		rmm[i] += delta * (newval - rmean[i]);
+	    }
+	}
+    }
 
-					double delta = newval - rmean[i];
-					rmean[i] += delta / _n;
-					rmm[i] += delta * (newval - rmean[i]);
-					rvar[i] = rmm[i] / (double) (_n - 1);
-				}
-		    }
-		}
+    void DensityVariance::rollback(unsigned int chain)
+    {
+	// Reverses the last update using the log densities, which are
+	// unchanged since the update
+	vector<double> const &logdensity =
+	    _density.logDensity(chain, PDF_FULL);
+	unsigned int n = _n[chain]--;
+	vector<double> &rmean = _means[chain];
+	vector<double> &rmm = _mms[chain];
+	for (unsigned int i = 0; i < _density.size(); ++i) {
+	    if (jags_isna(rmean[i]) || jags_isna(rmm[i])) continue;
+	    if (n > 1) {
+		double newval = densityValue(logdensity[i], _density_type);
+		double mean = (n * rmean[i] - newval) / (n - 1);
+		rmm[i] -= (newval - mean) * (newval - rmean[i]);
+		rmean[i] = mean;
+	    }
+	    else {
+		rmean[i] = 0;
+		rmm[i] = 0;
+	    }
+	}
+    }
+
+    bool DensityVariance::updatesByChain() const
+    {
+	return true;
     }
-	
+
     vector<double> const &DensityVariance::value(unsigned int chain) const
     {
-	return _variances[chain];
+	vector<double> const &rmm = _mms[chain];
+	vector<double> &rvar = _variances[chain];
+	for (unsigned int i = 0; i < rvar.size(); ++i) {
+	    if (jags_isna(rmm[i])) {
+		rvar[i] = JAGS_NA;
+	    }
+	    else {
+		rvar[i] = rmm[i] / (double) (_n[chain] - 1);
+	    }
+	}
+	return rvar;
     }
 
     vector<unsigned long> DensityVariance::dim() const
@@ -20,7 +20,10 @@ static vector<Node const *> toNodeVec(vector<StochasticNode const *> const &s)
 namespace dic {
 
     DevianceMean::DevianceMean(vector<StochasticNode const *> const &s)
-	: Monitor("mean", toNodeVec(s)), _values(s.size(),0), _snodes(s), _n(0)
+	: Monitor("mean", toNodeVec(s)), _values(s.size(),0), _snodes(s),
+	  _density(nodes()),
+	  _chain_means(s[0]->nchain(), vector<double>(s.size(), 0)),
+	  _n(s[0]->nchain(), 0)
     {
     }
 
@@ -39,22 +42,48 @@ namespace dic {
 	return true;
     }
 
-    vector<double> const &DevianceMean::value(unsigned int chain) const
+    vector<double> const &DevianceMean::value(unsigned int) const
     {
+	unsigned int nchain = _chain_means.size();
+	for (unsigned long i = 0; i < _values.size(); ++i) {
+	    double deviance = 0;
+	    for (unsigned int ch = 0; ch < nchain; ++ch) {
+		deviance += _chain_means[ch][i] / nchain;
+	    }
+	    _values[i] = deviance;
+	}
 	return _values;
     }
 
-    void DevianceMean::update()
+    void DevianceMean::update(unsigned int chain)
     {
-	_n++;
+	unsigned int n = ++_n[chain];
+	vector<double> &rmean = _chain_means[chain];
+	vector<double> const &logdensity =
+	    _density.logDensity(chain, PDF_FULL);
 	for (unsigned long i = 0; i < _snodes.size(); ++i) {
-	    double loglik = 0;
-	    unsigned int nchain = _snodes[i]->nchain();
-	    for (unsigned int ch = 0; ch < nchain; ++ch) {
-		loglik += _snodes[i]->logDensity(ch, PDF_FULL) / nchain;
-	    }
-	    _values[i] += (-2*loglik - _values[i])/_n;
+	    double deviance = -2 * logdensity[i];
+	    rmean[i] += (deviance - rmean[i])/n;
+	}
+    }
+
+    void DevianceMean::rollback(unsigned int chain)
+    {
+	// The log densities are unchanged since the last update, so
+	// the previous running mean can be recovered from them
+	unsigned int n = _n[chain]--;
+	vector<double> &rmean = _chain_means[chain];
+	vector<double> const &logdensity =
+	    _density.logDensity(chain, PDF_FULL);
+	for (unsigned long i = 0; i < _snodes.size(); ++i) {
+	    double deviance = -2 * logdensity[i];
+	    rmean[i] = n > 1 ? (n * rmean[i] - deviance) / (n - 1) : 0;
 	}
     }
 
+    bool DevianceMean::updatesByChain() const
+    {
+	return true;
+    }
+
 }}
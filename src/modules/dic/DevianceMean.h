@@ -3,6 +3,8 @@
 
 #include <model/Monitor.h>
 
+#include "DensityBuffer.h"
+
 namespace jags {
 
 class StochasticNode;
@@ -10,14 +12,18 @@ class StochasticNode;
 namespace dic {
 
     class DevianceMean : public Monitor {
-	std::vector<double>  _values; 
+	mutable std::vector<double>  _values; 
 	std::vector<StochasticNode const *> _snodes;
-	unsigned int _n;
+	DensityBuffer _density;
+	std::vector<std::vector<double> > _chain_means;
+	std::vector<unsigned int> _n;
     public:
 	DevianceMean(std::vector<StochasticNode const *> const &nodes);
 	std::vector<unsigned long> dim() const override;
 	std::vector<double> const &value(unsigned int chain) const override;
-	void update() override;
+	void update(unsigned int chain) override;
+	void rollback(unsigned int chain) override;
+	bool updatesByChain() const override;
 	bool poolChains() const override;
 	bool poolIterations() const override;
     };
@@ -24,7 +24,7 @@ namespace dic {
     DevianceTrace::DevianceTrace(vector<StochasticNode const *> const &
 				     snodes)
 	: Monitor("trace", toNode(snodes)), _values(snodes[0]->nchain()), 
-	  _snodes(snodes)
+	  _snodes(snodes), _density(nodes())
     {
     }
 
@@ -38,16 +38,25 @@ namespace dic {
 	return _values[chain];
     }
 
-    void DevianceTrace::update()
+    void DevianceTrace::update(unsigned int chain)
     {
-	unsigned int nchain = _snodes[0]->nchain();
-	for (unsigned int ch = 0; ch < nchain; ++ch) {
-	    double loglik = 0;
-	    for (unsigned long i = 0; i < _snodes.size(); ++i) {
-		loglik += _snodes[i]->logDensity(ch, PDF_FULL);
-	    }
-	    _values[ch].push_back(-2 * loglik);
+	vector<double> const &logdensity =
+	    _density.logDensity(chain, PDF_FULL);
+	double loglik = 0;
+	for (unsigned long i = 0; i < _snodes.size(); ++i) {
+	    loglik += logdensity[i];
 	}
+	_values[chain].push_back(-2 * loglik);
+    }
+
+    void DevianceTrace::rollback(unsigned int chain)
+    {
+	_values[chain].pop_back();
+    }
+
+    bool DevianceTrace::updatesByChain() const
+    {
+	return true;
     }
 
     bool DevianceTrace::poolChains() const
@@ -3,6 +3,8 @@
 
 #include <model/Monitor.h>
 
+#include "DensityBuffer.h"
+
 namespace jags {
 
 class StochasticNode;
@@ -12,11 +14,14 @@ namespace dic {
     class DevianceTrace : public Monitor {
 	std::vector<std::vector<double> >  _values; // sampled values
 	std::vector<StochasticNode const *> _snodes;
+	DensityBuffer _density;
     public:
 	DevianceTrace(std::vector<StochasticNode const *> const &nodes);
 	std::vector<unsigned long> dim() const override;
 	std::vector<double> const &value(unsigned int chain) const override;
-	void update() override;
+	void update(unsigned int chain) override;
+	void rollback(unsigned int chain) override;
+	bool updatesByChain() const override;
 	bool poolChains() const override;
 	bool poolIterations() const override;
     };
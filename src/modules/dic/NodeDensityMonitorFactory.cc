@@ -12,6 +12,7 @@
 #include "PenaltyPDTotal.h"
 #include "PenaltyPOPTTotal.h"
 #include "PenaltyPOPTTotalRep.h"
+#include "DensityBuffer.h"
 
 #include <model/BUGSModel.h>
 #include <graph/Graph.h>
@@ -60,6 +61,16 @@ namespace dic {
 		    return nullptr;
 		}
 		NodeArraySubset nodearray = NodeArraySubset(array, range);
+		/*
+		   Each element of the subset is monitored with the node
+		   it belongs to, which for a plate is the joint density
+		   of all its elements
+		*/
+		if (DensityBuffer::hasPlate(nodearray.allnodes())) {
+		    msg = string("Cannot monitor ") + type + " for " + name +
+			" because it is compiled as a plate. Set plates off before compiling the model";
+		    return nullptr;
+		}
 		
 		/* Do some checks and create the RNG vector for pd and popt monitors */
 
@@ -12,11 +12,13 @@
 #include "PenaltyPDTotal.h"
 #include "PenaltyPOPTTotal.h"
 #include "PenaltyPOPTTotalRep.h"
+#include "DensityBuffer.h"
 
 #include <model/BUGSModel.h>
 #include <graph/Graph.h>
 #include <graph/Node.h>
 #include <graph/StochasticNode.h>
+#include <graph/PlateStochasticNode.h>
 #include <sarray/RangeIterator.h>
 
 #include <set>
@@ -102,6 +104,31 @@ namespace dic {
 		    msg = "There are no observed stochastic nodes";
 		    return nullptr;
 		}
+
+		/* 
+		   Plates are expanded into separate observations, except
+		   by the penalty monitors. The pD monitor is summed over
+		   nodes, so it may treat a plate as a single node.
+		*/
+		bool expand = (monitor_type != PD && monitor_type != POPT);
+		if (!acceptsPlates(monitor_type) && name != "pD" &&
+		    DensityBuffer::hasPlate(observed_snodes))
+		{
+		    msg = string("Cannot monitor ") + type +
+			" when observations are compiled as plates. Set plates off before compiling the model";
+		    return nullptr;
+		}
+		vector<string> onames;
+		for (unsigned int i = 0; i < observed_snodes.size(); ++i) {
+		    Node const *node = observed_snodes[i];
+		    if (expand && dynamic_cast<PlateStochasticNode const *>(node)) {
+			vector<string> enames = model->symtab().getElementNames(node);
+			onames.insert(onames.end(), enames.begin(), enames.end());
+		    }
+		    else {
+			onames.push_back(model->symtab().getName(node));
+		    }
+		}
 		
 
 		/* Do some checks and create the RNG vector for pd and popt monitors */
@@ -126,7 +153,7 @@ namespace dic {
 		
 		// There is only ever a single dimension of variables to worry about:
 		vector<unsigned long> dim;
-		dim.push_back(observed_snodes.size());
+		dim.push_back(onames.size());
 
 		if (monitor_type == TRACE) {
 			m = new DensityTrace(observed_snodes, dim, density_type, type);
@@ -183,15 +210,6 @@ namespace dic {
 		    m->setElementNames(vector<string>(1, type));
 		}
 		else {
-			vector<string> onames;
-			string msg;
-			model->dumpNodeNames(onames, "observations", true, msg);
-			if ( onames.size() != observed_snodes.size() ) {
-				throw std::logic_error("The number of observed stochastic nodes does not match the length of the names");
-			}
-			if (!msg.empty()) {
-				throw std::logic_error(msg.c_str());
-			}
 		    m->setElementNames(onames);
 		}
 		
@@ -27,7 +27,10 @@ namespace dic {
 			 unsigned int nrep, double scale)
 	: Monitor("mean", toNodeVec(snodes)), _snodes(snodes), _rngs(rngs),
 	  _nrep(nrep),
-	  _values(snodes.size(), 0),  _weights(snodes.size(), 0),
+	  _values(snodes.size(), 0),
+	  _pdsum(rngs.size(), vector<double>(snodes.size(), 0)),
+	  _weights(rngs.size(), vector<double>(snodes.size(), 0)),
+	  _last_pdsum(rngs.size()), _last_weights(rngs.size()),
 	  _scale(scale), _nchain(rngs.size())
     {
 	if (_nchain < 2) {
@@ -46,6 +49,17 @@ namespace dic {
  
     vector<double> const &PDMonitor::value(unsigned int ) const
     {
+	for (unsigned int k = 0; k < _values.size(); ++k) {
+	    double pdsum = 0;
+	    double wsum = 0;
+	    for (unsigned int i = 0; i < _nchain; ++i) {
+		pdsum += _pdsum[i][k];
+		wsum += _weights[i][k];
+	    }
+	    if (wsum > 0) {
+		_values[k] = pdsum * _scale / (2 * wsum);
+	    }
+	}
 	return _values;
     }
 
@@ -59,32 +73,47 @@ namespace dic {
 	return true;
     }
 
-    void PDMonitor::update()
+    void PDMonitor::update(unsigned int chain)
     {
+	/*
+	   Each chain accumulates the weighted divergence from its own
+	   values to every other chain, using its own RNG, and the
+	   weights of the pairs it shares with lower-numbered chains,
+	   so that the pooled sums over chains count each pair once.
+	*/
+	_last_pdsum[chain] = _pdsum[chain];
+	_last_weights[chain] = _weights[chain];
 	vector<double> w(_nchain);
 	for (unsigned int k = 0; k < _values.size(); ++k) {
-	    
+	    for (unsigned int j = 0; j < _nchain; ++j) {
+		w[j] = weight(k, j);
+	    }
 	    double pdsum = 0;
 	    double wsum = 0;
-	    for (unsigned int i = 0; i < _nchain; ++i) {
-		w[i] = weight(_snodes[k], i);
-		for (unsigned int j = 0; j < i; ++j) {
-		    pdsum += w[i] * w[j] * (
-			_snodes[k]->KL(i, j, _rngs[i], _nrep) +
-			_snodes[k]->KL(j, i, _rngs[j], _nrep));
-		    wsum += w[i] * w[j];
-		}
+	    for (unsigned int j = 0; j < _nchain; ++j) {
+		if (j == chain) continue;
+		pdsum += w[j] * _snodes[k]->KL(chain, j, _rngs[chain], _nrep);
+		if (j < chain) wsum += w[j];
 	    }
-	    pdsum /= wsum;
-	    pdsum *= _scale/2;
-
-	    _weights[k] += wsum;
-	    _values[k] += wsum * (pdsum - _values[k])/_weights[k];
+	    _pdsum[chain][k] += w[chain] * pdsum;
+	    _weights[chain][k] += w[chain] * wsum;
 	}
     }
 
+    void PDMonitor::rollback(unsigned int chain)
+    {
+	// The divergences are estimated by simulation, so the sums
+	// before the last update are kept
+	_pdsum[chain].swap(_last_pdsum[chain]);
+	_weights[chain].swap(_last_weights[chain]);
+    }
+
+    bool PDMonitor::updatesByChain() const
+    {
+	return true;
+    }
 
-    double PDMonitor::weight(StochasticNode const *, unsigned int ) const
+    double PDMonitor::weight(unsigned long, unsigned int ) const
     {
 	return 1;
     }
@@ -16,8 +16,11 @@ namespace dic {
 	std::vector<StochasticNode const *> _snodes;
 	std::vector<RNG *> _rngs;
 	unsigned int _nrep;
-	std::vector<double> _values;
-	std::vector<double> _weights;
+	mutable std::vector<double> _values;
+	std::vector<std::vector<double> > _pdsum; // weighted KL by chain
+	std::vector<std::vector<double> > _weights; // pair weights by chain
+	std::vector<std::vector<double> > _last_pdsum; // before last update
+	std::vector<std::vector<double> > _last_weights;
 	double _scale;
 	unsigned long _nchain;
     public:
@@ -29,9 +32,10 @@ namespace dic {
 	std::vector<double> const &value(unsigned int chain) const override;
 	bool poolChains() const override;
 	bool poolIterations() const override;
-	void update() override;
-	virtual double weight(StochasticNode const *snode,
-			      unsigned int ch) const;
+	void update(unsigned int chain) override;
+	void rollback(unsigned int chain) override;
+	bool updatesByChain() const override;
+	virtual double weight(unsigned long k, unsigned int ch) const;
     };
 
 }}
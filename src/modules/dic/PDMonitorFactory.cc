@@ -3,7 +3,7 @@
 #include "PoptMonitor.h"
 
 #include <model/BUGSModel.h>
-#include <graph/StochasticNode.h>
+#include <graph/PlateStochasticNode.h>
 #include <distribution/Distribution.h>
 
 #include <set>
@@ -41,6 +41,13 @@ namespace dic {
 	vector<StochasticNode *> const &snodes = model->stochasticNodes();
 	for (unsigned int i = 0; i < snodes.size(); ++i) {
 	    if (snodes[i]->isFixed()) {
+		if (name == "popt" &&
+		    dynamic_cast<PlateStochasticNode const *>(snodes[i]))
+		{
+		    //popt weights each observation separately
+		    msg = "Cannot monitor popt when observations are compiled as plates. Set plates off before compiling the model";
+		    return nullptr;
+		}
 		if (isSupportFixed(snodes[i])) {
 		    observed_nodes.push_back(snodes[i]);
 		}
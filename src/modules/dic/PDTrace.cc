@@ -25,7 +25,7 @@ namespace dic {
 		     vector<RNG *> const &rngs, unsigned int nrep)
 	: Monitor("trace", toNodeVec(snodes)),
 	  _snodes(snodes), _rngs(rngs), _nrep(nrep),
-	  _nchain(rngs.size()),  _values()
+	  _nchain(rngs.size()), _chain_values(rngs.size()), _values()
     {
 	if (_nchain < 2) {
 	    throwLogicError("PDTrace needs at least 2 chains");
@@ -43,6 +43,16 @@ namespace dic {
  
     vector<double> const &PDTrace::value(unsigned int ) const
     {
+	unsigned long niter = _chain_values[0].size();
+	_values.assign(niter, 0);
+	for (unsigned int ch = 0; ch < _nchain; ++ch) {
+	    for (unsigned long t = 0; t < niter; ++t) {
+		_values[t] += _chain_values[ch][t];
+	    }
+	}
+	for (unsigned long t = 0; t < niter; ++t) {
+	    _values[t] /= _nchain * (_nchain - 1);
+	}
 	return _values;
     }
 
@@ -56,19 +66,27 @@ namespace dic {
 	return false;
     }
 
-    void PDTrace::update()
+    void PDTrace::update(unsigned int chain)
     {
 	double pd = 0;
 	for (unsigned int k = 0; k < _snodes.size(); ++k) {
-	    for (unsigned int i = 0; i < _nchain; ++i) {
-		for (unsigned int j = 0; j < i; ++j) {
-		    pd += _snodes[k]->KL(i, j, _rngs[i], _nrep);
-		    pd += _snodes[k]->KL(j, i, _rngs[j], _nrep);
+	    for (unsigned int j = 0; j < _nchain; ++j) {
+		if (j != chain) {
+		    pd += _snodes[k]->KL(chain, j, _rngs[chain], _nrep);
 		}
 	    }
 	}
-	pd /= _nchain * (_nchain - 1);
-	_values.push_back(pd);
+	_chain_values[chain].push_back(pd);
+    }
+
+    void PDTrace::rollback(unsigned int chain)
+    {
+	_chain_values[chain].pop_back();
+    }
+
+    bool PDTrace::updatesByChain() const
+    {
+	return true;
     }
 
 }}
@@ -17,7 +17,8 @@ namespace dic {
 	std::vector<RNG *> _rngs;
 	unsigned int _nrep;
 	unsigned long _nchain;
-	std::vector<double> _values;
+	std::vector<std::vector<double> > _chain_values; // KL sums by chain
+	mutable std::vector<double> _values;
 
     public:
 	PDTrace(std::vector<StochasticNode const *> const &snodes,
@@ -27,7 +28,9 @@ namespace dic {
 	std::vector<double> const &value(unsigned int chain) const override;
 	bool poolChains() const override;
 	bool poolIterations() const override;
-	void update() override;
+	void update(unsigned int chain) override;
+	void rollback(unsigned int chain) override;
+	bool updatesByChain() const override;
     };
 
 }}
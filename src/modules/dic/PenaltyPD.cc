@@ -17,7 +17,10 @@ namespace dic {
 			 vector<RNG *> const &rngs, unsigned int nrep)
 	: Monitor(monitor_name, nodes), _nodes(nodes), _rngs(rngs),
 	  _nrep(nrep), _values(nodes.size(), 0.0), _dim(dim), _scale_cst(0.5),
-	  _nchain(rngs.size()), _n(0)
+	  _nchain(rngs.size()),
+	  _pdsum(_nchain, vector<double>(nodes.size(), 0.0)),
+	  _weights(_nchain, vector<double>(nodes.size(), 0.0)),
+	  _last_pdsum(_nchain), _last_weights(_nchain)
 
     {
 		if (_nchain < 2) {
@@ -33,7 +36,10 @@ namespace dic {
 			 unsigned int nrep, double )
 	: Monitor(monitor_name, nodes), _nodes(nodes), _rngs(rngs),
 	  _nrep(nrep),_values(nodes.size(), 0.0), _dim(dim), _scale_cst(1.0),
-	  _nchain(rngs.size()), _n(0)
+	  _nchain(rngs.size()),
+	  _pdsum(_nchain, vector<double>(nodes.size(), 0.0)),
+	  _weights(_nchain, vector<double>(nodes.size(), 0.0)),
+	  _last_pdsum(_nchain), _last_weights(_nchain)
 
     {
 		if (_nchain < 2) {
@@ -53,6 +59,17 @@ namespace dic {
  
     vector<double> const &PenaltyPD::value(unsigned int ) const
     {
+	for (unsigned int k = 0; k < _values.size(); ++k) {
+	    double pdsum = 0;
+	    double wsum = 0;
+	    for (unsigned int i = 0; i < _nchain; ++i) {
+		pdsum += _pdsum[i][k];
+		wsum += _weights[i][k];
+	    }
+	    if (wsum > 0) {
+		_values[k] = _scale_cst * pdsum / wsum;
+	    }
+	}
 	return _values;
     }
 
@@ -66,27 +83,49 @@ namespace dic {
 	return true;
     }
 
-    void PenaltyPD::update()
+    void PenaltyPD::update(unsigned int chain)
     {
-		_n++;
-		for (unsigned int k = 0; k < _values.size(); ++k) {
-	    
-		    double pdsum = 0;
-		    for (unsigned int i = 0; i < _nchain; ++i) {
-				for (unsigned int j = 0; j < i; ++j) {
-				    pdsum += _nodes[k]->KL(i, j, _rngs[i], _nrep);
-					pdsum += _nodes[k]->KL(j, i, _rngs[j], _nrep);
-				}
-		    }
-			// Number of combinations of chains * unity weight products:
-			// pdsum /= (double) _nchain * (_nchain - 1) * 0.5;
-		    // pdsum *= _scale_cst;
-			// i.e. equivalent to:
-			pdsum /= (double) _nchain * (_nchain - 1);
-
-		    _values[k] -= (_values[k] - pdsum)/_n;
-		
-		}
+	/*
+	   Each chain accumulates the weighted divergence from its own
+	   values to every other chain, and the weights of the pairs it
+	   shares with lower-numbered chains. With unit weights, the
+	   pooled value is the mean divergence over pairs of chains.
+	*/
+	_last_pdsum[chain] = _pdsum[chain];
+	_last_weights[chain] = _weights[chain];
+	vector<double> w(_nchain);
+	for (unsigned int k = 0; k < _values.size(); ++k) {
+	    for (unsigned int j = 0; j < _nchain; ++j) {
+		w[j] = weight(k, j);
+	    }
+	    double pdsum = 0;
+	    double wsum = 0;
+	    for (unsigned int j = 0; j < _nchain; ++j) {
+		if (j == chain) continue;
+		pdsum += w[j] * _nodes[k]->KL(chain, j, _rngs[chain], _nrep);
+		if (j < chain) wsum += w[j];
+	    }
+	    _pdsum[chain][k] += w[chain] * pdsum;
+	    _weights[chain][k] += w[chain] * wsum;
+	}
+    }
+
+    void PenaltyPD::rollback(unsigned int chain)
+    {
+	// The divergences are estimated by simulation, so the sums
+	// before the last update are kept
+	_pdsum[chain].swap(_last_pdsum[chain]);
+	_weights[chain].swap(_last_weights[chain]);
+    }
+
+    bool PenaltyPD::updatesByChain() const
+    {
+	return true;
+    }
+
+    double PenaltyPD::weight(unsigned long, unsigned int ) const
+    {
+	return 1;
     }
 
 }}
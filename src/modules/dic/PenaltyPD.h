@@ -16,11 +16,14 @@ namespace dic {
 	std::vector<Node const *> const _nodes;
 	std::vector<RNG *> _rngs;
 	unsigned int _nrep;
-	std::vector<double> _values;
+	mutable std::vector<double> _values;
 	std::vector<unsigned long> const _dim;
 	double _scale_cst;
 	unsigned long _nchain;
-	unsigned int _n;
+	std::vector<std::vector<double> > _pdsum; // weighted KL by chain
+	std::vector<std::vector<double> > _weights; // pair weights by chain
+	std::vector<std::vector<double> > _last_pdsum; // before last update
+	std::vector<std::vector<double> > _last_weights;
 
 	// Protected constructor for use by PenaltyPOPT:
 	PenaltyPD(std::vector<Node const *> const &nodes,
@@ -41,7 +44,10 @@ namespace dic {
 	std::vector<double> const &value(unsigned int chain) const override;
 	bool poolChains() const override;
 	bool poolIterations() const override;
-	void update() override;
+	void update(unsigned int chain) override;
+	void rollback(unsigned int chain) override;
+	bool updatesByChain() const override;
+	virtual double weight(unsigned long k, unsigned int ch) const;
 	};
 
 }}
@@ -14,7 +14,7 @@ namespace dic {
 			 string const &monitor_name,
 			 vector<RNG *> const &rngs, unsigned int nrep)
 	: Monitor(monitor_name, nodes), _nodes(nodes), _rngs(rngs),
-	  _nrep(nrep), _nchain(rngs.size()), _values(),
+	  _nrep(nrep), _nchain(rngs.size()), _chain_values(_nchain), _values(),
 	  _dim(vector<unsigned long> (1,1)), 
 	  _scale_cst(1.0/2.0)
     {
@@ -30,7 +30,7 @@ namespace dic {
 			 vector<RNG *> const &rngs,
 			 unsigned int nrep, double scale)
 	: Monitor(monitor_name, nodes), _nodes(nodes), _rngs(rngs),
-	  _nrep(nrep), _nchain(rngs.size()), _values(),
+	  _nrep(nrep), _nchain(rngs.size()), _chain_values(_nchain), _values(),
 	  _dim(vector<unsigned long> (1,1)), _scale_cst(scale/2.0)
     {
 		// This monitor pools between variables so ignores the dim it is passed
@@ -50,6 +50,14 @@ namespace dic {
  
     vector<double> const &PenaltyPDTotal::value(unsigned int ) const
     {
+	// The chain traces are already scaled, so are summed over chains
+	unsigned long niter = _chain_values[0].size();
+	_values.assign(niter, 0.0);
+	for (unsigned int ch = 0; ch < _nchain; ++ch) {
+	    for (unsigned long t = 0; t < niter; ++t) {
+		_values[t] += _chain_values[ch][t];
+	    }
+	}
 	return _values;
     }
 
@@ -63,23 +71,29 @@ namespace dic {
 	return false;
     }
 
-    void PenaltyPDTotal::update()
+    void PenaltyPDTotal::update(unsigned int chain)
     {
-
 	double pd = 0;
 	for (unsigned int k = 0; k < _nodes.size(); ++k) {
-	    for (unsigned int i = 0; i < _nchain; ++i) {
-		for (unsigned int j = 0; j < i; ++j) {
-		    pd += _nodes[k]->KL(i, j, _rngs[i], _nrep);
-		    pd += _nodes[k]->KL(j, i, _rngs[j], _nrep);
+	    for (unsigned int j = 0; j < _nchain; ++j) {
+		if (j != chain) {
+		    pd += _nodes[k]->KL(chain, j, _rngs[chain], _nrep);
 		}
 	    }
 	}
-
 	// NB: constant multiplier 2/_scale_cst removed:
 	pd /= _nchain * (_nchain - 1);
-			
-	_values.push_back(pd);
+	_chain_values[chain].push_back(pd);
+    }
+
+    void PenaltyPDTotal::rollback(unsigned int chain)
+    {
+	_chain_values[chain].pop_back();
+    }
+
+    bool PenaltyPDTotal::updatesByChain() const
+    {
+	return true;
     }
 
 }}
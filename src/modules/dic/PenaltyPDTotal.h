@@ -16,7 +16,8 @@ namespace dic {
 	std::vector<RNG *> _rngs;
 	unsigned int _nrep;
 	unsigned long _nchain;
-	std::vector<double> _values;
+	std::vector<std::vector<double> > _chain_values; // trace by chain
+	mutable std::vector<double> _values;
 	std::vector<unsigned long> const _dim;
 	double _scale_cst;
 
@@ -37,7 +38,9 @@ namespace dic {
 	std::vector<double> const &value(unsigned int chain) const override;
 	bool poolChains() const override;
 	bool poolIterations() const override;
-	void update() override;
+	void update(unsigned int chain) override;
+	void rollback(unsigned int chain) override;
+	bool updatesByChain() const override;
 	};
 
 }}
@@ -2,6 +2,7 @@
 #define PENALTY_POPT_H_
 
 #include "PenaltyPD.h"
+#include "DensityBuffer.h"
 
 #include <vector>
 
@@ -9,7 +10,8 @@ namespace jags {
 namespace dic {
 
    class PenaltyPOPT : public PenaltyPD {
-		std::vector<double> _weights;
+	DensityBuffer _density;
+	std::vector<std::vector<double> const *> _logdensity;
     public:
 	PenaltyPOPT(std::vector<Node const *> const &nodes,
 		  std::vector<unsigned long> const &dim, 
@@ -18,6 +20,8 @@ namespace dic {
 		  unsigned int nrep);
 
 	void update() override;
+	double weight(unsigned long k, unsigned int ch) const override;
+	bool updatesByChain() const override;
     };
 
 }}
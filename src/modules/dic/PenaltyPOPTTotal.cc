@@ -19,39 +19,64 @@ namespace dic {
 			 vector<RNG *> const &rngs,
 			 unsigned int nrep)
 	: PenaltyPDTotal(nodes, monitor_name, rngs, nrep, 2.0),
-	  _n(0), _weights(nodes.size(), 0.0)
+	  _n(_nchain, 0), _weights(_nchain, vector<double>(nodes.size(), 0.0)),
+	  _last_weights(_nchain),
+	  _density(nodes)
     {
     }
 	
-    void PenaltyPOPTTotal::update()
+    void PenaltyPOPTTotal::update(unsigned int chain)
     {
-		_n++;
-
+		/*
+		   Each chain keeps its own copy of the average weights,
+		   which are calculated from the values of all chains
+		   and so are the same for every chain.
+		*/
+		unsigned int n = ++_n[chain];
+		_last_weights[chain] = _weights[chain];
+		vector<double> &weights = _weights[chain];
 		double popt = 0.0;
-		
 		vector<double> w(_nchain);
+		vector<double const *> logdensity(_nchain);
+		for (unsigned int i = 0; i < _nchain; ++i) {
+		    logdensity[i] = _density.logDensity(i, PDF_FULL).data();
+		}
 		for (unsigned int k = 0; k < _nodes.size(); ++k) {
-			
 		    double pdsum = 0;
 		    double wsum = 0;
 		    for (unsigned int i = 0; i < _nchain; ++i) {
-				w[i] = std::exp(- _nodes[k]->logDensity(i, PDF_FULL));
+				w[i] = std::exp(- logdensity[i][k]);
 				for (unsigned int j = 0; j < i; ++j) {
-				    pdsum += w[i] * w[j] * (
-					_nodes[k]->KL(i, j, _rngs[i], _nrep) +
-					_nodes[k]->KL(j, i, _rngs[j], _nrep));
 				    wsum += w[i] * w[j];
 				}
+		    }
+		    for (unsigned int j = 0; j < _nchain; ++j) {
+				if (j != chain) {
+				    pdsum += w[chain] * w[j] *
+					_nodes[k]->KL(chain, j, _rngs[chain], _nrep);
+				}
 		    }
 			// Here this is the average weight (is sum for PenaltyPOPT):
-			_weights[k] -= (_weights[k] - wsum) / _n;
-			popt += pdsum / _weights[k];
+			weights[k] -= (weights[k] - wsum) / n;
+			popt += pdsum / weights[k];
 		}
-		
 		popt *= _scale_cst;
-		_values.push_back(popt);				
+		_chain_values[chain].push_back(popt);
     }
-	
+
+    void PenaltyPOPTTotal::rollback(unsigned int chain)
+    {
+		PenaltyPDTotal::rollback(chain);
+		--_n[chain];
+		_weights[chain].swap(_last_weights[chain]);
+    }
+
+    bool PenaltyPOPTTotal::updatesByChain() const
+    {
+		// As for PenaltyPOPT, the weights need all chains
+		return false;
+    }
+
 	PenaltyPOPTTotal::~PenaltyPOPTTotal()
 	{
 	}
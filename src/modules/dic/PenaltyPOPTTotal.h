@@ -6,6 +6,7 @@
 #include <rng/RNG.h>
 
 #include "PenaltyPDTotal.h"
+#include "DensityBuffer.h"
 
 #include <vector>
 
@@ -20,15 +21,20 @@ namespace jags {
 namespace dic {
 
     class PenaltyPOPTTotal : public PenaltyPDTotal {
-		unsigned int _n;
-		std::vector<double> _weights;
+		std::vector<unsigned int> _n;
+		std::vector<std::vector<double> > _weights;
+		std::vector<std::vector<double> > _last_weights;
+		DensityBuffer _density;
     public:
 	PenaltyPOPTTotal(std::vector<Node const *> const &nodes,
 		  std::string const &monitor_name,
 		  std::vector<RNG *> const &rngs,
 		  unsigned int nrep);
 
-	void update() override;
+	void update(unsigned int chain) override;
+
+	void rollback(unsigned int chain) override;
+	bool updatesByChain() const override;
 	~PenaltyPOPTTotal() override;
     };
 
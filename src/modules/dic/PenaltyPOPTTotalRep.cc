@@ -18,7 +18,9 @@ namespace dic {
 			 vector<RNG *> const &rngs,
 			 unsigned int nrep)
 	: PenaltyPDTotal(nodes, monitor_name, rngs, nrep, 2.0),
-	  _n(0), _weights(nodes.size(), 0.0), _nodetrace(nodes.size())
+	  _n(0), _weights(nodes.size(), 0.0), _last_weights(nodes.size(), 0.0),
+	  _nodetrace(nodes.size()),
+	  _density(nodes)
     {
 		/* This is a hack to allow the total popt to be adjusted by
 		the running mean weight when requested by const value() */
@@ -28,16 +30,21 @@ namespace dic {
     void PenaltyPOPTTotalRep::update()
     {
 		_n++;
+		_last_weights = _weights;
 
 		double popt = 0.0;
 		
 		vector<double> w(_nchain);
+		vector<double const *> logdensity(_nchain);
+		for (unsigned int i = 0; i < _nchain; ++i) {
+		    logdensity[i] = _density.logDensity(i, PDF_FULL).data();
+		}
 		for (unsigned int k = 0; k < _nodes.size(); ++k) {
 			
 		    double pdsum = 0;
 		    double wsum = 0;
 		    for (unsigned int i = 0; i < _nchain; ++i) {
-				w[i] = std::exp(- _nodes[k]->logDensity(i, PDF_FULL));
+				w[i] = std::exp(- logdensity[i][k]);
 				for (unsigned int j = 0; j < i; ++j) {
 				    pdsum += w[i] * w[j] * (
 					_nodes[k]->KL(i, j, _rngs[i], _nrep) +
@@ -54,6 +61,20 @@ namespace dic {
 		}
     }
 	
+    void PenaltyPOPTTotalRep::rollback()
+    {
+		_n--;
+		_weights.swap(_last_weights);
+		for (unsigned int k = 0; k < _nodes.size(); ++k) {
+			_nodetrace[k].pop_back();
+		}
+    }
+	
+    bool PenaltyPOPTTotalRep::updatesByChain() const
+    {
+		return false;
+    }
+
     vector<double> const &PenaltyPOPTTotalRep::value(unsigned int ) const
     {
 		// Adjust by the running mean weights:
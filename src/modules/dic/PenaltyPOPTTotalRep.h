@@ -6,6 +6,7 @@
 #include <rng/RNG.h>
 
 #include "PenaltyPDTotal.h"
+#include "DensityBuffer.h"
 
 #include <vector>
 
@@ -22,10 +23,12 @@ namespace dic {
     class PenaltyPOPTTotalRep : public PenaltyPDTotal {
 		unsigned int _n;
 		std::vector<double> _weights;
+		std::vector<double> _last_weights;
 		/* This is a hack to allow the total popt to be adjusted by
 		the running mean weight when requested by const value() */
 		std::vector<double>* _totalpopt;
 		std::vector< std::vector<double> > _nodetrace;
+		DensityBuffer _density;
     public:
 	PenaltyPOPTTotalRep(std::vector<Node const *> const &nodes,
 		  std::string const &monitor_name,
@@ -34,6 +37,8 @@ namespace dic {
 
   	std::vector<double> const &value(unsigned int chain) const override;
 	void update() override;
+	void rollback() override;
+	bool updatesByChain() const override;
 	~PenaltyPOPTTotalRep() override;
     };
 
@@ -16,47 +16,88 @@ namespace dic {
     PenaltyPV::PenaltyPV(vector<Node const *> const &nodes, 
 		         string const &monitor_name)
 	: Monitor(monitor_name, nodes), _nodes(nodes),
-	  _mean(0.0), _mm(0.0),	_pv(1,0.0), _dim(vector<unsigned long> (1,1)),
-	  _nchain(nodes[0]->nchain()), _n(0)
+	  _density(nodes),
+	  _mean(nodes[0]->nchain(), 0.0), _mm(nodes[0]->nchain(), 0.0),
+	  _pv(1,0.0), _dim(vector<unsigned long> (1,1)),
+	  _nchain(nodes[0]->nchain()), _n(_nchain, 0)
     {
 		// This monitor pools between variables so ignores the dim it is passed
     }
 
-    void PenaltyPV::update()
+    void PenaltyPV::update(unsigned int chain)
     {
+		vector<double> const &logdensity =
+		    _density.logDensity(chain, PDF_FULL);
+		double newval = 0.0;
+		for (unsigned int i = 0; i < _nodes.size(); ++i) {
+			newval += (-2.0 * logdensity[i]);
+		}
+		if (jags_isna(newval)) {
+		    _mean[chain] = JAGS_NA;
+		    _mm[chain] = JAGS_NA;
+		}
+		else {
+			unsigned int n = ++_n[chain];
+			double delta = newval - _mean[chain];
+			_mean[chain] += delta / n;
+			_mm[chain] += delta * (newval - _mean[chain]);
+		}
+    }
 
-	    for (unsigned int ch = 0; ch < _nchain; ++ch) {
-			double newval = 0.0;
-			for (unsigned int i = 0; i < _nodes.size(); ++i) {
-				newval += (-2.0 * _nodes[i]->logDensity(ch, PDF_FULL));
-			}
-			if (jags_isna(newval)) {
-			    _mean = JAGS_NA;
-			    _mm = JAGS_NA;
-			    _pv[1] = JAGS_NA;
-			}
-			else {
-				// _n is incremented after the loop so the current sample is:
-				unsigned int effn = _n + ch + 1;
-				double delta = newval - _mean;
-				
-				_mean += delta / effn;
-				_mm += delta * (newval - _mean);
-			}			
+    void PenaltyPV::rollback(unsigned int chain)
+    {
+		// Reverses the last update using the log densities, which
+		// are unchanged since the update
+		if (jags_isna(_mean[chain]) || jags_isna(_mm[chain])) return;
+		vector<double> const &logdensity =
+		    _density.logDensity(chain, PDF_FULL);
+		double newval = 0.0;
+		for (unsigned int i = 0; i < _nodes.size(); ++i) {
+			newval += (-2.0 * logdensity[i]);
+		}
+		unsigned int n = _n[chain]--;
+		if (n > 1) {
+			double mean = (n * _mean[chain] - newval) / (n - 1);
+			_mm[chain] -= (newval - mean) * (newval - _mean[chain]);
+			_mean[chain] = mean;
+		}
+		else {
+			_mean[chain] = 0.0;
+			_mm[chain] = 0.0;
 		}
+    }
+
+    bool PenaltyPV::updatesByChain() const
+    {
+	return true;
+    }
 
-		// Only necessary to update this once per iteration:
-		_pv[0] = _mm / ( 2.0 * (double) (_n + _nchain - 1) );
-		
-		// Here _n is the total number of iterations * chains:
-  	  	_n += _nchain;
-		// Note: it is incremented after the loop as each chain counts as an iteration
-		
-   }
-	
     vector<double> const &PenaltyPV::value(unsigned int ) const
     {
-	return _pv;
+		// Each chain counts as an iteration. The sums of squared
+		// deviations of the chains are combined with the squared
+		// deviations of the chain means from the pooled mean.
+		unsigned int ntotal = 0;
+		double mean = 0.0;
+		for (unsigned int ch = 0; ch < _nchain; ++ch) {
+			if (jags_isna(_mean[ch]) || jags_isna(_mm[ch])) {
+			    _pv[0] = JAGS_NA;
+			    return _pv;
+			}
+			ntotal += _n[ch];
+			mean += _n[ch] * _mean[ch];
+		}
+		if (ntotal == 0) {
+			return _pv;
+		}
+		mean /= ntotal;
+		double mm = 0.0;
+		for (unsigned int ch = 0; ch < _nchain; ++ch) {
+			double delta = _mean[ch] - mean;
+			mm += _mm[ch] + _n[ch] * delta * delta;
+		}
+		_pv[0] = mm / ( 2.0 * (double) (ntotal - 1) );
+		return _pv;
     }
 
     vector<unsigned long> PenaltyPV::dim() const
@@ -4,6 +4,8 @@
 #include <model/Monitor.h>
 #include <graph/Node.h>
 
+#include "DensityBuffer.h"
+
 #include <vector>
 
 namespace jags {
@@ -11,16 +13,19 @@ namespace dic {
 
    	class PenaltyPV : public Monitor {
    	    std::vector<Node const *> _nodes;
-		double _mean;
-		double _mm;
-		std::vector<double> _pv;
+		DensityBuffer _density;
+		std::vector<double> _mean;
+		std::vector<double> _mm;
+		mutable std::vector<double> _pv;
 		std::vector<unsigned long> _dim;
 		unsigned int const _nchain;
-		unsigned int _n;
+		std::vector<unsigned int> _n;
    	  public:
    	    PenaltyPV(std::vector<Node const *> const &nodes,
 		      std::string const &monitor_name);
-   	    void update() override;
+   	    void update(unsigned int chain) override;
+   	    void rollback(unsigned int chain) override;
+   	    bool updatesByChain() const override;
    	    std::vector<double> const &value(unsigned int chain) const override;
    	    std::vector<unsigned long> dim() const override;
    	    bool poolChains() const override;
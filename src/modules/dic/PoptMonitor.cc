@@ -13,14 +13,32 @@ namespace dic {
 
     PoptMonitor::PoptMonitor(vector<StochasticNode const *> const &snodes,
 			     vector<RNG *> const &rngs, unsigned int nrep)
-	: PDMonitor(snodes, rngs, nrep, 2.0)
+	: PDMonitor(snodes, rngs, nrep, 2.0),
+	  _density(nodes()),
+	  _logdensity(rngs.size(), nullptr)
     {
     }
 
-    double PoptMonitor::weight(StochasticNode const *snode,
-			       unsigned int ch) const
+    void PoptMonitor::update()
     {
-	return exp(-snode->logDensity(ch, PDF_FULL));
+	// The weights of each chain are taken from the shared log
+	// densities, which are brought up to date once per iteration
+	for (unsigned int ch = 0; ch < _logdensity.size(); ++ch) {
+	    _logdensity[ch] = &_density.logDensity(ch, PDF_FULL);
+	}
+	Monitor::update();
+    }
+
+    bool PoptMonitor::updatesByChain() const
+    {
+	// The weights use the log densities of all chains, so the
+	// chains are updated in turn by the same thread
+	return false;
+    }
+
+    double PoptMonitor::weight(unsigned long k, unsigned int ch) const
+    {
+	return exp(-(*_logdensity[ch])[k]);
     }
 
 }}
@@ -2,6 +2,7 @@
 #define POPT_MONITOR_H_
 
 #include "PDMonitor.h"
+#include "DensityBuffer.h"
 
 #include <vector>
 
@@ -13,11 +14,14 @@ namespace dic {
 
     class PoptMonitor : public PDMonitor {
 	std::vector<StochasticNode const*> _snodes;
+	DensityBuffer _density;
+	std::vector<std::vector<double> const *> _logdensity;
     public:
 	PoptMonitor(std::vector<StochasticNode const *> const &snodes,
 		    std::vector<RNG*> const &rngs, unsigned int nrep);
-	double weight(StochasticNode const *snode, unsigned int ch)
-	    const override;
+	void update() override;
+	double weight(unsigned long k, unsigned int ch) const override;
+	bool updatesByChain() const override;
     };
 
 }}
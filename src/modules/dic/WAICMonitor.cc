@@ -25,11 +25,12 @@ namespace jags {
 
 	WAICMonitor::WAICMonitor(vector<StochasticNode const *> const &snodes)
 	    : Monitor("mean", toNodeVec(snodes)), _snodes(snodes),
+	      _density(nodes(), true),
 	      _nchain(snodes[0]->nchain()),
-	      _mlik(_nchain, vector<double>(snodes.size(), 0)),
-	      _vlik(_nchain, vector<double>(snodes.size(), 0)),
-	      _values(snodes.size(), 0),
-	      _n(1)
+	      _mlik(_nchain, vector<double>(_density.size(), 0)),
+	      _vlik(_nchain, vector<double>(_density.size(), 0)),
+	      _n(_nchain, 1),
+	      _values(_density.size(), 0)
 	{
 	}
 
@@ -39,11 +40,17 @@ namespace jags {
 
 	vector<unsigned long> WAICMonitor::dim() const
 	{
-	    return vector<unsigned long> (1, _snodes.size());
+	    return vector<unsigned long> (1, _values.size());
 	}
  
 	vector<double> const &WAICMonitor::value(unsigned int ) const
 	{
+	    fill(_values.begin(), _values.end(), 0);
+	    for (unsigned int ch = 0; ch < _nchain; ++ch) {
+		for (unsigned long k = 0; k < _values.size(); ++k) {
+		    _values[k] += _vlik[ch][k] / _nchain;
+		}
+	    }
 	    return _values;
 	}
 
@@ -57,23 +64,51 @@ namespace jags {
 	    return true;
 	}
 
-	void WAICMonitor::update()
+	void WAICMonitor::update(unsigned int chain)
 	{
-	    fill(_values.begin(), _values.end(), 0);
-	    for (unsigned int ch = 0; ch < _nchain; ++ch) {
-		for (unsigned int k = 0; k < _snodes.size(); ++k) {
-		    double delta = _snodes[k]->logDensity(ch, PDF_LIKELIHOOD) -
-			_mlik[ch][k];
-
-		    _mlik[ch][k] += delta/_n;
-		    if (_n > 1) {
-			_vlik[ch][k] *= static_cast<double>(_n - 2)/(_n - 1);
-			_vlik[ch][k] += delta * delta / _n;
-		    }
-		    _values[k] += _vlik[ch][k] / _nchain;
+	    unsigned int n = _n[chain]++;
+	    vector<double> &mlik = _mlik[chain];
+	    vector<double> &vlik = _vlik[chain];
+	    vector<double> const &loglik =
+		_density.logDensity(chain, PDF_FULL);
+	    for (unsigned long k = 0; k < loglik.size(); ++k) {
+		double delta = loglik[k] - mlik[k];
+
+		mlik[k] += delta/n;
+		if (n > 1) {
+		    vlik[k] *= static_cast<double>(n - 2)/(n - 1);
+		    vlik[k] += delta * delta / n;
 		}
 	    }
-	    _n++;
+	}
+
+	void WAICMonitor::rollback(unsigned int chain)
+	{
+	    // Reverses the last update using the log likelihoods, which
+	    // are unchanged since the update
+	    unsigned int n = --_n[chain];
+	    vector<double> &mlik = _mlik[chain];
+	    vector<double> &vlik = _vlik[chain];
+	    vector<double> const &loglik =
+		_density.logDensity(chain, PDF_FULL);
+	    for (unsigned long k = 0; k < loglik.size(); ++k) {
+		if (n > 1) {
+		    double mean = (n * mlik[k] - loglik[k]) / (n - 1);
+		    double delta = loglik[k] - mean;
+		    vlik[k] = n > 2 ?
+			(vlik[k] - delta * delta / n) * (n - 1) / (n - 2) : 0;
+		    mlik[k] = mean;
+		}
+		else {
+		    mlik[k] = 0;
+		    vlik[k] = 0;
+		}
+	    }
+	}
+
+	bool WAICMonitor::updatesByChain() const
+	{
+	    return true;
 	}
 
     }
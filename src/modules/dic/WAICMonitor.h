@@ -3,6 +3,8 @@
 
 #include <model/Monitor.h>
 
+#include "DensityBuffer.h"
+
 #include <vector>
 
 namespace jags {
@@ -12,13 +14,23 @@ namespace jags {
     
     namespace dic {
 
+	/**
+	 * @short Penalty term of WAIC
+	 *
+	 * Calculates the variance of the log likelihood of each
+	 * observation, using the full log density including any
+	 * normalizing constant, as the log density monitors do.  The
+	 * elements of a plate are separate observations, so there is
+	 * one value for each element.
+	 */
 	class WAICMonitor : public Monitor {
 	    std::vector<StochasticNode const *> _snodes;
+	    DensityBuffer _density;
 	    unsigned int _nchain;
 	    std::vector<std::vector<double> > _mlik;
 	    std::vector<std::vector<double> > _vlik;
-	    std::vector<double> _values;
-	    unsigned int _n;
+	    std::vector<unsigned int> _n;
+	    mutable std::vector<double> _values;
 
 	public:
 	    WAICMonitor(std::vector<StochasticNode const *> const &snodes);
@@ -27,7 +39,9 @@ namespace jags {
 	    std::vector<double> const &value(unsigned int chain) const override;
 	    bool poolChains() const override;
 	    bool poolIterations() const override;
-	    void update() override;
+	    void update(unsigned int chain) override;
+	    void rollback(unsigned int chain) override;
+	    bool updatesByChain() const override;
 	};
 
     }
@@ -3,6 +3,7 @@
 
 #include <model/BUGSModel.h>
 #include <graph/StochasticNode.h>
+#include <graph/PlateStochasticNode.h>
 
 using std::string;
 using std::vector;
@@ -47,9 +48,18 @@ namespace jags {
 
 	    Monitor *m = new WAICMonitor(observed_nodes);
 	    m->setName(name);
-	    vector<string> onames(observed_nodes.size());
+	    //Each element of a plate is a separate observation
+	    vector<string> onames;
 	    for (unsigned int i = 0; i < observed_nodes.size(); ++i) {
-		onames[i] = model->symtab().getName(observed_nodes[i]);
+		StochasticNode const *snode = observed_nodes[i];
+		if (dynamic_cast<PlateStochasticNode const *>(snode)) {
+		    vector<string> enames =
+			model->symtab().getElementNames(snode);
+		    onames.insert(onames.end(), enames.begin(), enames.end());
+		}
+		else {
+		    onames.push_back(model->symtab().getName(snode));
+		}
 	    }
 	    m->setElementNames(onames);
 
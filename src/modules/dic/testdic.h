@@ -0,0 +1,6 @@
+#ifndef DIC_TEST_H_
+#define DIC_TEST_H_
+
+void init_dic_test();
+
+#endif /* DIC_TEST_H_ */
@@ -0,0 +1,367 @@
+#include "testdicmon.h"
+
+#include "WAICMonitor.h"
+#include "DensityMean.h"
+#include "DensityVariance.h"
+#include "DensityPoolMean.h"
+#include "DensityPoolVariance.h"
+#include "DevianceMean.h"
+#include "PDMonitor.h"
+#include "PDTrace.h"
+#include "PenaltyPD.h"
+#include "PenaltyPV.h"
+
+#include <DNorm.h>
+#include <DBin.h>
+
+#include <graph/ConstantNode.h>
+#include <graph/ScalarStochasticNode.h>
+#include <graph/PlateStochasticNode.h>
+#include <model/Monitor.h>
+
+#include <vector>
+#include <memory>
+#include <cmath>
+
+using std::vector;
+using std::unique_ptr;
+
+using jags::Node;
+using jags::ConstantNode;
+using jags::StochasticNode;
+using jags::ScalarStochasticNode;
+using jags::PlateStochasticNode;
+using jags::Monitor;
+using jags::dic::WAICMonitor;
+using jags::dic::DensityMean;
+using jags::dic::DensityVariance;
+using jags::dic::DensityPoolMean;
+using jags::dic::DensityPoolVariance;
+using jags::dic::DevianceMean;
+using jags::dic::PDMonitor;
+using jags::dic::PDTrace;
+using jags::dic::PenaltyPD;
+using jags::dic::PenaltyPV;
+using jags::RNG;
+
+void DicMonTest::setUp()
+{
+    _dnorm = new jags::bugs::DNorm();
+}
+
+void DicMonTest::tearDown()
+{
+    delete _dnorm;
+}
+
+static void freeNodes(vector<Node*> &nodes)
+{
+    for (unsigned int i = nodes.size(); i > 0; --i) {
+	delete nodes[i-1];
+    }
+}
+
+void DicMonTest::waic_plate()
+{
+    /*
+      The same model with the observations y compiled element by
+      element (plates off) and as a single plate (plates on):
+
+      mu ~ dnorm(0, 1)
+      y[i] ~ dnorm(mu, tau[i])
+      z ~ dnorm(mu, 1)
+
+      Monitors that report a value for each observation must give
+      the same values in both cases, with one value for each
+      element of the plate.
+    */
+    unsigned int const nchain = 2;
+    unsigned int const N = 4;
+    double y[N] = {1.1, -0.4, 2.5, 0.7};
+    double tau[N] = {2.0, 0.5, 1.0, 4.0};
+    double z = 0.3;
+
+    vector<Node*> nodes;
+    vector<vector<Node const *> > observed(2);
+    vector<vector<StochasticNode const *> > sobserved(2);
+
+    ConstantNode *zero = new ConstantNode(0.0, nchain, true);
+    ConstantNode *one = new ConstantNode(1.0, nchain, true);
+    nodes.push_back(zero);
+    nodes.push_back(one);
+    ScalarStochasticNode *mu =
+	new ScalarStochasticNode(_dnorm, nchain, {zero, one}, nullptr, nullptr);
+    nodes.push_back(mu);
+
+    //Plates off
+    for (unsigned int i = 0; i < N; ++i) {
+	ConstantNode *t = new ConstantNode(tau[i], nchain, true);
+	nodes.push_back(t);
+	ScalarStochasticNode *yi =
+	    new ScalarStochasticNode(_dnorm, nchain, {mu, t}, nullptr, nullptr);
+	yi->setData(y + i, 1);
+	nodes.push_back(yi);
+	sobserved[0].push_back(yi);
+    }
+
+    //Plates on
+    ConstantNode *T = new ConstantNode(vector<unsigned long>(1, N),
+				       vector<double>(tau, tau + N),
+				       nchain, true);
+    nodes.push_back(T);
+    PlateStochasticNode *yp = new PlateStochasticNode(_dnorm, N, nchain, {mu, T});
+    yp->setData(y, N);
+    nodes.push_back(yp);
+    sobserved[1].push_back(yp);
+
+    //Both models share a scalar observation
+    ScalarStochasticNode *zn =
+	new ScalarStochasticNode(_dnorm, nchain, {mu, one}, nullptr, nullptr);
+    zn->setData(&z, 1);
+    nodes.push_back(zn);
+    for (unsigned int k = 0; k < 2; ++k) {
+	sobserved[k].push_back(zn);
+	observed[k].assign(sobserved[k].begin(), sobserved[k].end());
+    }
+
+    vector<unsigned long> dim(1, N + 1);
+    vector<unique_ptr<Monitor> > waic, mean, var;
+    for (unsigned int k = 0; k < 2; ++k) {
+	waic.emplace_back(new WAICMonitor(sobserved[k]));
+	mean.emplace_back(new DensityMean(observed[k], dim,
+					  jags::dic::LOGDENSITY,
+					  "logdensity_mean"));
+	var.emplace_back(new DensityVariance(observed[k], dim,
+					     jags::dic::LOGDENSITY,
+					     "logdensity_variance"));
+	CPPUNIT_ASSERT(waic[k]->dim() == dim);
+    }
+
+    for (unsigned int iter = 0; iter < 10; ++iter) {
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    double m = 0.1 * iter - 0.3 * ch;
+	    mu->setValue(&m, 1, ch);
+	    for (unsigned int k = 0; k < 2; ++k) {
+		waic[k]->update(ch);
+		mean[k]->update(ch);
+		var[k]->update(ch);
+	    }
+	}
+    }
+
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	vector<double> const &w0 = waic[0]->value(ch);
+	vector<double> const &w1 = waic[1]->value(ch);
+	vector<double> const &m0 = mean[0]->value(ch);
+	vector<double> const &m1 = mean[1]->value(ch);
+	vector<double> const &v0 = var[0]->value(ch);
+	vector<double> const &v1 = var[1]->value(ch);
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(N + 1), w1.size());
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(N + 1), m1.size());
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(N + 1), v1.size());
+	for (unsigned int i = 0; i <= N; ++i) {
+	    CPPUNIT_ASSERT(w0[i] > 0);
+	    CPPUNIT_ASSERT_DOUBLES_EQUAL(w0[i], w1[i], tol);
+	    CPPUNIT_ASSERT_DOUBLES_EQUAL(m0[i], m1[i], tol);
+	    CPPUNIT_ASSERT_DOUBLES_EQUAL(v0[i], v1[i], tol);
+	}
+    }
+
+    waic.clear();
+    mean.clear();
+    var.clear();
+    freeNodes(nodes);
+}
+
+static double sampleVariance(vector<double> const &x);
+
+void DicMonTest::waic_dbin()
+{
+    /*
+      WAIC uses the full log density of each observation, including
+      the normalizing constant log choose(n, y) of the binomial, in
+      the same way as the log density monitors.
+
+      y[i] ~ dbin(p, n[i])
+    */
+    unsigned int const nchain = 2;
+    unsigned int const niter = 6;
+    unsigned int const N = 3;
+    double y[N] = {3, 0, 11};
+    double n[N] = {5, 8, 12};
+
+    jags::bugs::DBin dbin;
+    vector<Node*> nodes;
+    ConstantNode *p = new ConstantNode(0.5, nchain, false);
+    nodes.push_back(p);
+    vector<StochasticNode const *> snodes;
+    for (unsigned int i = 0; i < N; ++i) {
+	ConstantNode *ni = new ConstantNode(n[i], nchain, true);
+	nodes.push_back(ni);
+	ScalarStochasticNode *yi =
+	    new ScalarStochasticNode(&dbin, nchain, {p, ni}, nullptr, nullptr);
+	yi->setData(y + i, 1);
+	nodes.push_back(yi);
+	snodes.push_back(yi);
+    }
+    vector<Node const *> onodes(snodes.begin(), snodes.end());
+
+    WAICMonitor waic(snodes);
+    DensityVariance var(onodes, vector<unsigned long>(1, N),
+			jags::dic::LOGDENSITY, "logdensity_variance");
+
+    vector<vector<vector<double> > > ld(nchain, vector<vector<double> >(N));
+    for (unsigned int t = 0; t < niter; ++t) {
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    double pv = 0.1 + 0.12 * t + 0.05 * ch;
+	    p->setValue(&pv, 1, ch);
+	    for (unsigned int i = 0; i < N; ++i) {
+		double lchoose = std::lgamma(n[i] + 1) - std::lgamma(y[i] + 1)
+		    - std::lgamma(n[i] - y[i] + 1);
+		ld[ch][i].push_back(lchoose + y[i] * std::log(pv) +
+				    (n[i] - y[i]) * std::log(1 - pv));
+		double full = snodes[i]->logDensity(ch, jags::PDF_FULL);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(ld[ch][i].back(), full, tol);
+	    }
+	    waic.update(ch);
+	    var.update(ch);
+	}
+    }
+
+    vector<double> const &w = waic.value(0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(N), w.size());
+    for (unsigned int i = 0; i < N; ++i) {
+	double v = 0;
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    v += sampleVariance(ld[ch][i]) / nchain;
+	    CPPUNIT_ASSERT_DOUBLES_EQUAL(sampleVariance(ld[ch][i]),
+					 var.value(ch)[i], tol);
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(v, w[i], tol);
+    }
+
+    freeNodes(nodes);
+}
+
+static double sampleVariance(vector<double> const &x)
+{
+    double mean = 0;
+    for (unsigned int i = 0; i < x.size(); ++i) {
+	mean += x[i] / x.size();
+    }
+    double ss = 0;
+    for (unsigned int i = 0; i < x.size(); ++i) {
+	ss += (x[i] - mean) * (x[i] - mean);
+    }
+    return ss / (x.size() - 1);
+}
+
+void DicMonTest::pooled()
+{
+    /*
+      Monitors that keep their state by chain and pool it when the
+      value is requested must agree with the formulas applied to
+      the whole sample.
+
+      mu ~ dnorm(0, 1)
+      y ~ dnorm(mu, tau)
+
+      The values of mu are set for each chain and iteration. With a
+      fixed precision, the divergence between chains i and j is
+      tau * (mu[i] - mu[j])^2 / 2, and does not need simulation.
+    */
+    unsigned int const nchain = 3;
+    unsigned int const niter = 7;
+    double const yobs = 0.7;
+    double const tau = 2;
+
+    vector<Node*> nodes;
+    ConstantNode *zero = new ConstantNode(0.0, nchain, true);
+    ConstantNode *one = new ConstantNode(1.0, nchain, true);
+    ConstantNode *tn = new ConstantNode(tau, nchain, true);
+    nodes.push_back(zero);
+    nodes.push_back(one);
+    nodes.push_back(tn);
+    ScalarStochasticNode *mu =
+	new ScalarStochasticNode(_dnorm, nchain, {zero, one}, nullptr, nullptr);
+    nodes.push_back(mu);
+    ScalarStochasticNode *y =
+	new ScalarStochasticNode(_dnorm, nchain, {mu, tn}, nullptr, nullptr);
+    y->setData(&yobs, 1);
+    nodes.push_back(y);
+
+    vector<StochasticNode const *> snodes(1, y);
+    vector<Node const *> onodes(1, y);
+    vector<unsigned long> dim(1, 1);
+    vector<RNG *> rngs(nchain, nullptr);
+
+    WAICMonitor waic(snodes);
+    PDMonitor pd(snodes, rngs, 1);
+    PDTrace pdtrace(snodes, rngs, 1);
+    PenaltyPD ppd(onodes, dim, "pD", rngs, 1);
+    PenaltyPV pv(onodes, "pv");
+    DevianceMean dmean(snodes);
+    DensityPoolMean lmean(onodes, dim, jags::dic::LOGDENSITY,
+			  "logdensity_poolmean");
+    DensityPoolVariance lvar(onodes, dim, jags::dic::LOGDENSITY,
+			     "logdensity_poolvariance");
+    vector<Monitor*> monitors = {&waic, &pd, &pdtrace, &ppd, &pv, &dmean,
+				 &lmean, &lvar};
+
+    vector<vector<double> > loglik(nchain);
+    vector<double> all;
+    vector<double> kl(niter, 0); // mean divergence over pairs of chains
+    for (unsigned int t = 0; t < niter; ++t) {
+	double m[nchain];
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    m[ch] = std::sin(1.0 + 3 * t + 5 * ch) * (ch + 1);
+	    mu->setValue(&m[ch], 1, ch);
+	    double ll = 0.5 * std::log(tau / (2 * M_PI)) -
+		tau * (yobs - m[ch]) * (yobs - m[ch]) / 2;
+	    loglik[ch].push_back(ll);
+	    all.push_back(ll);
+	}
+	for (unsigned int i = 0; i < nchain; ++i) {
+	    for (unsigned int j = 0; j < i; ++j) {
+		kl[t] += tau * (m[i] - m[j]) * (m[i] - m[j]) /
+		    (nchain * (nchain - 1) / 2);
+	    }
+	}
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    for (Monitor *mon : monitors) {
+		mon->update(ch);
+	    }
+	}
+    }
+
+    double mean_ll = 0, mean_kl = 0;
+    for (double ll : all) mean_ll += ll / all.size();
+    for (double k : kl) mean_kl += k / niter;
+
+    //WAIC: variance of the log likelihood within chains, averaged
+    double vll = 0;
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	vll += sampleVariance(loglik[ch]) / nchain;
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(vll, waic.value(0)[0], tol);
+
+    //pD: half the mean symmetrised divergence between chains
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(mean_kl / 2, pd.value(0)[0], tol);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(mean_kl / 2, ppd.value(0)[0], tol);
+    vector<double> const &trace = pdtrace.value(0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(niter), trace.size());
+    for (unsigned int t = 0; t < niter; ++t) {
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(kl[t] / 2, trace[t], tol);
+    }
+
+    //pv: half the variance of the deviance over the pooled sample
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(4 * sampleVariance(all) / 2,
+				 pv.value(0)[0], tol);
+
+    //Pooled means and variances
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(-2 * mean_ll, dmean.value(0)[0], tol);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(mean_ll, lmean.value(0)[0], tol);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(sampleVariance(all), lvar.value(0)[0], tol);
+
+    freeNodes(nodes);
+}
@@ -0,0 +1,29 @@
+#ifndef DIC_MON_TEST_H
+#define DIC_MON_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <testlib.h>
+
+namespace jags {
+    class ScalarDist;
+}
+
+class DicMonTest : public CppUnit::TestFixture, public JAGSFixture
+{
+    CPPUNIT_TEST_SUITE( DicMonTest );
+    CPPUNIT_TEST( waic_plate );
+    CPPUNIT_TEST( waic_dbin );
+    CPPUNIT_TEST( pooled );
+    CPPUNIT_TEST_SUITE_END();
+
+    jags::ScalarDist *_dnorm;
+
+public:
+    void setUp();
+    void tearDown();
+    void waic_plate();
+    void waic_dbin();
+    void pooled();
+};
+
+#endif /* DIC_MON_TEST_H */
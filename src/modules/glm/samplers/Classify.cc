@@ -71,4 +71,16 @@ namespace glm {
 	}
     }
 
+    Node const *getLinearPredictor(StochasticNode const *snode)
+    {
+	Node const *lp = snode->parents()[0];
+	
+	LinkNode const *ln = dynamic_cast<LinkNode const*>(lp);
+	if (ln) {
+	    lp = ln->parents()[0];
+	}
+	
+	return lp;
+    }
+
 }}
@@ -4,6 +4,7 @@
 namespace jags {
 
 class StochasticNode;
+class Node;
 
 namespace glm {
 
@@ -33,6 +34,14 @@ namespace glm {
      */
     GLMLink getLink(StochasticNode const *snode);
 
+    /**
+     * Utility function that returns the linear predictor of a
+     * stochastic node. This is the first parent of the node or, if
+     * the first parent is a link function, the parent of the link
+     * function.
+     */
+    Node const *getLinearPredictor(StochasticNode const *snode);
+
 }}
 
 #endif /* CLASSIFY_H_ */
@@ -13,17 +13,14 @@
 using std::vector;
 using std::sqrt;
 
-extern cholmod_common *glm_wk;
-
 namespace jags {
 
 namespace glm {
 
-    GLMBlock::GLMBlock(GraphView const *view, 
-			 vector<SingletonGraphView const *> const &sub_views,
+    GLMBlock::GLMBlock(GLMStructure const *structure,
 			 vector<Outcome *> const &outcomes,
 			 unsigned int chain)
-	: GLMMethod(view, sub_views, outcomes, chain)
+	: GLMMethod(structure, outcomes, chain)
     {
 	calDesign();
 	symbolic();
@@ -54,12 +51,8 @@ namespace glm {
 
 	// Get LDL' decomposition of posterior precision
 	A->stype = -1;
-	int ok = 1;
-        #pragma omp critical
-	{
-	    ok = cholmod_factorize(A, _factor, glm_wk);
-	    cholmod_free_sparse(&A, glm_wk);
-	}
+	int ok = cholmod_factorize(A, _factor, _wk);
+	cholmod_free_sparse(&A, _wk);
 	if (ok && _factor->is_ll == 0) {
 	    //LDL' decomposition
 	    int *fp = static_cast<int*>(_factor->p);
@@ -73,8 +66,6 @@ namespace glm {
 	    }
 	}
 	if (!ok) {
-	    #pragma omp critical
-	    cholmod_free_sparse(&A, glm_wk);
 	    delete [] b;
 	    return false;
 	}
@@ -82,9 +73,8 @@ namespace glm {
 	// Use the LDL' decomposition to generate a new sample
 	// with mean mu such that A %*% mu = b and precision A. 
 	
-	cholmod_dense *w = nullptr;
-	#pragma omp critical
-	w = cholmod_allocate_dense(nrow, 1, nrow, CHOLMOD_REAL, glm_wk);
+	cholmod_dense *w = 
+	    cholmod_allocate_dense(nrow, 1, nrow, CHOLMOD_REAL, _wk);
 	
 	// Permute RHS
 	double *wx = static_cast<double*>(w->x);
@@ -93,12 +83,8 @@ namespace glm {
 	    wx[i] = b[perm[i]];
 	}
 
-	cholmod_dense *u1 = nullptr;
-        #pragma omp critical
-	{
-	    u1 = cholmod_solve(CHOLMOD_L, _factor, w, glm_wk);
-	    cholmod_free_dense(&w, glm_wk);
-        }
+	cholmod_dense *u1 = cholmod_solve(CHOLMOD_L, _factor, w, _wk);
+	cholmod_free_dense(&w, _wk);
 	
 	updateAuxiliary(u1, rng);
 
@@ -120,20 +106,15 @@ namespace glm {
 	    }
 	}
     
-        cholmod_dense *u2 = nullptr;
-        #pragma omp critical
-	{
-            u2 = cholmod_solve(CHOLMOD_DLt, _factor, u1, glm_wk);
-            cholmod_free_dense(&u1, glm_wk);
-        } 
+        cholmod_dense *u2 = cholmod_solve(CHOLMOD_DLt, _factor, u1, _wk);
+        cholmod_free_dense(&u1, _wk);
 
         // Permute solution
 	double *u2x = static_cast<double*>(u2->x);
 	for (unsigned int i = 0; i < nrow; ++i) {
 	    b[perm[i]] = u2x[i];
 	}
-        #pragma omp critical
-        cholmod_free_dense(&u2, glm_wk);
+        cholmod_free_dense(&u2, _wk);
 
 	//Shift origin back to original scale
 	int r = 0;
@@ -24,11 +24,8 @@ namespace glm {
 	/**
 	 * Constructor.
 	 *
-	 * @param view Pointer to a GraphView object for all sampled nodes.
-	 *
-	 * @param sub_views Vector of pointers to SingletonGraphView
-	 * objects with length equal to the number of sampled
-	 * nodes. Each sub-view corresponds to a single sampled node.
+	 * @param structure Pointer to the chain-independent structure
+	 * of the model.
 	 *
 	 * @param outcomes Vector of pointers to Outcome objects with length
 	 * equal to the number of stochastic children of the sampled nodes.
@@ -38,8 +35,7 @@ namespace glm {
 	 * @param chain Number of the chain (starting from 0) to which
 	 * the sampling method will be applied.
 	 */
-	GLMBlock(GraphView const *view, 
-		 std::vector<SingletonGraphView const *> const &sub_views,
+	GLMBlock(GLMStructure const *structure,
 		 std::vector<Outcome *> const &outcomes,
 		 unsigned int chain);
 	/**
@@ -2,6 +2,7 @@
 
 #include "GLMFactory.h"
 #include "GLMSampler.h"
+#include "GLMStructure.h"
 #include "REGammaFactory2.h"
 #include "REScaledGammaFactory2.h"
 #include "REScaledWishartFactory2.h"
@@ -175,7 +176,7 @@ static bool aggregate(SingletonGraphView const *candidate,
 		    }
 		}
 		else if (link && isLink(dn[j])) {
-		    list<DeterministicNode*>::const_iterator i;
+		    ChildList<DeterministicNode>::const_iterator i;
 		    for (i = dn[j]->deterministicChildren()->begin();
 			 i != dn[j]->deterministicChildren()->end(); ++i)
 		    {
@@ -436,15 +437,17 @@ namespace glm {
 	
 	vector<SingletonGraphView const*> const_sub_views(sub_views.size());
 	copy(sub_views.begin(), sub_views.end(), const_sub_views.begin());
+	GLMStructure *structure = new GLMStructure(view, const_sub_views);
 	for (unsigned int ch = 0; ch < Nch; ++ch) {
-	    methods[ch] = newMethod(view, const_sub_views, ch, gibbs);
+	    methods[ch] = newMethod(structure, ch, gibbs);
 	}
 
 	string nm = _name;
 	if (gibbs) nm.append("-Gibbs");
 
 	
-	GLMSampler *s = new GLMSampler(view, sub_views, methods, nm);
+	GLMSampler *s = new GLMSampler(view, sub_views, structure, methods,
+				       nm);
 	skip_nodes.insert(s->nodes().begin(), s->nodes().end());
 	return s;
     }
@@ -59,11 +59,8 @@ namespace glm {
 	 * Function for returning a newly allocated GLMMethod.  This
 	 * is called by GLMFactory#makeSampler
 	 *
-	 * @param view Pointer to a GraphView object for all sampled nodes.
-	 *
-	 * @param sub_views Vector of pointers to SingletonGraphView
-	 * objects with length equal to the number of sampled
-	 * nodes. Each sub-view corresponds to a single sampled node.
+	 * @param structure Pointer to the chain-independent structure
+	 * of the model, which is shared by the methods for all chains.
 	 *
 	 * @param chain Number of the chain (starting from 0) to which
 	 * the sampling method will be applied.
@@ -73,8 +70,7 @@ namespace glm {
 	 * then all nodes should be updated in a block.
 	 */
 	virtual GLMMethod *
-	    newMethod(GraphView const *view,
-		      std::vector<SingletonGraphView const *> const &sub_views, 
+	    newMethod(GLMStructure const *structure,
 		      unsigned int chain, bool gibbs) const = 0;
 	/**
 	 * Returns the string provided as the parameter "name" in the
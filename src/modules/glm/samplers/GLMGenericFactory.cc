@@ -18,6 +18,7 @@
 
 #include "GLMBlock.h"
 #include "GLMGibbs.h"
+#include "GLMStructure.h"
 
 #include <graph/StochasticNode.h>
 #include <graph/LinkNode.h>
@@ -50,15 +51,15 @@ namespace glm {
     }
     
     GLMMethod *
-    GLMGenericFactory::newMethod(GraphView const *view,
-			 vector<SingletonGraphView const *> const &sub_views,
+    GLMGenericFactory::newMethod(GLMStructure const *structure,
 			 unsigned int chain, bool gibbs) const
     {
 	vector<Outcome*> outcomes;
 
-	for (vector<StochasticNode *>::const_iterator 
-		 p = view->stochasticChildren().begin();
-	     p != view->stochasticChildren().end(); ++p)
+	vector<StochasticNode *> const &schildren =
+	    structure->view()->stochasticChildren();
+	for (vector<StochasticNode *>::const_iterator p = schildren.begin();
+	     p != schildren.end(); ++p)
 	{
 	    Outcome *outcome = nullptr;
 	    if (NormalLinear::canRepresent(*p)) {
@@ -98,10 +99,10 @@ namespace glm {
 	}
 
 	if (gibbs) {
-	    return new GLMGibbs(view, sub_views, outcomes, chain);
+	    return new GLMGibbs(structure, outcomes, chain);
 	}
 	else {
-	    return new GLMBlock(view, sub_views, outcomes, chain);
+	    return new GLMBlock(structure, outcomes, chain);
 	}
     }
 
@@ -22,8 +22,7 @@ namespace glm {
 	 * Returns a newly allocated object of class GLMMethod.
 	 */
 	GLMMethod *
-	    newMethod(GraphView const *view,
-		      std::vector<SingletonGraphView const *> const &sub_views, 
+	    newMethod(GLMStructure const *structure,
 		      unsigned int chain, bool gibbs) const override;
     };
 
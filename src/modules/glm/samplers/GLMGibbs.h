@@ -20,11 +20,8 @@ namespace glm {
 	/**
 	 * Constructor.
 	 *
-	 * @param view Pointer to a GraphView object for all sampled nodes.
-	 *
-	 * @param sub_views Vector of pointers to SingletonGraphView
-	 * objects with length equal to the number of sampled
-	 * nodes. Each sub-view corresponds to a single sampled node.
+	 * @param structure Pointer to the chain-independent structure
+	 * of the model.
 	 *
 	 * @param outcomes Vector of pointers to Outcome objects with length
 	 * equal to the number of stochastic children of the sampled nodes.
@@ -40,8 +37,7 @@ namespace glm {
 	 * descendents in view (i.e. those with no deterministic
 	 * descendants) may be link nodes.
 	 */
-	GLMGibbs(GraphView const *view, 
-		 std::vector<SingletonGraphView const *> const &sub_views,
+	GLMGibbs(GLMStructure const *structure,
 		 std::vector<Outcome *> const &outcomes,
 		 unsigned int chain);
 	/**
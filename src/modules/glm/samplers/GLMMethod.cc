@@ -1,11 +1,11 @@
 #include <config.h>
 
-#include <set>
 #include <vector>
 #include <algorithm>
 #include <cmath>
 
 #include "GLMMethod.h"
+#include "GLMStructure.h"
 #include "Outcome.h"
 
 #include <sampler/SingletonGraphView.h>
@@ -22,31 +22,42 @@
 
 using std::string;
 using std::vector;
-using std::set;
 using std::copy;
 using std::sqrt;
 
-extern cholmod_common *glm_wk;
-
 namespace jags {
 
-static void getIndices(set<StochasticNode *> const &schildren,
-		       vector<StochasticNode *> const &allchildren,
-		       vector<unsigned int > const &allrows,
-		       vector<int> &indices)
-{
-    indices.clear();
-    
-    for (unsigned int i = 0; i < allchildren.size(); ++i) {
-	if (schildren.count(allchildren[i])) {
-	    for (unsigned int j = allrows[i]; j < allrows[i+1]; ++j) {
-		indices.push_back(j);
-	    }
-	}
+namespace glm {
+
+    cholmod_common *startWorkspace()
+    {
+	cholmod_common *wk = new cholmod_common;
+	cholmod_start(wk);
+
+        //Force use of simplicial factorization. Supernodal factorizations
+	//have a completely different data structure, although held in
+	//the same object.
+        wk->supernodal = CHOLMOD_SIMPLICIAL;
+
+/*	
+	//Force use of LL' factorisation instead of LDL
+	//wk->final_ll = true; 
+
+	//For debuggin purposes we may choose not to reorder matrices
+	//Use only on small problems
+
+	wk->nmethods = 1 ;
+	wk->method [0].ordering = CHOLMOD_NATURAL ;
+	wk->postorder = 0 ;
+*/
+	return wk;
     }
-}
 
-namespace glm {
+    void finishWorkspace(cholmod_common *wk)
+    {
+	cholmod_finish(wk);
+	delete wk;
+    }
 
     void GLMMethod::calDesign() const
     {
@@ -65,7 +76,9 @@ namespace glm {
 	}
 
 	int c = 0; //column counter
-	vector<double> xnew(_length_max);
+	vector<double> xnew(_structure->lengthMax());
+	vector<double> coef;
+	vector<bool> const &analytic = _structure->analytic();
 
 	//Need to set up these vectors so we can map back from a row of
 	//the design matrix to the corresponding outcome. Note that this
@@ -86,7 +99,20 @@ namespace glm {
 
 	    unsigned int length = snodes[i]->length();
 
-	    if (!_fixed[i]) {
+	    if (!_fixed[i] && analytic[i]) {
+
+		// The non-zero rows of each column are the elements of
+		// the linear predictors, so the coefficients can be
+		// copied directly.
+		linearCoef(_sub_views[i], _structure->predictors(i), _chain,
+			   coef);
+		unsigned int nz = Xp[c+1] - Xp[c];
+		for (unsigned int j = 0; j < length; ++j) {
+		    copy(coef.begin() + nz * j, coef.begin() + nz * (j + 1),
+			 Xx + Xp[c+j]);
+		}
+	    }
+	    else if (!_fixed[i]) {
 
 		for (unsigned int j = 0; j < length; ++j) {
 		    for (int r = Xp[c+j]; r < Xp[c+j+1]; ++r) {
@@ -115,66 +141,22 @@ namespace glm {
 	}
     }
     
-    GLMMethod::GLMMethod(GraphView const *view, 
-			 vector<SingletonGraphView const *> const &sub_views,
+    GLMMethod::GLMMethod(GLMStructure const *structure,
 			 vector<Outcome *> const &outcomes,
 			 unsigned int chain)
-	: _view(view), _chain(chain), _sub_views(sub_views),
-	  _outcomes(outcomes),
-	  _x(nullptr), _factor(nullptr), _fixed(sub_views.size(), false), 
-	  _length_max(0), _nz_prior(0)
+	: _structure(structure), _view(structure->view()), _chain(chain),
+	  _sub_views(structure->subViews()), _outcomes(outcomes),
+	  _wk(startWorkspace()), _x(nullptr), _factor(nullptr),
+	  _fixed(_sub_views.size(), false)
     {
-	view->checkFinite(chain); //Check validity of initial values
-	
-	vector<StochasticNode *> const &schildren = 
-	    view->stochasticChildren();
-
-	vector<unsigned int> rows(schildren.size() + 1);
-	rows[0] = 0;
-	for (unsigned int i = 0; i < schildren.size(); ++i) {
-	    rows[i+1] = rows[i] + schildren[i]->length();
-	}
-	int ncol = view->length();
-	int nrow = rows[schildren.size()];
-	
-	vector<int> Xp(ncol + 1);
-	vector<int> Xi;
-    
-	int c = 0; //column counter
-	int r = 0; //count of number of non-zero entries
-
-	for (unsigned int p = 0; p < _sub_views.size(); ++p) {
-
-	    set<StochasticNode *> children_p;
-	    children_p.insert(sub_views[p]->stochasticChildren().begin(),
-			      sub_views[p]->stochasticChildren().end());
-	    vector<int> indices;
-	    getIndices(children_p, schildren, rows, indices);
-
-	    unsigned int length = _sub_views[p]->length();
-	    for (unsigned int i = 0; i < length; ++i, ++c) {
-		Xp[c] = r;
-		for (unsigned int j = 0; j < indices.size(); ++j, ++r) {
-		    Xi.push_back(indices[j]);
-		}
-	    }
-
-	    //Save these values for later calculations
-	    _nz_prior += length * length; //No. of non-zeros in prior precision
-	    if (length > _length_max) {
-		_length_max = length; //Length of longest sampled node
-	    }
-	}
-	Xp[c] = r;
+	_view->checkFinite(chain); //Check validity of initial values
 
-	//Set up sparse representation of the design matrix
-	#pragma omp critical
-	_x = cholmod_allocate_sparse(nrow, ncol, r, 1, 1, 0, CHOLMOD_REAL, glm_wk);
-	int *_xp = static_cast<int*>(_x->p);
-	int *_xi = static_cast<int*>(_x->i);
-
-	copy(Xp.begin(), Xp.end(), _xp);
-	copy(Xi.begin(), Xi.end(), _xi);
+	// The design matrix shares its non-zero pattern with the
+	// structure, but has its own numeric values.
+	cholmod_sparse const *pattern = structure->design();
+	_x = new cholmod_sparse(*pattern);
+	_x->xtype = CHOLMOD_REAL;
+	_x->x = new double[pattern->nzmax];
 
 	// At this point, all elements of _fixed are set to false, so
 	// a call to calDesign calculates the whole design matrix
@@ -182,11 +164,7 @@ namespace glm {
 	
 	// In future calls to calDesign, we do not want to recalculate
 	// fixed linear terms.
-	for (unsigned int i = 0; i < sub_views.size(); ++i) {
-	    // FIXME: For future reference, we will need to make sure this
-	    // still works correctly for log-linear models.
-	    _fixed[i] = checkLinear(sub_views[i], true, true);
-	}
+	_fixed = structure->fixed();
     }
 
     GLMMethod::~GLMMethod()
@@ -195,66 +173,16 @@ namespace glm {
 	    delete _outcomes.back();
 	    _outcomes.pop_back();
 	}
-	#pragma omp critical
-	cholmod_free_sparse(&_x, glm_wk);
+	delete [] static_cast<double*>(_x->x);
+	delete _x;
+	cholmod_free_factor(&_factor, _wk);
+	finishWorkspace(_wk);
     }
     
-    /* 
-       Symbolic analysis of the posterior precision matrix for the
-       Cholesky decomposition.
-       
-       This only needs to be done once, when the GLMMethod is
-       created. It is a stripped-down version of the code in update.
-       Note that the values of the sparse matrices are never
-       referenced.
-    */
     void GLMMethod::symbolic()  
     {
-	unsigned int nrow = _view->length();
-
-	// Prior contribution 
-	cholmod_sparse *Aprior = cholmod_allocate_sparse(nrow, nrow, _nz_prior, 1, 1, 0, CHOLMOD_PATTERN, glm_wk); 
-	int *Ap = static_cast<int*>(Aprior->p);
-	int *Ai = static_cast<int*>(Aprior->i);
-
-	int c = 0;
-	int r = 0;
-	vector<StochasticNode*> const &snodes = _view->nodes();
-	for (vector<StochasticNode*>::const_iterator p = snodes.begin();
-	     p != snodes.end(); ++p)
-	{
-	    StochasticNode *snode = *p;
-	    unsigned int length = snode->length();
-
-	    /* 
-	       Fixme: we're assuming the prior precision of each node
-	       is dense, whereas it may be sparse.
-	    */
-	    int cbase = c; //first column in this diagonal block
-	    for (unsigned int j = 0; j < length; ++j, ++c) {
-		Ap[c] = r;
-		for (unsigned int i = 0; i < length; ++i, ++r) {
-		    Ai[r] = cbase + i;
-		}
-	    }
-	}
-	Ap[c] = r;
-	
-	// Likelihood contribution
-
-	cholmod_sparse *t_x = cholmod_transpose(_x, 0, glm_wk);
-	cholmod_sort(t_x, glm_wk);
-	cholmod_sparse *Alik = cholmod_aat(t_x, nullptr, 0, 0, glm_wk);
-	cholmod_sparse *A = cholmod_add(Aprior, Alik, nullptr, nullptr, 0, 0, glm_wk);
-	
-	//Free working matrices
-	cholmod_free_sparse(&t_x, glm_wk);
-	cholmod_free_sparse(&Aprior, glm_wk);
-	cholmod_free_sparse(&Alik, glm_wk);
-	
-	A->stype = -1;
-	_factor = cholmod_analyze(A, glm_wk); 
-	cholmod_free_sparse(&A, glm_wk);
+	_factor = cholmod_copy_factor(
+	    const_cast<cholmod_factor*>(_structure->symbolic()), _wk);
     }
 
     void GLMMethod::calCoef(double *&b, cholmod_sparse *&A) 
@@ -270,10 +198,9 @@ namespace glm {
 	unsigned int nrow = _view->length();
 	b = new double[nrow];
 
-	cholmod_sparse *Aprior = nullptr;
-	#pragma omp critical
-	Aprior = cholmod_allocate_sparse(nrow, nrow, _nz_prior, 1, 1, 0,
-					 CHOLMOD_REAL, glm_wk); 
+	cholmod_sparse *Aprior = 
+	    cholmod_allocate_sparse(nrow, nrow, _structure->nzPrior(), 1, 1, 0,
+				    CHOLMOD_REAL, _wk); 
     
 	// Set up prior contributions to A, b
 	int *Ap = static_cast<int*>(Aprior->p);
@@ -324,12 +251,8 @@ namespace glm {
 	   matrix. Try this with the lsat example to see what speed-up
 	   it gives.
 	*/
-	cholmod_sparse *t_x = nullptr;
-	#pragma omp critical
-	{
-	    t_x = cholmod_transpose(_x, 1, glm_wk);
-	    cholmod_sort(t_x, glm_wk); //Needed for multivariate outcomes
-	}
+	cholmod_sparse *t_x = cholmod_transpose(_x, 1, _wk);
+	cholmod_sort(t_x, _wk); //Needed for multivariate outcomes
 	
 	int *Tp = static_cast<int*>(t_x->p);
 	int *Ti = static_cast<int*>(t_x->i);
@@ -415,17 +338,14 @@ namespace glm {
 	    c += m;
 	}
 
-	#pragma omp critical
-	{
-	    cholmod_sparse *Alik = cholmod_ssmult(t_x, _x, CHOLMOD_REAL, 1, 0,
-						  glm_wk);
-	    cholmod_free_sparse(&t_x, glm_wk);
-	    double one[2] = {1, 0};
-	    A = cholmod_add(Aprior, Alik, one, one, 1, 0, glm_wk);
+	cholmod_sparse *Alik = cholmod_ssmult(t_x, _x, CHOLMOD_REAL, 1, 0,
+					      _wk);
+	cholmod_free_sparse(&t_x, _wk);
+	double one[2] = {1, 0};
+	A = cholmod_add(Aprior, Alik, one, one, 1, 0, _wk);
 	    
-	    cholmod_free_sparse(&Aprior, glm_wk);
-	    cholmod_free_sparse(&Alik, glm_wk);
-	}
+	cholmod_free_sparse(&Aprior, _wk);
+	cholmod_free_sparse(&Alik, _wk);
     }
 
     bool GLMMethod::isAdaptive() const
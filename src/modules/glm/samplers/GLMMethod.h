@@ -19,6 +19,23 @@ namespace jags {
 namespace glm {
 
     class Outcome;
+    class GLMStructure;
+
+    /**
+     * Allocates and initializes a CHOLMOD workspace with the settings
+     * used by all sampling methods in the glm module.
+     *
+     * CHOLMOD functions that share a workspace may not be called
+     * concurrently, so each sampling method has its own.
+     *
+     * @see finishWorkspace
+     */
+    cholmod_common *startWorkspace();
+
+    /**
+     * Frees a CHOLMOD workspace allocated by startWorkspace.
+     */
+    void finishWorkspace(cholmod_common *wk);
 
     /**
      * @short Abstract class for sampling generalized linear models.
@@ -35,31 +52,39 @@ namespace glm {
      * allows us to handle both fixed and random effects in a
      * consistent way without needing to distinguish between them or
      * relying on asymptotic approximations.
+     *
+     * Each GLMMethod has its own CHOLMOD workspace, so that methods
+     * for different chains, or for conditionally independent blocks
+     * of the same chain, may be updated concurrently.
+     *
+     * The structure of the model, including the non-zero pattern of
+     * the design matrix and the symbolic Cholesky decomposition of
+     * the posterior precision, is shared by the methods for all
+     * chains through a GLMStructure object. Each GLMMethod holds only
+     * the numeric values.
      */
     class GLMMethod : public MutableSampleMethod {
     protected:
+	GLMStructure const *_structure;
 	GraphView const *_view;
 	unsigned int _chain;
 	std::vector<SingletonGraphView const *> _sub_views;
 	std::vector<Outcome *> _outcomes;
+	cholmod_common *_wk; // Workspace for CHOLMOD
 	cholmod_sparse *_x;
-	cholmod_factor *_factor; //???
+	cholmod_factor *_factor;
 	void symbolic();
 	void calDesign() const;
     private:
 	std::vector<bool> _fixed;
-	unsigned int _length_max;
-	unsigned _nz_prior;
 	friend class REMethod2;
     public:
 	/**
 	 * Constructor.
 	 *
-	 * @param view Pointer to a GraphView object for all sampled nodes.
-	 *
-	 * @param sub_views Vector of pointers to SingletonGraphView
-	 * objects with length equal to the number of sampled
-	 * nodes. Each sub-view corresponds to a single sampled node.
+	 * @param structure Pointer to the chain-independent structure
+	 * of the model, which must remain valid for the lifetime of the
+	 * GLMMethod.
 	 *
 	 * @param outcomes Vector of pointers to Outcome objects with length
 	 * equal to the number of stochastic children of the sampled nodes.
@@ -69,8 +94,7 @@ namespace glm {
 	 * @param chain Number of the chain (starting from 0) to which
 	 * the sampling method will be applied.
 	 */
-	GLMMethod(GraphView const *view, 
-		  std::vector<SingletonGraphView const *> const &sub_views,
+	GLMMethod(GLMStructure const *structure,
 		  std::vector<Outcome *> const &outcomes,
 		  unsigned int chain);
 	/**
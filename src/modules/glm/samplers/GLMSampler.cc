@@ -2,6 +2,7 @@
 
 #include "GLMSampler.h"
 #include "GLMMethod.h"
+#include "GLMStructure.h"
 
 #include <sampler/GraphView.h>
 #include <sampler/SingletonGraphView.h>
@@ -15,10 +16,11 @@ namespace glm {
 
     GLMSampler::GLMSampler(GraphView *view, 
 			   vector<SingletonGraphView*> const &sub_views,
+			   GLMStructure *structure,
 			   vector<GLMMethod*> const &methods,
 			   std::string const &name)
-	: Sampler(view), _view(view), _sub_views(sub_views), _methods(methods),
-	  _name(name)
+	: Sampler(view), _view(view), _sub_views(sub_views),
+	  _structure(structure), _methods(methods), _name(name)
     {
 	//FIXME We need a pointer _view here because the friend class
 	//REFactory2 needs access to it and cannot get it from the parent
@@ -27,14 +29,15 @@ namespace glm {
     
     GLMSampler::~GLMSampler()
     {
+	for (unsigned int ch = 0; ch < _methods.size(); ++ch) {
+	    delete _methods[ch];
+	}
+	delete _structure;
+
 	while (!_sub_views.empty()) {
 	    delete _sub_views.back();
 	    _sub_views.pop_back();
 	}
-
-	for (unsigned int ch = 0; ch < _methods.size(); ++ch) {
-	    delete _methods[ch];
-	}
     }
 
     void GLMSampler::update(unsigned int ch, RNG * rng)
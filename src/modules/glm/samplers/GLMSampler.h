@@ -14,6 +14,7 @@ namespace jags {
 namespace glm {
 
     class GLMMethod;
+    class GLMStructure;
     
     /**
      * @short Base class for GLM samplers.
@@ -22,6 +23,7 @@ namespace glm {
     {
 	GraphView const *_view;
 	std::vector<SingletonGraphView*> _sub_views;
+	GLMStructure *_structure;
 	std::vector<GLMMethod*> _methods;
 	std::string _name;
 	friend class REFactory2;
@@ -37,16 +39,21 @@ namespace glm {
 	 * The GLMSampler object takes ownership of these sub-views
 	 * and deletes them when its destructor is called.
 	 *
+	 * @param structure Structure of the GLM shared by all
+	 * sampling methods. The GLMSampler takes ownership of it.
+	 *
 	 * @param methods Vector of sampling methods
 	 */
 	GLMSampler(GraphView *view, 
 		   std::vector<SingletonGraphView*> const &sub_views,
+		   GLMStructure *structure,
 		   std::vector<GLMMethod*> const &methods,
 		   std::string const &name);
 	/**
 	 * Destructor
 	 * 
-	 * Deletes the sub-views and the methods passed to the constructor.
+	 * Deletes the sub-views, the structure and the methods passed
+	 * to the constructor.
 	 */
 	~GLMSampler() override;
 	void update(unsigned int chain, RNG *rng) override;
@@ -0,0 +1,222 @@
+#include <config.h>
+
+#include "GLMStructure.h"
+#include "GLMMethod.h"
+#include "Classify.h"
+
+#include <sampler/SingletonGraphView.h>
+#include <sampler/Linear.h>
+#include <graph/StochasticNode.h>
+
+#include <set>
+#include <algorithm>
+
+using std::vector;
+using std::set;
+using std::copy;
+
+namespace jags {
+
+static void getIndices(set<StochasticNode *> const &schildren,
+		       vector<StochasticNode *> const &allchildren,
+		       vector<unsigned int > const &allrows,
+		       vector<int> &indices)
+{
+    indices.clear();
+
+    for (unsigned int i = 0; i < allchildren.size(); ++i) {
+	if (schildren.count(allchildren[i])) {
+	    for (unsigned int j = allrows[i]; j < allrows[i+1]; ++j) {
+		indices.push_back(j);
+	    }
+	}
+    }
+}
+
+namespace glm {
+
+    GLMStructure::GLMStructure(GraphView const *view,
+			       vector<SingletonGraphView const *> const
+			       &sub_views)
+	: _view(view), _sub_views(sub_views), _wk(startWorkspace()),
+	  _x(nullptr), _factor(nullptr), _fixed(sub_views.size(), false),
+	  _analytic(sub_views.size(), false), _predictors(sub_views.size()),
+	  _length_max(0), _nz_prior(0)
+    {
+	vector<StochasticNode *> const &schildren =
+	    view->stochasticChildren();
+
+	vector<unsigned int> rows(schildren.size() + 1);
+	rows[0] = 0;
+	for (unsigned int i = 0; i < schildren.size(); ++i) {
+	    rows[i+1] = rows[i] + schildren[i]->length();
+	}
+	int ncol = view->length();
+	int nrow = rows[schildren.size()];
+
+	vector<int> Xp(ncol + 1);
+	vector<int> Xi;
+
+	int c = 0; //column counter
+	int r = 0; //count of number of non-zero entries
+
+	for (unsigned int p = 0; p < _sub_views.size(); ++p) {
+
+	    set<StochasticNode *> children_p;
+	    children_p.insert(sub_views[p]->stochasticChildren().begin(),
+			      sub_views[p]->stochasticChildren().end());
+	    vector<int> indices;
+	    getIndices(children_p, schildren, rows, indices);
+
+	    unsigned int lp_length = 0;
+	    for (unsigned int i = 0; i < schildren.size(); ++i) {
+		if (children_p.count(schildren[i])) {
+		    Node const *lp = getLinearPredictor(schildren[i]);
+		    _predictors[p].push_back(lp);
+		    lp_length += lp->length();
+		}
+	    }
+	    _analytic[p] = lp_length == indices.size() &&
+		checkLinearCoef(sub_views[p], true);
+
+	    unsigned int length = _sub_views[p]->length();
+	    for (unsigned int i = 0; i < length; ++i, ++c) {
+		Xp[c] = r;
+		for (unsigned int j = 0; j < indices.size(); ++j, ++r) {
+		    Xi.push_back(indices[j]);
+		}
+	    }
+
+	    //Save these values for later calculations
+	    _nz_prior += length * length; //No. of non-zeros in prior precision
+	    if (length > _length_max) {
+		_length_max = length; //Length of longest sampled node
+	    }
+	}
+	Xp[c] = r;
+
+	//Set up sparse representation of the design matrix
+	_x = cholmod_allocate_sparse(nrow, ncol, r, 1, 1, 0, CHOLMOD_PATTERN,
+				     _wk);
+	copy(Xp.begin(), Xp.end(), static_cast<int*>(_x->p));
+	copy(Xi.begin(), Xi.end(), static_cast<int*>(_x->i));
+
+	// Contributions to the design matrix that are fixed do not
+	// need to be recalculated at each iteration
+	for (unsigned int i = 0; i < sub_views.size(); ++i) {
+	    // FIXME: For future reference, we will need to make sure this
+	    // still works correctly for log-linear models.
+	    _fixed[i] = checkLinear(sub_views[i], true, true);
+	}
+    }
+
+    GLMStructure::~GLMStructure()
+    {
+	cholmod_free_sparse(&_x, _wk);
+	cholmod_free_factor(&_factor, _wk);
+	finishWorkspace(_wk);
+    }
+
+    /*
+       Symbolic analysis of the posterior precision matrix for the
+       Cholesky decomposition.
+
+       This only needs to be done once. It is a stripped-down version
+       of the code in GLMMethod::calCoef.  Note that the values of the
+       sparse matrices are never referenced.
+    */
+    cholmod_factor const *GLMStructure::symbolic() const
+    {
+	if (_factor) return _factor;
+
+	unsigned int nrow = _view->length();
+
+	// Prior contribution
+	cholmod_sparse *Aprior = cholmod_allocate_sparse(nrow, nrow, _nz_prior, 1, 1, 0, CHOLMOD_PATTERN, _wk);
+	int *Ap = static_cast<int*>(Aprior->p);
+	int *Ai = static_cast<int*>(Aprior->i);
+
+	int c = 0;
+	int r = 0;
+	vector<StochasticNode*> const &snodes = _view->nodes();
+	for (vector<StochasticNode*>::const_iterator p = snodes.begin();
+	     p != snodes.end(); ++p)
+	{
+	    StochasticNode *snode = *p;
+	    unsigned int length = snode->length();
+
+	    /*
+	       Fixme: we're assuming the prior precision of each node
+	       is dense, whereas it may be sparse.
+	    */
+	    int cbase = c; //first column in this diagonal block
+	    for (unsigned int j = 0; j < length; ++j, ++c) {
+		Ap[c] = r;
+		for (unsigned int i = 0; i < length; ++i, ++r) {
+		    Ai[r] = cbase + i;
+		}
+	    }
+	}
+	Ap[c] = r;
+
+	// Likelihood contribution
+
+	cholmod_sparse *t_x = cholmod_transpose(_x, 0, _wk);
+	cholmod_sort(t_x, _wk);
+	cholmod_sparse *Alik = cholmod_aat(t_x, nullptr, 0, 0, _wk);
+	cholmod_sparse *A = cholmod_add(Aprior, Alik, nullptr, nullptr, 0, 0, _wk);
+
+	//Free working matrices
+	cholmod_free_sparse(&t_x, _wk);
+	cholmod_free_sparse(&Aprior, _wk);
+	cholmod_free_sparse(&Alik, _wk);
+
+	A->stype = -1;
+	_factor = cholmod_analyze(A, _wk);
+	cholmod_free_sparse(&A, _wk);
+
+	return _factor;
+    }
+
+    GraphView const *GLMStructure::view() const
+    {
+	return _view;
+    }
+
+    vector<SingletonGraphView const *> const &GLMStructure::subViews() const
+    {
+	return _sub_views;
+    }
+
+    cholmod_sparse const *GLMStructure::design() const
+    {
+	return _x;
+    }
+
+    vector<bool> const &GLMStructure::fixed() const
+    {
+	return _fixed;
+    }
+
+    vector<bool> const &GLMStructure::analytic() const
+    {
+	return _analytic;
+    }
+
+    vector<Node const *> const &
+    GLMStructure::predictors(unsigned int i) const
+    {
+	return _predictors[i];
+    }
+
+    unsigned int GLMStructure::lengthMax() const
+    {
+	return _length_max;
+    }
+
+    unsigned int GLMStructure::nzPrior() const
+    {
+	return _nz_prior;
+    }
+
+}}
@@ -0,0 +1,120 @@
+#ifndef GLM_STRUCTURE_H_
+#define GLM_STRUCTURE_H_
+
+#include <vector>
+
+extern "C" {
+#include <cholmod.h>
+}
+
+namespace jags {
+
+    class GraphView;
+    class SingletonGraphView;
+    class Node;
+
+namespace glm {
+
+    /**
+     * @short Chain-independent structure of a generalized linear model
+     *
+     * The sparsity pattern of the design matrix, and hence of the
+     * posterior precision of the regression parameters, depends only
+     * on the graph and not on the current values of the nodes. A
+     * GLMStructure calculates this structure once so that it can be
+     * shared by the sampling methods for all chains, which then only
+     * need to hold the numeric values.
+     *
+     * The symbolic analysis of the posterior precision for the
+     * Cholesky decomposition (including the fill-reducing ordering)
+     * is calculated on demand, as it is not needed by sampling
+     * methods that do Gibbs updates.
+     *
+     * A GLMStructure is not modified after construction, except by
+     * the first call to symbolic.  Sampling methods are created
+     * sequentially, so this does not need to be thread-safe.
+     */
+    class GLMStructure {
+	GraphView const *_view;
+	std::vector<SingletonGraphView const *> _sub_views;
+	cholmod_common *_wk;
+	cholmod_sparse *_x;
+	mutable cholmod_factor *_factor;
+	std::vector<bool> _fixed;
+	std::vector<bool> _analytic;
+	std::vector<std::vector<Node const *> > _predictors;
+	unsigned int _length_max;
+	unsigned int _nz_prior;
+    public:
+	/**
+	 * Constructor.
+	 *
+	 * @param view Pointer to a GraphView object for all sampled nodes.
+	 *
+	 * @param sub_views Vector of pointers to SingletonGraphView
+	 * objects with length equal to the number of sampled
+	 * nodes. Each sub-view corresponds to a single sampled node.
+	 *
+	 * The GLMStructure does not take ownership of the views.
+	 */
+	GLMStructure(GraphView const *view,
+		     std::vector<SingletonGraphView const *> const &sub_views);
+	~GLMStructure();
+	/**
+	 * Returns the GraphView for all sampled nodes
+	 */
+	GraphView const *view() const;
+	/**
+	 * Returns the vector of SingletonGraphView objects for each
+	 * sampled node.
+	 */
+	std::vector<SingletonGraphView const *> const &subViews() const;
+	/**
+	 * Returns the non-zero pattern of the design matrix.  The
+	 * matrix has one row for each element of the stochastic
+	 * children of the view and one column for each element of the
+	 * sampled nodes. Its xtype is CHOLMOD_PATTERN.
+	 */
+	cholmod_sparse const *design() const;
+	/**
+	 * Returns the symbolic analysis of the posterior precision
+	 * matrix of the sampled nodes for the Cholesky decomposition.
+	 * Sampling methods should take a copy with cholmod_copy_factor
+	 * before calling cholmod_factorize.
+	 */
+	cholmod_factor const *symbolic() const;
+	/**
+	 * Returns a logical vector, with one element for each sampled
+	 * node, that is true if the contribution of that node to the
+	 * design matrix is fixed.
+	 */
+	std::vector<bool> const &fixed() const;
+	/**
+	 * Returns a logical vector, with one element for each sampled
+	 * node, that is true if the contribution of that node to the
+	 * design matrix can be calculated analytically by linearCoef,
+	 * instead of by perturbing the value of the node.
+	 *
+	 * @see checkLinearCoef
+	 */
+	std::vector<bool> const &analytic() const;
+	/**
+	 * Returns the linear predictors of the stochastic children of
+	 * the ith sampled node, in the same order as the non-zero rows
+	 * of the corresponding columns of the design matrix.
+	 */
+	std::vector<Node const *> const &predictors(unsigned int i) const;
+	/**
+	 * Returns the length of the longest sampled node
+	 */
+	unsigned int lengthMax() const;
+	/**
+	 * Returns the number of non-zero elements of the prior precision
+	 * matrix of the sampled nodes.
+	 */
+	unsigned int nzPrior() const;
+    };
+
+}}
+
+#endif /* GLM_STRUCTURE_H_ */
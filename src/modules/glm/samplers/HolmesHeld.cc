@@ -19,19 +19,16 @@ using std::vector;
 using std::string;
 using std::sqrt;
 
-extern cholmod_common *glm_wk;
-
-static cholmod_sparse shallow_copy(cholmod_sparse *x, unsigned int c)
+static cholmod_sparse shallow_copy(cholmod_sparse *x, unsigned int c,
+				   int *p)
 {
     //Take a copy of column c of sparse matrix x without allocating
     //any memory. This is computationally cheaper than calling
     //cholmod_submatrix, but potentially dangerous if the copy is
-    //passed to a function that tries to modify it. Note that we can
-    //only have one shallow copy in use at a time since they all share
-    //the same array of column pointers given by the static array p.
+    //passed to a function that tries to modify it. The caller
+    //supplies the array p of length 2 that holds the column pointers
+    //of the copy. 
 
-    static int p[2]; 
-    
     cholmod_sparse xcopy = *x;
 
     double *xx = static_cast<double*>(x->x);
@@ -43,7 +40,7 @@ static cholmod_sparse shallow_copy(cholmod_sparse *x, unsigned int c)
     xcopy.nzmax = nz;
     p[0] = 0;
     p[1] = nz; 
-    xcopy.p = &p;
+    xcopy.p = p;
     xcopy.i = xi + xp[c];
     xcopy.x = xx + xp[c];
 
@@ -54,11 +51,10 @@ namespace jags {
 namespace glm {
 
     
-    HolmesHeld::HolmesHeld(GraphView const *view,
-			   vector<SingletonGraphView const *> const &sub_views,
+    HolmesHeld::HolmesHeld(GLMStructure const *structure,
 			   vector<Outcome *> const &outcomes,
 			   unsigned int chain)
-	: GLMBlock(view, sub_views, outcomes, chain)
+	: GLMBlock(structure, outcomes, chain)
     {
     }
 
@@ -86,16 +82,12 @@ namespace glm {
 
 	unsigned long nrow = schildren.size();
 
-	cholmod_sparse *pt_x = nullptr;
-	#pragma omp critical
-	{
-	    //Transpose and permute the design matrix
-	    cholmod_sparse *t_x = cholmod_transpose(_x, 1, glm_wk);
-	    int *fperm = static_cast<int*>(_factor->Perm);
-	    pt_x = cholmod_submatrix(t_x, fperm, t_x->nrow,
-				     nullptr, -1, 1, 1, glm_wk);
-	    cholmod_free_sparse(&t_x, glm_wk);
-	}
+	//Transpose and permute the design matrix
+	cholmod_sparse *t_x = cholmod_transpose(_x, 1, _wk);
+	int *fperm = static_cast<int*>(_factor->Perm);
+	cholmod_sparse *pt_x = cholmod_submatrix(t_x, fperm, t_x->nrow,
+						 nullptr, -1, 1, 1, _wk);
+	cholmod_free_sparse(&t_x, _wk);
 	
 	unsigned long ncol = _x->ncol;
 	vector<double> d(ncol, 1);
@@ -114,10 +106,10 @@ namespace glm {
 	cholmod_dense *U = nullptr, *Y = nullptr, *E = nullptr;
 	cholmod_sparse *uset = nullptr;
 
-	cholmod_dense *X = nullptr;
-	#pragma omp critical
-	X = cholmod_allocate_dense(ncol, 1, ncol, CHOLMOD_REAL, glm_wk);
+	cholmod_dense *X = 
+	    cholmod_allocate_dense(ncol, 1, ncol, CHOLMOD_REAL, _wk);
 	double *Xx = static_cast<double*>(X->x);
+	int xsetp[2]; //Column pointers for shallow copy
 
 	for (unsigned long r = 0; r < nrow; ++r) {
 
@@ -133,7 +125,7 @@ namespace glm {
 	    
 	    if (_outcomes[r]->fixedb()) continue;
 
-	    cholmod_sparse xset = shallow_copy(pt_x, r);
+	    cholmod_sparse xset = shallow_copy(pt_x, r, xsetp);
 	    double *xx = static_cast<double*>(xset.x);
 	    int *xp = static_cast<int*>(xset.p);
 	    int *xi = static_cast<int*>(xset.i);
@@ -144,9 +136,8 @@ namespace glm {
 		Xx[c] = xx[j];
 	    }
 
-	    #pragma omp critical
 	    cholmod_solve2(CHOLMOD_L, _factor, X, &xset, &U, &uset, &Y, &E,
-			   glm_wk);
+			   _wk);
 
 	    double mu_r = _outcomes[r]->mean(); // See IMPORTANT NOTE above
 	    double tau_r = _outcomes[r]->precision();
@@ -188,16 +179,13 @@ namespace glm {
 	    
 	//Free workspace
 
-	#pragma omp critical
-	{
-	    cholmod_free_sparse(&pt_x, glm_wk);
-	    cholmod_free_sparse(&uset, glm_wk);
+	cholmod_free_sparse(&pt_x, _wk);
+	cholmod_free_sparse(&uset, _wk);
 	    
-	    cholmod_free_dense(&U, glm_wk);
-	    cholmod_free_dense(&Y, glm_wk);
-	    cholmod_free_dense(&E, glm_wk);
-	    cholmod_free_dense(&X, glm_wk);
-	}
+	cholmod_free_dense(&U, _wk);
+	cholmod_free_dense(&Y, _wk);
+	cholmod_free_dense(&E, _wk);
+	cholmod_free_dense(&X, _wk);
     }
     
 }}
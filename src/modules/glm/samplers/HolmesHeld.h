@@ -21,8 +21,7 @@ namespace glm {
 	 * 
 	 * @see GLMMethod#GLMMethod
 	 */
-	HolmesHeld(GraphView const *view, 
-		   std::vector<SingletonGraphView const *> const &sub_views,
+	HolmesHeld(GLMStructure const *structure,
 		   std::vector<Outcome *> const &outcomes,
 		   unsigned int chain);
 	/**
@@ -8,6 +8,7 @@
 #include "HolmesHeldFactory.h"
 #include "HolmesHeld.h"
 #include "HolmesHeldGibbs.h"
+#include "GLMStructure.h"
 
 #include <module/ModuleError.h>
 #include <sampler/SingletonGraphView.h>
@@ -31,15 +32,15 @@ namespace glm {
 
     
     GLMMethod *
-    HolmesHeldFactory::newMethod(GraphView const *view,
-			     vector<SingletonGraphView const *> const &subviews,
+    HolmesHeldFactory::newMethod(GLMStructure const *structure,
 			     unsigned int chain, bool gibbs) const
     {
 	vector<Outcome*> outcomes;
 
+	vector<StochasticNode *> const &schildren =
+	    structure->view()->stochasticChildren();
 	vector<StochasticNode *>::const_iterator p;
-	for (p = view->stochasticChildren().begin();
-	     p != view->stochasticChildren().end(); ++p)
+	for (p = schildren.begin(); p != schildren.end(); ++p)
 	{
 	    Outcome *outcome = nullptr;
 	    if (BinaryProbit::canRepresent(*p)) {
@@ -62,10 +63,10 @@ namespace glm {
 	}
 
 	if (gibbs) {
-	    return new HolmesHeldGibbs(view, subviews, outcomes, chain);
+	    return new HolmesHeldGibbs(structure, outcomes, chain);
 	}
 	else {
-	    return new HolmesHeld(view, subviews, outcomes, chain);
+	    return new HolmesHeld(structure, outcomes, chain);
 	}
 	
     }
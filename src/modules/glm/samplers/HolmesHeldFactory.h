@@ -29,8 +29,7 @@ namespace glm {
 	 * This function is called by GLMFactory#makeSampler
 	 */
 	GLMMethod *
-	    newMethod(GraphView const *view,
-		      std::vector<SingletonGraphView const *> const &sub_views,
+	    newMethod(GLMStructure const *structure,
 		      unsigned int chain, bool gibbs) const override;
     };
 
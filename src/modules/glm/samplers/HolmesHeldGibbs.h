@@ -21,8 +21,7 @@ namespace glm {
 	 * 
 	 * @see GLMMethod#GLMMethod
 	 */
-	HolmesHeldGibbs(GraphView const *view, 
-			std::vector<SingletonGraphView const *> const &sv,
+	HolmesHeldGibbs(GLMStructure const *structure,
 			std::vector<Outcome *> const &outcomes,
 			unsigned int chain);
 	/**
@@ -28,8 +28,7 @@ namespace glm {
                               std::vector<double> const &x,
                               double *b, cholmod_sparse *A);
     public:
-	IWLS(GraphView const *view, 
-	     std::vector<SingletonGraphView const *> const &sub_views,
+	IWLS(GLMStructure const *structure,
 	     std::vector<Outcome *> const &outcomes,
 	     unsigned int chain);
 	/**
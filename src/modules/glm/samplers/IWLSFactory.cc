@@ -4,6 +4,7 @@
 #include "IWLS.h"
 #include "NormalLinear.h"
 #include "IWLSOutcome.h"
+#include "GLMStructure.h"
 
 #include <graph/StochasticNode.h>
 #include <sampler/GraphView.h>
@@ -25,15 +26,16 @@ namespace glm {
     }
     
     GLMMethod *
-    IWLSFactory::newMethod(GraphView const *view,
-			   vector<SingletonGraphView const *> const &sub_views,
+    IWLSFactory::newMethod(GLMStructure const *structure,
 			   unsigned int chain, bool ) const
     {
         bool linear = true;
         vector<Outcome*> outcomes;
 
-        for (vector<StochasticNode *>::const_iterator p = view->stochasticChildren().begin();
-             p != view->stochasticChildren().end(); ++p)
+        vector<StochasticNode *> const &schildren =
+            structure->view()->stochasticChildren();
+        for (vector<StochasticNode *>::const_iterator p = schildren.begin();
+             p != schildren.end(); ++p)
         {
             Outcome *outcome = nullptr;
             if (NormalLinear::canRepresent(*p)) {
@@ -47,10 +49,10 @@ namespace glm {
         }
 
         if (linear) {
-            return new GLMBlock(view, sub_views, outcomes, chain);
+            return new GLMBlock(structure, outcomes, chain);
         }
 	
-	return new IWLS(view, sub_views, outcomes, chain);
+	return new IWLS(structure, outcomes, chain);
     }
     
     bool IWLSFactory::canSample(StochasticNode const *snode) const
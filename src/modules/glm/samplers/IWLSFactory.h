@@ -26,8 +26,7 @@ namespace glm {
 	/**
 	 * Returns a newly allocated object of class IWLS
 	 */
-	GLMMethod *newMethod(GraphView const *view, 
-			     std::vector<SingletonGraphView const *> const &sub_views,
+	GLMMethod *newMethod(GLMStructure const *structure,
 			     unsigned int chain, bool gibbs) const override;
 	/**
 	 * Returns false if any parents of the candidate node are
@@ -3,30 +3,22 @@
 
 #include <module/ModuleError.h>
 #include <graph/StochasticNode.h>
-#include <graph/LinkNode.h>
 
 namespace jags {
 namespace glm {
 
-    static Node const *getLinearPredictor(StochasticNode const *snode)
+    static Node const *checkPredictor(StochasticNode const *snode)
     {
 	if (getFamily(snode) == GLM_UNKNOWN) {
 	    throwLogicError("Invalid distribution in glm::Outcome");
 	}
-	Node const *lp = snode->parents()[0];
-	
-	LinkNode const *ln = dynamic_cast<LinkNode const*>(lp);
-	if (ln) {
-	    lp = ln->parents()[0];
-	}
-	
-	return lp;
+	return getLinearPredictor(snode);
     }
 
     Outcome::Outcome(StochasticNode const *snode, unsigned int chain)
-	: _lp(getLinearPredictor(snode)->value(chain)[0]),
+	: _lp(checkPredictor(snode)->value(chain)[0]),
 	  _length(snode->length()),
-	  _vmean(getLinearPredictor(snode)->value(chain))
+	  _vmean(checkPredictor(snode)->value(chain))
     {
     }
 
@@ -3,6 +3,7 @@
 #include "REFactory.h"
 #include "RESampler.h"
 #include "REMethod.h"
+#include "GLMStructure.h"
 
 #include "AuxMixPoisson.h"
 #include "AuxMixBinomial.h"
@@ -148,6 +149,7 @@ namespace jags {
 		sub_eps.push_back(gv);
 		const_sub_eps.push_back(gv);
 	    }
+	    GLMStructure *structure = new GLMStructure(eps, const_sub_eps);
 
 	    unsigned int Nch = nchain(tau);
 	    vector<REMethod*> methods(Nch, nullptr);
@@ -194,7 +196,7 @@ namespace jags {
 		    outcomes.push_back(outcome);
 		}
 
-		methods[ch] = newMethod(tau, eps, const_sub_eps, outcomes,ch);
+		methods[ch] = newMethod(tau, structure, outcomes, ch);
 	    }
 
 	    /* Create a single GraphView containing all sampled nodes
@@ -205,7 +207,8 @@ namespace jags {
 	    snodes.push_back(tau->node());
 	    GraphView *view = new GraphView(snodes, graph, true);
 		
-	    return new RESampler(view, tau, eps, sub_eps, methods, _name);
+	    return new RESampler(view, tau, eps, sub_eps, structure, methods,
+				 _name);
 	}
 	
 	vector<Sampler*>  
@@ -12,6 +12,7 @@ namespace jags {
 
 	class REMethod;
 	class Outcome;
+	class GLMStructure;
 	
 	/**
 	 * @short Factory for scaled precision parameters 
@@ -38,8 +39,7 @@ namespace jags {
 	    virtual bool canSample(StochasticNode *snode) const = 0;
 	    virtual REMethod *
 		newMethod(SingletonGraphView const *tau,
-			  GraphView const *eps,
-			  std::vector<SingletonGraphView const *> const & veps,
+			  GLMStructure const *eps,
 			  std::vector<Outcome*> const &outcomes,
 			  unsigned int chain) const = 0;
 		
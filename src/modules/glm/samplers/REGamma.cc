@@ -40,11 +40,10 @@ namespace jags {
 	class Outcome;
 	
 	REGamma::REGamma(SingletonGraphView const *tau,
-			 GraphView const *eps,
-			 vector<SingletonGraphView const *> const &sub_eps,
+			 GLMStructure const *eps,
 			 vector<Outcome *> const &outcomes,
 			 unsigned int chain)
-	    : REMethod(tau, eps, sub_eps, outcomes, chain),
+	    : REMethod(tau, eps, outcomes, chain),
 	      _slicer(this, SHAPE(tau, chain), RATE(tau, chain),
 		      SIGMA(tau, chain))
 	{
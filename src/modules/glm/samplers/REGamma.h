@@ -14,8 +14,7 @@ namespace jags {
 	    REGammaSlicer _slicer;
 	  public:
 	    REGamma(SingletonGraphView const *tau,
-		    GraphView const *eps, 
-		    std::vector<SingletonGraphView const *> const &veps,
+		    GLMStructure const *eps,
 		    std::vector<Outcome *> const &outcomes,
 		    unsigned int chain);
 	    void updateTau(RNG *rng) override;
@@ -25,12 +25,11 @@ namespace jags {
 	REMethod *
 	REGammaFactory::newMethod(
 	    SingletonGraphView const *tau,
-	    GraphView const *eps,
-	    vector<SingletonGraphView const *> const & sub_eps,
+	    GLMStructure const *eps,
 	    vector<Outcome *> const &outcomes,
 	    unsigned int chain) const
 	{
-	    return new REGamma(tau, eps, sub_eps, outcomes, chain);
+	    return new REGamma(tau, eps, outcomes, chain);
 	}
 
     } // namespace glm
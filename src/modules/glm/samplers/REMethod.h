@@ -27,11 +27,11 @@ namespace glm {
 	/**
 	 * Constructor.
 	 *
-	 * @param view Pointer to a GraphView object for all sampled nodes.
+	 * @param tau Pointer to a SingletonGraphView object with the
+	 * precision parameter of the random effects as the sampled node.
 	 *
-	 * @param sub_views Vector of pointers to SingletonGraphView
-	 * objects with length equal to the number of sampled
-	 * nodes. Each sub-view corresponds to a single sampled node.
+	 * @param eps Pointer to the chain-independent structure of the
+	 * GLM for the random effects.
 	 *
 	 * @param outcomes Vector of pointers to Outcome objects with length
 	 * equal to the number of stochastic children of the sampled nodes.
@@ -48,8 +48,7 @@ namespace glm {
 	 * descendants) may be link nodes.
 	 */
 	REMethod(SingletonGraphView const *tau,
-		 GraphView const *eps, 
-		 std::vector<SingletonGraphView const *> const &sub_eps,
+		 GLMStructure const *eps,
 		 std::vector<Outcome *> const &outcomes,
 		 unsigned int chain);
 	~REMethod() override;
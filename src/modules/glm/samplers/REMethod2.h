@@ -30,6 +30,7 @@ namespace glm {
 	std::vector<Outcome*> const &_outcomes;
 	cholmod_sparse const *_x;
 	const unsigned int _chain;
+	cholmod_common *_wk; // Workspace for CHOLMOD
 	cholmod_dense *_z;
 	std::vector<unsigned int> _indices;
       public:
@@ -1,5 +1,6 @@
 #include "RESampler.h"
 #include "REMethod.h"
+#include "GLMStructure.h"
 
 #include <graph/StochasticNode.h>
 #include <sampler/SingletonGraphView.h>
@@ -14,23 +15,25 @@ namespace jags {
 	RESampler::RESampler(GraphView *view,
 			     SingletonGraphView *tau, GraphView *eps,
 			     vector<SingletonGraphView*> sub_eps,
+			     GLMStructure *structure,
 			     vector<REMethod*> const &methods,
 			     string const &name)
 	    : Sampler(view), _tau(tau), _eps(eps), _sub_eps(sub_eps),
-	      _methods(methods), _name(name)
+	      _structure(structure), _methods(methods), _name(name)
 	{
 	}
 
 	RESampler::~RESampler()
 	{
+	    for (unsigned int ch = 0; ch < _methods.size(); ++ch) {
+		delete _methods[ch];
+	    }
+	    delete _structure;
 	    delete _tau;
 	    delete _eps;
 	    for (unsigned int i = 0; i < _sub_eps.size(); ++i) {
 		delete _sub_eps[i];
 	    }
-	    for (unsigned int ch = 0; ch < _methods.size(); ++ch) {
-		delete _methods[ch];
-	    }
 	}
 
 	void RESampler::update(unsigned int ch, RNG *rng)
@@ -11,6 +11,7 @@ namespace jags {
     namespace glm {
 
 	class REMethod;
+	class GLMStructure;
 
 	/**
 	 * @short Multi-level sampler for random effects and their precision 
@@ -23,6 +24,7 @@ namespace jags {
 	    SingletonGraphView *_tau;
 	    GraphView *_eps;
 	    std::vector<SingletonGraphView*> _sub_eps;
+	    GLMStructure *_structure;
 	    std::vector<REMethod*> _methods;
 	    const std::string _name;
 	  public:
@@ -43,6 +45,10 @@ namespace jags {
 	     * @param sub_eps vector of singleton views: one for each
 	     * random effect. The RESampler takes ownership.
 	     *
+	     * @param structure structure of the GLM for the random
+	     * effects, shared by all methods. The RESampler takes
+	     * ownership.
+	     *
 	     * @param methods Vector of pointers to REMethod
 	     * objects, of length equal to the number of chains.  These
 	     * must be dynamically allocated, as the
@@ -55,6 +61,7 @@ namespace jags {
 	    RESampler(GraphView *view,
 		      SingletonGraphView *tau, GraphView *eps,
 		      std::vector<SingletonGraphView*> sub_eps,
+		      GLMStructure *structure,
 		      std::vector<REMethod*> const &methods,
 		      std::string const &name);
 	    ~RESampler() override;
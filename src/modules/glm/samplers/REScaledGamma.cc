@@ -16,17 +16,14 @@
 using std::vector;
 using std::sqrt;
 
-extern cholmod_common *glm_wk;
-
 namespace jags {
     namespace glm {
 
 	REScaledGamma::REScaledGamma(SingletonGraphView const *tau,
-	    GraphView const *eps,
-	    vector<SingletonGraphView const *> const &sub_eps,
+	    GLMStructure const *eps,
 	    vector<Outcome *> const &outcomes,
 	    unsigned int chain)
-	    : REMethod(tau, eps, sub_eps, outcomes, chain)
+	    : REMethod(tau, eps, outcomes, chain)
 	{
 	    //Initialize hyper-parameter _sigma 
 	    vector<Node const*> const &par = tau->node()->parents();
@@ -13,8 +13,7 @@ namespace jags {
 	    double _sigma;
 	  public:
 	    REScaledGamma(SingletonGraphView const *tau,
-			  GraphView const *eps, 
-			  std::vector<SingletonGraphView const *> const &veps,
+			  GLMStructure const *eps,
 			  std::vector<Outcome *> const &outcomes,
 			  unsigned int chain);
 	    void updateTau(RNG *rng) override;
@@ -25,12 +25,11 @@ namespace jags {
 	REMethod *
 	REScaledGammaFactory::newMethod(
 	    SingletonGraphView const *tau,
-	    GraphView const *eps,
-	    vector<SingletonGraphView const *> const & sub_eps,
+	    GLMStructure const *eps,
 	    vector<Outcome *> const &outcomes,
 	    unsigned int chain) const
 	{
-	    return new REScaledGamma(tau, eps, sub_eps, outcomes, chain);
+	    return new REScaledGamma(tau, eps, outcomes, chain);
 	}
 
     } // namespace glm
@@ -21,12 +21,11 @@ namespace jags {
     namespace glm {
 
 	REScaledWishart::REScaledWishart(SingletonGraphView const *tau,
-	    GraphView const *eps,
-	    vector<SingletonGraphView const *> const &sub_eps,
+	    GLMStructure const *eps,
 	    vector<Outcome *> const &outcomes,
 	    unsigned int chain)
-	    : REMethod(tau, eps, sub_eps, outcomes, chain),
-	      _sigma(eps->nodes()[0]->length())
+	    : REMethod(tau, eps, outcomes, chain),
+	      _sigma(_eps->nodes()[0]->length())
 	{
 	    vector<Node const*> const &par = tau->node()->parents();
 	    double const *S = par[0]->value(chain); //Prior scale
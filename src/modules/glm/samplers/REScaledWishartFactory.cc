@@ -31,12 +31,11 @@ namespace jags {
 	REMethod *
 	REScaledWishartFactory::newMethod(
 	    SingletonGraphView const *tau,
-	    GraphView const *eps,
-	    vector<SingletonGraphView const *> const & sub_eps,
+	    GLMStructure const *eps,
 	    vector<Outcome *> const &outcomes,
 	    unsigned int chain) const
 	{
-	    return new REScaledWishart(tau, eps, sub_eps, outcomes, chain);
+	    return new REScaledWishart(tau, eps, outcomes, chain);
 	}
 
     } // namespace glm
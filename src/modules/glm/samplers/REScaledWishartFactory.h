@@ -18,8 +18,7 @@ namespace jags {
 	    ~REScaledWishartFactory() override;
 	    bool canSample(StochasticNode *snode) const override;
 	    REMethod * newMethod(SingletonGraphView const *tau,
-				 GraphView const *eps,
-				 std::vector<SingletonGraphView const *> const & veps,
+				 GLMStructure const *eps,
 				 std::vector<Outcome*> const &outcomes,
 				 unsigned int chain) const override;
 	};
@@ -0,0 +1,203 @@
+/*
+  Benchmark for running glm samplers for several chains in parallel.
+
+  Builds the logistic regression
+
+  beta ~ dmnorm(m0, T0)
+  eta[i] <- inprod(X[i,], beta)
+  y[i] ~ dbern(ilogit(eta[i]))
+
+  with N observations and P coefficients, and updates beta with the
+  sampler from GLMGenericFactory. As in Model::update, the chains run
+  in a single OpenMP parallel region with one thread for each chain.
+  The benchmark is repeated for 1, 2, 4, ... chains up to the given
+  maximum.
+
+  Each sampling method has its own CHOLMOD workspace, so with one
+  core per chain the time per iteration should not grow with the
+  number of chains, and the throughput, in chain-iterations per
+  second, should grow in proportion to it. The checksum depends only
+  on the seeds.
+
+  Usage: glmbench [N [P [maxchain [niter]]]]
+*/
+
+#include <config.h>
+
+#include "GLMGenericFactory.h"
+#include <DMNorm.h>
+#include <DBern.h>
+#include <ILogit.h>
+#include <InProd.h>
+#include <MersenneTwisterRNG.h>
+
+#include <graph/Graph.h>
+#include <graph/ConstantNode.h>
+#include <graph/ScalarStochasticNode.h>
+#include <graph/ArrayStochasticNode.h>
+#include <graph/VectorLogicalNode.h>
+#include <graph/LinkNode.h>
+#include <sampler/Sampler.h>
+
+#include <iostream>
+#include <vector>
+#include <list>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using std::vector;
+using std::list;
+using std::cout;
+using std::endl;
+using std::atoi;
+using std::exp;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+using namespace jags;
+
+static void run(unsigned int N, unsigned int P, unsigned int nchain,
+		unsigned int niter, double &single)
+{
+    bugs::DMNorm dmnorm;
+    bugs::DBern dbern;
+    bugs::ILogit ilogit;
+    bugs::InProd inprod;
+    base::MersenneTwisterRNG gen(99, KINDERMAN_RAMAGE);
+
+    Graph graph;
+    vector<Node*> nodes;
+
+    vector<unsigned long> dP(1, P), dPP(2, P);
+    vector<double> prec(P * P, 0);
+    for (unsigned int j = 0; j < P; ++j) {
+	prec[j * P + j] = 1.0E-2;
+    }
+    ConstantNode *m0 = new ConstantNode(dP, vector<double>(P, 0), nchain,
+					true);
+    ConstantNode *T0 = new ConstantNode(dPP, prec, nchain, true);
+    nodes.push_back(m0);
+    nodes.push_back(T0);
+
+    vector<Node const*> bpar = {m0, T0};
+    ArrayStochasticNode *beta = new ArrayStochasticNode(&dmnorm, nchain, bpar);
+    vector<double> b0(P, 0);
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	beta->setValue(b0.data(), P, ch);
+    }
+    nodes.push_back(beta);
+    graph.insert(beta);
+
+    vector<double> btrue(P);
+    for (unsigned int j = 0; j < P; ++j) {
+	btrue[j] = 0.5 * gen.normal();
+    }
+    for (unsigned int i = 0; i < N; ++i) {
+	vector<double> x(P);
+	x[0] = 1;
+	double eta = btrue[0];
+	for (unsigned int j = 1; j < P; ++j) {
+	    x[j] = gen.normal();
+	    eta += x[j] * btrue[j];
+	}
+	ConstantNode *Xi = new ConstantNode(dP, x, nchain, true);
+	nodes.push_back(Xi);
+	vector<Node const*> epar = {Xi, beta};
+	VectorLogicalNode *e = new VectorLogicalNode(&inprod, nchain, epar);
+	nodes.push_back(e);
+	graph.insert(e);
+	vector<Node const*> ppar(1, e);
+	LinkNode *p = new LinkNode(&ilogit, nchain, ppar);
+	nodes.push_back(p);
+	graph.insert(p);
+	vector<Node const*> ypar(1, p);
+	ScalarStochasticNode *yi =
+	    new ScalarStochasticNode(&dbern, nchain, ypar, nullptr, nullptr);
+	double y = gen.uniform() < 1 / (1 + exp(-eta));
+	yi->setData(&y, 1);
+	nodes.push_back(yi);
+	graph.insert(yi);
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    e->deterministicSample(ch);
+	    p->deterministicSample(ch);
+	}
+    }
+
+    glm::GLMGenericFactory factory;
+    list<StochasticNode*> free_nodes(1, beta);
+    vector<Sampler*> samplers = factory.makeSamplers(free_nodes, graph);
+    vector<RNG*> rngs;
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	rngs.push_back(new base::MersenneTwisterRNG(1000 + ch,
+						    KINDERMAN_RAMAGE));
+    }
+
+    steady_clock::time_point t0 = steady_clock::now();
+    #pragma omp parallel num_threads(nchain)
+    {
+	unsigned int thread = 0, nthread = 1;
+#ifdef _OPENMP
+	thread = omp_get_thread_num();
+	nthread = omp_get_num_threads();
+#endif
+	for (unsigned int iter = 0; iter < niter; ++iter) {
+	    for (unsigned int n = thread; n < nchain; n += nthread) {
+		for (Sampler *s : samplers) {
+		    s->update(n, rngs[n]);
+		}
+	    }
+            #pragma omp barrier
+	}
+    }
+    double t = duration<double>(steady_clock::now() - t0).count();
+
+    double checksum = 0;
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	for (unsigned int j = 0; j < P; ++j) {
+	    checksum += beta->value(ch)[j] * (j + 1);
+	}
+    }
+    double throughput = nchain * niter / t;
+    if (nchain == 1) {
+	single = throughput;
+    }
+    cout << nchain << " chains: " << t / niter << " s/iteration, "
+	 << throughput << " chain-iterations/s (" << throughput / single
+	 << "x), checksum " << checksum << endl;
+
+    for (RNG *rng : rngs) {
+	delete rng;
+    }
+    for (Sampler *s : samplers) {
+	delete s;
+    }
+    for (unsigned int i = nodes.size(); i > 0; --i) {
+	delete nodes[i-1];
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int N = argc > 1 ? atoi(argv[1]) : 50000;
+    unsigned int P = argc > 2 ? atoi(argv[2]) : 10;
+    unsigned int maxchain = argc > 3 ? atoi(argv[3]) : 8;
+    unsigned int niter = argc > 4 ? atoi(argv[4]) : 10;
+
+    unsigned int nproc = 1;
+#ifdef _OPENMP
+    nproc = omp_get_num_procs();
+#endif
+    cout.precision(6);
+    cout << N << " observations, " << P << " coefficients, " << niter
+	 << " iterations, " << nproc << " processors" << endl;
+    double single = 0;
+    for (unsigned int nchain = 1; nchain <= maxchain; nchain *= 2) {
+	run(N, P, nchain, niter, single);
+    }
+    return 0;
+}
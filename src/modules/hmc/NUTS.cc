@@ -0,0 +1,486 @@
+#include <config.h>
+
+#include "NUTS.h"
+
+#include <sampler/GraphView.h>
+#include <graph/StochasticNode.h>
+#include <module/ModuleError.h>
+#include <rng/RNG.h>
+#include <util/nainf.h>
+
+#include <cmath>
+#include <algorithm>
+
+using std::vector;
+using std::exp;
+using std::log;
+using std::log1p;
+using std::sqrt;
+using std::pow;
+using std::fabs;
+using std::isfinite;
+using std::isnan;
+using std::fill;
+
+//Target value of the mean acceptance statistic
+#define TARGET 0.8
+//Parameters of the dual averaging algorithm for the step size
+#define GAMMA 0.05
+#define T0 10
+#define KAPPA 0.75
+//Iterations before the first estimate of the mass matrix
+#define INIT_BUFFER 75
+//Length of the first window for estimating the mass matrix
+#define BASE_WINDOW 25
+//Maximum number of doublings of the trajectory
+#define MAX_DEPTH 10
+//Energy error that signals a divergent trajectory
+#define MAX_DELTA_H 1000
+//Minimum number of adaptive iterations before checkAdaptation succeeds
+#define MIN_ADAPT 100
+
+namespace jags {
+namespace hmc {
+
+    static double logSumExp(double a, double b)
+    {
+	if (a == JAGS_NEGINF) return b;
+	if (b == JAGS_NEGINF) return a;
+	return a > b ? a + log1p(exp(b - a)) : b + log1p(exp(a - b));
+    }
+
+    static bool criterion(vector<double> const &p_sharp_minus,
+			  vector<double> const &p_sharp_plus,
+			  vector<double> const &rho)
+    {
+	//Generalized no-U-turn criterion
+	double plus = 0, minus = 0;
+	for (unsigned int i = 0; i < rho.size(); ++i) {
+	    plus += p_sharp_plus[i] * rho[i];
+	    minus += p_sharp_minus[i] * rho[i];
+	}
+	return plus > 0 && minus > 0;
+    }
+
+    static vector<double> add(vector<double> const &x,
+			      vector<double> const &y)
+    {
+	vector<double> z(x);
+	for (unsigned int i = 0; i < z.size(); ++i) {
+	    z[i] += y[i];
+	}
+	return z;
+    }
+
+    NUTS::State::State(unsigned int length)
+	: q(length), p(length), grad(length), logp(0)
+    {
+    }
+
+    NUTS::NUTS(GraphView const *gv, unsigned int chain)
+	: _gv(gv), _chain(chain), _length(gv->length()),
+	  _invmass(_length, 1.0), _epsilon(0), _adapt(true),
+	  _mu(0), _hbar(0), _logeps_bar(0), _nstep(0), _stat_sum(0),
+	  _iter(0), _window_end(INIT_BUFFER + BASE_WINDOW),
+	  _window_size(BASE_WINDOW), _nwindow(0), _wn(0),
+	  _wmean(_length, 0), _wm2(_length, 0)
+    {
+	for (unsigned int i = 0; i < gv->nodes().size(); ++i) {
+	    if (!canSample(gv->nodes()[i])) {
+		throwLogicError("Invalid NUTS");
+	    }
+	}
+	if (!canSample(gv)) {
+	    throwLogicError("Invalid NUTS");
+	}
+	gv->checkFinite(chain);
+    }
+
+    bool NUTS::canSample(StochasticNode const *node)
+    {
+	if (node->isDiscreteValued() || !node->fullRank())
+	    return false;
+
+	if (isBounded(node) || !isSupportFixed(node))
+	    return false;
+
+	//Support must be the whole real line
+	unsigned long N = node->length();
+	vector<double> lower(N), upper(N);
+	node->support(&lower[0], &upper[0], N, 0);
+	for (unsigned long i = 0; i < N; ++i) {
+	    if (isfinite(lower[i]) || isfinite(upper[i]))
+		return false;
+	}
+	return true;
+    }
+
+    bool NUTS::canSample(GraphView const *gv)
+    {
+	return gv->hasGradient();
+    }
+
+    double NUTS::logDensity() const
+    {
+	/*
+	   We calculate the log full conditional directly, instead of
+	   calling GraphView#logFullConditional, so that invalid
+	   values reached by a trajectory are treated as points of
+	   zero density instead of errors. The full density of the
+	   sampled nodes is used since they may depend on each other.
+	*/
+	double lp = 0;
+	vector<StochasticNode*> const &snodes = _gv->nodes();
+	for (unsigned int i = 0; i < snodes.size(); ++i) {
+	    lp += snodes[i]->logDensity(_chain, PDF_FULL);
+	}
+	vector<StochasticNode*> const &schild = _gv->stochasticChildren();
+	for (unsigned int i = 0; i < schild.size(); ++i) {
+	    lp += schild[i]->logDensity(_chain, PDF_LIKELIHOOD);
+	}
+	return isnan(lp) ? JAGS_NEGINF : lp;
+    }
+
+    void NUTS::evaluate(State &z) const
+    {
+	_gv->setValue(z.q, _chain);
+	z.logp = logDensity();
+	if (isfinite(z.logp)) {
+	    _gv->logFullConditionalGradient(_chain, &z.grad[0]);
+	}
+	else {
+	    fill(z.grad.begin(), z.grad.end(), 0);
+	}
+    }
+
+    void NUTS::leapfrog(State &z, double epsilon) const
+    {
+	for (unsigned int i = 0; i < _length; ++i) {
+	    z.p[i] += 0.5 * epsilon * z.grad[i];
+	}
+	for (unsigned int i = 0; i < _length; ++i) {
+	    z.q[i] += epsilon * _invmass[i] * z.p[i];
+	}
+	evaluate(z);
+	for (unsigned int i = 0; i < _length; ++i) {
+	    z.p[i] += 0.5 * epsilon * z.grad[i];
+	}
+    }
+
+    double NUTS::hamiltonian(State const &z) const
+    {
+	double K = 0;
+	for (unsigned int i = 0; i < _length; ++i) {
+	    K += _invmass[i] * z.p[i] * z.p[i];
+	}
+	double H = K/2 - z.logp;
+	return isnan(H) ? JAGS_POSINF : H;
+    }
+
+    void NUTS::sampleMomentum(State &z, RNG *rng) const
+    {
+	for (unsigned int i = 0; i < _length; ++i) {
+	    z.p[i] = rng->normal() / sqrt(_invmass[i]);
+	}
+    }
+
+    void NUTS::initStepSize(State const &z0, RNG *rng)
+    {
+	/*
+	   Heuristic for the initial step size: keep doubling or
+	   halving the step size until the acceptance probability of
+	   a single leapfrog step crosses the target value.
+	*/
+	if (_epsilon <= 0) _epsilon = 1;
+
+	State z(z0);
+	sampleMomentum(z, rng);
+	double H0 = hamiltonian(z);
+	leapfrog(z, _epsilon);
+	double delta_H = H0 - hamiltonian(z);
+	int direction = delta_H > log(TARGET) ? 1 : -1;
+
+	for (;;) {
+	    z = z0;
+	    sampleMomentum(z, rng);
+	    H0 = hamiltonian(z);
+	    leapfrog(z, _epsilon);
+	    delta_H = H0 - hamiltonian(z);
+	    if (direction == 1 && !(delta_H > log(TARGET)))
+		break;
+	    else if (direction == -1 && !(delta_H < log(TARGET)))
+		break;
+	    _epsilon = direction == 1 ? 2 * _epsilon : _epsilon / 2;
+	    if (_epsilon > 1.0E7) {
+		throwNodeError(_gv->nodes()[0],
+			       "Posterior is improper in NUTS sampler");
+	    }
+	    if (_epsilon == 0) {
+		throwNodeError(_gv->nodes()[0],
+			       "Step size vanished in NUTS sampler");
+	    }
+	}
+	_gv->setValue(z0.q, _chain);
+    }
+
+    bool NUTS::buildTree(unsigned int depth, State &z, State &z_propose,
+			 vector<double> &p_sharp_beg,
+			 vector<double> &p_sharp_end,
+			 vector<double> &rho,
+			 vector<double> &p_beg, vector<double> &p_end,
+			 double H0, double sign, unsigned int &n_leapfrog,
+			 double &log_sum_weight, double &sum_metro_prob,
+			 RNG *rng) const
+    {
+	if (depth == 0) {
+	    //Base case: a single leapfrog step
+	    leapfrog(z, sign * _epsilon);
+	    ++n_leapfrog;
+	    double H = hamiltonian(z);
+	    log_sum_weight = logSumExp(log_sum_weight, H0 - H);
+	    sum_metro_prob += H0 - H > 0 ? 1 : exp(H0 - H);
+	    z_propose = z;
+	    for (unsigned int i = 0; i < _length; ++i) {
+		p_sharp_beg[i] = _invmass[i] * z.p[i];
+		rho[i] += z.p[i];
+	    }
+	    p_sharp_end = p_sharp_beg;
+	    p_beg = z.p;
+	    p_end = p_beg;
+	    return H - H0 <= MAX_DELTA_H;
+	}
+
+	//Build the initial subtree
+	double log_sum_weight_init = JAGS_NEGINF;
+	vector<double> p_init_end(_length), p_sharp_init_end(_length);
+	vector<double> rho_init(_length, 0);
+	bool valid_init = buildTree(depth - 1, z, z_propose, p_sharp_beg,
+				    p_sharp_init_end, rho_init, p_beg,
+				    p_init_end, H0, sign, n_leapfrog,
+				    log_sum_weight_init, sum_metro_prob, rng);
+	if (!valid_init) return false;
+
+	//Build the final subtree
+	State z_propose_final(z);
+	double log_sum_weight_final = JAGS_NEGINF;
+	vector<double> p_final_beg(_length), p_sharp_final_beg(_length);
+	vector<double> rho_final(_length, 0);
+	bool valid_final = buildTree(depth - 1, z, z_propose_final,
+				     p_sharp_final_beg, p_sharp_end,
+				     rho_final, p_final_beg, p_end, H0, sign,
+				     n_leapfrog, log_sum_weight_final,
+				     sum_metro_prob, rng);
+	if (!valid_final) return false;
+
+	//Multinomial sample from the right subtree
+	double log_sum_weight_subtree =
+	    logSumExp(log_sum_weight_init, log_sum_weight_final);
+	log_sum_weight = logSumExp(log_sum_weight, log_sum_weight_subtree);
+	if (log_sum_weight_final > log_sum_weight_subtree) {
+	    z_propose = z_propose_final;
+	}
+	else {
+	    double accept_prob =
+		exp(log_sum_weight_final - log_sum_weight_subtree);
+	    if (rng->uniform() < accept_prob) {
+		z_propose = z_propose_final;
+	    }
+	}
+
+	vector<double> rho_subtree = add(rho_init, rho_final);
+	for (unsigned int i = 0; i < _length; ++i) {
+	    rho[i] += rho_subtree[i];
+	}
+
+	//Check the criterion across the merged subtree, and also
+	//between the two subtrees
+	return criterion(p_sharp_beg, p_sharp_end, rho_subtree) &&
+	    criterion(p_sharp_beg, p_sharp_final_beg,
+		      add(rho_init, p_final_beg)) &&
+	    criterion(p_sharp_init_end, p_sharp_end,
+		      add(rho_final, p_init_end));
+    }
+
+    double NUTS::transition(State &z, RNG *rng) const
+    {
+	sampleMomentum(z, rng);
+	double H0 = hamiltonian(z);
+
+	State z_fwd(z), z_bck(z), z_sample(z), z_propose(z);
+
+	vector<double> p_sharp(_length);
+	for (unsigned int i = 0; i < _length; ++i) {
+	    p_sharp[i] = _invmass[i] * z.p[i];
+	}
+	vector<double> p_sharp_fwd_bck(p_sharp), p_sharp_fwd_fwd(p_sharp);
+	vector<double> p_sharp_bck_fwd(p_sharp), p_sharp_bck_bck(p_sharp);
+	vector<double> p_fwd_bck(z.p), p_fwd_fwd(z.p);
+	vector<double> p_bck_fwd(z.p), p_bck_bck(z.p);
+	vector<double> rho(z.p);
+
+	double log_sum_weight = 0; // log(exp(H0 - H0))
+	unsigned int n_leapfrog = 0;
+	double sum_metro_prob = 0;
+
+	for (unsigned int depth = 0; depth < MAX_DEPTH; ++depth) {
+	    vector<double> rho_fwd(_length, 0), rho_bck(_length, 0);
+	    double log_sum_weight_subtree = JAGS_NEGINF;
+	    bool valid_subtree;
+
+	    if (rng->uniform() > 0.5) {
+		//Extend the trajectory forward
+		rho_bck = rho;
+		p_bck_fwd = p_fwd_bck;
+		p_sharp_bck_fwd = p_sharp_fwd_bck;
+		valid_subtree = buildTree(depth, z_fwd, z_propose,
+					  p_sharp_fwd_bck, p_sharp_fwd_fwd,
+					  rho_fwd, p_fwd_bck, p_fwd_fwd, H0, 1,
+					  n_leapfrog, log_sum_weight_subtree,
+					  sum_metro_prob, rng);
+	    }
+	    else {
+		//Extend the trajectory backward
+		rho_fwd = rho;
+		p_fwd_bck = p_bck_fwd;
+		p_sharp_fwd_bck = p_sharp_bck_fwd;
+		valid_subtree = buildTree(depth, z_bck, z_propose,
+					  p_sharp_bck_fwd, p_sharp_bck_bck,
+					  rho_bck, p_bck_fwd, p_bck_bck, H0, -1,
+					  n_leapfrog, log_sum_weight_subtree,
+					  sum_metro_prob, rng);
+	    }
+
+	    if (!valid_subtree) break;
+
+	    //Sample from the new subtree
+	    if (log_sum_weight_subtree > log_sum_weight) {
+		z_sample = z_propose;
+	    }
+	    else {
+		double accept_prob = exp(log_sum_weight_subtree - log_sum_weight);
+		if (rng->uniform() < accept_prob) {
+		    z_sample = z_propose;
+		}
+	    }
+	    log_sum_weight = logSumExp(log_sum_weight, log_sum_weight_subtree);
+
+	    //Stop when the no-U-turn criterion is violated
+	    rho = add(rho_bck, rho_fwd);
+	    bool persist =
+		criterion(p_sharp_bck_bck, p_sharp_fwd_fwd, rho) &&
+		criterion(p_sharp_bck_bck, p_sharp_fwd_bck,
+			  add(rho_bck, p_fwd_bck)) &&
+		criterion(p_sharp_bck_fwd, p_sharp_fwd_fwd,
+			  add(rho_fwd, p_bck_fwd));
+	    if (!persist) break;
+	}
+
+	z = z_sample;
+	_gv->setValue(z.q, _chain);
+
+	return n_leapfrog > 0 ? sum_metro_prob / n_leapfrog : 0;
+    }
+
+    void NUTS::adaptStepSize(double stat)
+    {
+	//Dual averaging (Nesterov, 2009; Hoffman and Gelman, 2014)
+	if (stat > 1) stat = 1;
+	++_nstep;
+	_stat_sum += stat;
+
+	double eta = 1.0 / (_nstep + T0);
+	_hbar = (1 - eta) * _hbar + eta * (TARGET - stat);
+	double x = _mu - _hbar * sqrt(static_cast<double>(_nstep)) / GAMMA;
+	double x_eta = pow(static_cast<double>(_nstep), -KAPPA);
+	_logeps_bar = x_eta * x + (1 - x_eta) * _logeps_bar;
+	_epsilon = exp(x);
+    }
+
+    void NUTS::adaptMass(State const &z, RNG *rng)
+    {
+	++_iter;
+	if (_iter <= INIT_BUFFER) return;
+
+	//Welford's algorithm for the running variance
+	++_wn;
+	for (unsigned int i = 0; i < _length; ++i) {
+	    double delta = z.q[i] - _wmean[i];
+	    _wmean[i] += delta / _wn;
+	    _wm2[i] += delta * (z.q[i] - _wmean[i]);
+	}
+
+	if (_iter == _window_end) {
+	    //Regularized estimate of the variance, shrunk towards 1.0E-3
+	    double n = _wn;
+	    for (unsigned int i = 0; i < _length; ++i) {
+		double var = _wm2[i] / (n - 1);
+		_invmass[i] = (n / (n + 5)) * var + 1.0E-3 * (5 / (n + 5));
+	    }
+	    fill(_wmean.begin(), _wmean.end(), 0);
+	    fill(_wm2.begin(), _wm2.end(), 0);
+	    _wn = 0;
+	    _window_size *= 2;
+	    _window_end += _window_size;
+	    ++_nwindow;
+
+	    //Restart the step size adaptation for the new mass matrix
+	    initStepSize(z, rng);
+	    _mu = log(10 * _epsilon);
+	    _hbar = 0;
+	    _logeps_bar = 0;
+	    _nstep = 0;
+	    _stat_sum = 0;
+	}
+    }
+
+    void NUTS::update(RNG *rng)
+    {
+	State z(_length);
+	_gv->getValue(z.q, _chain);
+	evaluate(z);
+	if (!isfinite(z.logp)) {
+	    throwNodeError(_gv->nodes()[0],
+			   "Current value is inconsistent with data");
+	}
+
+	if (_epsilon <= 0) {
+	    initStepSize(z, rng);
+	    _mu = log(10 * _epsilon);
+	}
+
+	double stat = transition(z, rng);
+
+	if (_adapt) {
+	    adaptStepSize(stat);
+	    adaptMass(z, rng);
+	}
+    }
+
+    bool NUTS::isAdaptive() const
+    {
+	return true;
+    }
+
+    void NUTS::adaptOff()
+    {
+	if (_nstep > 0) {
+	    _epsilon = exp(_logeps_bar);
+	}
+	_adapt = false;
+    }
+
+    bool NUTS::checkAdaptation() const
+    {
+	if (_iter < MIN_ADAPT || _nwindow == 0 || _nstep == 0)
+	    return false;
+
+	//Mean acceptance statistic must be close to the target on
+	//the logit scale
+	double mean = _stat_sum / _nstep;
+	if (mean <= 0 || mean >= 1)
+	    return false;
+	double ldiff = log(mean / (1 - mean)) - log(TARGET / (1 - TARGET));
+	return fabs(ldiff) < 1;
+    }
+
+}}
@@ -0,0 +1,113 @@
+#ifndef NUTS_H_
+#define NUTS_H_
+
+#include <sampler/MutableSampleMethod.h>
+
+#include <vector>
+
+namespace jags {
+
+class GraphView;
+class StochasticNode;
+
+namespace hmc {
+
+/**
+ * @short No-U-Turn sampler
+ *
+ * Updates a block of unbounded, continuous stochastic nodes jointly
+ * using the No-U-Turn variant of Hamiltonian Monte Carlo (Hoffman
+ * and Gelman, 2014) with multinomial sampling from the trajectory
+ * and a diagonal mass matrix.
+ *
+ * The gradient of the log full conditional density is calculated
+ * by GraphView#logFullConditionalGradient.
+ *
+ * In adaptive mode, the step size is tuned by dual averaging so that
+ * the mean acceptance statistic reaches a target value, and the
+ * diagonal of the inverse mass matrix is estimated from the sample
+ * variance of the chain over a sequence of windows of increasing
+ * length.
+ */
+    class NUTS : public MutableSampleMethod
+    {
+	/* Point in phase space */
+	struct State {
+	    std::vector<double> q;
+	    std::vector<double> p;
+	    std::vector<double> grad;
+	    double logp;
+	    State(unsigned int length);
+	};
+	GraphView const *_gv;
+	const unsigned int _chain;
+	const unsigned int _length;
+	std::vector<double> _invmass;
+	double _epsilon;
+	bool _adapt;
+	// Dual averaging of the step size
+	double _mu;
+	double _hbar;
+	double _logeps_bar;
+	unsigned int _nstep;
+	double _stat_sum;
+	// Windowed estimation of the mass matrix
+	unsigned int _iter;
+	unsigned int _window_end;
+	unsigned int _window_size;
+	unsigned int _nwindow;
+	unsigned int _wn;
+	std::vector<double> _wmean;
+	std::vector<double> _wm2;
+
+	double logDensity() const;
+	void evaluate(State &z) const;
+	void leapfrog(State &z, double epsilon) const;
+	double hamiltonian(State const &z) const;
+	void sampleMomentum(State &z, RNG *rng) const;
+	void initStepSize(State const &z, RNG *rng);
+	bool buildTree(unsigned int depth, State &z, State &z_propose,
+		       std::vector<double> &p_sharp_beg,
+		       std::vector<double> &p_sharp_end,
+		       std::vector<double> &rho,
+		       std::vector<double> &p_beg,
+		       std::vector<double> &p_end,
+		       double H0, double sign, unsigned int &n_leapfrog,
+		       double &log_sum_weight, double &sum_metro_prob,
+		       RNG *rng) const;
+	double transition(State &z, RNG *rng) const;
+	void adaptStepSize(double stat);
+	void adaptMass(State const &z, RNG *rng);
+    public:
+	/**
+	 * Constructor.
+	 *
+	 * @param gv GraphView containing the nodes to sample. All
+	 * sampled nodes must satisfy canSample, and the GraphView
+	 * must be differentiable.
+	 *
+	 * @param chain Index number of chain to sample (starting from zero)
+	 */
+	NUTS(GraphView const *gv, unsigned int chain);
+	void update(RNG *rng) override;
+	bool isAdaptive() const override;
+	void adaptOff() override;
+	bool checkAdaptation() const override;
+	/**
+	 * Returns true if the node is continuous, fully unobserved,
+	 * and its support is the whole real line.
+	 */
+	static bool canSample(StochasticNode const *node);
+	/**
+	 * Returns true if the log full conditional density of the
+	 * GraphView can be differentiated with respect to the values
+	 * of the sampled nodes.
+	 *
+	 * @see GraphView#hasGradient
+	 */
+	static bool canSample(GraphView const *gv);
+    };
+
+}}
+
+#endif /* NUTS_H_ */
@@ -0,0 +1,118 @@
+#include <config.h>
+
+#include "NUTSFactory.h"
+#include "NUTS.h"
+
+#include <sampler/MutableSampler.h>
+#include <sampler/GraphView.h>
+#include <sampler/SingletonGraphView.h>
+#include <graph/StochasticNode.h>
+
+#include <map>
+
+using std::vector;
+using std::list;
+using std::map;
+using std::string;
+
+namespace jags {
+namespace hmc {
+
+    static unsigned int findRoot(vector<unsigned int> &root, unsigned int i)
+    {
+	while (root[i] != i) {
+	    root[i] = root[root[i]];
+	    i = root[i];
+	}
+	return i;
+    }
+
+    static void join(vector<unsigned int> &root, unsigned int i,
+		     unsigned int j)
+    {
+	i = findRoot(root, i);
+	j = findRoot(root, j);
+	if (i < j) root[j] = i;
+	else if (j < i) root[i] = j;
+    }
+
+    vector<Sampler*> 
+    NUTSFactory::makeSamplers(list<StochasticNode*> const &nodes,
+			      Graph const &graph) const
+    {
+	//Find candidate nodes, and record their stochastic children
+	vector<StochasticNode*> candidates;
+	vector<vector<StochasticNode*> > children;
+	for (list<StochasticNode*>::const_iterator p = nodes.begin();
+	     p != nodes.end(); ++p)
+	{
+	    if (!NUTS::canSample(*p)) continue;
+	    SingletonGraphView gv(*p, graph);
+	    if (!NUTS::canSample(&gv)) continue;
+	    candidates.push_back(*p);
+	    children.push_back(gv.stochasticChildren());
+	}
+
+	vector<Sampler*> samplers;
+	if (candidates.empty()) return samplers;
+
+	/* 
+	   Join candidates into blocks. Two candidates belong to the
+	   same block if they share a stochastic child or if one is a
+	   stochastic child of the other.
+	*/
+	unsigned int N = candidates.size();
+	map<StochasticNode const*, unsigned int> index;
+	for (unsigned int i = 0; i < N; ++i) {
+	    index[candidates[i]] = i;
+	}
+	vector<unsigned int> root(N);
+	for (unsigned int i = 0; i < N; ++i) {
+	    root[i] = i;
+	}
+	map<StochasticNode const*, unsigned int> owner;
+	for (unsigned int i = 0; i < N; ++i) {
+	    for (unsigned int j = 0; j < children[i].size(); ++j) {
+		StochasticNode const *child = children[i][j];
+		map<StochasticNode const*, unsigned int>::const_iterator q;
+		if ((q = index.find(child)) != index.end()) {
+		    join(root, i, q->second);
+		}
+		else if ((q = owner.find(child)) != owner.end()) {
+		    join(root, i, q->second);
+		}
+		else {
+		    owner[child] = i;
+		}
+	    }
+	}
+
+	//Create one sampler per block
+	vector<vector<StochasticNode*> > blocks(N);
+	for (unsigned int i = 0; i < N; ++i) {
+	    blocks[findRoot(root, i)].push_back(candidates[i]);
+	}
+	for (unsigned int i = 0; i < N; ++i) {
+	    if (blocks[i].empty()) continue;
+	    GraphView *gv = new GraphView(blocks[i], graph, true);
+	    if (!NUTS::canSample(gv)) {
+		delete gv;
+		continue;
+	    }
+	    unsigned int nchain = gv->nodes()[0]->nchain();
+	    vector<MutableSampleMethod*> methods(nchain, nullptr);
+	    for (unsigned int ch = 0; ch < nchain; ++ch) {
+		methods[ch] = new NUTS(gv, ch);
+	    }
+	    samplers.push_back(new MutableSampler(gv, methods, "hmc::NUTS"));
+	}
+
+	return samplers;
+    }
+
+    string NUTSFactory::name() const
+    {
+	return "hmc::NUTS";
+    }
+
+}}
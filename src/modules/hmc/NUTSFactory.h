@@ -0,0 +1,31 @@
+#ifndef NUTS_FACTORY_H_
+#define NUTS_FACTORY_H_
+
+#include <sampler/SamplerFactory.h>
+
+namespace jags {
+namespace hmc {
+
+/**
+ * @short Factory object for No-U-Turn samplers
+ *
+ * The NUTSFactory collects all unbounded, continuous stochastic
+ * nodes that can be sampled by the NUTS method and joins them into
+ * blocks. Two nodes are placed in the same block if they share a
+ * stochastic child, or if one is a stochastic child of the
+ * other. Each block is then updated jointly by a single sampler.
+ *
+ * @see NUTS
+ */
+    class NUTSFactory : public SamplerFactory
+    {
+    public:
+	std::vector<Sampler*>
+	    makeSamplers(std::list<StochasticNode*> const &nodes,
+			 Graph const &graph) const override;
+	std::string name() const override;
+    };
+
+}}
+
+#endif /* NUTS_FACTORY_H_ */
@@ -0,0 +1,226 @@
+/*
+  Benchmark for GraphView::logFullConditionalGradient.
+
+  Builds the varying-intercept regression
+
+  beta[j] ~ dnorm(0, 0.01)
+  mu[1:N] <- beta[group]
+  eta[1:N] <- mu[1:N] * x[1:N]
+  y[i] ~ dnorm(eta[i], 1)
+
+  with N observations in J groups, and samples beta[1:J] jointly, as
+  the NUTS sampler does. The aggregate node mu has one column in its
+  Jacobian for each group, and the Jacobian of eta with respect to
+  mu is diagonal.
+
+  The reverse-mode gradient is compared with central differences of
+  the log full conditional, and both are timed. For comparison, the
+  benchmark also times the propagation of adjoints through dense
+  Jacobian matrices, which was the previous implementation, when N
+  is small enough for the N x N matrix to fit in memory.
+
+  Usage: gradbench [N [J [niter]]]
+*/
+
+#include <config.h>
+
+#include <DNorm.h>
+#include <Multiply.h>
+#include <MersenneTwisterRNG.h>
+
+#include <graph/Graph.h>
+#include <graph/ConstantNode.h>
+#include <graph/ScalarStochasticNode.h>
+#include <graph/AggNode.h>
+#include <graph/VSLogicalNode.h>
+#include <sampler/GraphView.h>
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+using std::vector;
+using std::cout;
+using std::endl;
+using std::atoi;
+using std::fabs;
+using std::max;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+using namespace jags;
+
+static double since(steady_clock::time_point t0)
+{
+    return duration<double>(steady_clock::now() - t0).count();
+}
+
+/* Central differences of the log full conditional */
+static vector<double> numGradient(GraphView const &gv, double delta)
+{
+    unsigned int n = gv.length();
+    vector<double> x(n), grad(n);
+    gv.getValue(x, 0);
+    for (unsigned int i = 0; i < n; ++i) {
+	double xi = x[i];
+	x[i] = xi + delta;
+	gv.setValue(x, 0);
+	double lp1 = gv.logFullConditional(0);
+	x[i] = xi - delta;
+	gv.setValue(x, 0);
+	double lp0 = gv.logFullConditional(0);
+	x[i] = xi;
+	grad[i] = (lp1 - lp0) / (2 * delta);
+    }
+    gv.setValue(x, 0);
+    return grad;
+}
+
+/*
+   Propagation of the adjoints through dense Jacobian matrices. The
+   adjoints of the stochastic children are the same as in the
+   reverse-mode calculation, so only this step is timed.
+*/
+static void denseProduct(vector<DeterministicNode*> const &dnodes,
+			 vector<double> const &adj, vector<double> &padj,
+			 vector<double> &work)
+{
+    for (unsigned int i = dnodes.size(); i > 0; --i) {
+	DeterministicNode const *dnode = dnodes[i-1];
+	vector<Node const*> const &par = dnode->parents();
+	for (unsigned int k = 0; k < par.size(); ++k) {
+	    if (!dnode->hasGradient(par[k])) continue;
+	    unsigned long plen = par[k]->length();
+	    if (work.size() < dnode->length() * plen) {
+		work.resize(dnode->length() * plen);
+	    }
+	    if (padj.size() < plen) {
+		padj.resize(plen);
+	    }
+	    dnode->DeterministicNode::gradientProduct(&padj[0], &adj[0],
+						      par[k], 0, &work[0]);
+	}
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int N = argc > 1 ? atoi(argv[1]) : 2000;
+    unsigned int J = argc > 2 ? atoi(argv[2]) : 20;
+    unsigned int niter = argc > 3 ? atoi(argv[3]) : 1000;
+
+    cout << N << " observations, " << J << " groups, "
+	 << niter << " iterations" << endl;
+
+    bugs::DNorm dnorm;
+    base::Multiply multiply;
+    base::MersenneTwisterRNG rng(1234, KINDERMAN_RAMAGE);
+
+    Graph graph;
+    vector<Node*> nodes;
+
+    ConstantNode *zero = new ConstantNode(0.0, 1, true);
+    ConstantNode *prec = new ConstantNode(0.01, 1, true);
+    ConstantNode *one = new ConstantNode(1.0, 1, true);
+    nodes.push_back(zero);
+    nodes.push_back(prec);
+    nodes.push_back(one);
+
+    vector<StochasticNode*> beta(J);
+    for (unsigned int j = 0; j < J; ++j) {
+	vector<Node const*> bpar = {zero, prec};
+	beta[j] = new ScalarStochasticNode(&dnorm, 1, bpar, nullptr, nullptr);
+	double b = rng.normal();
+	beta[j]->setValue(&b, 1, 0);
+	nodes.push_back(beta[j]);
+	graph.insert(beta[j]);
+    }
+
+    vector<unsigned long> dN(1, N);
+    vector<Node const*> mpar(N);
+    vector<double> x(N);
+    for (unsigned int i = 0; i < N; ++i) {
+	mpar[i] = beta[i % J];
+	x[i] = rng.normal();
+    }
+    AggNode *mu = new AggNode(dN, 1, mpar, vector<unsigned long>(N, 0));
+    nodes.push_back(mu);
+    graph.insert(mu);
+    ConstantNode *X = new ConstantNode(dN, x, 1, true);
+    nodes.push_back(X);
+    vector<Node const*> epar = {mu, X};
+    VSLogicalNode *eta = new VSLogicalNode(&multiply, 1, epar);
+    nodes.push_back(eta);
+    graph.insert(eta);
+    mu->deterministicSample(0);
+    eta->deterministicSample(0);
+
+    for (unsigned int i = 0; i < N; ++i) {
+	vector<Node const*> eipar(1, eta);
+	AggNode *etai = new AggNode(vector<unsigned long>(1, 1), 1, eipar,
+				    vector<unsigned long>(1, i));
+	nodes.push_back(etai);
+	graph.insert(etai);
+	vector<Node const*> ypar = {etai, one};
+	ScalarStochasticNode *yi =
+	    new ScalarStochasticNode(&dnorm, 1, ypar, nullptr, nullptr);
+	double y = eta->value(0)[i] + rng.normal();
+	yi->setData(&y, 1);
+	nodes.push_back(yi);
+	graph.insert(yi);
+    }
+
+    GraphView gv(beta, graph, true);
+    if (!gv.hasGradient()) {
+	cout << "No gradient available" << endl;
+	return 1;
+    }
+
+    //Accuracy
+    vector<double> grad(J);
+    gv.logFullConditionalGradient(0, &grad[0]);
+    vector<double> numgrad = numGradient(gv, 1.0E-5);
+    double maxerr = 0;
+    for (unsigned int j = 0; j < J; ++j) {
+	double err = fabs(grad[j] - numgrad[j]) / max(fabs(numgrad[j]), 1.0);
+	maxerr = max(maxerr, err);
+    }
+    cout << "Maximum relative difference from central differences: "
+	 << maxerr << endl;
+
+    //Speed
+    steady_clock::time_point t0 = steady_clock::now();
+    for (unsigned int it = 0; it < niter; ++it) {
+	gv.logFullConditionalGradient(0, &grad[0]);
+    }
+    double t = since(t0);
+    cout << "Reverse mode: " << niter / t << " gradients/sec" << endl;
+
+    unsigned int nnum = max(niter / J, 1U);
+    t0 = steady_clock::now();
+    for (unsigned int it = 0; it < nnum; ++it) {
+	numgrad = numGradient(gv, 1.0E-5);
+    }
+    t = since(t0);
+    cout << "Central differences: " << nnum / t << " gradients/sec" << endl;
+
+    if (N <= 5000) {
+	vector<double> adj(N, 1.0), padj, work;
+	unsigned int ndense = max(niter / 100, 1U);
+	t0 = steady_clock::now();
+	for (unsigned int it = 0; it < ndense; ++it) {
+	    denseProduct(gv.deterministicChildren(), adj, padj, work);
+	}
+	t = since(t0);
+	cout << "Dense Jacobians (previous implementation), propagation only: "
+	     << ndense / t << " gradients/sec" << endl;
+    }
+
+    for (unsigned int i = nodes.size(); i > 0; --i) {
+	delete nodes[i-1];
+    }
+    return 0;
+}
@@ -0,0 +1,32 @@
+#include <module/Module.h>
+#include <NUTSFactory.h>
+
+using std::vector;
+
+namespace jags {
+namespace hmc {
+
+    class HMCModule : public Module {
+
+    public:
+	HMCModule();
+	~HMCModule() override;
+    };
+
+    HMCModule::HMCModule() 
+	: Module("hmc") 
+    {
+	insert(new NUTSFactory);
+    }
+    
+    HMCModule::~HMCModule() {
+	
+	vector<SamplerFactory*> const &svec = samplerFactories();
+	for (unsigned int i = 0; i < svec.size(); ++i) {
+	    delete svec[i];
+	}
+    }
+    
+}}
+
+jags::hmc::HMCModule _hmc_module;
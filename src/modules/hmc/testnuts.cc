@@ -0,0 +1,449 @@
+#include "testnuts.h"
+
+#include "NUTS.h"
+#include "NUTSFactory.h"
+
+#include <DNorm.h>
+#include <DGamma.h>
+#include <DPois.h>
+#include <Multiply.h>
+#include <MersenneTwisterRNG.h>
+
+#include <graph/Graph.h>
+#include <graph/ConstantNode.h>
+#include <graph/ScalarStochasticNode.h>
+#include <graph/MixtureNode.h>
+#include <graph/VSLogicalNode.h>
+#include <graph/AggNode.h>
+#include <sampler/GraphView.h>
+#include <sampler/Sampler.h>
+
+#include <vector>
+#include <list>
+#include <cmath>
+#include <algorithm>
+
+using std::vector;
+using std::list;
+using std::sqrt;
+using std::fill;
+
+using jags::Node;
+using jags::Graph;
+using jags::ConstantNode;
+using jags::StochasticNode;
+using jags::ScalarStochasticNode;
+using jags::MixtureNode;
+using jags::MixMap;
+using jags::VSLogicalNode;
+using jags::AggNode;
+using jags::DeterministicNode;
+using jags::GraphView;
+using jags::Sampler;
+using jags::hmc::NUTS;
+using jags::hmc::NUTSFactory;
+using jags::base::MersenneTwisterRNG;
+
+void NUTSTest::setUp()
+{
+    _dnorm = new jags::bugs::DNorm;
+    _dgamma = new jags::bugs::DGamma;
+    _dpois = new jags::bugs::DPois;
+    _multiply = new jags::base::Multiply;
+}
+
+void NUTSTest::tearDown()
+{
+    delete _dnorm;
+    delete _dgamma;
+    delete _dpois;
+    delete _multiply;
+}
+
+static void freeNodes(vector<Node*> &nodes)
+{
+    //Delete in reverse order of creation so children go first
+    for (unsigned int i = nodes.size(); i > 0; --i) {
+	delete nodes[i-1];
+    }
+    nodes.clear();
+}
+
+static ScalarStochasticNode *
+addStoch(jags::RScalarDist const *dist, Node const *par1, Node const *par2,
+	 Graph &graph, vector<Node*> &nodes)
+{
+    vector<Node const*> par = {par1, par2};
+    ScalarStochasticNode *snode =
+	new ScalarStochasticNode(dist, 1, par, nullptr, nullptr);
+    nodes.push_back(snode);
+    graph.insert(snode);
+    return snode;
+}
+
+void NUTSTest::can_sample()
+{
+    /*
+      Only nodes with support on the whole real line can be sampled,
+      and only if the log full conditional is differentiable:
+
+      mu ~ dnorm(0, 1)
+      tau ~ dgamma(1, 1)
+      n ~ dpois(1)
+      y ~ dnorm(mu, 1) T(0,)
+    */
+    Graph graph;
+    vector<Node*> nodes;
+
+    ConstantNode *zero = new ConstantNode(0.0, 1, true);
+    ConstantNode *one = new ConstantNode(1.0, 1, true);
+    nodes.push_back(zero);
+    nodes.push_back(one);
+
+    ScalarStochasticNode *mu = addStoch(_dnorm, zero, one, graph, nodes);
+    ScalarStochasticNode *tau = addStoch(_dgamma, one, one, graph, nodes);
+    vector<Node const*> npar = {one};
+    ScalarStochasticNode *n =
+	new ScalarStochasticNode(_dpois, 1, npar, nullptr, nullptr);
+    nodes.push_back(n);
+    graph.insert(n);
+
+    CPPUNIT_ASSERT(NUTS::canSample(mu));
+    CPPUNIT_ASSERT(!NUTS::canSample(tau));
+    CPPUNIT_ASSERT(!NUTS::canSample(n));
+
+    vector<StochasticNode*> snodes(1, mu);
+    GraphView gv1(snodes, graph);
+    CPPUNIT_ASSERT(NUTS::canSample(&gv1));
+
+    vector<Node const*> ypar = {mu, one};
+    ScalarStochasticNode *y =
+	new ScalarStochasticNode(_dnorm, 1, ypar, zero, nullptr);
+    double yval = 1.0;
+    y->setData(&yval, 1);
+    nodes.push_back(y);
+    graph.insert(y);
+
+    GraphView gv2(snodes, graph);
+    CPPUNIT_ASSERT(!NUTS::canSample(&gv2));
+
+    freeNodes(nodes);
+}
+
+void NUTSTest::blocks()
+{
+    /*
+      Nodes are sampled in the same block if they share a stochastic
+      child or if one is the stochastic child of the other:
+
+      mu ~ dnorm(0, 0.01)
+      theta[j] ~ dnorm(mu, 1)
+      y[j] ~ dnorm(theta[j], 1)
+      a ~ dnorm(0, 1)
+      b ~ dnorm(0, 1)
+      z ~ dnorm(a * b, 1)
+      c ~ dnorm(0, 1)
+      tau ~ dgamma(1, 1)
+      w ~ dnorm(0, tau)
+
+      The blocks are {mu, theta[1:3]}, {a, b} and {c}. The node tau
+      cannot be sampled.
+    */
+    Graph graph;
+    vector<Node*> nodes;
+
+    ConstantNode *zero = new ConstantNode(0.0, 1, true);
+    ConstantNode *one = new ConstantNode(1.0, 1, true);
+    ConstantNode *prec = new ConstantNode(0.01, 1, true);
+    nodes.push_back(zero);
+    nodes.push_back(one);
+    nodes.push_back(prec);
+
+    list<StochasticNode*> candidates;
+    ScalarStochasticNode *mu = addStoch(_dnorm, zero, prec, graph, nodes);
+    candidates.push_back(mu);
+    for (unsigned int j = 0; j < 3; ++j) {
+	ScalarStochasticNode *theta =
+	    addStoch(_dnorm, mu, one, graph, nodes);
+	candidates.push_back(theta);
+	ScalarStochasticNode *y = addStoch(_dnorm, theta, one, graph, nodes);
+	double yval = j;
+	y->setData(&yval, 1);
+    }
+
+    ScalarStochasticNode *a = addStoch(_dnorm, zero, one, graph, nodes);
+    ScalarStochasticNode *b = addStoch(_dnorm, zero, one, graph, nodes);
+    candidates.push_back(a);
+    candidates.push_back(b);
+    vector<Node const*> abpar = {a, b};
+    VSLogicalNode *ab = new VSLogicalNode(_multiply, 1, abpar);
+    nodes.push_back(ab);
+    graph.insert(ab);
+    ScalarStochasticNode *z = addStoch(_dnorm, ab, one, graph, nodes);
+    double zval = 0.5;
+    z->setData(&zval, 1);
+
+    ScalarStochasticNode *c = addStoch(_dnorm, zero, one, graph, nodes);
+    candidates.push_back(c);
+
+    ScalarStochasticNode *tau = addStoch(_dgamma, one, one, graph, nodes);
+    candidates.push_back(tau);
+    ScalarStochasticNode *w = addStoch(_dnorm, zero, tau, graph, nodes);
+    double wval = 0.1;
+    w->setData(&wval, 1);
+
+    //Set initial values
+    for (StochasticNode *snode : candidates) {
+	double v = 1;
+	snode->setValue(&v, 1, 0);
+    }
+    ab->deterministicSample(0);
+
+    NUTSFactory factory;
+    vector<Sampler*> samplers = factory.makeSamplers(candidates, graph);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), samplers.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), samplers[0]->nodes().size());
+    CPPUNIT_ASSERT(samplers[0]->nodes()[0] == mu);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), samplers[1]->nodes().size());
+    CPPUNIT_ASSERT(samplers[1]->nodes()[0] == a);
+    CPPUNIT_ASSERT(samplers[1]->nodes()[1] == b);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), samplers[2]->nodes().size());
+    CPPUNIT_ASSERT(samplers[2]->nodes()[0] == c);
+
+    for (unsigned int i = 0; i < samplers.size(); ++i) {
+	delete samplers[i];
+    }
+    freeNodes(nodes);
+}
+
+void NUTSTest::mixture_jacobian()
+{
+    /*
+      The Jacobian of a mixture node with respect to its active
+      parent is the identity matrix, and zero for the other parents:
+
+      i ~ dpois(1)
+      x <- c(X1, X2)[i]
+    */
+    vector<unsigned long> d2(1, 2);
+    double x1[2] = {1.5, -2}, x2[2] = {3, 0.25};
+    ConstantNode X1(d2, vector<double>(x1, x1 + 2), 1, true);
+    ConstantNode X2(d2, vector<double>(x2, x2 + 2), 1, true);
+    ConstantNode one(1.0, 1, true);
+    vector<Node const*> ipar(1, &one);
+    ScalarStochasticNode index(_dpois, 1, ipar, nullptr, nullptr);
+    double i = 2;
+    index.setValue(&i, 1, 0);
+
+    MixMap mixmap;
+    mixmap[vector<unsigned long>(1, 1)] = &X1;
+    mixmap[vector<unsigned long>(1, 2)] = &X2;
+    MixtureNode x(vector<Node const*>(1, &index), 1, mixmap);
+    x.deterministicSample(0);
+    CPPUNIT_ASSERT_EQUAL(x2[1], x.value(0)[1]);
+
+    CPPUNIT_ASSERT(!x.hasGradient(&index));
+    CPPUNIT_ASSERT(x.hasGradient(&X1));
+
+    vector<double> grad(4, 0);
+    x.gradient(&grad[0], &X2, 0);
+    CPPUNIT_ASSERT_EQUAL(1.0, grad[0]);
+    CPPUNIT_ASSERT_EQUAL(0.0, grad[1]);
+    CPPUNIT_ASSERT_EQUAL(0.0, grad[2]);
+    CPPUNIT_ASSERT_EQUAL(1.0, grad[3]);
+
+    fill(grad.begin(), grad.end(), 0);
+    x.gradient(&grad[0], &X1, 0);
+    for (unsigned int i = 0; i < 4; ++i) {
+	CPPUNIT_ASSERT_EQUAL(0.0, grad[i]);
+    }
+}
+
+void NUTSTest::vslogical_jacobian()
+{
+    /*
+      The Jacobian of a vectorized scalar function is diagonal with
+      respect to a vector argument, and a single column with respect
+      to a scalar argument:
+
+      y <- x * s
+    */
+    vector<unsigned long> d3(1, 3);
+    double xv[3] = {1.5, -2, 0.5};
+    double sv = 3;
+    ConstantNode x(d3, vector<double>(xv, xv + 3), 1, true);
+    ConstantNode s(sv, 1, true);
+    vector<Node const*> par = {&x, &s};
+    VSLogicalNode y(_multiply, 1, par);
+    y.deterministicSample(0);
+
+    vector<double> gx(9, 0);
+    y.gradient(&gx[0], &x, 0);
+    for (unsigned int p = 0; p < 3; ++p) {
+	for (unsigned int q = 0; q < 3; ++q) {
+	    CPPUNIT_ASSERT_EQUAL(p == q ? sv : 0.0, gx[p + 3 * q]);
+	}
+    }
+
+    vector<double> gs(3, 0);
+    y.gradient(&gs[0], &s, 0);
+    for (unsigned int p = 0; p < 3; ++p) {
+	CPPUNIT_ASSERT_EQUAL(xv[p], gs[p]);
+    }
+}
+
+static void checkProduct(DeterministicNode const &node, Node const *parent)
+{
+    //Compare a sparse gradient product with the dense Jacobian
+    unsigned long len = node.length(), plen = parent->length();
+    vector<double> adj(len);
+    for (unsigned long l = 0; l < len; ++l) {
+	adj[l] = 0.5 + l;
+    }
+    vector<double> padj(plen, 1), dense(plen, 1);
+    vector<double> work(node.gradientWorkLength(parent) + 1);
+    node.gradientProduct(&padj[0], &adj[0], parent, 0, &work[0]);
+    vector<double> J(len * plen);
+    node.DeterministicNode::gradientProduct(&dense[0], &adj[0], parent, 0,
+					    &J[0]);
+    for (unsigned long q = 0; q < plen; ++q) {
+	CPPUNIT_ASSERT_EQUAL(dense[q], padj[q]);
+    }
+}
+
+void NUTSTest::gradient_product()
+{
+    /*
+      Aggregate nodes, mixture nodes and vectorized scalar functions
+      propagate adjoints without forming their Jacobians, and need
+      no work space:
+
+      b[1:4] <- c(X[1], X[3], X[1], Z)
+      v <- X[c(1, 3, 5)]
+      y <- X * s
+      w <- X * X
+      m <- c(X, W)[i]
+    */
+    vector<unsigned long> d5(1, 5);
+    double xv[5] = {1.5, -2, 0.5, 4, -1};
+    double wv[5] = {0, 1, 2, 3, 4};
+    ConstantNode X(d5, vector<double>(xv, xv + 5), 1, true);
+    ConstantNode W(d5, vector<double>(wv, wv + 5), 1, true);
+    ConstantNode Z(2.0, 1, true);
+    ConstantNode s(3.0, 1, true);
+
+    vector<Node const*> bpar = {&X, &X, &X, &Z};
+    unsigned long boff[4] = {0, 2, 0, 0};
+    AggNode b(vector<unsigned long>(1, 4), 1, bpar,
+	      vector<unsigned long>(boff, boff + 4));
+    CPPUNIT_ASSERT_EQUAL(0UL, b.gradientWorkLength(&X));
+    checkProduct(b, &X);
+    checkProduct(b, &Z);
+
+    vector<Node const*> vpar(3, &X);
+    unsigned long voff[3] = {0, 2, 4};
+    AggNode v(vector<unsigned long>(1, 3), 1, vpar,
+	      vector<unsigned long>(voff, voff + 3));
+    checkProduct(v, &X);
+
+    vector<Node const*> ypar = {&X, &s};
+    VSLogicalNode y(_multiply, 1, ypar);
+    CPPUNIT_ASSERT_EQUAL(0UL, y.gradientWorkLength(&X));
+    checkProduct(y, &X);
+    checkProduct(y, &s);
+
+    //A parent that appears twice contributes once for each argument
+    vector<Node const*> wpar = {&X, &X};
+    VSLogicalNode w(_multiply, 1, wpar);
+    checkProduct(w, &X);
+    vector<double> gw(5, 0), aw(5, 1);
+    w.gradientProduct(&gw[0], &aw[0], &X, 0, nullptr);
+    for (unsigned int l = 0; l < 5; ++l) {
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2 * xv[l], gw[l], tol);
+    }
+
+    ConstantNode one(1.0, 1, true);
+    vector<Node const*> ipar(1, &one);
+    ScalarStochasticNode index(_dpois, 1, ipar, nullptr, nullptr);
+    double i = 1;
+    index.setValue(&i, 1, 0);
+    MixMap mixmap;
+    mixmap[vector<unsigned long>(1, 1)] = &X;
+    mixmap[vector<unsigned long>(1, 2)] = &W;
+    MixtureNode m(vector<Node const*>(1, &index), 1, mixmap);
+    m.deterministicSample(0);
+    CPPUNIT_ASSERT_EQUAL(0UL, m.gradientWorkLength(&X));
+    checkProduct(m, &X);
+    checkProduct(m, &W);
+}
+
+void NUTSTest::normal_target()
+{
+    /*
+      Bivariate normal posterior:
+
+      mu ~ dnorm(0, 0.01)
+      theta ~ dnorm(mu, 1)
+      y ~ dnorm(theta, 4)
+
+      The posterior precision of (mu, theta) is Q = [1.01, -1; -1, 5]
+      and the posterior mean is Q^{-1} (0, 4y).
+    */
+    Graph graph;
+    vector<Node*> nodes;
+
+    ConstantNode *zero = new ConstantNode(0.0, 1, true);
+    ConstantNode *one = new ConstantNode(1.0, 1, true);
+    ConstantNode *four = new ConstantNode(4.0, 1, true);
+    ConstantNode *prec = new ConstantNode(0.01, 1, true);
+    nodes.push_back(zero);
+    nodes.push_back(one);
+    nodes.push_back(four);
+    nodes.push_back(prec);
+
+    ScalarStochasticNode *mu = addStoch(_dnorm, zero, prec, graph, nodes);
+    ScalarStochasticNode *theta = addStoch(_dnorm, mu, one, graph, nodes);
+    ScalarStochasticNode *y = addStoch(_dnorm, theta, four, graph, nodes);
+    double yval = 1.5;
+    y->setData(&yval, 1);
+    double init = 0;
+    mu->setValue(&init, 1, 0);
+    theta->setValue(&init, 1, 0);
+
+    double det = 1.01 * 5 - 1;
+    double mean[2] = {4 * yval / det, 1.01 * 4 * yval / det};
+    double var[2] = {5 / det, 1.01 / det};
+
+    vector<StochasticNode*> snodes = {mu, theta};
+    GraphView gv(snodes, graph, true);
+    NUTS method(&gv, 0);
+    MersenneTwisterRNG rng(2718, jags::KINDERMAN_RAMAGE);
+
+    for (unsigned int t = 0; t < 1000; ++t) {
+	method.update(&rng);
+    }
+    CPPUNIT_ASSERT(method.checkAdaptation());
+    method.adaptOff();
+
+    unsigned int const N = 5000;
+    double sum[2] = {0, 0}, sumsq[2] = {0, 0};
+    vector<double> x(2);
+    for (unsigned int t = 0; t < N; ++t) {
+	method.update(&rng);
+	gv.getValue(x, 0);
+	for (unsigned int i = 0; i < 2; ++i) {
+	    sum[i] += x[i];
+	    sumsq[i] += x[i] * x[i];
+	}
+    }
+
+    //Tolerances are about four standard errors for N independent draws
+    for (unsigned int i = 0; i < 2; ++i) {
+	double m = sum[i] / N;
+	double v = sumsq[i] / N - m * m;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(mean[i], m, 4 * sqrt(var[i] / N));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(var[i], v, 4 * var[i] * sqrt(2.0 / N));
+    }
+
+    freeNodes(nodes);
+}
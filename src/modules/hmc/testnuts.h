@@ -0,0 +1,39 @@
+#ifndef NUTS_TEST_H_
+#define NUTS_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <testlib.h>
+
+namespace jags {
+    class RScalarDist;
+    class ScalarFunction;
+}
+
+class NUTSTest : public CppUnit::TestFixture, public JAGSFixture
+{
+    CPPUNIT_TEST_SUITE( NUTSTest );
+    CPPUNIT_TEST( can_sample );
+    CPPUNIT_TEST( blocks );
+    CPPUNIT_TEST( mixture_jacobian );
+    CPPUNIT_TEST( vslogical_jacobian );
+    CPPUNIT_TEST( gradient_product );
+    CPPUNIT_TEST( normal_target );
+    CPPUNIT_TEST_SUITE_END();
+
+    jags::RScalarDist *_dnorm;
+    jags::RScalarDist *_dgamma;
+    jags::RScalarDist *_dpois;
+    jags::ScalarFunction *_multiply;
+
+public:
+    void setUp();
+    void tearDown();
+    void can_sample();
+    void blocks();
+    void mixture_jacobian();
+    void vslogical_jacobian();
+    void gradient_product();
+    void normal_target();
+};
+
+#endif /* NUTS_TEST_H_ */
@@ -1,5 +1,6 @@
 #include <config.h>
 #include "DBetaBin.h"
+#include <util/nainf.h>
 
 #include <algorithm>
 
@@ -14,6 +15,7 @@ using std::string;
 #define A(par) (*par[0])
 #define B(par) (*par[1])
 #define SIZE(par) (*par[2])
+#define R_D_nonint(x)     (fabs((x) - floor((x)+0.5)) > 1e-7)
 
 static inline double dbb(double x, double a, double b, double n)
 {
@@ -128,4 +130,19 @@ bool DBetaBin::isSupportFixed(vector<bool> const &fixmask) const
    return fixmask[2]; //SIZE is fixed;
 } 
 
+bool DBetaBin::isNormalizationFixed(vector<bool> const &fixmask) const
+{
+    return fixmask[2];
+}
+
+double DBetaBin::logKernel(double x, vector<double const *> const &par) const
+{
+    //Log density without the binomial coefficient
+    double n = SIZE(par);
+    if (x < 0 || x > n || R_D_nonint(x)) {
+	return JAGS_NEGINF;
+    }
+    return lbeta(x + A(par), n - x + B(par)) - lbeta(A(par), B(par));
+}
+
 }}
@@ -36,6 +36,13 @@ class DBetaBin : public RScalarDist {
    */
   bool checkParameterValue(std::vector<double const *> const &parameters) const override;
   bool isSupportFixed(std::vector<bool> const &fixmask) const override;
+  /**
+   * The binomial coefficient is fixed when n is fixed
+   */
+  bool isNormalizationFixed(std::vector<bool> const &fixmask)
+      const override;
+  double logKernel(double x, std::vector<double const *> const &parameters)
+      const override;
 };
 
 }}
@@ -4,6 +4,7 @@
 #include "DNormMix.h"
 
 #include <MersenneTwisterRNG.h>
+#include <util/nainf.h>
 #include <JRmath.h>
 
 #include <cmath>
@@ -387,3 +388,38 @@ void MixDistTest::normmix()
     test_mean_normmix(par2, len2, N);
     test_var_normmix(par2, len2, N);
 }
+
+void MixDistTest::kernel()
+{
+    /*
+       For fixed n, the full log density of the beta-binomial
+       distribution and the log kernel differ by lchoose(n, x)
+    */
+    vector<bool> fixmask = {false, false, true};
+    CPPUNIT_ASSERT(_dbetabin->isNormalizationFixed(fixmask));
+    fixmask[2] = false;
+    CPPUNIT_ASSERT(!_dbetabin->isNormalizationFixed(fixmask));
+
+    vector<double> avals = {0.1, 1, 2.5};
+    vector<double> bvals = {0.5, 1, 7};
+    vector<double> nvals = {0, 1, 8, 30};
+    for (double a : avals) {
+	for (double b : bvals) {
+	    for (double n : nvals) {
+		vector<double const *> par = mkPar(a, b, n);
+		for (double x = -1; x <= n + 1; ++x) {
+		    double full = _dbetabin->logDensity(x, PDF_FULL, par,
+							0, 0);
+		    double y = _dbetabin->logKernel(x, par);
+		    if (x < 0 || x > n) {
+			CPPUNIT_ASSERT_EQUAL(JAGS_NEGINF, y);
+		    }
+		    else {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(full, y + lchoose(n, x),
+						     tol * max(1.0, abs(full)));
+		    }
+		}
+	    }
+	}
+    }
+}
@@ -22,6 +22,7 @@ class MixDistTest : public CppUnit::TestFixture, public JAGSFixture
     CPPUNIT_TEST( rscalar );
     CPPUNIT_TEST( dkw );
     CPPUNIT_TEST( normmix );
+    CPPUNIT_TEST( kernel );
     CPPUNIT_TEST_SUITE_END(  );
 
     jags::RNG *_rng;
@@ -56,6 +57,8 @@ class MixDistTest : public CppUnit::TestFixture, public JAGSFixture
     void dkw();
 
     void normmix();
+
+    void kernel();
 };
 
 #endif /* MIX_DIST_TEST_H */
@@ -6,6 +6,8 @@
 #include <samplers/MixSamplerFactory.h>
 #include <samplers/DirichletCatFactory.h>
 #include <samplers/LDAFactory.h>
+#include <samplers/AliasLDAFactory.h>
+#include <samplers/ParallelLDAFactory.h>
 
 using std::vector;
 
@@ -27,6 +29,9 @@ namespace mix {
 	
 	insert(new MixSamplerFactory);
 	insert(new DirichletCatFactory);
+	//Inserted first, so that mix::LDA has priority
+	insert(new ParallelLDAFactory);
+	insert(new AliasLDAFactory);
 	insert(new LDAFactory);
     }
 
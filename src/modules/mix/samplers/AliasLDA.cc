@@ -0,0 +1,147 @@
+#include <config.h>
+
+#include "AliasLDA.h"
+
+#include <rng/RNG.h>
+
+#include <vector>
+#include <numeric>
+
+using std::vector;
+using std::accumulate;
+
+/*
+ * Number of Metropolis-Hastings cycles per topic indicator. Each
+ * cycle draws once from the document proposal and once from the
+ * word proposal.
+ */
+#define MH_CYCLES 2
+
+namespace jags {
+    namespace mix {
+
+	AliasLDA::WordProposal::WordProposal()
+	    : remaining(0)
+	{
+	}
+
+	AliasLDA::AliasLDA(vector<vector<StochasticNode*> > const &topics,
+			   vector<vector<StochasticNode*> > const &words,
+			   vector<StochasticNode*> const &topic_priors,
+			   vector<StochasticNode*> const &word_priors,
+			   GraphView const *gv, unsigned int ch)
+	    : LDA(topics, words, topic_priors, word_priors, gv, ch),
+	      _wordProposals(_nWord), _work(_nTopic)
+	{
+	}
+
+	void AliasLDA::rebuildProposal(int word, double wordHyperSum)
+	{
+	    WordProposal &wp = _wordProposals[word];
+	    int const *wordTopics = &_topicsByWord[word * _nTopic];
+	    wp.weight.resize(_nTopic);
+	    for (unsigned int t = 0; t < _nTopic; ++t) {
+		wp.weight[t] = (wordTopics[t] + _wordHyper[word]) /
+		    (_topicSums[t] + wordHyperSum);
+	    }
+	    wp.table.build(wp.weight.data(), _nTopic, _work);
+	    wp.remaining = _nTopic;
+	}
+
+	void AliasLDA::update(RNG *rng)
+	{
+	    double wordHyperSum =
+		accumulate(_wordHyper, _wordHyper + _nWord, 0.0);
+	    double topicHyperSum =
+		accumulate(_topicHyper, _topicHyper + _nTopic, 0.0);
+
+	    //The topic hyper-parameter may have changed since the last
+	    //update, but building its alias table is cheap
+	    _topicTable.build(_topicHyper, _nTopic, _work);
+
+	    for (unsigned int doc = 0; doc < _nDoc; ++doc) {
+
+		int *docTopics = &_topicsByDoc[doc * _nTopic];
+		vector<int> &docTokens = _topicTokens[doc];
+		double docLength = _docSums[doc];
+
+		for (unsigned int i = 0; i < _docSums[doc]; ++i) {
+
+		    int const s = docTokens[i];
+		    int const word = _wordTokens[doc][i];
+		    int *wordTopics = &_topicsByWord[word * _nTopic];
+		    double const wordHyper = _wordHyper[word];
+
+		    //Proposals must be fixed while this token is sampled
+		    WordProposal &wp = _wordProposals[word];
+		    if (wp.remaining == 0) {
+			rebuildProposal(word, wordHyperSum);
+		    }
+
+		    //Remove current value from tables
+		    docTopics[s]--;
+		    wordTopics[s]--;
+		    _topicSums[s]--;
+
+		    /*
+		      The document proposal is calculated with the
+		      current token still assigned to topic s, so that
+		      it can be drawn from docTokens.
+		    */
+		    int t = s;
+		    double pt = (docTopics[t] + _topicHyper[t]) *
+			(wordTopics[t] + wordHyper) /
+			(_topicSums[t] + wordHyperSum);
+		    double qt = docTopics[t] + _topicHyper[t] + 1;
+
+		    for (unsigned int k = 0; k < MH_CYCLES; ++k) {
+
+			//Document proposal
+			double u = rng->uniform() * (docLength + topicHyperSum);
+			int c = (u < docLength) ?
+			    docTokens[static_cast<unsigned int>(u)] :
+			    _topicTable.draw(rng);
+			if (c != t) {
+			    double pc = (docTopics[c] + _topicHyper[c]) *
+				(wordTopics[c] + wordHyper) /
+				(_topicSums[c] + wordHyperSum);
+			    double qc = docTopics[c] + _topicHyper[c] +
+				(c == s ? 1 : 0);
+			    if (rng->uniform() * pt * qc < pc * qt) {
+				t = c;
+				pt = pc;
+				qt = qc;
+			    }
+			}
+
+			//Word proposal
+			c = wp.table.draw(rng);
+			if (wp.remaining > 0) --wp.remaining;
+			if (c != t) {
+			    double pc = (docTopics[c] + _topicHyper[c]) *
+				(wordTopics[c] + wordHyper) /
+				(_topicSums[c] + wordHyperSum);
+			    if (rng->uniform() * pt * wp.weight[c] <
+				pc * wp.weight[t])
+			    {
+				t = c;
+				pt = pc;
+				qt = docTopics[c] + _topicHyper[c] +
+				    (c == s ? 1 : 0);
+			    }
+			}
+		    }
+
+		    //Add new value to tables
+		    docTokens[i] = t;
+		    docTopics[t]++;
+		    wordTopics[t]++;
+		    _topicSums[t]++;
+		}
+	    }
+
+	    setTopics();
+	}
+
+    }
+}
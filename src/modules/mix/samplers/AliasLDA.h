@@ -0,0 +1,71 @@
+#ifndef ALIAS_LDA_H_
+#define ALIAS_LDA_H_
+
+#include "LDA.h"
+#include "AliasTable.h"
+
+#include <vector>
+
+namespace jags {
+
+    namespace mix {
+	/**
+	 * @short Metropolis-Hastings sampler for Latent Dirichlet
+	 * Allocation models using alias tables.
+	 *
+	 * AliasLDA samples the same topic indicators as LDA, with the
+	 * same collapsed posterior, but it does not calculate the full
+	 * conditional distribution of each topic, which takes time
+	 * proportional to the number of topics. Instead, each topic is
+	 * updated by a short Metropolis-Hastings chain that alternates
+	 * between two proposals, each of which can be drawn in constant
+	 * time:
+	 *
+	 * - The document proposal is proportional to the topic counts
+	 *   in the document plus the topic hyper-parameter. It is drawn
+	 *   by choosing the topic of a random token in the document, or
+	 *   by drawing from an alias table for the hyper-parameter.
+	 *
+	 * - The word proposal is proportional to the word-topic
+	 *   likelihood. It is drawn from an alias table for each word
+	 *   that is allowed to go stale: it is rebuilt only after it has
+	 *   been used once for each topic, so the cost of rebuilding is
+	 *   constant per draw.
+	 *
+	 * The acceptance probabilities use the current counts, so the
+	 * stale proposals do not change the stationary distribution.
+	 * Alias tables are built on first use of each word, and take
+	 * memory proportional to the number of topics times the number
+	 * of distinct words observed.
+	 */
+	class AliasLDA : public LDA {
+	    /*
+	     * Stale word proposal, with the unnormalized probabilities
+	     * used to build it and the number of draws left before it
+	     * is rebuilt.
+	     */
+	    struct WordProposal {
+		AliasTable table;
+		std::vector<double> weight;
+		unsigned int remaining;
+		WordProposal();
+	    };
+	    AliasTable _topicTable;
+	    std::vector<WordProposal> _wordProposals;
+	    std::vector<int> _work;
+	    void rebuildProposal(int word, double wordHyperSum);
+	  public:
+	    /**
+	     * Constructor. The arguments are the same as for LDA.
+	     */
+	    AliasLDA(std::vector<std::vector<StochasticNode*> > const &topics,
+		     std::vector<std::vector<StochasticNode*> > const &words,
+		     std::vector<StochasticNode*> const &topic_priors,
+		     std::vector<StochasticNode*> const &word_priors,
+		     GraphView const *gv, unsigned int chain);
+	    void update(RNG *rng) override;
+	};
+    }
+}
+
+#endif /* ALIAS_LDA_H_ */
@@ -0,0 +1,28 @@
+#include <config.h>
+#include "AliasLDAFactory.h"
+#include "AliasLDA.h"
+
+using std::vector;
+using std::string;
+
+namespace jags {
+    namespace mix {
+
+	MutableSampleMethod *
+	AliasLDAFactory::makeMethod(
+	    vector<vector<StochasticNode*> > const &topics,
+	    vector<vector<StochasticNode*> > const &words,
+	    vector<StochasticNode*> const &topicPriors,
+	    vector<StochasticNode*> const &wordPriors,
+	    GraphView const *gv, unsigned int chain) const
+	{
+	    return new AliasLDA(topics, words, topicPriors, wordPriors,
+				gv, chain);
+	}
+
+	string AliasLDAFactory::name() const
+	{
+	    return "mix::AliasLDA";
+	}
+    }
+}
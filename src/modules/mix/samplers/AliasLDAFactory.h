@@ -0,0 +1,32 @@
+#ifndef ALIAS_LDA_FACTORY_H_
+#define ALIAS_LDA_FACTORY_H_
+
+#include "LDAFactory.h"
+
+namespace jags {
+    namespace mix {
+
+	/**
+	 * @short Factory object for AliasLDA samplers
+	 *
+	 * AliasLDAFactory samples the same models as LDAFactory, which
+	 * has priority over it. To use the AliasLDA sampler, the
+	 * mix::LDA factory must be switched off.
+	 */
+	class AliasLDAFactory : public LDAFactory
+	{
+	  protected:
+	    MutableSampleMethod *
+		makeMethod(
+		    std::vector<std::vector<StochasticNode*> > const &topics,
+		    std::vector<std::vector<StochasticNode*> > const &words,
+		    std::vector<StochasticNode*> const &topicPriors,
+		    std::vector<StochasticNode*> const &wordPriors,
+		    GraphView const *gv, unsigned int chain) const override;
+	  public:
+	    std::string name() const override;
+	};
+    }
+}
+
+#endif /* ALIAS_LDA_FACTORY_H_ */
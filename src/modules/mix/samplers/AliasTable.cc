@@ -0,0 +1,65 @@
+#include <config.h>
+
+#include "AliasTable.h"
+
+#include <rng/RNG.h>
+
+#include <numeric>
+
+using std::vector;
+using std::accumulate;
+
+namespace jags {
+    namespace mix {
+
+	void AliasTable::build(double const *weight, unsigned int n,
+			       vector<int> &work)
+	{
+	    //Vose's method. Indices of small and large probabilities
+	    //are stacked at the front and back of work respectively
+	    _prob.resize(n);
+	    _alias.resize(n);
+	    work.resize(n);
+
+	    double sum = accumulate(weight, weight + n, 0.0);
+	    unsigned int nsmall = 0, nlarge = 0;
+	    for (unsigned int i = 0; i < n; ++i) {
+		_prob[i] = weight[i] * n / sum;
+		_alias[i] = i;
+		if (_prob[i] < 1) {
+		    work[nsmall++] = i;
+		}
+		else {
+		    work[n - ++nlarge] = i;
+		}
+	    }
+	    while (nsmall > 0 && nlarge > 0) {
+		int s = work[--nsmall];
+		int l = work[n - nlarge];
+		_alias[s] = l;
+		_prob[l] -= 1 - _prob[s];
+		if (_prob[l] < 1) {
+		    --nlarge;
+		    work[nsmall++] = l;
+		}
+	    }
+	    //Remaining probabilities differ from 1 by rounding error
+	    while (nlarge > 0) {
+		_prob[work[n - nlarge--]] = 1;
+	    }
+	    while (nsmall > 0) {
+		_prob[work[--nsmall]] = 1;
+	    }
+	}
+
+	int AliasTable::draw(RNG *rng) const
+	{
+	    unsigned int n = _prob.size();
+	    double x = rng->uniform() * n;
+	    unsigned int i = static_cast<unsigned int>(x);
+	    if (i >= n) i = n - 1;
+	    return (x - i < _prob[i]) ? i : _alias[i];
+	}
+
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef ALIAS_TABLE_H_
+#define ALIAS_TABLE_H_
+
+#include <vector>
+
+namespace jags {
+
+    struct RNG;
+
+    namespace mix {
+	/**
+	 * @short Alias table for drawing from a discrete distribution
+	 *
+	 * An alias table for n categories is built from their
+	 * unnormalized weights in time proportional to n, using Vose's
+	 * method. Each draw then takes constant time.
+	 */
+	class AliasTable {
+	    std::vector<double> _prob;
+	    std::vector<int> _alias;
+	  public:
+	    /**
+	     * Builds the table.
+	     *
+	     * @param weight Array of n non-negative weights, not all zero
+	     * @param n Number of categories
+	     * @param work Work space, which is resized to length n
+	     */
+	    void build(double const *weight, unsigned int n,
+		       std::vector<int> &work);
+	    /**
+	     * Draws a category, numbered from zero, with probability
+	     * proportional to its weight.
+	     */
+	    int draw(RNG *rng) const;
+	};
+    }
+}
+
+#endif /* ALIAS_TABLE_H_ */
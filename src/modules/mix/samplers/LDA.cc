@@ -20,7 +20,7 @@ using std::set;
 using std::string;
 using std::upper_bound;
 using std::accumulate;
-using std::partial_sum;
+using std::fill;
 
 namespace jags {
 
@@ -49,8 +49,8 @@ namespace jags {
 	      _chain(ch),
 	    _topicTokens(_nDoc), 
 	    _wordTokens(_nDoc), 
-	    _topicsByWord(_nWord, vector<int>(_nTopic, 0)),
-	    _topicsByDoc(_nDoc, vector<int>(_nTopic, 0)),
+	    _topicsByWord(_nWord * _nTopic, 0),
+	    _topicsByDoc(_nDoc * _nTopic, 0),
 	    _docSums(_nDoc), _topicSums(_nTopic),
 	    _wordsObserved(true)
 	{
@@ -60,11 +60,11 @@ namespace jags {
 		for (unsigned int i = 0; i < _docSums[d]; ++i) {
 		    int topic = static_cast<int>(*topics[d][i]->value(ch)) - 1;
 		    _topicTokens[d].push_back(topic);
-		    _topicsByDoc[d][topic]++;
+		    _topicsByDoc[d * _nTopic + topic]++;
 		    _topicSums[topic]++;
 		    int word = static_cast<int>(*words[d][i]->value(ch)) - 1;
 		    _wordTokens[d].push_back(word);
-		    _topicsByWord[word][topic]++;
+		    _topicsByWord[word * _nTopic + topic]++;
 		    if (isParameter(words[d][i])) _wordsObserved = false;
 		}
 	    }
@@ -84,11 +84,7 @@ namespace jags {
 
 	void LDA::rebuildTable()
 	{
-	    for (unsigned int t = 0; t < _nTopic; ++t) {
-		for (unsigned int w = 0; w < _nWord; ++w) {
-		    _topicsByWord[w][t] = 0;
-		}
-	    }
+	    fill(_topicsByWord.begin(), _topicsByWord.end(), 0);
 
 	    vector<StochasticNode *> const &s = _gv->nodes();
 	    unsigned int offset = 0;
@@ -97,7 +93,7 @@ namespace jags {
 		    int topic = _topicTokens[d][i];
 		    int word = static_cast<int>(*s[offset + i]->value(_chain)) 
 			- 1;
-		    _topicsByWord[word][topic]++;
+		    _topicsByWord[word * _nTopic + topic]++;
 		}
 		offset += _docSums[d];
 	    }
@@ -115,7 +111,7 @@ namespace jags {
 	    vector<double> sump(_nTopic);
 	    for (unsigned int doc = 0; doc < _nDoc; ++doc) {
 
-		vector<int> &thisDocTopics = _topicsByDoc[doc];
+		int *thisDocTopics = &_topicsByDoc[doc * _nTopic];
 
 		for (unsigned int i = 0; i < _docSums[doc]; ++i) {
 
@@ -123,25 +119,25 @@ namespace jags {
 		    int &topic = _topicTokens[doc][i];
 		    int const &word = _wordTokens[doc][i];
 
-		    vector<int> &thisWordTopics = _topicsByWord[word];
+		    int *thisWordTopics = &_topicsByWord[word * _nTopic];
 
 		    //Remove current value from tables
 		    thisDocTopics[topic]--;
 		    thisWordTopics[topic]--;
 		    _topicSums[topic]--;
 
-		    //Calculate probability vector
-		    vector<double> prob(_nTopic);
+		    //Calculate cumulative probability vector
+		    double sum = 0;
 		    for (unsigned int t = 0; t < _nTopic; ++t) {
 			double prior = thisDocTopics[t] + _topicHyper[t];
 			double likelihood = 
 			    (thisWordTopics[t] + _wordHyper[word]) /
 			    (_topicSums[t] + wordHyperSum);
-			prob[t] = prior * likelihood;
+			sum += prior * likelihood;
+			sump[t] = sum;
 		    }
 		    
 		    //Draw random sample from categorical distribution
-		    partial_sum(prob.begin(), prob.end(), sump.begin());
 		    double p = rng->uniform() * sump.back();
 		    topic = upper_bound(sump.begin(), sump.end(), p) -
 			sump.begin();
@@ -153,7 +149,12 @@ namespace jags {
 		    _topicSums[topic]++;
 		}
 	    }
-	    
+
+	    setTopics();
+	}
+
+	void LDA::setTopics()
+	{
 	    vector<double> value;
 	    value.reserve(_gv->length());
 	    for (unsigned int d = 0; d < _nDoc; ++d) {
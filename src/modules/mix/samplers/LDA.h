@@ -17,16 +17,27 @@ namespace jags {
 	 * models.
 	 */
 	class LDA : public SampleMethodNoAdapt {
+	  protected:
 	    const unsigned int _nTopic, _nWord, _nDoc;
 	    double const *_topicHyper;
 	    double const *_wordHyper;
 	    GraphView const *_gv;
 	    const unsigned int _chain;	    
 	    std::vector<std::vector<int> > _topicTokens, _wordTokens;
-	    std::vector<std::vector<int> > _topicsByWord, _topicsByDoc;
+	    /*
+	     * Count tables stored as flat row-major matrices, so that
+	     * the topic counts for word w start at
+	     * _topicsByWord[w * _nTopic] and those for document d at
+	     * _topicsByDoc[d * _nTopic].
+	     */
+	    std::vector<int> _topicsByWord, _topicsByDoc;
 	    std::vector<unsigned int> _docSums, _topicSums;
 	    bool _wordsObserved;
 	    void rebuildTable();
+	    /**
+	     * Copies the current topic indicators to the sampled nodes.
+	     */
+	    void setTopics();
 	  public:
 	    /**
 	     * Constructor.
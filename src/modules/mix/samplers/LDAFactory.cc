@@ -154,14 +154,24 @@ namespace jags {
 		unsigned int N = nchain(view);
 		vector<MutableSampleMethod*> methods(N);
 		for (unsigned int ch = 0; ch < N; ++ch) {
-		    methods[ch] = new LDA(topics, words, topicPriors,
-					  wordPriors, view, ch);
+		    methods[ch] = makeMethod(topics, words, topicPriors,
+					     wordPriors, view, ch);
 		}
-		return new MutableSampler(view, methods, "mix::LDA");
+		return new MutableSampler(view, methods, name());
 	    }
 	    else return nullptr;
 	}
 
+	MutableSampleMethod *
+	LDAFactory::makeMethod(vector<vector<StochasticNode*> > const &topics,
+			       vector<vector<StochasticNode*> > const &words,
+			       vector<StochasticNode*> const &topicPriors,
+			       vector<StochasticNode*> const &wordPriors,
+			       GraphView const *gv, unsigned int chain) const
+	{
+	    return new LDA(topics, words, topicPriors, wordPriors, gv, chain);
+	}
+
 	string LDAFactory::name() const
 	{
 	    return "mix::LDA";
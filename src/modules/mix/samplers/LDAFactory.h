@@ -4,6 +4,10 @@
 #include <sampler/SamplerFactory.h>
 
 namespace jags {
+
+    class MutableSampleMethod;
+    class GraphView;
+
     namespace mix {
 
 	/**
@@ -12,6 +16,18 @@ namespace jags {
 
 	class LDAFactory : public SamplerFactory
 	{
+	  protected:
+	    /**
+	     * Creates the sample method for a single chain. The
+	     * arguments are those of the LDA constructor.
+	     */
+	    virtual MutableSampleMethod *
+		makeMethod(
+		    std::vector<std::vector<StochasticNode*> > const &topics,
+		    std::vector<std::vector<StochasticNode*> > const &words,
+		    std::vector<StochasticNode*> const &topicPriors,
+		    std::vector<StochasticNode*> const &wordPriors,
+		    GraphView const *gv, unsigned int chain) const;
 	  public:
 	    Sampler *
 		makeSampler(std::vector<StochasticNode*> const &topicPriors,
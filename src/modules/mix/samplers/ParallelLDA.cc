@@ -0,0 +1,171 @@
+#include <config.h>
+
+#include "ParallelLDA.h"
+
+#include <rng/RNG.h>
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+using std::vector;
+using std::upper_bound;
+using std::accumulate;
+using std::fill;
+using std::min;
+
+namespace jags {
+    namespace mix {
+
+	ParallelLDA::ParallelLDA(vector<vector<StochasticNode*> > const &topics,
+				 vector<vector<StochasticNode*> > const &words,
+				 vector<StochasticNode*> const &topic_priors,
+				 vector<StochasticNode*> const &word_priors,
+				 GraphView const *gv, unsigned int ch,
+				 unsigned int npart)
+	    : LDA(topics, words, topic_priors, word_priors, gv, ch)
+	{
+	    unsigned int ntoken = accumulate(_docSums.begin(), _docSums.end(),
+					     0U);
+	    _uniform.resize(ntoken);
+
+	    //Divide the documents into partitions with roughly equal
+	    //numbers of tokens
+	    if (npart == 0) npart = 1;
+	    if (npart > _nDoc) npart = _nDoc;
+	    unsigned int offset = 0;
+	    unsigned int doc = 0;
+	    for (unsigned int p = 0; p < npart && doc < _nDoc; ++p) {
+		Partition part;
+		part.begin = doc;
+		part.offset = offset;
+		unsigned long target =
+		    static_cast<unsigned long>(ntoken) * (p + 1) / npart;
+		do {
+		    offset += _docSums[doc++];
+		} while (doc < _nDoc && offset < target);
+		part.end = doc;
+		_partitions.push_back(part);
+	    }
+
+	    //Index the words in each partition
+	    vector<int> local(_nWord, -1);
+	    for (Partition &part : _partitions) {
+		for (unsigned int d = part.begin; d < part.end; ++d) {
+		    vector<int> lw(_docSums[d]);
+		    for (unsigned int i = 0; i < _docSums[d]; ++i) {
+			int word = _wordTokens[d][i];
+			if (local[word] < 0) {
+			    local[word] = part.words.size();
+			    part.words.push_back(word);
+			}
+			lw[i] = local[word];
+		    }
+		    part.localWords.push_back(lw);
+		}
+		for (int word : part.words) {
+		    local[word] = -1;
+		}
+		part.wordDelta.assign(part.words.size() * _nTopic, 0);
+		part.topicDelta.assign(_nTopic, 0);
+	    }
+	}
+
+	void ParallelLDA::updatePartition(Partition &part, double wordHyperSum)
+	{
+	    vector<double> sump(_nTopic);
+	    double const *u = &_uniform[part.offset];
+	    for (unsigned int doc = part.begin; doc < part.end; ++doc) {
+
+		int *thisDocTopics = &_topicsByDoc[doc * _nTopic];
+		vector<int> const &localWords = part.localWords[doc - part.begin];
+
+		for (unsigned int i = 0; i < _docSums[doc]; ++i) {
+
+		    int &topic = _topicTokens[doc][i];
+		    int const &word = _wordTokens[doc][i];
+
+		    int const *globalWordTopics = &_topicsByWord[word * _nTopic];
+		    int *thisWordTopics =
+			&part.wordDelta[localWords[i] * _nTopic];
+
+		    //Remove current value from local tables
+		    thisDocTopics[topic]--;
+		    thisWordTopics[topic]--;
+		    part.topicDelta[topic]--;
+
+		    //Calculate cumulative probability vector using the
+		    //global tables plus the local changes
+		    double sum = 0;
+		    for (unsigned int t = 0; t < _nTopic; ++t) {
+			double prior = thisDocTopics[t] + _topicHyper[t];
+			double likelihood =
+			    (globalWordTopics[t] + thisWordTopics[t] +
+			     _wordHyper[word]) /
+			    (_topicSums[t] + part.topicDelta[t] + wordHyperSum);
+			sum += prior * likelihood;
+			sump[t] = sum;
+		    }
+
+		    //Draw random sample from categorical distribution
+		    double p = *u++ * sump.back();
+		    topic = upper_bound(sump.begin(), sump.end(), p) -
+			sump.begin();
+		    if (topic == static_cast<int>(_nTopic)) --topic;
+
+		    //Add new value to local tables
+		    thisDocTopics[topic]++;
+		    thisWordTopics[topic]++;
+		    part.topicDelta[topic]++;
+		}
+	    }
+	}
+
+	void ParallelLDA::mergePartitions()
+	{
+	    /*
+	      Each block of topics is merged by a single thread, so the
+	      threads write to disjoint parts of the global tables.
+	    */
+	    int const npart = _partitions.size();
+	    int const blocksize = (_nTopic + npart - 1) / npart;
+	    #pragma omp parallel for num_threads(npart)
+	    for (int b = 0; b < npart; ++b) {
+		unsigned int tbegin = min<unsigned int>(b * blocksize, _nTopic);
+		unsigned int tend = min<unsigned int>(tbegin + blocksize, _nTopic);
+		for (Partition &part : _partitions) {
+		    for (unsigned int j = 0; j < part.words.size(); ++j) {
+			int *global = &_topicsByWord[part.words[j] * _nTopic];
+			int *delta = &part.wordDelta[j * _nTopic];
+			for (unsigned int t = tbegin; t < tend; ++t) {
+			    global[t] += delta[t];
+			    delta[t] = 0;
+			}
+		    }
+		    for (unsigned int t = tbegin; t < tend; ++t) {
+			_topicSums[t] += part.topicDelta[t];
+			part.topicDelta[t] = 0;
+		    }
+		}
+	    }
+	}
+
+	void ParallelLDA::update(RNG *rng)
+	{
+	    double wordHyperSum =
+		accumulate(_wordHyper, _wordHyper + _nWord, 0.0);
+
+	    rng->uniform(_uniform.data(), _uniform.size());
+
+	    int const npart = _partitions.size();
+	    #pragma omp parallel for num_threads(npart) schedule(dynamic)
+	    for (int p = 0; p < npart; ++p) {
+		updatePartition(_partitions[p], wordHyperSum);
+	    }
+	    mergePartitions();
+
+	    setTopics();
+	}
+
+    }
+}
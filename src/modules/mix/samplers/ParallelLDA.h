@@ -0,0 +1,80 @@
+#ifndef PARALLEL_LDA_H_
+#define PARALLEL_LDA_H_
+
+#include "LDA.h"
+
+#include <vector>
+
+namespace jags {
+
+    namespace mix {
+	/**
+	 * @short Approximate distributed sampler for Latent Dirichlet
+	 * Allocation models.
+	 *
+	 * ParallelLDA divides the documents into partitions that are
+	 * updated concurrently, following the AD-LDA algorithm of
+	 * Newman et al (2009). Each partition has exclusive access to
+	 * the topic counts of its own documents, but it sees the
+	 * word-topic counts and topic sums from the start of the
+	 * iteration plus its own changes, which are held in
+	 * partition-local delta tables. The deltas are merged into the
+	 * global tables at the end of each update.
+	 *
+	 * This is not an exact Gibbs sampler, since each partition
+	 * ignores the changes made by the others during the same
+	 * iteration, but the error is small when there are many
+	 * documents per partition.
+	 *
+	 * The number of partitions is fixed when the sampler is
+	 * created, and the random numbers for all tokens are drawn
+	 * from the chain RNG before the partitions are updated, so the
+	 * results do not depend on how the partitions are scheduled
+	 * over threads.
+	 *
+	 * The partitions are updated in a parallel region nested
+	 * inside the one that runs the chains. The sampler does not
+	 * change the OpenMP settings of the process, so with more than
+	 * one chain the partitions are only updated concurrently if
+	 * nested parallelism is enabled, e.g. with
+	 * OMP_MAX_ACTIVE_LEVELS=2.
+	 */
+	class ParallelLDA : public LDA {
+	    struct Partition {
+		// Documents in the partition
+		unsigned int begin, end;
+		// Offset of the first token in the partition
+		unsigned int offset;
+		// Distinct words in the partition, and the topic counts
+		// that the partition has added to them
+		std::vector<int> words;
+		std::vector<int> wordDelta;
+		std::vector<int> topicDelta;
+		// Index of each token in words
+		std::vector<std::vector<int> > localWords;
+	    };
+	    std::vector<Partition> _partitions;
+	    std::vector<double> _uniform;
+	    void updatePartition(Partition &part, double wordHyperSum);
+	    void mergePartitions();
+	  public:
+	    /**
+	     * Constructor. The first six arguments are the same as for
+	     * LDA.
+	     *
+	     * @param npart Number of partitions into which the documents
+	     * are divided. This is also the maximum number of threads
+	     * used to update them.
+	     */
+	    ParallelLDA(
+		std::vector<std::vector<StochasticNode*> > const &topics,
+		std::vector<std::vector<StochasticNode*> > const &words,
+		std::vector<StochasticNode*> const &topic_priors,
+		std::vector<StochasticNode*> const &word_priors,
+		GraphView const *gv, unsigned int chain, unsigned int npart);
+	    void update(RNG *rng) override;
+	};
+    }
+}
+
+#endif /* PARALLEL_LDA_H_ */
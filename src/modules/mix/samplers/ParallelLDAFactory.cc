@@ -0,0 +1,55 @@
+#include <config.h>
+#include "ParallelLDAFactory.h"
+#include "ParallelLDA.h"
+
+#include <sampler/GraphView.h>
+
+#include <cmath>
+#include <climits>
+
+using std::vector;
+using std::string;
+using std::floor;
+
+namespace jags {
+    namespace mix {
+
+	ParallelLDAFactory::ParallelLDAFactory(unsigned int npart)
+	    : _npart(npart)
+	{
+	}
+
+	MutableSampleMethod *
+	ParallelLDAFactory::makeMethod(
+	    vector<vector<StochasticNode*> > const &topics,
+	    vector<vector<StochasticNode*> > const &words,
+	    vector<StochasticNode*> const &topicPriors,
+	    vector<StochasticNode*> const &wordPriors,
+	    GraphView const *gv, unsigned int chain) const
+	{
+	    return new ParallelLDA(topics, words, topicPriors, wordPriors,
+				   gv, chain, _npart);
+	}
+
+	string ParallelLDAFactory::name() const
+	{
+	    return "mix::ParallelLDA";
+	}
+
+	bool ParallelLDAFactory::setOption(string const &name, double value)
+	{
+	    if (name != "partitions" || !(value >= 1) || value > UINT_MAX ||
+		value != floor(value))
+	    {
+		return false;
+	    }
+	    _npart = static_cast<unsigned int>(value);
+	    return true;
+	}
+
+	unsigned int ParallelLDAFactory::partitions() const
+	{
+	    return _npart;
+	}
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef PARALLEL_LDA_FACTORY_H_
+#define PARALLEL_LDA_FACTORY_H_
+
+#include "LDAFactory.h"
+
+namespace jags {
+    namespace mix {
+
+	/**
+	 * @short Factory object for ParallelLDA samplers
+	 *
+	 * ParallelLDAFactory samples the same models as LDAFactory and
+	 * AliasLDAFactory, which both have priority over it. Since
+	 * ParallelLDA is not an exact Gibbs sampler, it is only used
+	 * when the mix::LDA and mix::AliasLDA factories are switched
+	 * off.
+	 *
+	 * To use it, both factories must be switched off, e.g.
+	 *
+	 * set factory "mix::LDA" off, type(sampler)
+	 * set factory "mix::AliasLDA" off, type(sampler)
+	 *
+	 * The number of partitions is the option "partitions" of the
+	 * factory, with default 4, e.g.
+	 *
+	 * set factory "mix::ParallelLDA" partitions(8), type(sampler)
+	 *
+	 * It does not depend on the number of processors, so the
+	 * samples are the same on any machine.
+	 */
+	class ParallelLDAFactory : public LDAFactory
+	{
+	    unsigned int _npart;
+	  protected:
+	    MutableSampleMethod *
+		makeMethod(
+		    std::vector<std::vector<StochasticNode*> > const &topics,
+		    std::vector<std::vector<StochasticNode*> > const &words,
+		    std::vector<StochasticNode*> const &topicPriors,
+		    std::vector<StochasticNode*> const &wordPriors,
+		    GraphView const *gv, unsigned int chain) const override;
+	  public:
+	    /**
+	     * @param npart Number of partitions into which each sampler
+	     * divides its documents.
+	     */
+	    ParallelLDAFactory(unsigned int npart = 4);
+	    std::string name() const override;
+	    /**
+	     * Sets the number of partitions with the option
+	     * "partitions", which must be a positive integer.
+	     */
+	    bool setOption(std::string const &name, double value) override;
+	    /**
+	     * Returns the number of partitions
+	     */
+	    unsigned int partitions() const;
+	};
+    }
+}
+
+#endif /* PARALLEL_LDA_FACTORY_H_ */
@@ -0,0 +1,280 @@
+#include "testmixsamp.h"
+
+#include "AliasTable.h"
+#include "AliasLDA.h"
+#include "ParallelLDA.h"
+#include "ParallelLDAFactory.h"
+
+#include <DCat.h>
+#include <DDirch.h>
+#include <MersenneTwisterRNG.h>
+
+#include <graph/Graph.h>
+#include <graph/ConstantNode.h>
+#include <graph/VectorStochasticNode.h>
+#include <sampler/GraphView.h>
+
+#include <vector>
+#include <numeric>
+#include <cmath>
+
+using std::vector;
+using std::accumulate;
+using std::sqrt;
+using std::fabs;
+
+using jags::Node;
+using jags::Graph;
+using jags::ConstantNode;
+using jags::StochasticNode;
+using jags::VectorStochasticNode;
+using jags::GraphView;
+using jags::mix::AliasTable;
+
+/* Dimensions of the LDA test model */
+static const unsigned int NTOPIC = 3;
+static const unsigned int NWORD = 5;
+static const unsigned int NDOC = 6;
+
+namespace {
+
+    /*
+     * Exposes the count tables of an LDA sampler so that they can be
+     * compared with the values of the sampled nodes.
+     */
+    template<class LDASampler>
+    class LDACounts : public LDASampler {
+      public:
+	using LDASampler::LDASampler;
+	bool consistent(vector<vector<StochasticNode*> > const &topics,
+			vector<vector<StochasticNode*> > const &words) const;
+    };
+
+    template<class LDASampler>
+    bool LDACounts<LDASampler>::consistent(
+	vector<vector<StochasticNode*> > const &topics,
+	vector<vector<StochasticNode*> > const &words) const
+    {
+	unsigned int const K = this->_nTopic;
+	vector<int> byWord(this->_nWord * K, 0), byDoc(this->_nDoc * K, 0);
+	vector<unsigned int> sums(K, 0);
+	for (unsigned int d = 0; d < topics.size(); ++d) {
+	    if (this->_docSums[d] != topics[d].size()) return false;
+	    for (unsigned int i = 0; i < topics[d].size(); ++i) {
+		int t = static_cast<int>(topics[d][i]->value(0)[0]) - 1;
+		int w = static_cast<int>(words[d][i]->value(0)[0]) - 1;
+		if (t != this->_topicTokens[d][i]) return false;
+		if (w != this->_wordTokens[d][i]) return false;
+		byWord[w * K + t]++;
+		byDoc[d * K + t]++;
+		sums[t]++;
+	    }
+	}
+	return byWord == this->_topicsByWord && byDoc == this->_topicsByDoc
+	    && sums == this->_topicSums;
+    }
+
+}
+
+void MixSampTest::setUp()
+{
+    _rng = new jags::base::MersenneTwisterRNG(1234567,
+					      jags::KINDERMAN_RAMAGE);
+    _dcat = new jags::bugs::DCat;
+    _ddirch = new jags::bugs::DDirch;
+}
+
+void MixSampTest::tearDown()
+{
+    delete _rng;
+    delete _dcat;
+    delete _ddirch;
+}
+
+MixSampTest::LDAModel::~LDAModel()
+{
+    for (unsigned int i = nodes.size(); i > 0; --i) {
+	delete nodes[i-1];
+    }
+}
+
+void MixSampTest::makeLDA(LDAModel &model, Graph &graph)
+{
+    /*
+      theta[d,] ~ ddirch(alpha)
+      phi[k,] ~ ddirch(beta)
+      topic[d,i] ~ dcat(theta[d,])
+      word[d,i] ~ dcat(phi[1,])
+
+      The words do not depend on the topics, since the LDA sampler
+      only uses the values of the words.
+    */
+    vector<unsigned long> dk(1, NTOPIC), dw(1, NWORD);
+    ConstantNode *alpha =
+	new ConstantNode(dk, vector<double>(NTOPIC, 0.5), 1, true);
+    ConstantNode *beta =
+	new ConstantNode(dw, vector<double>(NWORD, 0.1), 1, true);
+    model.nodes.push_back(alpha);
+    model.nodes.push_back(beta);
+
+    for (unsigned int k = 0; k < NTOPIC; ++k) {
+	vector<Node const*> par(1, beta);
+	VectorStochasticNode *phi = new VectorStochasticNode(_ddirch, 1, par);
+	vector<double> v(NWORD, 1.0/NWORD);
+	phi->setValue(&v[0], NWORD, 0);
+	model.nodes.push_back(phi);
+	model.wordPriors.push_back(phi);
+	graph.insert(phi);
+    }
+
+    model.topics.resize(NDOC);
+    model.words.resize(NDOC);
+    for (unsigned int d = 0; d < NDOC; ++d) {
+	vector<Node const*> par(1, alpha);
+	VectorStochasticNode *theta = 
+	    new VectorStochasticNode(_ddirch, 1, par);
+	vector<double> v(NTOPIC, 1.0/NTOPIC);
+	theta->setValue(&v[0], NTOPIC, 0);
+	model.nodes.push_back(theta);
+	model.topicPriors.push_back(theta);
+	graph.insert(theta);
+
+	unsigned int ntoken = 4 + d;
+	for (unsigned int i = 0; i < ntoken; ++i) {
+	    vector<Node const*> tpar(1, theta);
+	    VectorStochasticNode *topic = 
+		new VectorStochasticNode(_dcat, 1, tpar);
+	    double t = (d + i) % NTOPIC + 1;
+	    topic->setValue(&t, 1, 0);
+	    model.nodes.push_back(topic);
+	    model.topics[d].push_back(topic);
+	    graph.insert(topic);
+
+	    vector<Node const*> wpar(1, model.wordPriors[0]);
+	    VectorStochasticNode *word = 
+		new VectorStochasticNode(_dcat, 1, wpar);
+	    double w = (d * i + i / 2) % NWORD + 1;
+	    word->setData(&w, 1);
+	    model.nodes.push_back(word);
+	    model.words[d].push_back(word);
+	    graph.insert(word);
+	}
+    }
+}
+
+void MixSampTest::alias_table_freq(vector<double> const &weight)
+{
+    /*
+       The frequency of each category must agree with its weight to
+       within 5 binomial standard deviations
+    */
+    unsigned int n = weight.size();
+    AliasTable table;
+    vector<int> work;
+    table.build(&weight[0], n, work);
+
+    unsigned int N = 100000;
+    vector<unsigned int> count(n, 0);
+    for (unsigned int j = 0; j < N; ++j) {
+	int i = table.draw(_rng);
+	CPPUNIT_ASSERT(i >= 0 && i < static_cast<int>(n));
+	count[i]++;
+    }
+
+    double sum = accumulate(weight.begin(), weight.end(), 0.0);
+    for (unsigned int i = 0; i < n; ++i) {
+	double p = weight[i] / sum;
+	if (p == 0) {
+	    CPPUNIT_ASSERT_EQUAL(0U, count[i]);
+	}
+	else {
+	    double sd = sqrt(N * p * (1 - p));
+	    CPPUNIT_ASSERT(fabs(count[i] - N * p) < 5 * sd + 1);
+	}
+    }
+}
+
+void MixSampTest::alias_table()
+{
+    alias_table_freq(vector<double>(1, 2.0));
+    alias_table_freq(vector<double>(7, 1.0));
+    alias_table_freq({1, 0, 3.5, 0.25, 2, 10});
+    alias_table_freq({1E-3, 1, 1E-3, 0.5});
+}
+
+void MixSampTest::alias_lda()
+{
+    /*
+       After each update, the count tables of the sampler must agree
+       with the topics written to the sampled nodes
+    */
+    Graph graph;
+    LDAModel model;
+    makeLDA(model, graph);
+
+    vector<StochasticNode*> snodes;
+    for (unsigned int d = 0; d < NDOC; ++d) {
+	snodes.insert(snodes.end(), model.topics[d].begin(),
+		      model.topics[d].end());
+    }
+    GraphView gv(snodes, graph);
+    vector<double> start(gv.length());
+    gv.getValue(start, 0);
+
+    LDACounts<jags::mix::AliasLDA> method(model.topics, model.words,
+					  model.topicPriors, model.wordPriors,
+					  &gv, 0);
+    CPPUNIT_ASSERT(method.consistent(model.topics, model.words));
+    for (unsigned int iter = 0; iter < 20; ++iter) {
+	method.update(_rng);
+	CPPUNIT_ASSERT(method.consistent(model.topics, model.words));
+    }
+
+    vector<double> end(gv.length());
+    gv.getValue(end, 0);
+    CPPUNIT_ASSERT(start != end);
+}
+
+void MixSampTest::parallel_lda()
+{
+    /*
+       The count tables must agree with the sampled topics after the
+       partitions are merged. The documents are divided into a fixed
+       number of partitions, so the samples are reproducible.
+    */
+    Graph graph;
+    LDAModel model;
+    makeLDA(model, graph);
+
+    vector<StochasticNode*> snodes;
+    for (unsigned int d = 0; d < NDOC; ++d) {
+	snodes.insert(snodes.end(), model.topics[d].begin(),
+		      model.topics[d].end());
+    }
+    GraphView gv(snodes, graph);
+    vector<double> start(gv.length());
+    gv.getValue(start, 0);
+
+    LDACounts<jags::mix::ParallelLDA> method(model.topics, model.words,
+					     model.topicPriors,
+					     model.wordPriors, &gv, 0, 3);
+    CPPUNIT_ASSERT(method.consistent(model.topics, model.words));
+    for (unsigned int iter = 0; iter < 20; ++iter) {
+	method.update(_rng);
+	CPPUNIT_ASSERT(method.consistent(model.topics, model.words));
+    }
+
+    vector<double> end(gv.length());
+    gv.getValue(end, 0);
+    CPPUNIT_ASSERT(start != end);
+
+    //The number of partitions is set by the factory option
+    jags::mix::ParallelLDAFactory factory;
+    CPPUNIT_ASSERT_EQUAL(4U, factory.partitions());
+    CPPUNIT_ASSERT(factory.setOption("partitions", 8));
+    CPPUNIT_ASSERT_EQUAL(8U, factory.partitions());
+    CPPUNIT_ASSERT(!factory.setOption("partitions", 0));
+    CPPUNIT_ASSERT(!factory.setOption("partitions", 2.5));
+    CPPUNIT_ASSERT(!factory.setOption("threads", 2));
+    CPPUNIT_ASSERT_EQUAL(8U, factory.partitions());
+}
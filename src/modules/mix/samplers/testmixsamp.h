@@ -0,0 +1,52 @@
+#ifndef MIX_SAMP_TEST_H
+#define MIX_SAMP_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <testlib.h>
+
+#include <vector>
+
+namespace jags {
+    class VectorDist;
+    class Node;
+    class StochasticNode;
+    class Graph;
+    struct RNG;
+}
+
+class MixSampTest : public CppUnit::TestFixture, public JAGSFixture
+{
+    CPPUNIT_TEST_SUITE( MixSampTest );
+    CPPUNIT_TEST( alias_table );
+    CPPUNIT_TEST( alias_lda );
+    CPPUNIT_TEST( parallel_lda );
+    CPPUNIT_TEST_SUITE_END();
+
+    jags::RNG *_rng;
+    jags::VectorDist *_dcat;
+    jags::VectorDist *_ddirch;
+
+    /*
+     * Nodes of a small LDA model. The vectors topics, words,
+     * topicPriors and wordPriors are arranged as for the LDA
+     * constructor. All nodes are added to the vector nodes, which
+     * owns them.
+     */
+    struct LDAModel {
+	std::vector<std::vector<jags::StochasticNode*> > topics, words;
+	std::vector<jags::StochasticNode*> topicPriors, wordPriors;
+	std::vector<jags::Node*> nodes;
+	~LDAModel();
+    };
+    void makeLDA(LDAModel &model, jags::Graph &graph);
+    void alias_table_freq(std::vector<double> const &weight);
+
+public:
+    void setUp();
+    void tearDown();
+    void alias_table();
+    void alias_lda();
+    void parallel_lda();
+};
+
+#endif /* MIX_SAMP_TEST_H */
@@ -1,7 +1,9 @@
 #include "testmix.h"
 #include "distributions/testmixdist.h"
+#include "samplers/testmixsamp.h"
 #include <cppunit/extensions/HelperMacros.h>
 
 void init_mix_test() {
     CPPUNIT_TEST_SUITE_REGISTRATION( MixDistTest );
+    CPPUNIT_TEST_SUITE_REGISTRATION( MixSampTest );
 }
@@ -102,20 +102,12 @@ double DMState::logDensity(double const *y, PDFType type,
     }
     else {
 	/*
-	  FIXME: There is a big problem here with hidden Markov models.
-	  If the node is not observed, then we will need to evaluate the
-	  log-likelihood at different values of x, but with the same
-	  par.  This is hugely inefficient at the moment because 
-	  we calculate - and THROW AWAY - the transition probability matrix
-	  each time.  
-
-	  SOLUTION: Maybe a cache?
+	  The transition probability matrix is cached, so that it
+	  is not recalculated for other values of x, or for other
+	  observations with the same time and intensity.
 	*/
-	double *P = new double[nstate*nstate];
-	//MatrixExp(P, intensity, nstate, time);
-	MatrixExpPade(P, intensity, nstate, time);
+	double const *P = MatrixExpCached(intensity, nstate, time);
 	double lik = P[(initial - 1) + nstate * (x - 1)];
-	delete [] P;
 	if (lik <= 0) {
 	    /*
 	      Allow for some numerical imprecision that may create small
@@ -132,20 +124,17 @@ double DMState::logDensity(double const *y, PDFType type,
 static double q(double p, int initial, double time, unsigned int nstate,
 		double const *intensity)
 {
-    double *P = new double[nstate*nstate];
-    MatrixExpPade(P, intensity, nstate, time);
+    double const *P = MatrixExpCached(intensity, nstate, time);
     
     /* Categorize */
     double sump = 0.0;
     for (unsigned int j = 1; j < nstate; j++) {
 	sump += P[(initial - 1) + nstate * (j - 1)];
 	if (p <= sump) {
-	    delete [] P;
 	    return j;
 	}
     }
 
-    delete [] P;
     return nstate;
 }
 
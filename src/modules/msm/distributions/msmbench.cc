@@ -0,0 +1,151 @@
+/*
+  Benchmark for DMState with panel data.
+
+  Evaluates the log density of N observations from a 5-state Markov
+  model, in which the observations are made at a few distinct time
+  gaps. The intensity matrix is modified at each iteration, as it
+  would be by a sampler, and the benchmark reports the number of
+  iterations per second of
+
+  - DMState::logDensity, which uses the cache of transition
+    probability matrices;
+  - the previous implementation, which called MatrixExpPade for each
+    observation.
+
+  This is done for a birth-death process, which has real eigenvalues
+  so that the exponentials are calculated from one eigendecomposition
+  per iteration, and for a cyclic process, which has complex
+  eigenvalues so that each exponential is calculated by MatrixExpPade.
+  The benchmark also reports the largest difference between cached
+  and uncached transition probabilities.
+
+  Usage: msmbench [N [niter]]
+*/
+
+#include <config.h>
+
+#include "DMState.h"
+#include "matexp.h"
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+using std::vector;
+using std::cout;
+using std::endl;
+using std::atoi;
+using std::fabs;
+using std::max;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+using namespace jags;
+
+static const int NSTATE = 5;
+
+static double since(steady_clock::time_point t0)
+{
+    return duration<double>(steady_clock::now() - t0).count();
+}
+
+/* Intensity matrix of a birth-death or a cyclic process */
+static void intensity(double *Q, bool cyclic, double scale)
+{
+    for (int i = 0; i < NSTATE * NSTATE; ++i) {
+	Q[i] = 0;
+    }
+    for (int i = 0; i < NSTATE; ++i) {
+	double rate = scale * (1 + 0.1 * i);
+	int j = (i + 1) % NSTATE;
+	if (cyclic) {
+	    Q[i + NSTATE * j] = rate;
+	}
+	else {
+	    if (i + 1 < NSTATE) Q[i + NSTATE * (i + 1)] = rate;
+	    if (i > 0) Q[i + NSTATE * (i - 1)] = 0.5 * rate;
+	}
+    }
+    for (int i = 0; i < NSTATE; ++i) {
+	double sum = 0;
+	for (int j = 0; j < NSTATE; ++j) {
+	    if (j != i) sum += Q[i + NSTATE * j];
+	}
+	Q[i + NSTATE * i] = -sum;
+    }
+}
+
+static void run(unsigned int N, unsigned int niter, bool cyclic)
+{
+    msm::DMState dmstate;
+    double const times[] = {0.5, 1.0, 2.0, 5.0};
+
+    vector<double> initial(N), time(N), x(N);
+    for (unsigned int i = 0; i < N; ++i) {
+	initial[i] = 1 + i % NSTATE;
+	time[i] = times[i % 4];
+	x[i] = 1 + (i / 7) % NSTATE;
+    }
+    vector<double> Q(NSTATE * NSTATE);
+    vector<vector<unsigned long> > dims = {{1}, {1}, {NSTATE, NSTATE}};
+    vector<double const *> par(3);
+    par[2] = Q.data();
+
+    double sum = 0;
+    steady_clock::time_point t0 = steady_clock::now();
+    for (unsigned int it = 0; it < niter; ++it) {
+	intensity(Q.data(), cyclic, 1 + 0.001 * it);
+	for (unsigned int i = 0; i < N; ++i) {
+	    par[0] = &initial[i];
+	    par[1] = &time[i];
+	    sum += dmstate.logDensity(&x[i], PDF_FULL, par, dims);
+	}
+    }
+    double t = since(t0);
+    cout << (cyclic ? "Cyclic" : "Birth-death") << " process" << endl;
+    cout << "DMState::logDensity: " << niter / t << " iterations/sec"
+	 << endl;
+
+    vector<double> P(NSTATE * NSTATE);
+    double sum0 = 0;
+    t0 = steady_clock::now();
+    for (unsigned int it = 0; it < niter; ++it) {
+	intensity(Q.data(), cyclic, 1 + 0.001 * it);
+	for (unsigned int i = 0; i < N; ++i) {
+	    msm::MatrixExpPade(P.data(), Q.data(), NSTATE, time[i]);
+	    int r = static_cast<int>(initial[i]) - 1;
+	    int c = static_cast<int>(x[i]) - 1;
+	    sum0 += std::log(P[r + NSTATE * c]);
+	}
+    }
+    t = since(t0);
+    cout << "MatrixExpPade per observation (previous implementation): "
+	 << niter / t << " iterations/sec" << endl;
+
+    double maxdiff = 0;
+    for (unsigned int k = 0; k < 4; ++k) {
+	msm::MatrixExpPade(P.data(), Q.data(), NSTATE, times[k]);
+	double const *Pc = msm::MatrixExpCached(Q.data(), NSTATE, times[k]);
+	for (int i = 0; i < NSTATE * NSTATE; ++i) {
+	    maxdiff = max(maxdiff, fabs(P[i] - Pc[i]));
+	}
+    }
+    cout << "Largest difference in transition probabilities: " << maxdiff
+	 << endl;
+    cout << "Difference in total log density: " << sum - sum0 << endl;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int N = argc > 1 ? atoi(argv[1]) : 10000;
+    unsigned int niter = argc > 2 ? atoi(argv[2]) : 100;
+
+    cout << N << " observations, " << NSTATE << " states, 4 time gaps, "
+	 << niter << " iterations" << endl;
+    run(N, niter, false);
+    run(N, niter, true);
+    return 0;
+}
@@ -6,6 +6,10 @@
 #define F77_DGEMM  F77_FUNC(dgemm,DGEMM)
 #define F77_DSCAL  F77_FUNC(dscal,DSCAL)
 #define F77_DLANGE F77_FUNC(dlange,DLANGE)
+#define F77_DGEEV  F77_FUNC(dgeev,DGEEV)
+#define F77_DGETRF F77_FUNC(dgetrf,DGETRF)
+#define F77_DGETRI F77_FUNC(dgetri,DGETRI)
+#define F77_DGECON F77_FUNC(dgecon,DGECON)
 
 extern "C" {
 
@@ -18,6 +22,22 @@ extern "C" {
     
     double F77_DLANGE (const char *norm, const int *m, const int *n,
 		       const double *a, const int *lda, double *work);
+
+    void F77_DGEEV (const char *jobvl, const char *jobvr, const int *n,
+		    double *a, const int *lda, double *wr, double *wi,
+		    double *vl, const int *ldvl, double *vr, const int *ldvr,
+		    double *work, const int *lwork, int *info);
+
+    void F77_DGETRF (const int *m, const int *n, double *a, const int *lda,
+		     int *ipiv, int *info);
+
+    void F77_DGETRI (const int *n, double *a, const int *lda,
+		     const int *ipiv, double *work, const int *lwork,
+		     int *info);
+
+    void F77_DGECON (const char *norm, const int *n, const double *a,
+		     const int *lda, const double *anorm, double *rcond,
+		     double *work, int *iwork, int *info);
     
     /* BLAS routines */
 
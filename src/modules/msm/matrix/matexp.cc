@@ -14,6 +14,8 @@
 
 #include <string>
 #include <cmath>
+#include <vector>
+#include <algorithm>
 
 #include <module/ModuleError.h>
 
@@ -23,6 +25,9 @@
 using std::pow;
 using std::exp;
 using std::log;
+using std::vector;
+using std::equal;
+using std::nan;
 
 namespace jags {
 namespace msm {
@@ -204,4 +209,181 @@ MatrixExpPade(double *ExpAt, double const *A, int n, double t)
     delete [] workspace;
 }
 
+namespace {
+
+    /*
+       Transition probability matrices for one intensity matrix.
+
+       As for the factorizations in the bugs module, distributions
+       see only the values of their parameters, so entries are
+       indexed by the address of the intensity matrix and validated
+       against a copy of it. Each entry holds the exponentials for
+       the most recently used times, which in panel data are shared
+       by many observations.
+    */
+    struct ExpTime {
+	double time;
+	vector<double> P;
+	unsigned long stamp;
+    };
+
+    struct IntensityExp {
+	double const *address;  // Address of the matrix, or null if unused
+	int n;                  // Number of rows or columns
+	vector<double> value;   // Copy of the matrix
+	bool eigen;             // Is the eigendecomposition used?
+	vector<double> lambda;  // Eigenvalues
+	vector<double> V;       // Right eigenvectors
+	vector<double> Vinv;    // Inverse of V
+	vector<ExpTime> times;
+	unsigned long stamp;    // Time of last use
+	IntensityExp() : address(nullptr), n(0), eigen(false), stamp(0) {}
+    };
+
+    /* Maximum number of intensity matrices held by each thread */
+    const unsigned int NINTENSITY = 8;
+    /* Maximum number of times held for each intensity matrix */
+    const unsigned int NTIME = 32;
+    /* Minimum reciprocal condition number of V */
+    const double RCOND_MIN = 1.0E-8;
+
+    struct ExpCache {
+	IntensityExp entries[NINTENSITY];
+	unsigned long clock;
+	ExpCache() : clock(0) {}
+    };
+
+    thread_local ExpCache expCache;
+
+    /*
+       Calculates the eigendecomposition Q = V diag(lambda) V^-1.
+       Returns false if Q has complex eigenvalues or if V is too
+       close to singular for exp(Q*t) to be calculated accurately
+       from it.
+    */
+    bool decompose(IntensityExp &e)
+    {
+	int n = e.n;
+	int N = n * n;
+	vector<double> A(e.value);
+	vector<double> wi(n);
+	double vl = 0;
+	e.lambda.resize(n);
+	e.V.resize(N);
+
+	int info = 0;
+	int lwork = -1;
+	double worktest = 0;
+	F77_DGEEV("N", "V", &n, A.data(), &n, e.lambda.data(), wi.data(),
+		  &vl, &c_1, e.V.data(), &n, &worktest, &lwork, &info);
+	lwork = static_cast<int>(worktest);
+	vector<double> work(lwork);
+	F77_DGEEV("N", "V", &n, A.data(), &n, e.lambda.data(), wi.data(),
+		  &vl, &c_1, e.V.data(), &n, work.data(), &lwork, &info);
+	if (info != 0) return false;
+	for (int i = 0; i < n; ++i) {
+	    if (wi[i] != 0) return false;
+	}
+
+	e.Vinv = e.V;
+	vector<int> ipiv(n);
+	double anorm = F77_DLANGE("1", &n, &n, e.Vinv.data(), &n, nullptr);
+	F77_DGETRF(&n, &n, e.Vinv.data(), &n, ipiv.data(), &info);
+	if (info != 0) return false;
+
+	double rcond = 0;
+	vector<double> cwork(4 * n);
+	vector<int> iwork(n);
+	F77_DGECON("1", &n, e.Vinv.data(), &n, &anorm, &rcond, cwork.data(),
+		   iwork.data(), &info);
+	if (info != 0 || rcond < RCOND_MIN) return false;
+
+	lwork = -1;
+	F77_DGETRI(&n, e.Vinv.data(), &n, ipiv.data(), &worktest, &lwork,
+		   &info);
+	lwork = static_cast<int>(worktest);
+	work.resize(lwork);
+	F77_DGETRI(&n, e.Vinv.data(), &n, ipiv.data(), work.data(), &lwork,
+		   &info);
+	return info == 0;
+    }
+
+    /* Calculates exp(Q*t) = V diag(exp(lambda * t)) V^-1 */
+    void expEigen(double *P, IntensityExp const &e, double t)
+    {
+	int n = e.n;
+	vector<double> W(e.V);
+	for (int j = 0; j < n; ++j) {
+	    double ej = exp(e.lambda[j] * t);
+	    for (int i = 0; i < n; ++i) {
+		W[MI(i, j, n)] *= ej;
+	    }
+	}
+	double one = 1, zero = 0;
+	F77_DGEMM("n", "n", &n, &n, &n, &one, W.data(), &n, e.Vinv.data(), &n,
+		  &zero, P, &n);
+    }
+
+}
+
+double const *MatrixExpCached(double const *mat, int n, double t)
+{
+    ExpCache &cache = expCache;
+    int N = n * n;
+
+    IntensityExp *e = nullptr;
+    for (unsigned int i = 0; i < NINTENSITY; ++i) {
+	IntensityExp &f = cache.entries[i];
+	if (f.address == mat && f.n == n) {
+	    e = &f;
+	    break;
+	}
+    }
+    if (e == nullptr || !equal(mat, mat + N, e->value.begin())) {
+	if (e == nullptr) {
+	    //Replace the least recently used matrix
+	    e = &cache.entries[0];
+	    for (unsigned int i = 1; i < NINTENSITY; ++i) {
+		if (cache.entries[i].stamp < e->stamp) {
+		    e = &cache.entries[i];
+		}
+	    }
+	}
+	e->address = mat;
+	e->n = n;
+	e->value.assign(mat, mat + N);
+	e->times.clear();
+	e->eigen = decompose(*e);
+    }
+    e->stamp = ++cache.clock;
+
+    ExpTime *et = nullptr;
+    for (unsigned int i = 0; i < e->times.size(); ++i) {
+	if (e->times[i].time == t) {
+	    e->times[i].stamp = cache.clock;
+	    return e->times[i].P.data();
+	}
+	if (et == nullptr || e->times[i].stamp < et->stamp) {
+	    et = &e->times[i];
+	}
+    }
+    if (e->times.size() < NTIME) {
+	e->times.push_back(ExpTime());
+	et = &e->times.back();
+    }
+    //The time is set after the calculation, which may throw an
+    //exception, so that the entry never holds an invalid result
+    et->time = nan("");
+    et->stamp = cache.clock;
+    et->P.resize(N);
+    if (e->eigen) {
+	expEigen(et->P.data(), *e, t);
+    }
+    else {
+	MatrixExpPade(et->P.data(), mat, n, t);
+    }
+    et->time = t;
+    return et->P.data();
+}
+
 }}
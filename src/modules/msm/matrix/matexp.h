@@ -6,6 +6,18 @@ namespace msm {
 
 void MatrixExp(double *expmat, double const *mat, int n, double t);
 void MatrixExpPade(double *expmat, double const *mat, int n, double t);
+/*
+ * Returns exp(mat * t) for the n x n intensity matrix mat. Results are
+ * cached by each thread, so repeated calls with the same matrix and
+ * time do not recalculate the exponential. If mat has real eigenvalues
+ * and is well-conditioned for diagonalisation, one eigendecomposition
+ * is shared by all times. Otherwise the exponential is calculated by
+ * MatrixExpPade.
+ *
+ * The returned pointer is valid until the next call from the same
+ * thread.
+ */
+double const *MatrixExpCached(double const *mat, int n, double t);
 
 }}
 
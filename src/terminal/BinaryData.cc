@@ -0,0 +1,186 @@
+#include <config.h>
+#include "BinaryData.h"
+#include <util/binaryio.h>
+
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+using std::cerr;
+using std::endl;
+using std::map;
+using std::string;
+using std::vector;
+using std::ofstream;
+using std::ios;
+using std::runtime_error;
+using std::memcpy;
+using std::memcmp;
+using std::uint64_t;
+using std::piecewise_construct;
+using std::forward_as_tuple;
+
+using jags::SArray;
+using jags::MappedFile;
+using jags::putInt;
+using jags::putString;
+using jags::getInt;
+using jags::getString;
+using jags::alignOffset;
+
+static const char DATA_MAGIC[8] = {'J','A','G','S','D','A','T','\0'};
+static const uint64_t DATA_BYTE_ORDER = 0x0102030405060708ULL;
+static const uint64_t DATA_VERSION = 1;
+
+/* Serialization of the header */
+
+static string writeHeader(map<string, SArray> const &table,
+			  string const &rngname,
+			  vector<unsigned long> const &offsets)
+{
+    string out(DATA_MAGIC, sizeof(DATA_MAGIC));
+    putInt(DATA_BYTE_ORDER, out);
+    putInt(DATA_VERSION, out);
+    putString(rngname, out);
+    putInt(table.size(), out);
+
+    unsigned int i = 0;
+    for (map<string, SArray>::const_iterator p = table.begin();
+	 p != table.end(); ++p, ++i)
+    {
+	putString(p->first, out);
+	vector<unsigned long> const &dim = p->second.dim(false);
+	putInt(dim.size(), out);
+	for (unsigned int j = 0; j < dim.size(); ++j) {
+	    putInt(dim[j], out);
+	}
+	putInt(offsets[i], out);
+    }
+    return out;
+}
+
+bool writeBinaryData(string const &file, map<string, SArray> const &table,
+		     string const &rngname)
+{
+    /*
+       The size of the header does not depend on the offsets, so we
+       can calculate them from a header with dummy offsets.
+    */
+    vector<unsigned long> offsets(table.size(), 0);
+    unsigned long offset = alignOffset(writeHeader(table, rngname, offsets).size());
+    unsigned long start = offset;
+    unsigned int i = 0;
+    for (map<string, SArray>::const_iterator p = table.begin();
+	 p != table.end(); ++p, ++i)
+    {
+	offsets[i] = offset;
+	offset += p->second.value().size() * sizeof(double);
+    }
+    string header = writeHeader(table, rngname, offsets);
+
+    ofstream out(file.c_str(), ios::binary);
+    if (!out) {
+	cerr << "Failed to open file " << file << endl;
+	return false;
+    }
+    out.write(header.data(), header.size());
+    string padding(start - header.size(), '\0');
+    out.write(padding.data(), padding.size());
+    for (map<string, SArray>::const_iterator p = table.begin();
+	 p != table.end(); ++p)
+    {
+	vector<double> const &value = p->second.value();
+	out.write(reinterpret_cast<char const*>(value.data()),
+		  value.size() * sizeof(double));
+    }
+    out.close();
+    if (!out) {
+	cerr << "Failed to write file " << file << endl;
+	return false;
+    }
+    return true;
+}
+
+bool isBinaryData(char const *header, unsigned long size)
+{
+    return size >= sizeof(DATA_MAGIC) &&
+	memcmp(header, DATA_MAGIC, sizeof(DATA_MAGIC)) == 0;
+}
+
+/* Reader */
+
+static void readTable(char const *data, unsigned long size,
+		      map<string, SArray> &table, string &rngname)
+{
+    unsigned long pos = 0;
+    if (!isBinaryData(data, size)) {
+	throw runtime_error("Not a binary data file");
+    }
+    pos += sizeof(DATA_MAGIC);
+    if (getInt(data, size, pos) != DATA_BYTE_ORDER) {
+	throw runtime_error("File was written with a different byte order");
+    }
+    if (getInt(data, size, pos) != DATA_VERSION) {
+	throw runtime_error("Unsupported version");
+    }
+    rngname = getString(data, size, pos);
+    uint64_t narray = getInt(data, size, pos);
+    for (uint64_t i = 0; i < narray; ++i) {
+	string name = getString(data, size, pos);
+	uint64_t ndim = getInt(data, size, pos);
+	if (ndim == 0 || ndim > size) {
+	    throw runtime_error(string("Invalid dimension for variable ") +
+				name);
+	}
+	vector<unsigned long> dim(ndim);
+	unsigned long length = 1;
+	for (uint64_t j = 0; j < ndim; ++j) {
+	    dim[j] = getInt(data, size, pos);
+	    if (dim[j] == 0 || dim[j] > size / sizeof(double)) {
+		throw runtime_error(string("Invalid dimension for variable ")
+				    + name);
+	    }
+	    length *= dim[j];
+	    if (length > size / sizeof(double)) {
+		throw runtime_error(string("Truncated data for variable ") +
+				    name);
+	    }
+	}
+	uint64_t offset = getInt(data, size, pos);
+	if (offset % sizeof(double) != 0 || offset > size ||
+	    length > (size - offset) / sizeof(double))
+	{
+	    throw runtime_error(string("Truncated data for variable ") + name);
+	}
+
+	map<string, SArray>::iterator p = table.find(name);
+	if (p != table.end()) {
+	    cerr << "WARNING: Replacing " << name << endl;
+	    table.erase(p);
+	}
+	vector<double> value(length);
+	memcpy(value.data(), data + offset, length * sizeof(double));
+	p = table.emplace(piecewise_construct, forward_as_tuple(name),
+			  forward_as_tuple(dim)).first;
+	p->second.setValue(std::move(value));
+    }
+}
+
+bool readBinaryData(string const &file, map<string, SArray> &table,
+		    string &rngname)
+{
+    try {
+	MappedFile data(file);
+	readTable(data.data(), data.size(), table, rngname);
+    }
+    catch (runtime_error const &except) {
+	cerr << "Error reading binary data file " << file << ": "
+	     << except.what() << endl;
+	return false;
+    }
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef BINARY_DATA_H_
+#define BINARY_DATA_H_
+
+#include <map>
+#include <string>
+#include <sarray/SArray.h>
+
+/*
+ * Binary data files hold a table of arrays, like a file in R dump
+ * format, but without the need to parse numbers. All integers in the
+ * header are unsigned 64-bit values and each string is stored as its
+ * length followed by its characters:
+ *
+ * - The 8 characters "JAGSDAT" followed by a null
+ * - The value 0x0102030405060708, which identifies the byte order
+ * - The file format version
+ * - The name of the random number generator (may be empty)
+ * - The number of arrays
+ *
+ * This is followed by a record for each array containing its name,
+ * number of dimensions, dimensions, and the byte offset of its values
+ * from the start of the file. The values are 64-bit floating point
+ * numbers in column-major order. Offsets are multiples of 8 so that
+ * the values are aligned when the file is mapped into memory.
+ */
+
+/*
+ * Tests whether the first bytes of a file identify a binary data file
+ */
+bool isBinaryData(char const *header, unsigned long size);
+
+/*
+ * Reads a binary data file. See readData.
+ */
+bool readBinaryData(std::string const &file,
+		    std::map<std::string, jags::SArray> &table,
+		    std::string &rngname);
+
+/*
+ * Writes a table of arrays to a binary data file. Returns false, after
+ * printing an error message, if the file cannot be written.
+ */
+bool writeBinaryData(std::string const &file,
+		     std::map<std::string, jags::SArray> const &table,
+		     std::string const &rngname);
+
+#endif /* BINARY_DATA_H_ */
@@ -1,176 +1,530 @@
-#include <model/NodeArray.h>
 #include "ReadData.h"
+#include "BinaryData.h"
 #include <sarray/SArray.h>
+#include <util/nainf.h>
 
 #include <iostream>
 #include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <tuple>
+#include <utility>
 
-using std::cout;
 using std::cerr;
 using std::endl;
 
 using std::map;
 using std::string;
 using std::vector;
+using std::FILE;
+using std::fopen;
+using std::fclose;
+using std::fread;
+using std::strtod;
+using std::piecewise_construct;
+using std::forward_as_tuple;
 
 using jags::SArray;
-using jags::ParseTree;
-using jags::P_VAR;
-using jags::P_VECTOR;
-using jags::P_ARRAY;
-using jags::P_RANGE;
-
-bool readRData(vector<ParseTree*> const *array_list, 
-	       map<string, SArray> &table,
-	       string &rngname)
-{
-    /* Check validity of expressions */
-    for (vector<ParseTree*>::const_iterator p = array_list->begin(); 
-	 p != array_list->end(); ++p) 
-      {
-	if ((*p)->treeClass() == P_VAR) {
-	  /*
-	    Assignments of the form "foo" <- "bar" The only type
-	    currently allowed is ".RNG.name" <- "bar"
-	  */
-	  if ((*p)->name() != ".RNG.name") {
-	    cout << "Unrecognized string assignment. "
-		 << "Expecting \".RNG.name\"";
+
+namespace {
+
+    enum Token {T_NAME, T_STRING, T_NUMBER, T_ARROW, T_LPAREN, T_RPAREN,
+		T_COMMA, T_EQUALS, T_COLON, T_SEMICOLON, T_EOF, T_ERROR};
+
+    /*
+       Streaming reader for files in R dump format.
+
+       The file is read in blocks and scanned one token at a time.
+       Numbers are converted as soon as they are scanned and appended
+       to the value array of the current variable, which becomes the
+       storage of the SArray in the data table. This avoids building
+       a parse tree with one node per value, which takes time and
+       memory proportional to a large multiple of the size of the
+       data.
+
+       The accepted syntax is the same as the previous bison
+       grammar, which only recognizes the ".Dim" attribute of a
+       structure and skips any others. In addition, the special values
+       Inf, -Inf and NaN, which are written by the "data to" and
+       "parameters to" commands, may be read back.
+    */
+    class RDumpReader {
+	FILE *_file;
+	vector<char> _buffer;
+	unsigned long _pos;
+	unsigned long _end;
+	unsigned long _line;
+	unsigned long _tokline;
+	unsigned long _errline;
+	Token _token;
+	string _text;
+	double _number;
+	string _error;
+
+	int peekChar();
+	int getChar();
+	Token next();
+	bool expect(Token token, char const *what);
+	bool fail(string const &message);
+	bool fail(string const &message, unsigned long line);
+	bool readName(string &name);
+	bool readNumbers(vector<double> &values);
+	bool readCollection(vector<double> &values);
+	bool readDim(vector<unsigned long> &dim);
+	bool skipValue();
+	bool readAssignment(map<string, SArray> &table, string &rngname);
+    public:
+	RDumpReader(FILE *file);
+	bool read(map<string, SArray> &table, string &rngname);
+	string const &error() const;
+	unsigned long line() const;
+    };
+
+    /* Size of the blocks in which the file is read */
+    const unsigned long BLOCK_SIZE = 65536;
+    /* Longest numeric token */
+    const unsigned long MAX_NUMBER = 64;
+
+    RDumpReader::RDumpReader(FILE *file)
+	: _file(file), _buffer(BLOCK_SIZE), _pos(0), _end(0), _line(1),
+	  _tokline(1), _errline(1), _token(T_EOF), _number(0)
+    {
+    }
+
+    inline int RDumpReader::peekChar()
+    {
+	if (_pos == _end) {
+	    _end = fread(&_buffer[0], 1, _buffer.size(), _file);
+	    _pos = 0;
+	    if (_end == 0) return EOF;
+	}
+	return static_cast<unsigned char>(_buffer[_pos]);
+    }
+
+    inline int RDumpReader::getChar()
+    {
+	int c = peekChar();
+	if (c != EOF) {
+	    ++_pos;
+	    if (c == '\n') ++_line;
+	}
+	return c;
+    }
+
+    static inline bool isNameChar(int c)
+    {
+	return std::isalnum(c) || c == '.' || c == '_';
+    }
+
+    static inline bool isNumberChar(int c)
+    {
+	return std::isdigit(c) || c == '.' || c == 'e' || c == 'E' ||
+	    c == '+' || c == '-';
+    }
+
+    Token RDumpReader::next()
+    {
+	int c = getChar();
+	for (;;) {
+	    if (c == '#') {
+		while (c != '\n' && c != EOF) c = getChar();
+	    }
+	    else if (std::isspace(c)) {
+		c = getChar();
+	    }
+	    else {
+		break;
+	    }
+	}
+	_tokline = _line;
+
+	switch (c) {
+	case EOF: return _token = T_EOF;
+	case '(': return _token = T_LPAREN;
+	case ')': return _token = T_RPAREN;
+	case ',': return _token = T_COMMA;
+	case '=': return _token = T_EQUALS;
+	case ':': return _token = T_COLON;
+	case ';': return _token = T_SEMICOLON;
+	case '<':
+	    if (peekChar() == '-') {
+		getChar();
+		return _token = T_ARROW;
+	    }
+	    return _token = T_ERROR;
+	case '"': case '\'': case '`':
+	{
+	    // Quoted string or name
+	    int quote = c;
+	    _text.clear();
+	    for (c = getChar(); c != quote; c = getChar()) {
+		if (c == EOF) return _token = T_ERROR;
+		_text.push_back(static_cast<char>(c));
+	    }
+	    return _token = (quote == '`') ? T_NAME : T_STRING;
+	}
+	}
+
+	bool negative = false;
+	if (c == '-') {
+	    negative = true;
+	    c = getChar();
+	}
+
+	if (std::isdigit(c) || (c == '.' && std::isdigit(peekChar()))) {
+	    char buf[MAX_NUMBER + 2];
+	    unsigned long n = 0;
+	    if (negative) buf[n++] = '-';
+	    buf[n++] = static_cast<char>(c);
+	    int prev = c;
+	    for (c = peekChar(); isNumberChar(c); c = peekChar()) {
+		if ((c == '+' || c == '-') && prev != 'e' && prev != 'E') {
+		    break;
+		}
+		if (n == MAX_NUMBER) return _token = T_ERROR;
+		buf[n++] = static_cast<char>(getChar());
+		prev = c;
+	    }
+	    buf[n] = '\0';
+	    if (c == 'L') {
+		// Integer value
+		getChar();
+	    }
+	    char *end = nullptr;
+	    _number = strtod(buf, &end);
+	    return _token = (end == buf + n) ? T_NUMBER : T_ERROR;
+	}
+	else if (std::isalpha(c) || c == '.') {
+	    _text.assign(1, static_cast<char>(c));
+	    for (c = peekChar(); isNameChar(c); c = peekChar()) {
+		_text.push_back(static_cast<char>(getChar()));
+	    }
+	    if (_text == "Inf") {
+		_number = negative ? JAGS_NEGINF : JAGS_POSINF;
+		return _token = T_NUMBER;
+	    }
+	    else if (negative) {
+		return _token = T_ERROR;
+	    }
+	    else if (_text == "NA") {
+		_number = JAGS_NA;
+		return _token = T_NUMBER;
+	    }
+	    else if (_text == "NaN") {
+		_number = JAGS_NAN;
+		return _token = T_NUMBER;
+	    }
+	    return _token = T_NAME;
+	}
+	return _token = T_ERROR;
+    }
+
+    bool RDumpReader::fail(string const &message)
+    {
+	return fail(message, _tokline);
+    }
+
+    bool RDumpReader::fail(string const &message, unsigned long line)
+    {
+	/* Records the first error and the line of the current token,
+	   or of the given line */
+	if (_error.empty()) {
+	    _error = (_token == T_ERROR) ? string("Syntax error") : message;
+	    _errline = line;
+	}
+	return false;
+    }
+
+    bool RDumpReader::expect(Token token, char const *what)
+    {
+	if (_token != token) {
+	    return fail(string("Expected ") + what);
+	}
+	next();
+	return true;
+    }
+
+    bool RDumpReader::readName(string &name)
+    {
+	if (_token != T_NAME && _token != T_STRING) {
+	    return fail("Expected variable name");
+	}
+	name = _text;
+	next();
+	return true;
+    }
+
+    bool RDumpReader::readNumbers(vector<double> &values)
+    {
+	/* Reads a comma-separated list of numbers */
+	for (;;) {
+	    if (_token != T_NUMBER) {
+		return fail("Expected numeric value");
+	    }
+	    values.push_back(_number);
+	    if (next() != T_COMMA) break;
+	    next();
+	}
+	return true;
+    }
+
+    bool RDumpReader::readCollection(vector<double> &values)
+    {
+	/* A number, or a vector c(...), optionally inside as.integer() */
+	if (_token == T_NUMBER) {
+	    values.push_back(_number);
+	    next();
+	    return true;
+	}
+	else if (_token == T_NAME && _text == "as.integer") {
+	    next();
+	    return expect(T_LPAREN, "(") && readCollection(values) &&
+		expect(T_RPAREN, ")");
+	}
+	else if (_token == T_NAME && _text == "c") {
+	    next();
+	    return expect(T_LPAREN, "(") && readNumbers(values) &&
+		expect(T_RPAREN, ")");
+	}
+	return fail("Expected numeric value");
+    }
+
+    bool RDumpReader::readDim(vector<unsigned long> &dim)
+    {
+	vector<double> d;
+	if (_token == T_NUMBER) {
+	    // R dump can store a contiguous integer sequence using the
+	    // ":" notation e.g. c(3,4,5) is written 3:5
+	    double lower = _number;
+	    if (next() == T_COLON) {
+		if (next() != T_NUMBER) {
+		    return fail("Expected numeric value");
+		}
+		double upper = _number;
+		next();
+		if (lower < 0 || upper <= lower) {
+		    return fail("Invalid sequence in dimension attribute");
+		}
+		for (double x = lower; x <= upper; ++x) {
+		    d.push_back(x);
+		}
+	    }
+	    else {
+		d.push_back(lower);
+	    }
+	}
+	else if (!readCollection(d)) {
 	    return false;
-	  }
-		
-	  if (((*p)->parameters().size() != 1) ||
-	      ((*p)->parameters()[0]->treeClass() != P_VAR)) 
-	    {
-	      cout << "Invalid .RNG.name";
-	      return false;
+	}
+
+	dim.resize(d.size());
+	for (unsigned long i = 0; i < d.size(); ++i) {
+	    if (!(d[i] > 0)) {
+		return fail("Non-positive dimension");
 	    }
-	      
-	  rngname = (*p)->parameters()[0]->name();
+	    dim[i] = static_cast<unsigned long>(d[i]);
 	}
-	else if ((*p)->treeClass() != P_ARRAY) {
-	  cout << "Error reading S data.";
-	  return false;
+	return true;
+    }
+
+    bool RDumpReader::skipValue()
+    {
+	/*
+	   Skips the value of an attribute other than .Dim. This may be
+	   a number, string, NULL, or a call such as c(...), list(...)
+	   or structure(...), which is skipped up to the matching
+	   bracket.
+	*/
+	if (_token != T_NAME && _token != T_STRING && _token != T_NUMBER) {
+	    return fail("Invalid attribute");
+	}
+	if (next() != T_LPAREN) {
+	    return true;
+	}
+	for (unsigned long depth = 1; depth > 0; ) {
+	    switch (next()) {
+	    case T_LPAREN:
+		++depth;
+		break;
+	    case T_RPAREN:
+		--depth;
+		break;
+	    case T_EOF: case T_ERROR:
+		return fail("Unterminated attribute");
+	    default:
+		break;
+	    }
 	}
-      }  
+	next();
+	return true;
+    }
 
-    for (vector<ParseTree*>::const_iterator p = array_list->begin(); 
-	 p != array_list->end(); ++p) 
-	{
-	  if ((*p)->treeClass() == P_VAR) {
-	    /* Skip any string assignments and break if one comes
-	       at the end */
-	    ++p;
-	    if (p == array_list->end())
-	      break;
-	  }
-
-	  string const &name = (*p)->name();
-
-	  /* Check to see if name is already in table */
-	  if (table.find(name) != table.end()) {
+    bool RDumpReader::readAssignment(map<string, SArray> &table,
+				     string &rngname)
+    {
+	string name;
+	unsigned long line = _tokline;
+	if (!readName(name) || !expect(T_ARROW, "<-")) {
+	    return false;
+	}
+
+	if (_token == T_STRING) {
+	    /*
+	      Assignments of the form "foo" <- "bar" The only type
+	      currently allowed is ".RNG.name" <- "bar"
+	    */
+	    if (name != ".RNG.name") {
+		return fail("Unrecognized string assignment. "
+			    "Expecting \".RNG.name\"");
+	    }
+	    rngname = _text;
+	    next();
+	    return true;
+	}
+
+	vector<double> values;
+	vector<unsigned long> dim;
+	if (_token == T_NAME && _text == "structure") {
+	    next();
+	    if (!expect(T_LPAREN, "(")) return false;
+	    if (_token == T_NAME && _text == ".Data") {
+		next();
+		if (!expect(T_EQUALS, "=")) return false;
+	    }
+	    if (!readCollection(values)) return false;
+	    while (_token == T_COMMA) {
+		next();
+		if (_token != T_NAME) {
+		    return fail("Expected attribute name");
+		}
+		bool isdim = _text == ".Dim";
+		next();
+		if (!expect(T_EQUALS, "=")) return false;
+		if (isdim) {
+		    if (!readDim(dim)) return false;
+		}
+		else if (!skipValue()) {
+		    return false;
+		}
+	    }
+	    if (!expect(T_RPAREN, ")")) return false;
+	}
+	else if (!readCollection(values)) {
+	    return false;
+	}
+
+	/* Check that dimension is consistent with length */
+	if (dim.empty()) {
+	    dim.push_back(values.size());
+	}
+	else {
+	    unsigned long dimprod = 1;
+	    for (unsigned long i = 0; i < dim.size(); ++i) {
+		dimprod *= dim[i];
+	    }
+	    if (dimprod != values.size()) {
+		return fail(string("Bad dimension for variable ") + name, line);
+	    }
+	}
+
+	/* Check to see if name is already in table */
+	map<string, SArray>::iterator p = table.find(name);
+	if (p != table.end()) {
 	    cerr << "WARNING: Replacing " << name << endl;
-	    table.erase(table.find(name));
-	  }
-
-	  /* Get the length of the data */
-	  ParseTree const *vec = (*p)->parameters()[0]; 
-	  unsigned long length = vec->parameters().size();
-    
-	  /* Get the number of dimensions of the array */
-	  ParseTree const *pdim = nullptr;
-	  unsigned long ndim = 1;
-	  if ((*p)->parameters().size() == 2) {
-	      // Array has dimension attribute
-	      pdim = (*p)->parameters()[1];
-	      if (pdim->treeClass() == P_VECTOR) {
-		  ndim = pdim->parameters().size();
-	      }
-	      else if (pdim->treeClass() == P_RANGE) {
-		  // R dump can store a contiguous integer sequence
-		  // using the ":" notation e.g. c(3,4,5) is written 3:5
-		  double lower = pdim->parameters()[0]->value();
-		  double upper = pdim->parameters()[1]->value();
-		  if (lower < 0 || upper <= lower) {
-		      cerr << "Invalid sequence " << name << " = " << lower << ":" << upper << endl;
-		      return false;
-		  }
-		  ndim = static_cast<unsigned long>(upper - lower + 1);
-	      }
-	      else {
-		  cerr << "Invalid dimension attribute for variable " << name << endl;
-		  return false;
-	      }
-	  }
-	  /* Get the dimensions of the array */
-	  vector<unsigned long> dim(ndim);
-	  if (pdim) {
-	      if (pdim->treeClass() == P_VECTOR) {
-		  for (unsigned long i = 0; i < ndim; ++i) {
-		      double dim_i = pdim->parameters()[i]->value();
-		      if (dim_i <= 0) {
-			  cerr << "Non-positive dimension for variable "
-			       << name << endl; 
-			  return false;
-		      }
-		      dim[i] = static_cast<unsigned long>(dim_i);
-		  }
-	      }
-	      else if (pdim->treeClass() == P_RANGE) {
-		  double lower = pdim->parameters()[0]->value();
-		  for (unsigned long i = 0; i < ndim; ++i) {
-		      dim[i] = static_cast<unsigned long>(lower + i);
-		  }
-	      }
-	      /* Check that dimension is consistent with length */
-	      unsigned long dimprod = 1;
-	      for (unsigned long i = 0; i < ndim; i++) {
-		  dimprod *= dim[i];
-	      }
-	      if (dimprod != length) {
-		  cerr << "Bad dimension for variable " << name << endl;
-		  return false;
-	      }
-	  }
-	  else {
-	      dim[0] = length;
-	  }
-
-	  /* Get the data */
-	  vector<double> values(length);
-	  for (unsigned long i = 0; i < length; ++i) {
-	    values[i] = vec->parameters()[i]->value();
-	  }
-
-	  /* Now assign it to an SArray */
-	  SArray sarray(dim);
-	  sarray.setValue(values);
-    
-	  /* Since there is no default constructor for SArray, we can't
-	     use the shorthand table[names[i]] = par;
-	  */
-	  table.insert(map<string, SArray>::value_type(name, sarray));
-
-	  /*
-	    std::cout << "Reading " << name << "[";
-	    for(unsigned int j = 0; j < dim.length(); j++) {
-	    if (j > 0) {
-	    std::cout << ",";
-	    }
-	    std::cout << dim[j];
-	    }
-	    std::cout << "]" << std::endl;
-	  */
+	    table.erase(p);
 	}
-    return true;
-}
 
+	/*
+	  Since there is no default constructor for SArray, we can't
+	  use the shorthand table[name] = ...
+	*/
+	p = table.emplace(piecewise_construct, forward_as_tuple(name),
+			  forward_as_tuple(dim)).first;
+	p->second.setValue(std::move(values));
+	return true;
+    }
 
+    bool RDumpReader::read(map<string, SArray> &table, string &rngname)
+    {
+	next();
+	while (_token != T_EOF) {
+	    if (!readAssignment(table, rngname)) {
+		return false;
+	    }
+	    if (_token == T_SEMICOLON) {
+		next();
+	    }
+	}
+	return true;
+    }
 
+    string const &RDumpReader::error() const
+    {
+	return _error;
+    }
 
+    unsigned long RDumpReader::line() const
+    {
+	return _errline;
+    }
 
+}
 
+static bool readFile(string const &file, map<string, SArray> &table,
+		     string &rngname)
+{
+    FILE *fp = fopen(file.c_str(), "rb");
+    if (!fp) {
+	cerr << "Unable to open file " << file << endl;
+	return false;
+    }
 
+    char header[8];
+    unsigned long n = fread(header, 1, sizeof(header), fp);
+    if (isBinaryData(header, n)) {
+	fclose(fp);
+	return readBinaryData(file, table, rngname);
+    }
+    rewind(fp);
 
+    RDumpReader reader(fp);
+    bool ok = reader.read(table, rngname);
+    if (!ok) {
+	cerr << "Error reading " << file << " at line " << reader.line()
+	     << ": " << reader.error() << endl;
+    }
+    fclose(fp);
+    return ok;
+}
 
+bool readData(string const &file, map<string, SArray> &table,
+	      string &rngname)
+{
+    /*
+       The file is read into a new table, which is merged into the
+       given table only if the whole file was read, so that a file
+       with an error leaves no partial values behind.
+    */
+    map<string, SArray> values;
+    string name;
+    if (!readFile(file, values, name)) {
+	return false;
+    }
 
+    for (map<string, SArray>::iterator p = values.begin();
+	 p != values.end(); ++p)
+    {
+	map<string, SArray>::iterator q = table.find(p->first);
+	if (q != table.end()) {
+	    cerr << "WARNING: Replacing " << p->first << endl;
+	    table.erase(q);
+	}
+	table.emplace(p->first, std::move(p->second));
+    }
+    if (!name.empty()) {
+	rngname = name;
+    }
+    return true;
+}
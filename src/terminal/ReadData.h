@@ -3,11 +3,20 @@
 
 #include <map>
 #include <string>
-#include <compiler/ParseTree.h>
 #include <sarray/SArray.h>
 
-bool readRData(std::vector<jags::ParseTree*> const *r_assignment_list, 
-	       std::map<std::string, jags::SArray> &table,
-               std::string &rngname);
+/*
+ * Reads a file of data or parameter values into table. The file may
+ * be in R dump format, or in the binary format written by
+ * writeBinaryData, which is recognized from its first bytes. The name
+ * of the random number generator, if given by an assignment to
+ * ".RNG.name", is written to rngname.
+ *
+ * Returns false, after printing an error message, if the file cannot
+ * be read. In that case table and rngname are not modified.
+ */
+bool readData(std::string const &file,
+	      std::map<std::string, jags::SArray> &table,
+	      std::string &rngname);
 
 #endif /* READ_DATA_H_ */
@@ -42,6 +42,7 @@
 #include <compiler/Compiler.h>
 
 #include "ReadData.h"
+#include "BinaryData.h"
 
     typedef void(*pt2Func)();
 
@@ -55,15 +56,14 @@
     void setName(jags::ParseTree *p, std::string *name);
     std::map<std::string, jags::SArray> _data_table;
     std::deque<lt_dlhandle> _dyn_lib;
-    bool open_data_buffer(std::string const *name);
     bool open_command_buffer(std::string const *name);
     void return_to_main_buffer();
-    void setMonitor(jags::ParseTree const *var, int thin, std::string const &type);
+    void setMonitor(jags::ParseTree const *var, int thin, std::string const &type, std::string const &stem = "CODA");
     void clearMonitor(jags::ParseTree const *var, std::string const &type);
-    void doCoda (jags::ParseTree const *var, std::string const &stem, std::string const &type);
-    void doAllCoda (std::string const &stem, std::string const &type);
+    void doCoda (jags::ParseTree const *var, std::string const &stem, std::string const &type, std::string const &format = "coda");
+    void doAllCoda (std::string const &stem, std::string const &type, std::string const &format = "coda");
     void dumpNodeNames (std::string const &file, std::string const &type);
-    void doDump (std::string const &file, jags::ValueType type, unsigned int chain);
+    void doDump (std::string const &file, jags::ValueType type, unsigned int chain, std::string const &format = "rdump");
     void dumpMonitors(std::string const &file, std::string const &type);
     void doSystem(std::string const *command);
     std::string ExpandFileName(char const *s);
@@ -80,12 +80,16 @@
     static void loadModule(std::string const &name);
     static void unloadModule(std::string const &name);
     static void dumpSamplers(std::string const &file);
-    static void delete_pvec(std::vector<jags::ParseTree*> *);
+    static void readDataFile(std::string const &file);
+    static void readParameterFile(std::string const &file, unsigned int chain);
     static void print_unused_variables(std::map<std::string, jags::SArray> const &table, bool data);
     static void listFactories(jags::FactoryType type);
 	static void listModules();
     static void setFactory(std::string const &name, jags::FactoryType type,
                            std::string const &status);
+    static void setFactoryOption(std::string const &name,
+                                 jags::FactoryType type,
+                                 std::string const &option, int value);
     static void setSeed(unsigned int seed);
     static bool Jtry(bool ok);
 	// Needed for update (and adapt) functions to dump variable states:
@@ -137,6 +141,7 @@
 %token <intval> THIN
 %token <intval> CODA
 %token <intval> STEM
+%token <intval> FORMAT
 %token <intval> EXIT
 %token <intval> NCHAINS
 %token <intval> CHAIN
@@ -151,16 +156,8 @@
 %token <intval> SEED;
 
 %token <intval> LIST 
-%token <intval> STRUCTURE
-%token <intval> DIM
-%token <intval> NA
-%token <intval> R_NULL
 %token <intval> DIMNAMES
 %token <intval> ITER
-%token <intval> ARROW
-%token <intval> ENDDATA
-%token <intval> ASINTEGER
-%token <intval> DOTDATA
 
 %token <intval> DIRECTORY
 %token <intval> CD
@@ -169,14 +166,9 @@
 %token <intval> ENDSCRIPT
 
 %type <ptree> var index 
-%type <ptree> r_assignment r_structure
-%type <ptree> range_element r_dim
-%type <ptree> r_attribute_list
-%type <ptree> r_value 
-%type <pvec>  r_value_list r_assignment_list range_list
-%type <ptree> r_value_collection r_integer_collection r_collection r_data
+%type <ptree> range_element
+%type <pvec>  range_list
 %type <stringptr> file_name;
-%type <stringptr> r_name;
 
 %%
 
@@ -225,6 +217,8 @@ command: model
 | list_modules
 | set_factory
 | set_seed
+| set_threads
+| set_plates
 ;
 
 model: MODEL IN file_name {
@@ -244,36 +238,21 @@ model: MODEL IN file_name {
  }
 ;
 
-data_in: data r_assignment_list ENDDATA {
-    std::string rngname;
-    readRData($2, _data_table, rngname);
-    if (rngname.size() != 0) {
-	std::cerr << "WARNING: .RNG.name assignment ignored" << std::endl;
-    }
-    delete_pvec($2);
+data_in: DATA IN file_name {
+    std::cout << "Reading data file " << *$3 << std::endl;
+    readDataFile(*$3);
+    delete $3;
  }
-| data {
-    // Failed to open the data file 
-    if (!interactive) exit(1);
-  }    
 ;
 
 data_to: DATA TO file_name {
     doDump(*$3, jags::DATA_VALUES, 1);
     delete $3;
 }
-;
-
-data: DATA IN file_name {
-    if(open_data_buffer($3)) {
-	std::cout << "Reading data file " << *$3 << std::endl;
-    }
-    else {
-	std::cerr << "Unable to open file " << *$3 << std::endl << std::flush;
-	if (!interactive) exit(1);
-    }
-    delete $3;
- }
+| DATA TO file_name ',' FORMAT '(' NAME ')' {
+    doDump(*$3, jags::DATA_VALUES, 1, *$7);
+    delete $3; delete $7;
+}
 ;
 
 data_clear: DATA CLEAR {
@@ -282,47 +261,27 @@ data_clear: DATA CLEAR {
 }
 ;
 
-parameters_in: parameters r_assignment_list ENDDATA
-{
-    std::map<std::string, jags::SArray> parameter_table;
-    std::string rngname;
-    readRData($2, parameter_table, rngname);
-    delete_pvec($2);
-    /* Set all chains to the same state. If the user sets the
-       RNG state in addition to the parameter values then all
-       chains will be identical!
-    */
-    if (console->model() == 0) {
-	std::cout << "ERROR: Initial values ignored. "
-		  <<  "(You must compile the model first)" << std::endl;
-	if (!interactive) exit(1);
-    }
-    for (unsigned int i = 1; i <= console->nchain(); ++i) {
-	/* We have to set the name first, because the state or seed
-	   might be embedded in the parameter_table */
-	if (rngname.size() != 0) {
-	    Jtry(console->setRNGname(rngname, i));
-	}
-	Jtry(console->setParameters(parameter_table, i));
-    }
-    print_unused_variables(parameter_table, false);
-
+parameters_in: PARAMETERS IN file_name {
+    std::cout << "Reading parameter file " << *$3 << std::endl;
+    readParameterFile(*$3, 0);
+    delete $3;
 }
-| parameters r_assignment_list ENDDATA ',' CHAIN '(' INT ')' 
-{
-    std::map<std::string, jags::SArray> parameter_table;
-    std::string rngname;
-    readRData($2, parameter_table, rngname);
-    delete $2;
-    /* We have to set the name first, because the state or seed
-       might be embedded in the parameter_table */
-    if (rngname.size() != 0) {
-        Jtry(console->setRNGname(rngname, $7));
-    }
-    Jtry(console->setParameters(parameter_table, $7));
-    print_unused_variables(parameter_table, false);
+| PARAMETERS IN file_name ',' CHAIN '(' INT ')' {
+    std::cout << "Reading parameter file " << *$3 << std::endl;
+    readParameterFile(*$3, $7);
+    delete $3;
+}
+| INITS IN file_name {
+    /* Legacy option to not break existing scripts */
+    std::cout << "Reading initial values file " << *$3 << std::endl;
+    readParameterFile(*$3, 0);
+    delete $3;
+}
+| INITS IN file_name ',' CHAIN '(' INT ')' {
+    std::cout << "Reading initial values file " << *$3 << std::endl;
+    readParameterFile(*$3, $7);
+    delete $3;
 }
-| parameters {} // Failed to open the file
 ;
 
 parameters_to: PARAMETERS TO file_name {
@@ -333,26 +292,13 @@ parameters_to: PARAMETERS TO file_name {
     doDump(*$3, jags::PARAMETER_VALUES, $7);
     delete $3;
 }
-;
-
-parameters: PARAMETERS IN file_name {
-  if(open_data_buffer($3)) {
-    std::cout << "Reading parameter file " << *$3 << std::endl;
-  }
-  else {
-    std::cerr << "Unable to open file " << *$3 << std::endl << std::flush;
-  }
-  delete $3;
+| PARAMETERS TO file_name ',' FORMAT '(' NAME ')' {
+    doDump(*$3, jags::PARAMETER_VALUES, 1, *$7);
+    delete $3; delete $7;
 }
-| INITS IN file_name {
-  /* Legacy option to not break existing scripts */
-  if(open_data_buffer($3)) {
-    std::cout << "Reading initial values file " << *$3 << std::endl;
-  }
-  else {
-    std::cerr << "Unable to open file " << *$3 << std::endl << std::flush;
-  }
-  delete $3;
+| PARAMETERS TO file_name ',' CHAIN '(' INT ')' ',' FORMAT '(' NAME ')' {
+    doDump(*$3, jags::PARAMETER_VALUES, $7, *$12);
+    delete $3; delete $12;
 }
 ;
 
@@ -469,6 +415,14 @@ monitor_set: MONITOR SET var  {
     setMonitor($2, $6, *$10); 
     delete $10;
 }
+| MONITOR var ',' TYPE '(' NAME ')' STEM '(' file_name ')' {
+    setMonitor($2, 1, *$6, *$10);
+    delete $2; delete $6; delete $10;
+}
+| MONITOR var ',' TYPE '(' NAME ')' THIN '(' INT ')' STEM '(' file_name ')' {
+    setMonitor($2, $10, *$6, *$14);
+    delete $2; delete $6; delete $14;
+}
 ;
 
 monitor_clear: MONITOR CLEAR var {
@@ -524,6 +478,12 @@ coda: CODA var {
 | CODA var ',' STEM '(' file_name ')' TYPE '(' NAME ')' {
   doCoda ($2, *$6, *$10); delete $2; delete $6; delete $10;
 }
+| CODA var ',' STEM '(' file_name ')' ',' FORMAT '(' NAME ')' {
+  doCoda ($2, *$6, "*", *$11); delete $2; delete $6; delete $11;
+}
+| CODA var ',' STEM '(' file_name ')' TYPE '(' NAME ')' ',' FORMAT '(' NAME ')' {
+  doCoda ($2, *$6, *$10, *$15); delete $2; delete $6; delete $10; delete $15;
+}
 | CODA '*' {
   doAllCoda ("CODA", "*"); 
 }
@@ -533,6 +493,12 @@ coda: CODA var {
 | CODA '*' ',' STEM '(' file_name ')' TYPE '(' NAME ')' {
   doAllCoda (*$6, *$10); delete $6; delete $10;
 }
+| CODA '*' ',' STEM '(' file_name ')' ',' FORMAT '(' NAME ')' {
+  doAllCoda (*$6, "*", *$11); delete $6; delete $11;
+}
+| CODA '*' ',' STEM '(' file_name ')' TYPE '(' NAME ')' ',' FORMAT '(' NAME ')' {
+  doAllCoda (*$6, *$10, *$15); delete $6; delete $10; delete $15;
+}
 ;
 
 load: LOAD file_name { loadModule(*$2); }
@@ -577,6 +543,13 @@ set_factory: SET FACTORY STRING NAME ',' TYPE '(' SAMPLER ')'
     delete $4;
 }
 |
+SET FACTORY STRING NAME '(' INT ')' ',' TYPE '(' SAMPLER ')'
+{
+    setFactoryOption(*$3, jags::SAMPLER_FACTORY, *$4, $6);
+    delete $3;
+    delete $4;
+}
+|
 SET FACTORY NAME NAME ',' TYPE '(' RNGTOK ')'
 {
     setFactory(*$3, jags::RNG_FACTORY, *$4);
@@ -598,138 +571,41 @@ set_seed: SET SEED INT
 }
 ;
 
-/* Rules for scanning dumped R datasets */
-
-r_assignment_list: r_assignment {
-  $$ = new std::vector<jags::ParseTree*>(1, $1);
-}
-| r_assignment_list r_assignment {
-  $$ = $1; $$->push_back($2);
-}
-| r_assignment_list ';' r_assignment {
-  $$ = $1; $$->push_back($3);
-}
-;
-
-r_assignment: r_name ARROW r_structure {
-  $$ = $3; setName($$, $1);
-}
-| r_name ARROW r_collection {
-  $$ = new jags::ParseTree(jags::P_ARRAY);
-  setName($$, $1);
-  setParameters($$, $3);
-}
-| r_name ARROW STRING {
-  /* Allow this for setting the NAME of the random number generator */
-  $$ = new jags::ParseTree(jags::P_VAR); setName($$, $1);
-  jags::ParseTree *p = new jags::ParseTree(jags::P_VAR); setName(p, $3);
-  setParameters($$, p);
-}
-;
-
-r_name: STRING
-| NAME
-| '`' NAME '`' {
-    /* R >= 2.4.0 uses backticks for quoted names */
-    $$ = $2;
-}
-
-r_data: r_collection
-| DOTDATA '=' r_collection {
-    $$ = $3;
-}
-
-r_structure: STRUCTURE '(' r_data ',' r_attribute_list ')' {
-  $$ = new jags::ParseTree(jags::P_ARRAY); 
-  if ($5) 
-    setParameters($$, $3, $5);
-  else
-    setParameters($$, $3);
-}
-| STRUCTURE '(' r_data ')' {
-    $$ = new jags::ParseTree(jags::P_ARRAY);
-    setParameters($$, $3);
-}
-;
-
-/* The only attribute we are interested in is .Dim. The rest are
-   simply discarded - see below */
-r_attribute_list: r_dim
-| r_generic_attribute {$$=0;}
-| r_attribute_list ',' r_generic_attribute
-| r_attribute_list ',' r_dim {$$=$3;}
-;
-
-r_dim: DIM '=' r_collection {
-  $$ = $3;
-}
-| DIM '=' range_element {
-  $$ = $3;
+set_threads: SET NAME INT
+{
+    /* "threads" is not a keyword, so it can still be used as a name */
+    if (*$2 != "threads") {
+	std::cerr << "syntax error, unknown option " << *$2 << std::endl;
+    }
+    else if ($3 <= 0) {
+	std::cerr << "number of threads must be positive" << std::endl;
+    }
+    else {
+	Jtry(console->setSamplerThreads($3));
+    }
+    delete $2;
 }
 ;
 
-r_collection: r_integer_collection
-| r_value_collection
-;
-
-r_integer_collection: ASINTEGER '(' r_value_collection ')' {$$ = $3;}
-;
-
-r_value_collection: r_value { 
-  $$ = new jags::ParseTree(jags::P_VECTOR); 
-  setParameters($$, $1);
-}
-| 'c' '(' r_value_list ')' {
-  $$ = new jags::ParseTree(jags::P_VECTOR);
-  setParameters($$, $3);
+set_plates: SET NAME NAME
+{
+    /* As for "threads", "plates" is not a keyword */
+    if (*$2 != "plates") {
+	std::cerr << "syntax error, unknown option " << *$2 << std::endl;
+    }
+    else if (*$3 == "on") {
+	console->setPlates(true);
+    }
+    else if (*$3 == "off") {
+	console->setPlates(false);
+    }
+    else {
+	std::cerr << "status should be \"on\" or \"off\"" << std::endl;
+    }
+    delete $2;
+    delete $3;
 }
 ;
- 
-r_value_list: r_value {$$ = new std::vector<jags::ParseTree*>(1, $1); }
-| r_value_list ',' r_value {$$ = $1; $$->push_back($3);}
-;
-
-r_value: DOUBLE {$$ = new jags::ParseTree(jags::P_VALUE); $$->setValue($1);}
-| NA {$$ = new jags::ParseTree(jags::P_VALUE); $$->setValue(JAGS_NA);}
-;
-
-/* Rules for parsing generic attributes.  We don't want to do anything
-   with the results, just have the parser accept them */
-
-r_generic_attribute: NAME '=' r_generic_vector {}
-;
-
-r_generic_list: r_generic_list_element {}
-| r_generic_list ',' r_generic_list_element {}
-;
-
-r_generic_list_element: r_generic_vector {}
-| NAME '=' r_generic_vector {}
-;
-
-r_generic_vector: r_numeric_vector {}
-| ASINTEGER '(' r_numeric_vector ')' {}
-| r_character_vector {}
-| LIST '(' r_generic_list ')' {}
-| STRUCTURE '(' r_generic_list ')' {}
-| R_NULL {}
-;
-
-r_numeric_vector: DOUBLE {}
-| 'c' '(' r_double_list ')'
-;
-
-r_double_list: DOUBLE {}
-| r_double_list ',' DOUBLE {}
-;
-
-r_character_vector: STRING {}
-| 'c' '(' r_string_list ')' {}
-;
-
-r_string_list: STRING {}
-| r_string_list ',' STRING {}
-;
 
 /* Rules for interacting with the operating system */
 
@@ -823,16 +699,17 @@ static jags::Range getRange(jags::ParseTree const *var)
   return jags::SimpleRange(ind_lower, ind_upper);
 }
 
-void setMonitor(jags::ParseTree const *var, int thin, std::string const &type)
+void setMonitor(jags::ParseTree const *var, int thin, std::string const &type,
+		std::string const &stem)
 {
     std::string const &name = var->name();
     if (var->parameters().empty()) {
 	/* Requesting the whole node */
-	console->setMonitor(name, jags::Range(), thin, type);
+	console->setMonitor(name, jags::Range(), thin, type, stem);
     }
     else {
 	/* Requesting subset of a multivariate node */
-	console->setMonitor(name, getRange(var), thin, type);
+	console->setMonitor(name, getRange(var), thin, type, stem);
     }
 }
 
@@ -849,13 +726,39 @@ void clearMonitor(jags::ParseTree const *var, std::string const &type)
     }
 }
 
-void doAllCoda (std::string const &stem, std::string const &type)
+/* Returns true if the format name is valid, setting binary accordingly */
+static bool getCodaFormat(std::string const &format, bool &binary)
+{
+    if (format == "coda") {
+	binary = false;
+    }
+    else if (format == "binary") {
+	binary = true;
+    }
+    else {
+	std::cerr << "Unknown output format " << format << std::endl;
+	return false;
+    }
+    return true;
+}
+
+void doAllCoda (std::string const &stem, std::string const &type,
+		std::string const &format)
 {
-    console->coda(stem, type);
+    bool binary = false;
+    if (getCodaFormat(format, binary)) {
+	console->coda(stem, type, binary);
+    }
 }
 
-void doCoda (jags::ParseTree const *var, std::string const &stem, std::string const &type)
+void doCoda (jags::ParseTree const *var, std::string const &stem, std::string const &type,
+	     std::string const &format)
 {
+    bool binary = false;
+    if (!getCodaFormat(format, binary)) {
+	return;
+    }
+
     //FIXME: Allow list of several nodes
 
     std::vector<std::pair<std::string, jags::Range> > dmp;
@@ -867,7 +770,7 @@ void doCoda (jags::ParseTree const *var, std::string const &stem, std::string co
 	/* Requesting subset of a multivariate node */
 	dmp.push_back(std::pair<std::string,jags::Range>(var->name(), getRange(var)));
     }
-    console->coda(dmp, stem, type);
+    console->coda(dmp, stem, type, binary);
 }
 
 /* Helper function for doDump that handles all the special cases
@@ -896,14 +799,25 @@ static void writeValue(double x, std::ostream &out, bool isdiscrete)
   }
 }
 
-void doDump(std::string const &file, jags::ValueType type, unsigned int chain)
+void doDump(std::string const &file, jags::ValueType type, unsigned int chain,
+	    std::string const &format)
 {
+    if (format != "rdump" && format != "binary") {
+	std::cerr << "Unknown output format " << format << std::endl;
+	return;
+    }
+
     std::map<std::string,jags::SArray> data_table;
     std::string rng_name;
     if (!console->dumpState(data_table, rng_name, type, chain)) {
 	return;
     }
 
+    if (format == "binary") {
+	writeBinaryData(file, data_table, rng_name);
+	return;
+    }
+
     /* Open output file */
     std::ofstream out(file.c_str());
     if (!out) {
@@ -1592,12 +1506,49 @@ static void dumpSamplers(std::string const &file)
     out.close();
 }
 
-static void delete_pvec(std::vector<jags::ParseTree*> *pv)
+static void readDataFile(std::string const &file)
 {
-    for (unsigned int i = 0; i < pv->size(); ++i) {
-	delete (*pv)[i];
+    std::string rngname;
+    if (!readData(ExpandFileName(file.c_str()), _data_table, rngname)) {
+	if (!interactive) exit(1);
+	return;
+    }
+    if (rngname.size() != 0) {
+	std::cerr << "WARNING: .RNG.name assignment ignored" << std::endl;
     }
-    delete pv;
+}
+
+static void readParameterFile(std::string const &file, unsigned int chain)
+{
+    /* Reads parameter values for the given chain, or for all chains
+       if chain is zero */
+    std::map<std::string, jags::SArray> parameter_table;
+    std::string rngname;
+    if (!readData(ExpandFileName(file.c_str()), parameter_table, rngname)) {
+	if (!interactive) exit(1);
+	return;
+    }
+    if (console->model() == 0) {
+	std::cout << "ERROR: Initial values ignored. "
+		  <<  "(You must compile the model first)" << std::endl;
+	if (!interactive) exit(1);
+	return;
+    }
+    /* Setting all chains to the same state: if the user sets the
+       RNG state in addition to the parameter values then all chains
+       will be identical!
+    */
+    unsigned int first = chain ? chain : 1;
+    unsigned int last = chain ? chain : console->nchain();
+    for (unsigned int i = first; i <= last; ++i) {
+	/* We have to set the name first, because the state or seed
+	   might be embedded in the parameter_table */
+	if (rngname.size() != 0) {
+	    Jtry(console->setRNGname(rngname, i));
+	}
+	Jtry(console->setParameters(parameter_table, i));
+    }
+    print_unused_variables(parameter_table, false);
 }
 
 static void print_unused_variables(std::map<std::string, jags::SArray> const &table,
@@ -1741,6 +1692,15 @@ void setFactory(std::string const &name, jags::FactoryType type,
     }
 }
 
+void setFactoryOption(std::string const &name, jags::FactoryType type,
+		      std::string const &option, int value)
+{
+    if (!jags::Console::setFactoryOption(name, type, option, value)) {
+	std::cout << "Cannot set option " << option << " of factory "
+		  << name;
+    }
+}
+
 void setSeed(unsigned int seed)
 {
     if (seed == 0) {
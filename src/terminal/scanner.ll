@@ -11,15 +11,12 @@
     int buffer_count = 0;
     void return_to_main_buffer();
     void close_buffer();
-    std::string ExpandFileName(char const *name);
 %}
 
 %option prefix="zz"
 
 EXPONENT	[eE][+-][0-9]+
-BRACKET         [ \t]*\(
 
-%s RDATA
 %x COMMENT
 %x SYSTEM
 
@@ -60,6 +57,7 @@ seed                    zzlval.intval=SEED; return SEED;
 
 coda			zzlval.intval=CODA; return CODA;
 stem			zzlval.intval=STEM; return STEM;
+format			zzlval.intval=FORMAT; return FORMAT;
 
 load                    zzlval.intval=LOAD; return LOAD;
 unload                  zzlval.intval=UNLOAD; return UNLOAD;
@@ -78,20 +76,17 @@ run                     zzlval.intval=RUN; return RUN;
 "("			return '(';
 ")"			return ')';
 "="                     return '=';
-"<-"			return ARROW;
 "*"			return '*';
 ":"                     return ':';
 ";"                     return ';';
-"`"                     return '`';
 
 "/*"                    BEGIN(COMMENT);
 <COMMENT>[^*]*          /* Eat up anything that's not a '*' */
 <COMMENT>"*"+[^*/]*     /* Eat up '*'s not followed by a '/'  */
 <COMMENT>"*"+"/"        BEGIN(INITIAL);
 
-<RDATA,INITIAL>[ \t\r\f]+ /* Eat whitespace */
-<RDATA,INITIAL>"#".*\n  /* Eat single-line comments */
-<RDATA>[\n]+            /* Eat newlines */
+<INITIAL>[ \t\r\f]+      /* Eat whitespace */
+<INITIAL>"#".*\n         /* Eat single-line comments */
 <INITIAL>[\n]           return ENDCMD;
 
 <INITIAL>"system"       BEGIN(SYSTEM);
@@ -103,40 +98,25 @@ run                     zzlval.intval=RUN; return RUN;
     BEGIN(INITIAL); return ENDCMD;
  }
 
-<INITIAL,RDATA>"-"?([0-9]+){EXPONENT}  {
+<INITIAL>"-"?([0-9]+){EXPONENT}  {
   zzlval.val = atof(zztext); return DOUBLE;
 }
-<INITIAL,RDATA>"-"?([0-9]+"."[0-9]*){EXPONENT}  {
+<INITIAL>"-"?([0-9]+"."[0-9]*){EXPONENT}  {
   zzlval.val = atof(zztext); return DOUBLE;
 }
-<INITIAL,RDATA>"-"?([0-9]+"."[0-9]*)  {
+<INITIAL>"-"?([0-9]+"."[0-9]*)  {
   zzlval.val = atof(zztext); return DOUBLE;
 }
-<INITIAL,RDATA>"-"?("."[0-9]+){EXPONENT}  {
+<INITIAL>"-"?("."[0-9]+){EXPONENT}  {
   zzlval.val = atof(zztext); return DOUBLE;
 }
-<INITIAL,RDATA>"-"?("."[0-9]+)  {
-  zzlval.val = atof(zztext); return DOUBLE;
-}
-<RDATA>"-"?[0-9]+  {
-  zzlval.val = atof(zztext); return DOUBLE;
-}
-<RDATA>"-"?[0-9]+"L" {
+<INITIAL>"-"?("."[0-9]+)  {
   zzlval.val = atof(zztext); return DOUBLE;
 }
 <INITIAL>"-"?[0-9]+	{
   zzlval.intval = atoi(zztext); return INT;
 }
 
-<RDATA>".Dim"                   return DIM;
-<RDATA>".Data"                  return DOTDATA;
-<RDATA>"NA"		        return NA;
-<RDATA>"NULL"		        return R_NULL;
-<RDATA>"structure"/{BRACKET}	return STRUCTURE;
-<RDATA>"list"/{BRACKET}		return LIST;
-<RDATA>"c"/{BRACKET} 		return 'c';
-<RDATA>"as.integer"/{BRACKET}   return ASINTEGER;
-
 [a-zA-Z\.]+[a-zA-Z0-9\._\-\\\/]* { 
   zzlval.stringptr = new std::string(zztext);
   return NAME;
@@ -179,11 +159,6 @@ _observations_ {
     }
     return ENDSCRIPT;
 }
-<RDATA><<EOF>> {
-    close_buffer();
-    BEGIN(INITIAL);
-    return ENDDATA;
-}
 %%
 
 int zzwrap()
@@ -204,20 +179,6 @@ void pop_file() {
 }
 
 
-bool open_data_buffer(std::string const *name) {
-    FILE *file = fopen(ExpandFileName(name->c_str()).c_str(),"r");
-    if (file) {
-	zzpush_buffer_state(zz_create_buffer(file, YY_BUF_SIZE));
-	push_file(file);
-        ++buffer_count;
-	BEGIN(RDATA);
-	return true;
-    }
-    else {
-	return false;
-    }
-}
-
 void close_buffer() {
     zzpop_buffer_state();
     pop_file();
@@ -0,0 +1,264 @@
+#include <config.h>
+#include "testreaddata.h"
+
+#include "ReadData.h"
+#include "BinaryData.h"
+
+#include <util/nainf.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+
+using std::cerr;
+using std::streambuf;
+using std::ostringstream;
+using std::ifstream;
+using std::ofstream;
+using std::ios;
+using std::istreambuf_iterator;
+using std::map;
+using std::string;
+using std::vector;
+using std::isnan;
+
+using jags::SArray;
+
+static const char *TEMP_FILE = "testreaddata.tmp";
+
+namespace {
+
+    /* Captures the error messages printed while it is in scope */
+    class CaptureErrors {
+	ostringstream _out;
+	streambuf *_buf;
+    public:
+	CaptureErrors() : _buf(cerr.rdbuf(_out.rdbuf())) {}
+	~CaptureErrors() { cerr.rdbuf(_buf); }
+	string str() const { return _out.str(); }
+    };
+
+}
+
+static void writeFile(string const &contents)
+{
+    ofstream out(TEMP_FILE, ios::binary);
+    out << contents;
+}
+
+static SArray const &lookup(map<string, SArray> const &table,
+			    string const &name)
+{
+    map<string, SArray>::const_iterator p = table.find(name);
+    CPPUNIT_ASSERT_MESSAGE(name, p != table.end());
+    return p->second;
+}
+
+static void checkDim(SArray const &x, vector<unsigned long> const &dim)
+{
+    CPPUNIT_ASSERT(x.dim(false) == dim);
+}
+
+void ReadDataTest::tearDown()
+{
+    std::remove(TEMP_FILE);
+}
+
+void ReadDataTest::rdump()
+{
+    writeFile("# Written by R\n"
+	      "`x` <- c(1.5, NA, Inf, -Inf, NaN)\n"
+	      "\"N\" <-\n"
+	      "5L\n"
+	      "Y <- structure(.Data = c(1, 2, 3, 4, 5, 6), .Dim = 2:3)\n"
+	      "Z <- structure(c(1L, 2L, 3L, 4L), .Dim = c(2L, 2L),\n"
+	      "  dimnames = list(c(\"a\", \"b\"), NULL))\n"
+	      "n <- as.integer(c(3, 4))\n"
+	      "\".RNG.name\" <- \"base::Wichmann-Hill\"\n"
+	      "`a b` <- 1e-3; w <- -2.5E+2\n");
+
+    map<string, SArray> table;
+    SArray old(vector<unsigned long>(1, 1));
+    old.setValue(vector<double>(1, 1.0));
+    table.emplace("N", old);
+    table.emplace("old", old);
+    string rngname;
+    {
+	CaptureErrors errors;
+	CPPUNIT_ASSERT(readData(TEMP_FILE, table, rngname));
+	CPPUNIT_ASSERT_EQUAL(string("WARNING: Replacing N\n"), errors.str());
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(8), table.size());
+    CPPUNIT_ASSERT_EQUAL(string("base::Wichmann-Hill"), rngname);
+
+    //Special values
+    SArray const &x = lookup(table, "x");
+    checkDim(x, vector<unsigned long>(1, 5));
+    vector<double> const &xv = x.value();
+    CPPUNIT_ASSERT_EQUAL(1.5, xv[0]);
+    CPPUNIT_ASSERT(jags_isna(xv[1]));
+    CPPUNIT_ASSERT_EQUAL(JAGS_POSINF, xv[2]);
+    CPPUNIT_ASSERT_EQUAL(JAGS_NEGINF, xv[3]);
+    CPPUNIT_ASSERT(isnan(xv[4]) && !jags_isna(xv[4]));
+
+    //Integer suffix, and replacement of an existing value
+    SArray const &N = lookup(table, "N");
+    checkDim(N, vector<unsigned long>(1, 1));
+    CPPUNIT_ASSERT_EQUAL(5.0, N.value()[0]);
+    CPPUNIT_ASSERT_EQUAL(1.0, lookup(table, "old").value()[0]);
+
+    //Structures, with dimensions given as a sequence or a vector,
+    //and with other attributes skipped
+    SArray const &Y = lookup(table, "Y");
+    vector<unsigned long> dimY(2);
+    dimY[0] = 2; dimY[1] = 3;
+    checkDim(Y, dimY);
+    for (unsigned int i = 0; i < 6; ++i) {
+	CPPUNIT_ASSERT_EQUAL(i + 1.0, Y.value()[i]);
+    }
+    SArray const &Z = lookup(table, "Z");
+    checkDim(Z, vector<unsigned long>(2, 2));
+    CPPUNIT_ASSERT_EQUAL(4.0, Z.value()[3]);
+
+    SArray const &n = lookup(table, "n");
+    checkDim(n, vector<unsigned long>(1, 2));
+    CPPUNIT_ASSERT_EQUAL(3.0, n.value()[0]);
+    CPPUNIT_ASSERT_EQUAL(4.0, n.value()[1]);
+
+    //Backtick names and assignments on the same line
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0E-3, lookup(table, "a b").value()[0],
+				 tol);
+    CPPUNIT_ASSERT_EQUAL(-250.0, lookup(table, "w").value()[0]);
+}
+
+void ReadDataTest::rdump_errors()
+{
+    /*
+      An error is reported with the line on which it was found, and
+      the table and the name of the random number generator are left
+      unchanged.
+    */
+    struct {
+	char const *contents;
+	char const *message;
+    } cases[] = {
+	{"x <- 1\ny <- c(1,\n2,,3)\n",
+	 " at line 3: Expected numeric value"},
+	{"x <- 1\n\nz <- structure(c(1, 2, 3),\n .Dim = c(2L, 2L))\nw <- 2\n",
+	 " at line 3: Bad dimension for variable z"},
+	{"a <- 1\nb <- `unterminated\n\n",
+	 " at line 2: Syntax error"},
+	{"a <- 1\n\"b\" <- \"foo\"\n",
+	 " at line 2: Unrecognized string assignment"},
+	{"a <- structure(c(1, 2), .Dim = 3:2)\n",
+	 " at line 1: Invalid sequence in dimension attribute"},
+	{"\n\na <- c(1, 2) b = 3\n",
+	 " at line 3: Expected <-"}
+    };
+
+    for (unsigned int i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+	writeFile(cases[i].contents);
+	map<string, SArray> table;
+	SArray x(vector<unsigned long>(1, 1));
+	x.setValue(vector<double>(1, 99.0));
+	table.emplace("x", x);
+	string rngname("keep");
+	CaptureErrors errors;
+	CPPUNIT_ASSERT(!readData(TEMP_FILE, table, rngname));
+	CPPUNIT_ASSERT_MESSAGE(errors.str(), errors.str().find(cases[i].message)
+			       != string::npos);
+	CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), table.size());
+	CPPUNIT_ASSERT_EQUAL(99.0, lookup(table, "x").value()[0]);
+	CPPUNIT_ASSERT_EQUAL(string("keep"), rngname);
+    }
+
+    std::remove(TEMP_FILE);
+    map<string, SArray> table;
+    string rngname;
+    CaptureErrors errors;
+    CPPUNIT_ASSERT(!readData(TEMP_FILE, table, rngname));
+    CPPUNIT_ASSERT(errors.str().find("Unable to open file") != string::npos);
+}
+
+void ReadDataTest::binary()
+{
+    map<string, SArray> table;
+
+    SArray alpha(vector<unsigned long>(1, 1));
+    alpha.setValue(vector<double>(1, 3.0));
+    table.emplace("alpha", alpha);
+
+    SArray beta(vector<unsigned long>(1, 5));
+    double bv[5] = {1.5, JAGS_NA, JAGS_POSINF, JAGS_NEGINF, JAGS_NAN};
+    beta.setValue(vector<double>(bv, bv + 5));
+    table.emplace("beta", beta);
+
+    vector<unsigned long> dim(3, 2);
+    dim[1] = 3;
+    SArray gamma(dim);
+    vector<double> gv(12);
+    for (unsigned int i = 0; i < gv.size(); ++i) {
+	gv[i] = 0.25 * i - 1;
+    }
+    gamma.setValue(gv);
+    table.emplace("gamma", gamma);
+
+    CPPUNIT_ASSERT(writeBinaryData(TEMP_FILE, table, "base::Marsaglia-Multicarry"));
+
+    //The file is recognized from its first bytes
+    ifstream in(TEMP_FILE, ios::binary);
+    string contents((istreambuf_iterator<char>(in)),
+		    istreambuf_iterator<char>());
+    in.close();
+    CPPUNIT_ASSERT(isBinaryData(contents.data(), contents.size()));
+    CPPUNIT_ASSERT(!isBinaryData(contents.data(), 7));
+    CPPUNIT_ASSERT(!isBinaryData("x <- c(1, 2)", 12));
+    //Values are aligned for memory mapping
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0),
+			 (contents.size() - 18 * sizeof(double)) % 8);
+
+    //Round trip
+    map<string, SArray> table2;
+    string rngname;
+    CPPUNIT_ASSERT(readData(TEMP_FILE, table2, rngname));
+    CPPUNIT_ASSERT_EQUAL(string("base::Marsaglia-Multicarry"), rngname);
+    CPPUNIT_ASSERT_EQUAL(table.size(), table2.size());
+    for (map<string, SArray>::const_iterator p = table.begin();
+	 p != table.end(); ++p)
+    {
+	SArray const &y = lookup(table2, p->first);
+	checkDim(y, p->second.dim(false));
+	vector<double> const &v1 = p->second.value();
+	vector<double> const &v2 = y.value();
+	CPPUNIT_ASSERT_EQUAL(v1.size(), v2.size());
+	for (unsigned int i = 0; i < v1.size(); ++i) {
+	    if (isnan(v1[i])) {
+		CPPUNIT_ASSERT(isnan(v2[i]));
+		CPPUNIT_ASSERT_EQUAL(jags_isna(v1[i]), jags_isna(v2[i]));
+	    }
+	    else {
+		CPPUNIT_ASSERT_EQUAL(v1[i], v2[i]);
+	    }
+	}
+    }
+
+    //A truncated file is rejected without modifying the table
+    writeFile(contents.substr(0, contents.size() - sizeof(double)));
+    map<string, SArray> table3;
+    table3.emplace("alpha", beta);
+    rngname = "keep";
+    CaptureErrors errors;
+    CPPUNIT_ASSERT(!readData(TEMP_FILE, table3, rngname));
+    CPPUNIT_ASSERT(errors.str().find("Truncated data for variable gamma")
+		   != string::npos);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), table3.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5),
+			 lookup(table3, "alpha").value().size());
+    CPPUNIT_ASSERT_EQUAL(string("keep"), rngname);
+}
@@ -0,0 +1,22 @@
+#ifndef READ_DATA_TEST_H_
+#define READ_DATA_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <testlib.h>
+
+class ReadDataTest : public CppUnit::TestFixture, public JAGSFixture
+{
+    CPPUNIT_TEST_SUITE( ReadDataTest );
+    CPPUNIT_TEST( rdump );
+    CPPUNIT_TEST( rdump_errors );
+    CPPUNIT_TEST( binary );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void tearDown();
+    void rdump();
+    void rdump_errors();
+    void binary();
+};
+
+#endif /* READ_DATA_TEST_H_ */
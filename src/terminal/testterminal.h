@@ -0,0 +1,6 @@
+#ifndef TERMINAL_TEST_H_
+#define TERMINAL_TEST_H_
+
+void init_terminal_test();
+
+#endif /* TERMINAL_TEST_H_ */
@@ -0,0 +1,89 @@
+#!/bin/sh
+
+## Runs scripts through jags-terminal that read data files with the
+## "data in" command and write them back with "data to", in R dump
+## and binary format. Values written in one format must be read back
+## unchanged, and a file with an error must stop the script with a
+## message giving the line of the error.
+
+top_builddir=`cd "${top_builddir:-..}" && pwd`
+JAGS="${top_builddir}/src/terminal/jags-terminal"
+LTDL_LIBRARY_PATH="${top_builddir}/src/modules/base:${top_builddir}/src/modules/bugs"
+export LTDL_LIBRARY_PATH
+
+dir=dataio.dir
+rm -rf $dir
+mkdir $dir
+cd $dir
+
+fail() {
+    echo "FAIL: $1"
+    exit 1
+}
+
+cat > model.bug <<EOF
+model {
+   for (i in 1:N) {
+      for (j in 1:M) {
+         Y[i,j] ~ dnorm(mu[j], tau)
+      }
+   }
+   for (j in 1:M) {
+      mu[j] ~ dnorm(0, 1.0E-3)
+   }
+   tau ~ dgamma(1, 1)
+}
+EOF
+
+cat > data.R <<EOF
+# Written by hand
+\`N\` <- 2L
+"M" <- as.integer(3)
+Y <- structure(.Data = c(1.5, NA, -0.25, 3, 1e-3, -2.5E+2), .Dim = 2:3)
+EOF
+
+cat > dataio.cmd <<EOF
+model in "model.bug"
+data in "data.R"
+compile
+data to "out.R"
+data to "out.bin", format(binary)
+data clear
+data in "out.bin"
+compile
+data to "bin.R"
+data clear
+data in "out.R"
+compile
+data to "rdump.R"
+exit
+EOF
+
+"${JAGS}" dataio.cmd > dataio.log 2>&1 || fail "data round trip"
+grep -q '^`Y` <-' out.R || fail "data to"
+cmp -s out.R bin.R || fail "binary data do not match"
+cmp -s out.R rdump.R || fail "R dump data do not match"
+
+cat > bad.R <<EOF
+N <- 2L
+M <- 3L
+Y <- structure(c(1, 2, 3, 4, 5),
+   .Dim = c(2L, 3L))
+EOF
+
+cat > bad.cmd <<EOF
+model in "model.bug"
+data in "bad.R"
+compile
+exit
+EOF
+
+if "${JAGS}" bad.cmd > bad.log 2>&1; then
+    fail "bad data file accepted"
+fi
+grep -q 'at line 3: Bad dimension for variable Y' bad.log || \
+    fail "error message"
+
+cd ..
+rm -rf $dir
+exit 0